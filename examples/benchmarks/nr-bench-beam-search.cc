@@ -0,0 +1,230 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/nr-module.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * @file nr-bench-beam-search.cc
+ * @ingroup examples
+ * @brief Microbenchmark of the beam search of CellScanBeamforming.
+ *
+ * For each size of the gNB and UE antenna arrays, the benchmark places a gNB and a UE on a
+ * 3GPP UMa channel and selects their beams with CellScanBeamforming, which builds the
+ * candidate beams once and evaluates the received power only for the pairs of beams whose
+ * upper bound, computed from the per-cluster long-term responses of all the pairs, is not
+ * below the best power found. It compares it with the previous exhaustive scan, which set
+ * the sector of the beam managers and computed the received power for every pair of beams,
+ * and checks that both select the same beams.
+ *
+ * The oversampling factor and the bandwidth can be configured through the command line, e.g.:
+ *
+ * ./ns3 run "nr-bench-beam-search --oversamplingFactor=2 --bandwidth=20e6"
+ */
+
+using namespace ns3;
+
+/**
+ * @brief Select the beams of a gNB and a UE by computing the received power of every pair
+ * of beams, as CellScanBeamforming did before CellScanBeamSearch
+ * @param gnbSpectrumPhy the spectrum PHY of the gNB
+ * @param ueSpectrumPhy the spectrum PHY of the UE
+ * @param oversamplingFactor the number of samples per antenna row and column
+ * @return the beam IDs of the gNB and of the UE
+ */
+static std::pair<BeamId, BeamId>
+ExhaustiveCellScan(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                   const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                   uint8_t oversamplingFactor)
+{
+    Ptr<const PhasedArraySpectrumPropagationLossModel> splm =
+        gnbSpectrumPhy->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel();
+
+    std::vector<int> activeRbs;
+    for (size_t rbId = 0; rbId < gnbSpectrumPhy->GetRxSpectrumModel()->GetNumBands(); rbId++)
+    {
+        activeRbs.push_back(rbId);
+    }
+    Ptr<const SpectrumValue> fakePsd = NrSpectrumValueHelper::CreateTxPowerSpectralDensity(
+        0.0,
+        activeRbs,
+        gnbSpectrumPhy->GetRxSpectrumModel(),
+        NrSpectrumValueHelper::UNIFORM_POWER_ALLOCATION_BW);
+    Ptr<SpectrumSignalParameters> fakeParams = Create<SpectrumSignalParameters>();
+    fakeParams->psd = fakePsd->Copy();
+
+    Ptr<UniformPlanarArray> gnbUpa = DynamicCast<UniformPlanarArray>(gnbSpectrumPhy->GetAntenna());
+    Ptr<UniformPlanarArray> ueUpa = DynamicCast<UniformPlanarArray>(ueSpectrumPhy->GetAntenna());
+    uint16_t txNumCols = gnbUpa->GetNumColumns();
+    uint16_t txNumRows = gnbUpa->GetNumRows();
+    uint16_t rxNumCols = ueUpa->GetNumColumns();
+    uint16_t rxNumRows = ueUpa->GetNumRows();
+
+    double txZenithStep = 180 / ((txNumRows > 1 ? oversamplingFactor : 1) * txNumRows);
+    double txSectorStep = 1.0 / (txNumCols > 1 ? oversamplingFactor : 1);
+    double rxZenithStep = 180 / ((rxNumRows > 1 ? oversamplingFactor : 1) * rxNumRows);
+    double rxSectorStep = 1.0 / (rxNumCols > 1 ? oversamplingFactor : 1);
+
+    double max = 0;
+    double maxTxTheta = 0;
+    double maxRxTheta = 0;
+    uint16_t maxTxSector = 0;
+    uint16_t maxRxSector = 0;
+    for (double txZenith = 0; txZenith < 180; txZenith += txZenithStep)
+    {
+        double txTheta = txZenith + txZenithStep * 0.5;
+        for (double txSector = 0; txSector < txNumCols; txSector += txSectorStep)
+        {
+            gnbSpectrumPhy->GetBeamManager()->SetSector(txSector, txTheta);
+            for (double rxZenith = 0; rxZenith < 180; rxZenith += txZenithStep)
+            {
+                double rxTheta = rxZenith + rxZenithStep * 0.5;
+                for (double rxSector = 0; rxSector < rxNumCols; rxSector += rxSectorStep)
+                {
+                    ueSpectrumPhy->GetBeamManager()->SetSector(rxSector, rxTheta);
+                    Ptr<SpectrumSignalParameters> rxParams =
+                        splm->CalcRxPowerSpectralDensity(fakeParams,
+                                                         gnbSpectrumPhy->GetMobility(),
+                                                         ueSpectrumPhy->GetMobility(),
+                                                         gnbUpa,
+                                                         ueUpa);
+                    double power = Sum(*(rxParams->psd));
+                    if (max < power)
+                    {
+                        max = power;
+                        maxTxSector = txSector;
+                        maxRxSector = rxSector;
+                        maxTxTheta = txTheta;
+                        maxRxTheta = rxTheta;
+                    }
+                }
+            }
+        }
+    }
+
+    return {BeamId(maxTxSector * (txNumCols > 1 ? oversamplingFactor : 1), maxTxTheta),
+            BeamId(maxRxSector * (rxNumCols > 1 ? oversamplingFactor : 1), maxRxTheta)};
+}
+
+/**
+ * @brief Run a function and return the time it took, in milliseconds per iteration
+ * @param iterations the number of iterations
+ * @param fn the function to run
+ * @return the time per iteration, in milliseconds
+ */
+template <typename F>
+static double
+TimePerIteration(uint32_t iterations, F fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t oversamplingFactor = 2;
+    double centralFrequency = 3.5e9;
+    double bandwidth = 20e6;
+    double ueDistance = 100;
+    uint32_t iterations = 3;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("oversamplingFactor", "Samples per antenna row/column", oversamplingFactor);
+    cmd.AddValue("centralFrequency", "The system frequency", centralFrequency);
+    cmd.AddValue("bandwidth", "The system bandwidth", bandwidth);
+    cmd.AddValue("ueDistance", "Horizontal distance between the gNB and the UE, in m", ueDistance);
+    cmd.AddValue("iterations", "Number of searches per measurement", iterations);
+    cmd.Parse(argc, argv);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Oversampling factor " << oversamplingFactor << ", " << bandwidth / 1e6
+              << " MHz" << std::endl;
+    std::cout << "gNB array\tUE array\tpairs\texhaustive (ms)\tsearch (ms)\tspeedup" << std::endl;
+
+    for (auto [gnbRows, gnbCols, ueRows, ueCols] :
+         std::vector<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t>>{{2, 2, 1, 1},
+                                                                          {4, 4, 1, 2},
+                                                                          {4, 4, 2, 2},
+                                                                          {8, 8, 2, 2},
+                                                                          {8, 8, 4, 4}})
+    {
+        NodeContainer gnbNodes;
+        gnbNodes.Create(1);
+        NodeContainer ueNodes;
+        ueNodes.Create(1);
+
+        MobilityHelper mobility;
+        mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+        Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+        positionAlloc->Add(Vector(0.0, 0.0, 25.0));
+        positionAlloc->Add(Vector(ueDistance, ueDistance / 3, 1.5));
+        mobility.SetPositionAllocator(positionAlloc);
+        mobility.Install(gnbNodes);
+        mobility.Install(ueNodes);
+
+        Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+        Ptr<NrChannelHelper> channelHelper = CreateObject<NrChannelHelper>();
+        channelHelper->ConfigureFactories("UMa", "Default", "ThreeGpp");
+        channelHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+        CcBwpCreator ccBwpCreator;
+        CcBwpCreator::SimpleOperationBandConf bandConf(centralFrequency, bandwidth, 1);
+        OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+        channelHelper->AssignChannelsToBands({band});
+        BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+        nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(gnbRows));
+        nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(gnbCols));
+        nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(ueRows));
+        nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(ueCols));
+        NetDeviceContainer gnbDevices = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+        NetDeviceContainer ueDevices = nrHelper->InstallUeDevice(ueNodes, allBwps);
+        nrHelper->AssignStreams(gnbDevices, 1);
+        nrHelper->AssignStreams(ueDevices, 1000);
+
+        Ptr<NrSpectrumPhy> gnbSpectrumPhy =
+            DynamicCast<NrGnbNetDevice>(gnbDevices.Get(0))->GetPhy(0)->GetSpectrumPhy();
+        Ptr<NrSpectrumPhy> ueSpectrumPhy =
+            DynamicCast<NrUeNetDevice>(ueDevices.Get(0))->GetPhy(0)->GetSpectrumPhy();
+
+        Ptr<CellScanBeamforming> cellScan = CreateObject<CellScanBeamforming>();
+        cellScan->SetAttribute("OversamplingFactor", UintegerValue(oversamplingFactor));
+        CellScanBeamSearch beamSearch(
+            DynamicCast<UniformPlanarArray>(gnbSpectrumPhy->GetAntenna()),
+            DynamicCast<UniformPlanarArray>(ueSpectrumPhy->GetAntenna()),
+            oversamplingFactor);
+
+        std::pair<BeamId, BeamId> exhaustiveBeams;
+        double msExhaustive = TimePerIteration(iterations, [&]() {
+            exhaustiveBeams =
+                ExhaustiveCellScan(gnbSpectrumPhy, ueSpectrumPhy, oversamplingFactor);
+        });
+        BeamformingVectorPair searchBeams;
+        double msSearch = TimePerIteration(iterations, [&]() {
+            searchBeams = cellScan->GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy);
+        });
+
+        NS_ABORT_MSG_IF(!(searchBeams.first.second == exhaustiveBeams.first) ||
+                            !(searchBeams.second.second == exhaustiveBeams.second),
+                        "The search selected different beams than the exhaustive scan");
+        std::cout << gnbRows << "x" << gnbCols << "\t" << ueRows << "x" << ueCols << "\t"
+                  << beamSearch.GetTxBeams().size() * beamSearch.GetRxBeams().size() << "\t"
+                  << msExhaustive << "\t" << msSearch << "\t" << msExhaustive / msSearch
+                  << std::endl;
+
+        Simulator::Destroy();
+    }
+
+    return 0;
+}
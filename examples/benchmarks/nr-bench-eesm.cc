@@ -0,0 +1,130 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/core-module.h"
+#include "ns3/nr-module.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+/**
+ * @file nr-bench-eesm.cc
+ * @ingroup examples
+ * @brief Microbenchmark of the EESM error model BLER lookups.
+ *
+ * The benchmark evaluates GetTbDecodificationStats() of an EESM error model for
+ * random SINR vectors, MCSs and TB sizes, so that most of the time is spent in the
+ * effective SINR computation and in the BLER-SINR curve lookups. It also reports the
+ * time spent by NrAmc to create a CQI feedback from the same SINR vectors, with and
+ * without the SINR threshold table.
+ *
+ * The error model, the number of evaluations and the number of RBs can be
+ * configured through the command line, e.g.:
+ *
+ * ./ns3 run "nr-bench-eesm --errorModel=ns3::NrEesmIrT2 --iterations=100000"
+ */
+
+using namespace ns3;
+
+/**
+ * @brief Run a function and return the time it took, in nanoseconds per iteration
+ * @param iterations the number of iterations
+ * @param fn the function to run, with the iteration number as argument
+ * @return the time per iteration, in nanoseconds
+ */
+template <typename F>
+static double
+TimePerIteration(uint32_t iterations, F fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        fn(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string errorModel = "ns3::NrEesmIrT1";
+    uint32_t iterations = 20000;
+    uint32_t numRbs = 106;
+    uint32_t numSinrVectors = 64;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("errorModel", "EESM error model to benchmark", errorModel);
+    cmd.AddValue("iterations", "Number of evaluations of each benchmark", iterations);
+    cmd.AddValue("numRbs", "Number of RBs of the SINR vectors", numRbs);
+    cmd.AddValue("numSinrVectors", "Number of random SINR vectors", numSinrVectors);
+    cmd.Parse(argc, argv);
+
+    ObjectFactory factory;
+    factory.SetTypeId(errorModel);
+    Ptr<NrEesmErrorModel> em = DynamicCast<NrEesmErrorModel>(factory.Create());
+    NS_ABORT_MSG_IF(em == nullptr, errorModel << " is not an EESM error model");
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+
+    std::vector<BandInfo> bands(numRbs);
+    Ptr<SpectrumModel> sm = Create<SpectrumModel>(bands);
+    std::vector<SpectrumValue> sinrs;
+    std::vector<int> rbMap(numRbs);
+    std::iota(rbMap.begin(), rbMap.end(), 0);
+    for (uint32_t v = 0; v < numSinrVectors; ++v)
+    {
+        SpectrumValue sinr(sm);
+        for (uint32_t rb = 0; rb < numRbs; ++rb)
+        {
+            sinr[rb] = std::pow(10.0, rv->GetValue(-5.0, 30.0) / 10.0);
+        }
+        sinrs.emplace_back(sinr);
+    }
+
+    std::vector<uint8_t> mcss(iterations);
+    std::vector<uint32_t> sizes(iterations);
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        mcss[i] = static_cast<uint8_t>(rv->GetInteger(0, em->GetMaxMcs()));
+        sizes[i] = rv->GetInteger(10, 20000);
+    }
+
+    double tblerSum = 0.0;
+    double nsDecodification = TimePerIteration(iterations, [&](uint32_t i) {
+        auto output = em->GetTbDecodificationStats(sinrs[i % numSinrVectors],
+                                                   rbMap,
+                                                   sizes[i],
+                                                   mcss[i],
+                                                   NrErrorModel::NrErrorModelHistory());
+        tblerSum += output->m_tbler;
+    });
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << errorModel << ", " << numRbs << " RBs, " << iterations << " iterations"
+              << std::endl;
+    std::cout << "GetTbDecodificationStats: " << nsDecodification << " ns/call (avg TBLER "
+              << tblerSum / iterations << ")" << std::endl;
+
+    for (bool useThresholds : {false, true})
+    {
+        Ptr<NrAmc> amc = CreateObject<NrAmc>();
+        amc->SetAttribute("ErrorModelType", TypeIdValue(em->GetInstanceTypeId()));
+        amc->SetAttribute("UseSinrThresholdTable", BooleanValue(useThresholds));
+        uint32_t mcsSum = 0;
+        double nsCqi = TimePerIteration(iterations, [&](uint32_t i) {
+            uint8_t mcs = 0;
+            amc->CreateCqiFeedbackSiso(sinrs[i % numSinrVectors], mcs);
+            mcsSum += mcs;
+        });
+        std::cout << "CreateCqiFeedbackSiso (UseSinrThresholdTable=" << useThresholds
+                  << "): " << nsCqi << " ns/call (avg MCS "
+                  << static_cast<double>(mcsSum) / iterations << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/core-module.h"
+#include "ns3/nr-module.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * @file nr-bench-interference.cc
+ * @ingroup examples
+ * @brief Microbenchmark of the accumulation of the MIMO interference covariance matrix.
+ *
+ * For each number of interferers, the benchmark builds the interference-plus-noise covariance
+ * matrix of a MIMO receiver, as NrInterference does for each chunk, from random precoded
+ * channels of the interferers. It compares the fused kernel of
+ * NrCovMat::AddPrecodedInterferenceSignal(), which accumulates the covariance in place in a
+ * reused matrix, with the previous computation, which formed each precoded channel and its
+ * outer product as temporary matrix arrays in a new covariance matrix.
+ *
+ * The dimensions and the number of chunks can be configured through the command line, e.g.:
+ *
+ * ./ns3 run "nr-bench-interference --nRxPorts=4 --nTxPorts=4 --rank=2 --numRbs=273"
+ */
+
+using namespace ns3;
+
+/**
+ * @brief Create a matrix array with random complex Gaussian elements
+ * @param rv the normal random variable
+ * @param nRows the number of rows
+ * @param nCols the number of columns
+ * @param nPages the number of pages
+ * @return the matrix array
+ */
+static ComplexMatrixArray
+CreateRandomMatrix(Ptr<NormalRandomVariable> rv, size_t nRows, size_t nCols, size_t nPages)
+{
+    ComplexMatrixArray mat{nRows, nCols, nPages};
+    for (size_t p = 0; p < nPages; p++)
+    {
+        for (size_t j = 0; j < nCols; j++)
+        {
+            for (size_t i = 0; i < nRows; i++)
+            {
+                mat(i, j, p) = std::complex<double>{rv->GetValue(), rv->GetValue()};
+            }
+        }
+    }
+    return mat;
+}
+
+/**
+ * @brief Run a function and return the time it took, in microseconds per iteration
+ * @param iterations the number of iterations
+ * @param fn the function to run
+ * @return the time per iteration, in microseconds
+ */
+template <typename F>
+static double
+TimePerIteration(uint32_t iterations, F fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nRxPorts = 4;
+    uint32_t nTxPorts = 4;
+    uint32_t rank = 4;
+    uint32_t numRbs = 106;
+    uint32_t chunks = 20;
+    uint32_t maxInterferers = 200;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("nRxPorts", "Number of receive ports", nRxPorts);
+    cmd.AddValue("nTxPorts", "Number of transmit ports of the interferers", nTxPorts);
+    cmd.AddValue("rank", "Number of layers of the interferers", rank);
+    cmd.AddValue("numRbs", "Number of RBs", numRbs);
+    cmd.AddValue("chunks", "Number of covariance matrices computed per measurement", chunks);
+    cmd.AddValue("maxInterferers", "Maximum number of interferers", maxInterferers);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(rank > nTxPorts, "The rank cannot be larger than the TX ports");
+
+    Ptr<NormalRandomVariable> rv = CreateObject<NormalRandomVariable>();
+    rv->SetStream(1);
+
+    std::vector<ComplexMatrixArray> chanMats;
+    std::vector<ComplexMatrixArray> precMats;
+    for (uint32_t i = 0; i < maxInterferers; ++i)
+    {
+        chanMats.emplace_back(CreateRandomMatrix(rv, nRxPorts, nTxPorts, numRbs));
+        precMats.emplace_back(CreateRandomMatrix(rv, nTxPorts, rank, numRbs));
+    }
+    std::vector<BandInfo> bands(numRbs);
+    SpectrumValue noise(Create<SpectrumModel>(bands));
+    noise = 1e-13;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << nRxPorts << "x" << nTxPorts << " MIMO, rank " << rank << ", " << numRbs
+              << " RBs, " << chunks << " chunks" << std::endl;
+    std::cout << "interferers\ttemporaries (us/chunk)\tfused (us/chunk)\tspeedup" << std::endl;
+
+    NrCovMat fusedCov;
+    for (uint32_t numInterferers : {1, 2, 5, 10, 20, 50, 100, 200})
+    {
+        if (numInterferers > maxInterferers)
+        {
+            break;
+        }
+
+        NrCovMat refCov;
+        double usTemporaries = TimePerIteration(chunks, [&]() {
+            refCov = NrCovMat{ComplexMatrixArray(nRxPorts, nRxPorts, numRbs)};
+            for (size_t iRb = 0; iRb < numRbs; iRb++)
+            {
+                for (size_t iRxPort = 0; iRxPort < nRxPorts; iRxPort++)
+                {
+                    refCov(iRxPort, iRxPort, iRb) = noise.ValuesAt(iRb);
+                }
+            }
+            for (uint32_t i = 0; i < numInterferers; ++i)
+            {
+                auto chanPrec = chanMats[i] * precMats[i];
+                refCov += chanPrec * chanPrec.HermitianTranspose();
+            }
+        });
+
+        double usFused = TimePerIteration(chunks, [&]() {
+            fusedCov.SetDiagonal(nRxPorts, numRbs, noise);
+            for (uint32_t i = 0; i < numInterferers; ++i)
+            {
+                fusedCov.AddPrecodedInterferenceSignal(chanMats[i], precMats[i]);
+            }
+        });
+
+        NS_ABORT_MSG_IF(!fusedCov.IsAlmostEqual(refCov, 1e-6 * numInterferers * nTxPorts),
+                        "The fused covariance differs from the reference one");
+        std::cout << numInterferers << "\t" << usTemporaries << "\t" << usFused << "\t"
+                  << std::setprecision(2) << usTemporaries / usFused << std::setprecision(1)
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/nr-module.h"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+/**
+ * @file nr-bench-rlc.cc
+ * @ingroup examples
+ * @brief Microbenchmark of the RLC UM and AM entities with deep transmission queues.
+ *
+ * A transmitting RLC entity is connected back to back to a receiving one, without MAC
+ * nor PHY: in each slot, the transmission queue is refilled with SDUs up to the
+ * configured depth, and the transmitting entity gets a transmission opportunity of a
+ * fixed size. Its PDUs are delivered to the receiving entity right away. In AM, the
+ * receiving entity gets a transmission opportunity for each STATUS PDU it reports, which
+ * is delivered back to the transmitting one. The benchmark reports the wall-clock time
+ * per transmission opportunity and the number of SDUs delivered per wall-clock second.
+ *
+ * The mode, the queue depths, the SDU and TB sizes and the number of slots can be
+ * configured through the command line, e.g.:
+ *
+ * ./ns3 run "nr-bench-rlc --mode=AM --queueDepths=100,1000,10000 --slots=20000"
+ */
+
+using namespace ns3;
+
+/**
+ * @brief MAC SAP provider that delivers the PDUs of an RLC entity to a peer entity, and
+ * optionally grants a transmission opportunity for each STATUS PDU reported
+ */
+class BenchMacSapProvider : public NrMacSapProvider
+{
+  public:
+    void TransmitPdu(TransmitPduParameters params) override
+    {
+        m_peer->ReceivePdu(
+            NrMacSapUser::ReceivePduParameters(params.pdu, params.rnti, params.lcid));
+    }
+
+    void BufferStatusReport(BufferStatusReportParameters params) override
+    {
+        if (m_grantStatusPdus && params.statusPduSize > 0)
+        {
+            NrMacSapUser::TxOpportunityParameters txOp(params.statusPduSize,
+                                                       0,
+                                                       0,
+                                                       0,
+                                                       params.rnti,
+                                                       params.lcid);
+            Simulator::ScheduleNow(&NrMacSapUser::NotifyTxOpportunity, m_user, txOp);
+        }
+    }
+
+    NrMacSapUser* m_user{nullptr}; //!< MAC SAP user of the entity
+    NrMacSapUser* m_peer{nullptr}; //!< MAC SAP user of the peer entity
+    bool m_grantStatusPdus{false}; //!< Grant a transmission opportunity for STATUS PDUs
+};
+
+/**
+ * @brief RLC SAP user that counts the delivered SDUs
+ */
+class BenchRlcSapUser : public NrRlcSapUser
+{
+  public:
+    void ReceivePdcpPdu(Ptr<Packet> p) override
+    {
+        ++m_sdus;
+    }
+
+    uint64_t m_sdus{0}; //!< Number of delivered SDUs
+};
+
+/**
+ * @brief Result of a benchmark run
+ */
+struct BenchResult
+{
+    double usPerTxOp;       //!< Wall-clock time per transmission opportunity, in microseconds
+    double sdusPerSecond;   //!< SDUs delivered per wall-clock second
+    uint64_t deliveredSdus; //!< Number of delivered SDUs
+};
+
+/**
+ * @brief Run a pair of RLC entities back to back, keeping the transmission queue at a
+ * given depth
+ * @param mode the RLC mode (UM or AM)
+ * @param queueDepth the number of SDUs in the transmission queue at each slot
+ * @param sduSize the SDU size, in bytes
+ * @param tbSize the size of the transmission opportunity of each slot, in bytes
+ * @param slots the number of slots
+ * @return the time per transmission opportunity, and the delivered SDUs
+ */
+static BenchResult
+RunBenchmark(const std::string& mode,
+             uint32_t queueDepth,
+             uint32_t sduSize,
+             uint32_t tbSize,
+             uint32_t slots)
+{
+    const uint16_t rnti = 1;
+    const uint8_t lcid = 1;
+    const Time slotPeriod = MicroSeconds(125);
+
+    ObjectFactory factory;
+    factory.SetTypeId("ns3::NrRlc" + mode);
+    // UM does not accept an unlimited buffer, AM does with zero
+    factory.Set("MaxTxBufferSize",
+                UintegerValue(mode == "UM" ? 2 * (queueDepth + 1) * sduSize : 0));
+    Ptr<NrRlc> tx = DynamicCast<NrRlc>(factory.Create());
+    Ptr<NrRlc> rx = DynamicCast<NrRlc>(factory.Create());
+    NS_ABORT_MSG_IF(tx == nullptr || rx == nullptr, "Unknown RLC mode " << mode);
+
+    BenchMacSapProvider txMac;
+    BenchMacSapProvider rxMac;
+    BenchRlcSapUser txPdcp;
+    BenchRlcSapUser rxPdcp;
+    auto connect = [&](Ptr<NrRlc> rlc,
+                       BenchMacSapProvider* mac,
+                       BenchRlcSapUser* pdcp,
+                       Ptr<NrRlc> peer) {
+        rlc->SetRnti(rnti);
+        rlc->SetLcId(lcid);
+        rlc->SetNrMacSapProvider(mac);
+        rlc->SetNrRlcSapUser(pdcp);
+        mac->m_user = rlc->GetNrMacSapUser();
+        mac->m_peer = peer->GetNrMacSapUser();
+    };
+    connect(tx, &txMac, &txPdcp, rx);
+    connect(rx, &rxMac, &rxPdcp, tx);
+    rxMac.m_grantStatusPdus = true;
+
+    uint64_t enqueuedSdus = 0;
+    std::function<void(uint32_t)> slot = [&](uint32_t n) {
+        // Refill the queue with the SDUs that have been delivered since the previous slot
+        for (; enqueuedSdus - rxPdcp.m_sdus < queueDepth; ++enqueuedSdus)
+        {
+            NrRlcSapProvider::TransmitPdcpPduParameters params;
+            params.pdcpPdu = Create<Packet>(sduSize);
+            params.rnti = rnti;
+            params.lcid = lcid;
+            tx->GetNrRlcSapProvider()->TransmitPdcpPdu(params);
+        }
+        tx->GetNrMacSapUser()->NotifyTxOpportunity(
+            NrMacSapUser::TxOpportunityParameters(tbSize, 0, 0, 0, rnti, lcid));
+        if (n + 1 < slots)
+        {
+            Simulator::Schedule(slotPeriod, slot, n + 1);
+        }
+    };
+    Simulator::ScheduleNow(slot, 0);
+    // The AM timers keep running while there is data in the queues
+    Simulator::Stop(slotPeriod * slots);
+
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    Simulator::Destroy();
+
+    tx->Dispose();
+    rx->Dispose();
+
+    return {elapsed.count() * 1e6 / slots,
+            static_cast<double>(rxPdcp.m_sdus) / elapsed.count(),
+            rxPdcp.m_sdus};
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string mode = "AM";
+    std::string queueDepthList = "100,1000,10000,50000";
+    uint32_t sduSize = 1500;
+    uint32_t tbSize = 9000;
+    uint32_t slots = 20000;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("mode", "RLC mode to benchmark (UM or AM)", mode);
+    cmd.AddValue("queueDepths",
+                 "Comma-separated list of numbers of SDUs kept in the TX queue",
+                 queueDepthList);
+    cmd.AddValue("sduSize", "SDU size, in bytes", sduSize);
+    cmd.AddValue("tbSize", "Transmission opportunity of each slot, in bytes", tbSize);
+    cmd.AddValue("slots", "Number of slots", slots);
+    cmd.Parse(argc, argv);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "RLC " << mode << ", " << sduSize << " bytes per SDU, " << tbSize
+              << " bytes per TX opportunity, " << slots << " slots" << std::endl;
+
+    std::stringstream ss(queueDepthList);
+    std::string queueDepth;
+    while (std::getline(ss, queueDepth, ','))
+    {
+        uint32_t depth = std::stoul(queueDepth);
+        BenchResult result = RunBenchmark(mode, depth, sduSize, tbSize, slots);
+        std::cout << depth << " SDUs queued: " << result.usPerTxOp << " us per TX opportunity, "
+                  << result.sdusPerSecond << " SDUs/s, " << result.deliveredSdus
+                  << " SDUs delivered" << std::endl;
+    }
+
+    return 0;
+}
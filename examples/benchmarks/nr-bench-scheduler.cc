@@ -0,0 +1,299 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/core-module.h"
+#include "ns3/nr-module.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+/**
+ * @file nr-bench-scheduler.cc
+ * @ingroup examples
+ * @brief Microbenchmark of the DL allocation of the OFDMA schedulers.
+ *
+ * The benchmark drives an OFDMA scheduler through its SAP interfaces, without PHY
+ * nor channel: in each slot, all the UEs report a random wideband or sub-band CQI and
+ * a random RLC buffer, the scheduler is triggered for a DL slot, and the previous DCIs
+ * are ACKed. It reports the time per slot spent in the scheduler, with the attribute
+ * IncrementalUeSort disabled and enabled, and checks that the allocations are the same.
+ *
+ * The scheduler, the number of UEs, the number of RBGs and the number of slots can be
+ * configured through the command line, e.g.:
+ *
+ * ./ns3 run "nr-bench-scheduler --scheduler=PF --numUes=10,100,500 --slots=200"
+ */
+
+using namespace ns3;
+
+/**
+ * @brief CSCHED SAP user that ignores all the messages
+ */
+class BenchCschedSapUser : public NrMacCschedSapUser
+{
+  public:
+    void CschedCellConfigCnf(const struct CschedCellConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigCnf(const struct CschedUeConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcConfigCnf(const struct CschedLcConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcReleaseCnf(const struct CschedLcReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeReleaseCnf(const struct CschedUeReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigUpdateInd(const struct CschedUeConfigUpdateIndParameters& params) override
+    {
+    }
+
+    void CschedCellConfigUpdateInd(
+        const struct CschedCellConfigUpdateIndParameters& params) override
+    {
+    }
+};
+
+/**
+ * @brief SCHED SAP user that keeps a checksum of the allocations, and the HARQ
+ * feedback for the DCIs of the last slot
+ */
+class BenchSchedSapUser : public NrMacSchedSapUser
+{
+  public:
+    void SchedConfigInd(const struct SchedConfigIndParameters& params) override
+    {
+        for (const auto& varTti : params.m_slotAllocInfo.m_varTtiAllocInfo)
+        {
+            const auto& dci = varTti.m_dci;
+            if (dci->m_type != DciInfoElementTdma::DATA)
+            {
+                continue;
+            }
+            m_checksum = m_checksum * 1000003 + dci->m_rnti;
+            m_checksum = m_checksum * 1000003 + dci->m_tbSize;
+            m_checksum = m_checksum * 1000003 + dci->m_mcs;
+            for (size_t rbg = 0; rbg < dci->m_rbgBitmask.size(); ++rbg)
+            {
+                m_checksum += dci->m_rbgBitmask[rbg] ? rbg * 7919 : 0;
+            }
+
+            DlHarqInfo ack;
+            ack.m_rnti = dci->m_rnti;
+            ack.m_harqProcessId = dci->m_harqProcess;
+            ack.m_bwpIndex = 0;
+            ack.m_harqStatus = DlHarqInfo::ACK;
+            ack.m_numRetx = 0;
+            m_feedback.push_back(ack);
+        }
+    }
+
+    Ptr<const SpectrumModel> GetSpectrumModel() const override
+    {
+        return nullptr;
+    }
+
+    uint32_t GetNumRbPerRbg() const override
+    {
+        return 1;
+    }
+
+    uint8_t GetNumHarqProcess() const override
+    {
+        return 16;
+    }
+
+    uint16_t GetBwpId() const override
+    {
+        return 0;
+    }
+
+    uint16_t GetCellId() const override
+    {
+        return 0;
+    }
+
+    uint32_t GetSymbolsPerSlot() const override
+    {
+        return 14;
+    }
+
+    Time GetSlotPeriod() const override
+    {
+        return MilliSeconds(1);
+    }
+
+    void BuildRarList(SlotAllocInfo& allocInfo) override
+    {
+    }
+
+    uint64_t m_checksum{0};              //!< Checksum of the DL data allocations
+    std::vector<DlHarqInfo> m_feedback; //!< ACKs for the DCIs of the last slot
+};
+
+/**
+ * @brief Result of a benchmark run
+ */
+struct BenchResult
+{
+    double usPerSlot;  //!< Time spent in the scheduler, in microseconds per slot
+    uint64_t checksum; //!< Checksum of the allocations
+};
+
+/**
+ * @brief Schedule a number of DL slots, and measure the time spent in the scheduler
+ * @param scheduler the scheduler type (RR, PF, MR, Qos)
+ * @param incrementalUeSort the IncrementalUeSort attribute
+ * @param numUes the number of UEs
+ * @param numRbgs the number of RBGs
+ * @param numBeams the number of beams, to which the UEs are assigned in turns
+ * @param subband true to report sub-band CQIs, false for wideband CQIs
+ * @param slots the number of slots
+ * @return the time per slot, and the checksum of the allocations
+ */
+static BenchResult
+RunBenchmark(const std::string& scheduler,
+             bool incrementalUeSort,
+             uint32_t numUes,
+             uint32_t numRbgs,
+             uint32_t numBeams,
+             bool subband,
+             uint32_t slots)
+{
+    ObjectFactory factory;
+    factory.SetTypeId("ns3::NrMacSchedulerOfdma" + scheduler);
+    factory.Set("IncrementalUeSort", BooleanValue(incrementalUeSort));
+    factory.Set("McsCsiSource", StringValue(subband ? "AVG_MCS" : "WIDEBAND_MCS"));
+    Ptr<NrMacSchedulerNs3> sched = DynamicCast<NrMacSchedulerNs3>(factory.Create());
+    NS_ABORT_MSG_IF(sched == nullptr, "Unknown OFDMA scheduler " << scheduler);
+
+    BenchSchedSapUser sapUser;
+    BenchCschedSapUser csapUser;
+    sched->SetMacSchedSapUser(&sapUser);
+    sched->SetMacCschedSapUser(&csapUser);
+
+    NrMacCschedSapProvider::CschedCellConfigReqParameters cellConfig{};
+    cellConfig.m_dlBandwidth = numRbgs;
+    cellConfig.m_ulBandwidth = numRbgs;
+    sched->DoCschedCellConfigReq(cellConfig);
+    sched->InstallDlAmc(CreateObject<NrAmc>());
+    sched->InstallUlAmc(CreateObject<NrAmc>());
+
+    for (uint16_t rnti = 1; rnti <= numUes; ++rnti)
+    {
+        NrMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+        ueConfig.m_rnti = rnti;
+        ueConfig.m_beamId = BeamId(rnti % numBeams, 120.0);
+        sched->DoCschedUeConfigReq(ueConfig);
+
+        NrMacCschedSapProvider::CschedLcConfigReqParameters lcConfig;
+        lcConfig.m_rnti = rnti;
+        lcConfig.m_reconfigureFlag = false;
+        nr::LogicalChannelConfigListElement_s lc;
+        lc.m_direction = nr::LogicalChannelConfigListElement_s::DIR_DL;
+        lc.m_qosBearerType = nr::LogicalChannelConfigListElement_s::QBT_NON_GBR;
+        lc.m_qci = 9;
+        lc.m_logicalChannelGroup = 2;
+        lc.m_logicalChannelIdentity = 1;
+        lcConfig.m_logicalChannelConfigList.emplace_back(lc);
+        sched->DoCschedLcConfigReq(lcConfig);
+    }
+
+    // Same random inputs for all the runs
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+
+    std::chrono::steady_clock::duration elapsed{0};
+    for (uint32_t slot = 0; slot < slots; ++slot)
+    {
+        NrMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiParams{};
+        for (uint16_t rnti = 1; rnti <= numUes; ++rnti)
+        {
+            DlCqiInfo cqi;
+            cqi.m_rnti = rnti;
+            cqi.m_ri = 1;
+            cqi.m_wbCqi = rv->GetInteger(1, 15);
+            if (subband)
+            {
+                cqi.m_cqiType = DlCqiInfo::SB;
+                for (uint32_t sb = 0; sb < 16; ++sb)
+                {
+                    cqi.m_sbCqis.push_back(rv->GetInteger(1, 15));
+                }
+            }
+            cqiParams.m_cqiList.push_back(cqi);
+
+            NrMacSchedSapProvider::SchedDlRlcBufferReqParameters rlc{};
+            rlc.m_rnti = rnti;
+            rlc.m_logicalChannelIdentity = 1;
+            rlc.m_rlcTransmissionQueueSize = rv->GetInteger(100, 50000);
+            sched->DoSchedDlRlcBufferReq(rlc);
+        }
+        sched->DoSchedDlCqiInfoReq(cqiParams);
+
+        NrMacSchedSapProvider::SchedDlTriggerReqParameters dlTrigger;
+        dlTrigger.m_snfSf = SfnSf(slot / 10, slot % 10, 0, 0);
+        dlTrigger.m_slotType = LteNrTddSlotType::DL;
+        dlTrigger.m_dlHarqInfoList = std::move(sapUser.m_feedback);
+        sapUser.m_feedback.clear();
+
+        auto start = std::chrono::steady_clock::now();
+        sched->DoSchedDlTriggerReq(dlTrigger);
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    return {std::chrono::duration<double, std::micro>(elapsed).count() / slots,
+            sapUser.m_checksum};
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string scheduler = "PF";
+    std::string numUesList = "10,100,500";
+    uint32_t numRbgs = 273;
+    uint32_t numBeams = 1;
+    bool subband = false;
+    uint32_t slots = 200;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scheduler", "OFDMA scheduler to benchmark (RR, PF, MR, Qos)", scheduler);
+    cmd.AddValue("numUes", "Comma-separated list of numbers of UEs", numUesList);
+    cmd.AddValue("numRbgs", "Number of RBGs of the bandwidth part", numRbgs);
+    cmd.AddValue("numBeams", "Number of beams the UEs are distributed to", numBeams);
+    cmd.AddValue("subband", "Report sub-band CQIs instead of wideband CQIs", subband);
+    cmd.AddValue("slots", "Number of DL slots to schedule", slots);
+    cmd.Parse(argc, argv);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "OFDMA " << scheduler << ", " << numRbgs << " RBGs, " << numBeams
+              << " beam(s), " << (subband ? "sub-band" : "wideband") << " CQI, " << slots
+              << " slots" << std::endl;
+
+    std::stringstream ss(numUesList);
+    std::string numUes;
+    while (std::getline(ss, numUes, ','))
+    {
+        uint32_t ues = std::stoul(numUes);
+        BenchResult full = RunBenchmark(scheduler, false, ues, numRbgs, numBeams, subband, slots);
+        BenchResult incremental =
+            RunBenchmark(scheduler, true, ues, numRbgs, numBeams, subband, slots);
+        std::cout << ues << " UEs: " << full.usPerSlot << " us/slot with a full sort per RBG, "
+                  << incremental.usPerSlot << " us/slot with IncrementalUeSort ("
+                  << full.usPerSlot / incremental.usPerSlot << "x), allocations "
+                  << (full.checksum == incremental.checksum ? "match" : "DIFFER") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,217 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+/**
+ * @ingroup examples
+ * @file cttc-nr-distributed.cc
+ * @brief An NR deployment simulated by several MPI processes, partitioned by site
+ *
+ * The sites are placed along a line, each with one gNB and a few UEs that receive a DL
+ * UDP flow from the remote host. The sites are assigned to the processes in round-robin
+ * order: each process simulates the gNBs and UEs of its sites, with its own copy of the
+ * core network and of the remote host, and NrDistributedHelper exchanges the signals
+ * transmitted by the NR devices, so that the UEs and gNBs of each process see the
+ * interference of the sites of the others.
+ *
+ * Every process builds the whole topology in the same order, and installs the
+ * applications only on its local nodes. The lookahead of the distributed simulator is the
+ * minimum propagation delay between the NR devices of different processes, which is
+ * printed at the start.
+ *
+ * ns-3 must be configured with --enable-mpi. To run the example with two processes:
+ *
+ * \code{.unparsed}
+$ ./ns3 run cttc-nr-distributed --command-template="mpiexec -np 2 %s"
+    \endcode
+ *
+ * Each process prints the statistics of the flows of its own UEs.
+ */
+
+#include "ns3/antenna-module.h"
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/mpi-interface.h"
+#include "ns3/nr-module.h"
+#include "ns3/point-to-point-module.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("CttcNrDistributed");
+
+int
+main(int argc, char* argv[])
+{
+    uint16_t numSites = 4;
+    uint16_t uesPerSite = 2;
+    double interSiteDistance = 200.0;
+    double centralFrequency = 3.5e9;
+    double bandwidth = 20e6;
+    uint16_t numerology = 1;
+    double txPower = 40.0;
+    uint32_t packetSize = 1000;
+    uint32_t lambda = 1000;
+    Time simTime = MilliSeconds(500);
+    Time appStartTime = MilliSeconds(200);
+    bool nullMessage = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("numSites", "Number of sites, each with one gNB", numSites);
+    cmd.AddValue("uesPerSite", "Number of UEs of each site", uesPerSite);
+    cmd.AddValue("interSiteDistance", "Distance between the sites, in m", interSiteDistance);
+    cmd.AddValue("centralFrequency", "The system frequency", centralFrequency);
+    cmd.AddValue("bandwidth", "The system bandwidth", bandwidth);
+    cmd.AddValue("numerology", "The numerology of the bandwidth part", numerology);
+    cmd.AddValue("txPower", "The gNB transmission power, in dBm", txPower);
+    cmd.AddValue("packetSize", "Size of the UDP packets, in bytes", packetSize);
+    cmd.AddValue("lambda", "Number of UDP packets per second of each flow", lambda);
+    cmd.AddValue("simTime", "Simulation time", simTime);
+    cmd.AddValue("appStartTime", "Start time of the applications", appStartTime);
+    cmd.AddValue("nullMessage", "Use the null message distributed simulator", nullMessage);
+    cmd.Parse(argc, argv);
+
+    GlobalValue::Bind("SimulatorImplementationType",
+                      StringValue(nullMessage ? "ns3::NullMessageSimulatorImpl"
+                                              : "ns3::DistributedSimulatorImpl"));
+    MpiInterface::Enable(&argc, &argv);
+    uint32_t systemId = MpiInterface::GetSystemId();
+    uint32_t systemCount = MpiInterface::GetSize();
+
+    Config::SetDefault("ns3::NrRlcUm::MaxTxBufferSize", UintegerValue(999999999));
+
+    /*
+     * Create the nodes of each site in the process of the site. All the processes create
+     * all the nodes, in the same order, so that they have the same IDs everywhere.
+     */
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    Ptr<ListPositionAllocator> gnbPositions = CreateObject<ListPositionAllocator>();
+    Ptr<ListPositionAllocator> uePositions = CreateObject<ListPositionAllocator>();
+    for (uint16_t site = 0; site < numSites; ++site)
+    {
+        uint32_t siteSystemId = site % systemCount;
+        double x = site * interSiteDistance;
+        gnbNodes.Create(1, siteSystemId);
+        gnbPositions->Add(Vector(x, 0.0, 25.0));
+        for (uint16_t ue = 0; ue < uesPerSite; ++ue)
+        {
+            ueNodes.Create(1, siteSystemId);
+            uePositions->Add(Vector(x + 10.0 * ue, 30.0 + 20.0 * ue, 1.5));
+        }
+    }
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(gnbPositions);
+    mobility.Install(gnbNodes);
+    mobility.SetPositionAllocator(uePositions);
+    mobility.Install(ueNodes);
+
+    /*
+     * The S1-U links between the core network of a process and the gNBs of the other
+     * processes are distributed links, and their delay must not be 0.
+     */
+    Ptr<NrPointToPointEpcHelper> nrEpcHelper = CreateObject<NrPointToPointEpcHelper>();
+    nrEpcHelper->SetAttribute("S1uLinkDelay", TimeValue(MilliSeconds(1)));
+    Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    nrHelper->SetEpcHelper(nrEpcHelper);
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(centralFrequency, bandwidth, 1);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+
+    Ptr<NrChannelHelper> channelHelper = CreateObject<NrChannelHelper>();
+    channelHelper->ConfigureFactories("UMa", "Default", "ThreeGpp");
+    channelHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    channelHelper->AssignChannelsToBands({band});
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(numerology));
+    nrHelper->SetGnbPhyAttribute("TxPower", DoubleValue(txPower));
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(4));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(8));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+
+    NetDeviceContainer gnbDevices = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueDevices = nrHelper->InstallUeDevice(ueNodes, allBwps);
+
+    int64_t randomStream = 1;
+    randomStream += nrHelper->AssignStreams(gnbDevices, randomStream);
+    randomStream += nrHelper->AssignStreams(ueDevices, randomStream);
+
+    /*
+     * Exchange the signals of the NR devices between the processes. It must be called with
+     * the devices of all the processes.
+     */
+    Ptr<NrDistributedHelper> distributedHelper = CreateObject<NrDistributedHelper>();
+    distributedHelper->Install(NetDeviceContainer(gnbDevices, ueDevices));
+    if (systemId == 0)
+    {
+        std::cout << "Sites: " << numSites << ", processes: " << systemCount
+                  << ", lookahead: " << distributedHelper->GetLookahead().As(Time::US)
+                  << std::endl;
+    }
+
+    auto [remoteHost, remoteHostIpv4Address] =
+        nrEpcHelper->SetupRemoteHost("100Gb/s", 2500, Seconds(0.000));
+
+    InternetStackHelper internet;
+    internet.Install(ueNodes);
+    Ipv4InterfaceContainer ueIpIfaces = nrEpcHelper->AssignUeIpv4Address(ueDevices);
+
+    nrHelper->AttachToClosestGnb(ueDevices, gnbDevices);
+
+    /*
+     * Install the applications of the local UEs only
+     */
+    uint16_t dlPort = 1234;
+    ApplicationContainer serverApps;
+    ApplicationContainer clientApps;
+    UdpClientHelper dlClient;
+    dlClient.SetAttribute("MaxPackets", UintegerValue(0xFFFFFFFF));
+    dlClient.SetAttribute("PacketSize", UintegerValue(packetSize));
+    dlClient.SetAttribute("Interval", TimeValue(Seconds(1.0 / lambda)));
+    UdpServerHelper dlPacketSink(dlPort);
+    for (uint32_t i = 0; i < ueNodes.GetN(); ++i)
+    {
+        if (!NrDistributedHelper::IsLocal(ueNodes.Get(i)))
+        {
+            continue;
+        }
+        serverApps.Add(dlPacketSink.Install(ueNodes.Get(i)));
+        dlClient.SetAttribute(
+            "Remote",
+            AddressValue(addressUtils::ConvertToSocketAddress(ueIpIfaces.GetAddress(i), dlPort)));
+        clientApps.Add(dlClient.Install(remoteHost));
+    }
+    serverApps.Start(appStartTime);
+    clientApps.Start(appStartTime);
+    serverApps.Stop(simTime);
+    clientApps.Stop(simTime);
+
+    Simulator::Stop(simTime);
+    Simulator::Run();
+
+    double flowDuration = (simTime - appStartTime).GetSeconds();
+    uint64_t txPackets = clientApps.GetN() * static_cast<uint64_t>(flowDuration * lambda);
+    uint64_t rxPackets = 0;
+    for (uint32_t i = 0; i < serverApps.GetN(); ++i)
+    {
+        rxPackets += DynamicCast<UdpServer>(serverApps.Get(i))->GetReceived();
+    }
+    std::cout << "Process " << systemId << ": " << serverApps.GetN() << " UEs, received "
+              << rxPackets << " of about " << txPackets << " packets, mean throughput "
+              << (serverApps.GetN() > 0 ? rxPackets * packetSize * 8.0 / flowDuration / 1e6 /
+                                              serverApps.GetN()
+                                        : 0.0)
+              << " Mbps" << std::endl;
+
+    Simulator::Destroy();
+    MpiInterface::Disable();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/command-line.h"
+#include "ns3/nr-module.h"
+
+#include <iostream>
+
+/**
+ * @ingroup examples
+ * @file nr-trace-converter.cc
+ * @brief Converts a binary trace file to the tab-separated text format.
+ *
+ * The RxPacketTrace, DlDataSinr, DlCtrlSinr and MAC scheduling traces can be written in a
+ * binary format with NrHelper::EnableTraces(NrTraceWriter::BINARY), or with the
+ * `TraceFormat` attribute of NrPhyRxTrace and NrMacSchedulingStats. This program reads
+ * one of those files and writes the same text file that the TEXT format would have
+ * produced, e.g.:
+ *
+ * ./ns3 run "nr-trace-converter --input=RxPacketTrace.bin --output=RxPacketTrace.txt"
+ *
+ * If no output file is given, the name of the input file with the ".txt" extension is used.
+ */
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string input;
+    std::string output;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("input", "Binary trace file to convert", input);
+    cmd.AddValue("output", "Text trace file to write", output);
+    cmd.Parse(argc, argv);
+
+    NS_ABORT_MSG_IF(input.empty(), "An input file is required, see --help");
+    if (output.empty())
+    {
+        output = input;
+        const std::string extension = ".bin";
+        if (output.size() >= extension.size() &&
+            output.compare(output.size() - extension.size(), extension.size(), extension) == 0)
+        {
+            output.resize(output.size() - extension.size());
+        }
+        output += ".txt";
+    }
+
+    NrBinaryTraceReader reader(input);
+    uint64_t rows = reader.ConvertToText(output);
+    std::cout << "Converted " << rows << " rows of " << reader.GetColumns().size()
+              << " columns from " << input << " to " << output << std::endl;
+
+    return 0;
+}
@@ -121,6 +121,7 @@ main(int argc, char* argv[])
     double yMax = 50.0;
     uint16_t yRes = 50;
     double z = 1.5;
+    uint32_t remThreads = 1;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("remMode",
@@ -201,6 +202,9 @@ main(int argc, char* argv[])
     cmd.AddValue("yMax", "The max y coordinate of the rem map", yMax);
     cmd.AddValue("yRes", "The resolution on the y axis of the rem map", yRes);
     cmd.AddValue("z", "The z coordinate of the rem map", z);
+    cmd.AddValue("remThreads",
+                 "The number of threads that compute the rem map (0 for one per hardware thread)",
+                 remThreads);
 
     cmd.Parse(argc, argv);
 
@@ -522,6 +526,7 @@ main(int argc, char* argv[])
     remHelper->SetResY(yRes);
     remHelper->SetZ(z);
     remHelper->SetSimTag(simTag);
+    remHelper->SetNumThreads(remThreads);
 
     gnbNetDev.Get(0)
         ->GetObject<NrGnbNetDevice>()
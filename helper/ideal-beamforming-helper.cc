@@ -4,14 +4,19 @@
 
 #include "ideal-beamforming-helper.h"
 
+#include "ns3/boolean.h"
 #include "ns3/ideal-beamforming-algorithm.h"
 #include "ns3/log.h"
 #include "ns3/nr-gnb-net-device.h"
 #include "ns3/nr-gnb-phy.h"
 #include "ns3/nr-spectrum-phy.h"
+#include "ns3/nr-thread-pool.h"
 #include "ns3/nr-ue-net-device.h"
 #include "ns3/nr-ue-phy.h"
+#include "ns3/nyu-spectrum-propagation-loss-model.h"
 #include "ns3/object-factory.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/uinteger.h"
 #include "ns3/vector.h"
 
 namespace ns3
@@ -59,7 +64,26 @@ IdealBeamformingHelper::GetTypeId()
                           TimeValue(MilliSeconds(100)),
                           MakeTimeAccessor(&IdealBeamformingHelper::SetPeriodicity,
                                            &IdealBeamformingHelper::GetPeriodicity),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("NumThreads",
+                          "The number of threads that prepare the beamforming tasks. If 0, one "
+                          "thread per hardware thread is used. Only the part of a task returned "
+                          "by IdealBeamformingAlgorithm::PrepareBeamformingVectors() runs on "
+                          "these threads: currently, the received power bounds of "
+                          "CellScanBeamforming with a 3GPP channel and single port, single "
+                          "polarization antennas. The beams are the same for any number of "
+                          "threads.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&IdealBeamformingHelper::SetNumThreads,
+                                               &IdealBeamformingHelper::GetNumThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("SkipUnchangedTasks",
+                          "If true, the beams of a gNB-UE pair are only computed again when the "
+                          "position of a device changed, or when their channel was updated, "
+                          "since the previous computation.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&IdealBeamformingHelper::m_skipUnchangedTasks),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -81,6 +105,8 @@ IdealBeamformingHelper::AddBeamformingTask(const Ptr<NrGnbNetDevice>& gnbDev,
 
         m_spectrumPhyPair.emplace_back(gnbSpectrumPhy, ueSpectrumPhy);
         RunTask(gnbSpectrumPhy, ueSpectrumPhy);
+        m_taskStates.push_back(GetTaskState(m_spectrumPhyPair.back()));
+        m_numTasksRun++;
     }
 }
 
@@ -91,10 +117,107 @@ IdealBeamformingHelper::Run() const
     NS_LOG_INFO("Running the beamforming method. There are :" << m_spectrumPhyPair.size()
                                                               << " tasks.");
 
+    // Select the tasks whose devices moved, or whose channel was updated, since their last run
+    m_taskStates.resize(m_spectrumPhyPair.size());
+    std::vector<std::pair<const SpectrumPhyPair*, TaskState*>> tasks;
+    auto state = m_taskStates.begin();
     for (const auto& task : m_spectrumPhyPair)
     {
-        RunTask(task.first, task.second);
+        TaskState& lastState = *state++;
+        if (m_skipUnchangedTasks && lastState.valid)
+        {
+            TaskState currentState = GetTaskState(task);
+            if (currentState.valid && currentState.gnbPosition == lastState.gnbPosition &&
+                currentState.uePosition == lastState.uePosition &&
+                currentState.channelTime == lastState.channelTime)
+            {
+                // Keep the beams, but point the UE to the gNB again, as RunTask() does
+                task.second->GetBeamManager()->ChangeBeamformingVector(task.first->GetDevice());
+                m_numTasksSkipped++;
+                continue;
+            }
+        }
+        tasks.emplace_back(&task, &lastState);
     }
+    NS_LOG_INFO("Running " << tasks.size() << " tasks, skipping "
+                           << m_spectrumPhyPair.size() - tasks.size());
+
+    if (m_numThreads != 1 && tasks.size() > 1)
+    {
+        // The preparations access the channel models and the antennas, so they run in the
+        // main thread, in the order of the tasks; only the returned jobs run in parallel
+        std::vector<std::function<void()>> jobs;
+        for (const auto& [task, taskState] : tasks)
+        {
+            auto job = m_beamformingAlgorithm->PrepareBeamformingVectors(task->first, task->second);
+            if (job)
+            {
+                jobs.push_back(std::move(job));
+            }
+        }
+        if (jobs.size() < tasks.size())
+        {
+            NS_LOG_WARN(tasks.size() - jobs.size()
+                        << " of " << tasks.size()
+                        << " tasks have no part that can run on several threads, so they run only "
+                           "in the main thread");
+        }
+        NrThreadPool::Get().Run(m_numThreads, jobs.size(), [&jobs](size_t i) { jobs[i](); });
+        m_numTasksInParallel += jobs.size();
+    }
+
+    for (const auto& [task, taskState] : tasks)
+    {
+        RunTask(task->first, task->second);
+        *taskState = GetTaskState(*task);
+    }
+    m_numTasksRun += tasks.size();
+}
+
+IdealBeamformingHelper::TaskState
+IdealBeamformingHelper::GetTaskState(const SpectrumPhyPair& task) const
+{
+    TaskState state;
+    Ptr<MobilityModel> gnbMobility = task.first->GetMobility();
+    Ptr<MobilityModel> ueMobility = task.second->GetMobility();
+    state.gnbPosition = gnbMobility->GetPosition();
+    state.uePosition = ueMobility->GetPosition();
+
+    // Without a phased array channel, only the positions are tracked. A phased array channel
+    // whose updates cannot be tracked invalidates the state, so that the task is always run
+    auto splm = task.first->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel();
+    if (!splm)
+    {
+        state.valid = true;
+        return state;
+    }
+
+    Ptr<MatrixBasedChannelModel> channelModel;
+    if (auto threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel>(splm))
+    {
+        channelModel = threeGppSplm->GetChannelModel();
+    }
+    else if (auto nyuSplm = DynamicCast<NYUSpectrumPropagationLossModel>(splm))
+    {
+        channelModel = nyuSplm->GetChannelModel();
+    }
+    if (channelModel)
+    {
+        auto params = channelModel->GetParams(gnbMobility, ueMobility);
+        state.valid = params != nullptr;
+        state.channelTime = params ? params->m_generatedTime : Time();
+
+        // Parameters as old as the update period are generated again at their next use, which
+        // may come after this run, so the beams must be computed again now
+        TimeValue updatePeriod;
+        if (params && channelModel->GetAttributeFailSafe("UpdatePeriod", updatePeriod) &&
+            updatePeriod.Get().IsStrictlyPositive() &&
+            Simulator::Now() - params->m_generatedTime >= updatePeriod.Get())
+        {
+            state.valid = false;
+        }
+    }
+    return state;
 }
 
 BeamformingVectorPair
@@ -141,4 +264,35 @@ IdealBeamformingHelper::GetPeriodicity() const
     return m_beamformingPeriodicity;
 }
 
+void
+IdealBeamformingHelper::SetNumThreads(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    m_numThreads = numThreads;
+}
+
+uint32_t
+IdealBeamformingHelper::GetNumThreads() const
+{
+    return m_numThreads;
+}
+
+uint64_t
+IdealBeamformingHelper::GetNumTasksRun() const
+{
+    return m_numTasksRun;
+}
+
+uint64_t
+IdealBeamformingHelper::GetNumTasksSkipped() const
+{
+    return m_numTasksSkipped;
+}
+
+uint64_t
+IdealBeamformingHelper::GetNumTasksInParallel() const
+{
+    return m_numTasksInParallel;
+}
+
 } // namespace ns3
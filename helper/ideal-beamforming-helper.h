@@ -7,6 +7,7 @@
 #include "ns3/beamforming-vector.h"
 #include "ns3/event-id.h"
 #include "ns3/nstime.h"
+#include "ns3/vector.h"
 
 #ifndef SRC_NR_HELPER_IDEAL_BEAMFORMING_HELPER_H_
 #define SRC_NR_HELPER_IDEAL_BEAMFORMING_HELPER_H_
@@ -21,6 +22,24 @@ class IdealBeamformingAlgorithm;
 /**
  * @ingroup helper
  * @brief The IdealBeamformingHelper class
+ *
+ * Every BeamformingPeriodicity, the helper computes the beamforming vectors of all the
+ * gNB-UE pairs added with AddBeamformingTask(), one task per pair and bandwidth part.
+ *
+ * With the attribute SkipUnchangedTasks, a task is only computed again if the position of
+ * the gNB or of the UE changed since its last computation, or if the parameters of their
+ * channel were generated again or are due for an update (a 3GPP or NYU channel is updated
+ * when it is used after its UpdatePeriod). GetNumTasksRun() and GetNumTasksSkipped() count
+ * the computed and the skipped tasks.
+ *
+ * With NumThreads different from 1, the part of each task that does not access the
+ * simulation objects (see IdealBeamformingAlgorithm::PrepareBeamformingVectors()) runs on the
+ * threads of NrThreadPool. The rest of the tasks runs afterwards in the main thread, in the
+ * order of the tasks, so the beams are the same for any number of threads. Currently, only
+ * CellScanBeamforming with a 3GPP channel and single port, single polarization antennas
+ * has such a part, the bounds of the received power of its beam pairs; the other tasks run
+ * entirely in the main thread, with a warning, and GetNumTasksInParallel() counts the tasks
+ * that used the threads.
  */
 class IdealBeamformingHelper : public BeamformingHelperBase
 {
@@ -57,6 +76,35 @@ class IdealBeamformingHelper : public BeamformingHelperBase
      */
     Time GetPeriodicity() const;
 
+    /**
+     * @brief Set the number of threads that prepare the beamforming tasks
+     * @param numThreads the number of threads, or 0 to use all the available cores
+     */
+    void SetNumThreads(uint32_t numThreads);
+
+    /**
+     * @return the number of threads that prepare the beamforming tasks
+     */
+    uint32_t GetNumThreads() const;
+
+    /**
+     * @return the number of beamforming tasks computed, including those of
+     * AddBeamformingTask()
+     */
+    uint64_t GetNumTasksRun() const;
+
+    /**
+     * @return the number of beamforming tasks skipped because neither the positions of the
+     * devices nor their channel changed
+     */
+    uint64_t GetNumTasksSkipped() const;
+
+    /**
+     * @return the number of computed beamforming tasks whose preparation ran on the threads
+     * of NrThreadPool
+     */
+    uint64_t GetNumTasksInParallel() const;
+
     /**
      * @brief Run beamforming task
      */
@@ -93,6 +141,31 @@ class IdealBeamformingHelper : public BeamformingHelperBase
         m_beamformingAlgorithm; //!< The beamforming algorithm that will be used
 
     std::list<SpectrumPhyPair> m_spectrumPhyPair; //!< The list of beamforming tasks to be executed
+
+  private:
+    /// Positions and channel of the devices of a task when its beams were computed
+    struct TaskState
+    {
+        bool valid{false};  //!< Whether the state is known and can be compared
+        Vector gnbPosition; //!< Position of the gNB
+        Vector uePosition;  //!< Position of the UE
+        Time channelTime;   //!< Generation time of the parameters of the channel
+    };
+
+    /**
+     * @brief Get the current positions and channel of the devices of a task
+     * @param task the task
+     * @return the state of the task
+     */
+    TaskState GetTaskState(const SpectrumPhyPair& task) const;
+
+    uint32_t m_numThreads{1};         //!< The `NumThreads` attribute
+    bool m_skipUnchangedTasks{false}; //!< The `SkipUnchangedTasks` attribute
+    mutable std::vector<TaskState>
+        m_taskStates; //!< State of each task at its last run, in the order of m_spectrumPhyPair
+    mutable uint64_t m_numTasksRun{0};        //!< Number of tasks computed
+    mutable uint64_t m_numTasksSkipped{0};    //!< Number of tasks skipped
+    mutable uint64_t m_numTasksInParallel{0}; //!< Number of tasks prepared by the threads
 };
 
 }; // namespace ns3
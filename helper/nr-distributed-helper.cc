@@ -0,0 +1,609 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-distributed-helper.h"
+
+#include "nr-spectrum-value-helper.h"
+
+#include "ns3/data-rate.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/nr-gnb-net-device.h"
+#include "ns3/nr-phy.h"
+#include "ns3/nr-spectrum-phy.h"
+#include "ns3/nr-spectrum-signal-parameters.h"
+#include "ns3/nr-ue-net-device.h"
+#include "ns3/packet.h"
+#include "ns3/phased-array-model.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-channel.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <limits>
+#include <set>
+#include <valarray>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrDistributedHelper");
+NS_OBJECT_ENSURE_REGISTERED(NrDistributedHelper);
+
+namespace
+{
+
+constexpr double SPEED_OF_LIGHT{299792458.0}; //!< Speed of light in vacuum, in m/s
+constexpr uint16_t SUMMARY_PROTOCOL{0x0800};  //!< Protocol number, one that PPP can carry
+constexpr uint32_t MAX_PAYLOAD{65535};        //!< MTU of the links between the processes
+constexpr uint64_t LINK_RATE{1'000'000'000'000'000}; //!< Rate with negligible transmission time
+
+/**
+ * @brief Append a value to a summary
+ * @param buffer the summary
+ * @param value the value
+ */
+template <typename T>
+void
+Write(std::vector<uint8_t>& buffer, const T& value)
+{
+    auto offset = buffer.size();
+    buffer.resize(offset + sizeof(T));
+    std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+/**
+ * @brief Read a value of a summary, and move past it
+ * @param data the position of the value in the summary
+ * @param end the end of the summary
+ * @return the value
+ */
+template <typename T>
+T
+Read(const uint8_t*& data, const uint8_t* end)
+{
+    NS_ABORT_MSG_IF(static_cast<size_t>(end - data) < sizeof(T), "Truncated signal summary");
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return value;
+}
+
+/**
+ * @brief Abort if a summary is shorter than an array of values
+ * @param data the position of the array in the summary
+ * @param end the end of the summary
+ * @param numValues the number of values of the array
+ * @param valueSize the size of each value
+ */
+void
+CheckArraySize(const uint8_t* data, const uint8_t* end, size_t numValues, size_t valueSize)
+{
+    NS_ABORT_MSG_IF(numValues > static_cast<size_t>(end - data) / valueSize,
+                    "Truncated signal summary");
+}
+
+/**
+ * @brief Get the spectrum PHYs of an NR device, one for each bandwidth part
+ * @param device the NR device
+ * @return the spectrum PHYs
+ */
+std::vector<Ptr<NrSpectrumPhy>>
+GetSpectrumPhys(const Ptr<NetDevice>& device)
+{
+    std::vector<Ptr<NrSpectrumPhy>> phys;
+    if (auto gnb = DynamicCast<NrGnbNetDevice>(device))
+    {
+        for (uint32_t bwp = 0; bwp < gnb->GetCcMapSize(); ++bwp)
+        {
+            phys.push_back(gnb->GetPhy(bwp)->GetSpectrumPhy());
+        }
+    }
+    else if (auto ue = DynamicCast<NrUeNetDevice>(device))
+    {
+        for (uint32_t bwp = 0; bwp < ue->GetCcMapSize(); ++bwp)
+        {
+            phys.push_back(ue->GetPhy(bwp)->GetSpectrumPhy());
+        }
+    }
+    else
+    {
+        NS_ABORT_MSG("Not an NR device");
+    }
+    return phys;
+}
+
+} // namespace
+
+TypeId
+NrDistributedHelper::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrDistributedHelper")
+            .SetParent<Object>()
+            .AddConstructor<NrDistributedHelper>()
+            .SetGroupName("Nr")
+            .AddAttribute("Lookahead",
+                          "Delay of the links that carry the signals between the processes, "
+                          "which is the lookahead of the distributed simulator. The value 0 "
+                          "uses the minimum propagation delay between the NR devices of "
+                          "different processes.",
+                          TimeValue(Time(0)),
+                          MakeTimeAccessor(&NrDistributedHelper::m_lookahead),
+                          MakeTimeChecker(Time(0)));
+    return tid;
+}
+
+NrDistributedHelper::NrDistributedHelper()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NrDistributedHelper::~NrDistributedHelper()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+NrDistributedHelper::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_sendEvent.Cancel();
+    m_phys.clear();
+    m_phyIndex.clear();
+    m_exchangeDevices.clear();
+    m_exchangeNodes = NodeContainer();
+    m_summaries.clear();
+    m_summaryEnds.clear();
+    Object::DoDispose();
+}
+
+bool
+NrDistributedHelper::IsDistributed()
+{
+#ifdef NS3_MPI
+    return MpiInterface::IsEnabled() && MpiInterface::GetSize() > 1;
+#else
+    return false;
+#endif
+}
+
+uint32_t
+NrDistributedHelper::GetLocalSystemId()
+{
+#ifdef NS3_MPI
+    if (MpiInterface::IsEnabled())
+    {
+        return MpiInterface::GetSystemId();
+    }
+#endif
+    return 0;
+}
+
+bool
+NrDistributedHelper::IsLocal(const Ptr<const Node>& node)
+{
+    return !IsDistributed() || node->GetSystemId() == GetLocalSystemId();
+}
+
+Time
+NrDistributedHelper::GetLookahead() const
+{
+    return m_lookahead;
+}
+
+Time
+NrDistributedHelper::GetMinPropagationDelay(const NetDeviceContainer& devices)
+{
+    double minDistance = std::numeric_limits<double>::infinity();
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        auto nodeA = devices.Get(i)->GetNode();
+        auto mobilityA = nodeA->GetObject<MobilityModel>();
+        NS_ABORT_MSG_IF(!mobilityA, "The NR devices need a mobility model");
+        for (uint32_t j = i + 1; j < devices.GetN(); ++j)
+        {
+            auto nodeB = devices.Get(j)->GetNode();
+            if (nodeA->GetSystemId() != nodeB->GetSystemId())
+            {
+                auto mobilityB = nodeB->GetObject<MobilityModel>();
+                NS_ABORT_MSG_IF(!mobilityB, "The NR devices need a mobility model");
+                minDistance = std::min(minDistance, mobilityA->GetDistanceFrom(mobilityB));
+            }
+        }
+    }
+    return std::isinf(minDistance) ? Time::Max() : Seconds(minDistance / SPEED_OF_LIGHT);
+}
+
+void
+NrDistributedHelper::Install(const NetDeviceContainer& devices)
+{
+    NS_LOG_FUNCTION(this);
+    if (!IsDistributed())
+    {
+        return;
+    }
+    NS_ABORT_MSG_IF(!m_phys.empty(), "Install() can be called only once");
+
+    if (m_lookahead.IsZero())
+    {
+        m_lookahead = GetMinPropagationDelay(devices);
+        if (m_lookahead == Time::Max())
+        {
+            NS_LOG_INFO("All the NR devices belong to the same process, no signal to exchange");
+            m_lookahead = Time(0);
+            return;
+        }
+        NS_ABORT_MSG_IF(m_lookahead.IsZero(),
+                        "Devices of different processes are co-located, set the Lookahead "
+                        "attribute of NrDistributedHelper");
+    }
+    NS_LOG_INFO("Lookahead " << m_lookahead.As(Time::US));
+
+    std::set<Ptr<SpectrumChannel>> channels;
+    for (uint32_t i = 0; i < devices.GetN(); ++i)
+    {
+        for (const auto& phy : GetSpectrumPhys(devices.Get(i)))
+        {
+            m_phyIndex[PeekPointer(phy)] = static_cast<uint32_t>(m_phys.size());
+            m_phys.push_back(phy);
+            channels.insert(phy->GetSpectrumChannel());
+        }
+    }
+
+    uint32_t numProcesses = 1;
+#ifdef NS3_MPI
+    numProcesses = MpiInterface::GetSize();
+#endif
+    for (uint32_t systemId = 0; systemId < numProcesses; ++systemId)
+    {
+        m_exchangeNodes.Create(1, systemId);
+    }
+
+    PointToPointHelper p2ph;
+    p2ph.SetDeviceAttribute("DataRate", DataRateValue(DataRate(LINK_RATE)));
+    p2ph.SetDeviceAttribute("Mtu", UintegerValue(MAX_PAYLOAD));
+    p2ph.SetChannelAttribute("Delay", TimeValue(m_lookahead));
+    p2ph.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue("100000p"));
+    auto localSystemId = GetLocalSystemId();
+    for (uint32_t i = 0; i < numProcesses; ++i)
+    {
+        for (uint32_t j = i + 1; j < numProcesses; ++j)
+        {
+            auto link = p2ph.Install(m_exchangeNodes.Get(i), m_exchangeNodes.Get(j));
+            for (uint32_t k = 0; k < link.GetN(); ++k)
+            {
+                if (link.Get(k)->GetNode()->GetSystemId() == localSystemId)
+                {
+                    m_exchangeDevices.push_back(link.Get(k));
+                }
+            }
+        }
+    }
+    m_exchangeNodes.Get(localSystemId)
+        ->RegisterProtocolHandler(MakeCallback(&NrDistributedHelper::Receive, this),
+                                  SUMMARY_PROTOCOL,
+                                  nullptr);
+
+    for (const auto& channel : channels)
+    {
+        channel->TraceConnectWithoutContext("TxSigParams",
+                                            MakeCallback(&NrDistributedHelper::TxSignal, this));
+    }
+}
+
+void
+NrDistributedHelper::TxSignal(Ptr<SpectrumSignalParameters> params)
+{
+    auto it = m_phyIndex.find(PeekPointer(DynamicCast<NrSpectrumPhy>(params->txPhy)));
+    if (it == m_phyIndex.end())
+    {
+        return;
+    }
+    auto txPhy = m_phys[it->second];
+    auto phy = txPhy->GetPhy();
+    if (!phy->IsLocal())
+    {
+        // A signal of another process, transmitted again by RxSignal()
+        return;
+    }
+
+    SignalSummary summary;
+    summary.phyIndex = it->second;
+    if (auto data = DynamicCast<NrSpectrumSignalParametersDataFrame>(params))
+    {
+        summary.type = SignalType::DATA;
+        summary.cellId = data->cellId;
+        summary.rnti = data->rnti;
+    }
+    else if (auto dlCtrl = DynamicCast<NrSpectrumSignalParametersDlCtrlFrame>(params))
+    {
+        summary.type = SignalType::DL_CTRL;
+        summary.cellId = dlCtrl->cellId;
+    }
+    else if (auto ulCtrl = DynamicCast<NrSpectrumSignalParametersUlCtrlFrame>(params))
+    {
+        summary.type = SignalType::UL_CTRL;
+        summary.cellId = ulCtrl->cellId;
+    }
+    else
+    {
+        // CSI-RS and other signals that are not interference for the other processes
+        return;
+    }
+    summary.txTime = Simulator::Now();
+    summary.duration = params->duration;
+    summary.numRbs = phy->GetRbNum();
+    summary.centralFrequency = phy->GetCentralFrequency();
+    summary.subcarrierSpacing = phy->GetSubcarrierSpacing();
+    summary.psd = params->psd;
+
+    auto antenna = DynamicCast<PhasedArrayModel>(txPhy->GetAntenna());
+    NS_ABORT_MSG_IF(!antenna, "The NR devices need a phased array antenna");
+    while (summary.panel + 1 < txPhy->GetNumPanels() &&
+           txPhy->GetPanelByIndex(summary.panel) != antenna)
+    {
+        ++summary.panel;
+    }
+    summary.beamformingVector = antenna->GetBeamformingVector();
+    summary.precodingMatrix = params->precodingMatrix;
+
+    WriteSummary(summary, m_summaries);
+    m_summaryEnds.push_back(m_summaries.size());
+    if (!m_sendEvent.IsPending())
+    {
+        m_sendEvent = Simulator::ScheduleNow(&NrDistributedHelper::SendSummaries, this);
+    }
+}
+
+void
+NrDistributedHelper::SendSummaries()
+{
+    NS_LOG_FUNCTION(this << m_summaryEnds.size());
+
+    auto send = [this](size_t begin, size_t end) {
+        auto packet =
+            Create<Packet>(m_summaries.data() + begin, static_cast<uint32_t>(end - begin));
+        for (const auto& device : m_exchangeDevices)
+        {
+            device->Send(packet->Copy(), device->GetBroadcast(), SUMMARY_PROTOCOL);
+        }
+    };
+
+    // Pack the summaries in as few packets as the MTU allows
+    size_t packetBegin = 0;
+    size_t packetEnd = 0;
+    for (auto summaryEnd : m_summaryEnds)
+    {
+        NS_ABORT_MSG_IF(summaryEnd - packetEnd > MAX_PAYLOAD, "Signal summary too large");
+        if (summaryEnd - packetBegin > MAX_PAYLOAD)
+        {
+            send(packetBegin, packetEnd);
+            packetBegin = packetEnd;
+        }
+        packetEnd = summaryEnd;
+    }
+    if (packetEnd > packetBegin)
+    {
+        send(packetBegin, packetEnd);
+    }
+
+    m_summaries.clear();
+    m_summaryEnds.clear();
+}
+
+void
+NrDistributedHelper::Receive(Ptr<NetDevice> device,
+                             Ptr<const Packet> packet,
+                             uint16_t protocol,
+                             const Address& from,
+                             const Address& to,
+                             NetDevice::PacketType packetType)
+{
+    NS_LOG_FUNCTION(this << packet->GetSize());
+
+    std::vector<uint8_t> data(packet->GetSize());
+    packet->CopyData(data.data(), data.size());
+    const uint8_t* summary = data.data();
+    const uint8_t* end = data.data() + data.size();
+    while (summary < end)
+    {
+        auto size = GetSummarySize(summary, end);
+        NS_ABORT_MSG_IF(size == 0, "Truncated signal summaries");
+        RxSignal(ReadSummary(summary, summary + size));
+        summary += size;
+    }
+}
+
+void
+NrDistributedHelper::WriteSummary(const SignalSummary& summary, std::vector<uint8_t>& buffer)
+{
+    // The size of the summary is written at its start, once known
+    auto begin = buffer.size();
+    Write(buffer, static_cast<uint32_t>(0));
+
+    Write(buffer, summary.phyIndex);
+    Write(buffer, summary.type);
+    Write(buffer, summary.cellId);
+    Write(buffer, summary.rnti);
+    Write(buffer, summary.txTime.GetTimeStep());
+    Write(buffer, summary.duration.GetTimeStep());
+
+    // Parameters of the spectrum model of the PSD
+    Write(buffer, summary.numRbs);
+    Write(buffer, summary.centralFrequency);
+    Write(buffer, summary.subcarrierSpacing);
+    const auto& psd = *summary.psd;
+    NS_ASSERT_MSG(psd.GetValuesN() == summary.numRbs, "PSD not in the spectrum model");
+    for (auto value = psd.ConstValuesBegin(); value != psd.ConstValuesEnd(); ++value)
+    {
+        Write(buffer, *value);
+    }
+
+    Write(buffer, summary.panel);
+    const auto& beamformingVector = summary.beamformingVector;
+    Write(buffer, static_cast<uint32_t>(beamformingVector.GetSize()));
+    for (size_t i = 0; i < beamformingVector.GetSize(); ++i)
+    {
+        Write(buffer, beamformingVector[i]);
+    }
+
+    const auto& precodingMatrix = summary.precodingMatrix;
+    Write(buffer, static_cast<uint32_t>(precodingMatrix ? precodingMatrix->GetNumRows() : 0));
+    if (precodingMatrix)
+    {
+        Write(buffer, static_cast<uint32_t>(precodingMatrix->GetNumCols()));
+        Write(buffer, static_cast<uint32_t>(precodingMatrix->GetNumPages()));
+        for (const auto& value : precodingMatrix->GetValues())
+        {
+            Write(buffer, value);
+        }
+    }
+
+    auto size = static_cast<uint32_t>(buffer.size() - begin);
+    std::memcpy(buffer.data() + begin, &size, sizeof(size));
+}
+
+size_t
+NrDistributedHelper::GetSummarySize(const uint8_t* data, const uint8_t* end)
+{
+    uint32_t size;
+    if (static_cast<size_t>(end - data) < sizeof(size))
+    {
+        return 0;
+    }
+    std::memcpy(&size, data, sizeof(size));
+    if (size < sizeof(size) || size > static_cast<size_t>(end - data))
+    {
+        return 0;
+    }
+    return size;
+}
+
+NrDistributedHelper::SignalSummary
+NrDistributedHelper::ReadSummary(const uint8_t* data, const uint8_t* end)
+{
+    Read<uint32_t>(data, end); // Size of the summary
+
+    SignalSummary summary;
+    summary.phyIndex = Read<uint32_t>(data, end);
+    summary.type = Read<SignalType>(data, end);
+    NS_ABORT_MSG_IF(summary.type > SignalType::UL_CTRL, "Unknown type of signal summary");
+    summary.cellId = Read<uint16_t>(data, end);
+    summary.rnti = Read<uint16_t>(data, end);
+    summary.txTime = TimeStep(Read<int64_t>(data, end));
+    summary.duration = TimeStep(Read<int64_t>(data, end));
+
+    summary.numRbs = Read<uint32_t>(data, end);
+    summary.centralFrequency = Read<double>(data, end);
+    summary.subcarrierSpacing = Read<uint32_t>(data, end);
+    CheckArraySize(data, end, summary.numRbs, sizeof(double));
+    summary.psd = Create<SpectrumValue>(
+        NrSpectrumValueHelper::GetSpectrumModel(summary.numRbs,
+                                                summary.centralFrequency,
+                                                summary.subcarrierSpacing));
+    for (auto value = summary.psd->ValuesBegin(); value != summary.psd->ValuesEnd(); ++value)
+    {
+        *value = Read<double>(data, end);
+    }
+
+    summary.panel = Read<uint8_t>(data, end);
+    auto numElems = Read<uint32_t>(data, end);
+    CheckArraySize(data, end, numElems, sizeof(std::complex<double>));
+    summary.beamformingVector = PhasedArrayModel::ComplexVector(numElems);
+    for (size_t i = 0; i < numElems; ++i)
+    {
+        summary.beamformingVector[i] = Read<std::complex<double>>(data, end);
+    }
+
+    auto rows = Read<uint32_t>(data, end);
+    if (rows > 0)
+    {
+        auto cols = Read<uint32_t>(data, end);
+        auto pages = Read<uint32_t>(data, end);
+        NS_ABORT_MSG_IF(cols == 0 || pages == 0, "Empty precoding matrix in signal summary");
+        auto pageSize = static_cast<size_t>(rows) * cols;
+        CheckArraySize(data, end, pageSize, sizeof(std::complex<double>));
+        CheckArraySize(data, end, pages, pageSize * sizeof(std::complex<double>));
+        std::valarray<std::complex<double>> values(pageSize * pages);
+        for (auto& value : values)
+        {
+            value = Read<std::complex<double>>(data, end);
+        }
+        summary.precodingMatrix = Create<ComplexMatrixArray>(rows, cols, pages, std::move(values));
+    }
+    NS_ABORT_MSG_IF(data != end, "Malformed signal summary");
+    return summary;
+}
+
+void
+NrDistributedHelper::RxSignal(const SignalSummary& summary)
+{
+    auto phyIndex = summary.phyIndex;
+    NS_ABORT_MSG_IF(phyIndex >= m_phys.size(),
+                    "Unknown PHY, were the devices installed in the same order?");
+
+    auto remaining = summary.txTime + summary.duration - Simulator::Now();
+    if (!remaining.IsStrictlyPositive())
+    {
+        NS_LOG_LOGIC("Signal of PHY " << phyIndex << " ended before the lookahead");
+        return;
+    }
+
+    Ptr<SpectrumSignalParameters> params;
+    switch (summary.type)
+    {
+    case SignalType::DATA: {
+        auto dataFrame = Create<NrSpectrumSignalParametersDataFrame>();
+        dataFrame->cellId = summary.cellId;
+        dataFrame->rnti = summary.rnti;
+        params = dataFrame;
+        break;
+    }
+    case SignalType::DL_CTRL: {
+        auto dlCtrl = Create<NrSpectrumSignalParametersDlCtrlFrame>();
+        dlCtrl->cellId = summary.cellId;
+        dlCtrl->pss = false;
+        params = dlCtrl;
+        break;
+    }
+    case SignalType::UL_CTRL: {
+        auto ulCtrl = Create<NrSpectrumSignalParametersUlCtrlFrame>();
+        ulCtrl->cellId = summary.cellId;
+        params = ulCtrl;
+        break;
+    }
+    }
+
+    // The passive copy of the transmitting PHY transmits the rest of the signal, with the
+    // antenna configuration of the original one
+    const auto& txPhy = m_phys[phyIndex];
+    txPhy->SetActivePanel(summary.panel);
+    auto antenna = DynamicCast<PhasedArrayModel>(txPhy->GetAntenna());
+    if (summary.beamformingVector.GetSize() == antenna->GetNumElems())
+    {
+        antenna->SetBeamformingVector(summary.beamformingVector);
+    }
+    txPhy->SetTxPowerSpectralDensity(summary.psd);
+
+    params->txPhy = txPhy;
+    params->psd = summary.psd;
+    params->duration = remaining;
+    params->precodingMatrix = summary.precodingMatrix;
+    NS_LOG_LOGIC("Signal of PHY " << phyIndex << " of cell " << summary.cellId << " for "
+                                  << remaining.As(Time::US));
+    txPhy->GetSpectrumChannel()->StartTx(params);
+}
+
+} // namespace ns3
@@ -0,0 +1,224 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_DISTRIBUTED_HELPER_H
+#define NR_DISTRIBUTED_HELPER_H
+
+#include "ns3/event-id.h"
+#include "ns3/net-device-container.h"
+#include "ns3/net-device.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/phased-array-model.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+class NrSpectrumPhy;
+class Packet;
+class SpectrumSignalParameters;
+class SpectrumValue;
+
+/**
+ * @ingroup helper
+ * @brief Support for distributed (MPI) simulations of NR deployments partitioned by site
+ *
+ * In a distributed simulation, every process builds the whole topology, in the same order,
+ * and each node belongs to the process given by its system ID. The gNBs of a site and the
+ * UEs attached to them must belong to the same process. The NR devices of the nodes of
+ * other processes are installed by NrHelper in every process, so that all the processes
+ * assign the same cell IDs, IMSIs, interfaces and addresses, but they are passive: their PHYs
+ * do not start and are not receivers of the spectrum channel, the UEs are not attached, and
+ * no beamforming is computed for them. Each process therefore simulates, and keeps the
+ * channel matrices of, its own sites only.
+ *
+ * The EPC helpers create the core network nodes, and the remote hosts of SetupRemoteHost(),
+ * in the local process, so each process has its own copy of the core network, which serves
+ * the gNBs of that process: in this module the S1-AP and S11 interfaces are ideal, and they
+ * cannot span two processes. The applications must be installed only on the local nodes.
+ * The X2 links, and the unused S1-U links between the core network of a process and the
+ * gNBs of the others, are distributed point-to-point links, so their delay must not be 0.
+ * Handovers between cells of different processes are not supported.
+ *
+ * Install() exchanges the signals transmitted by the local NR devices with the other
+ * processes, so that the receivers of a process see the interference of the sites of the
+ * others. Each signal is summarized by its power spectral density, its duration, the
+ * beamforming vector of the transmitting antenna and its precoding matrix, and is
+ * transmitted again, in the receiving process, by the passive copy of the transmitting
+ * device, which applies the channel between that device and the local receivers. The
+ * summaries are sent over point-to-point links between the processes, whose delay is the
+ * lookahead of the distributed simulator: by default, the minimum propagation delay between
+ * the NR devices of different processes. The signals of other processes therefore arrive
+ * later, by the lookahead, than they would in a sequential simulation, and they are only
+ * interference: the UEs do not measure the cells of other processes.
+ *
+ * All the methods work in sequential simulations too, where every node is local and
+ * Install() does nothing.
+ */
+class NrDistributedHelper : public Object
+{
+  public:
+    /**
+     * @brief Get the type ID
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief NrDistributedHelper constructor
+     */
+    NrDistributedHelper();
+
+    /**
+     * @brief ~NrDistributedHelper
+     */
+    ~NrDistributedHelper() override;
+
+    /**
+     * @return true if the simulation runs in more than one process
+     */
+    static bool IsDistributed();
+
+    /**
+     * @return the system ID of the local process, or 0 in a sequential simulation
+     */
+    static uint32_t GetLocalSystemId();
+
+    /**
+     * @param node a node
+     * @return true if the node is simulated by the local process
+     */
+    static bool IsLocal(const Ptr<const Node>& node);
+
+    /**
+     * @brief Exchange the signals of the NR devices with the other processes
+     *
+     * It must be called in every process with all the NR devices, of all the processes, in
+     * the same order, after installing them and before the simulation starts. It creates
+     * one node for each process, and a point-to-point link between each pair of them.
+     *
+     * @param devices the gNB and UE devices of all the processes
+     */
+    void Install(const NetDeviceContainer& devices);
+
+    /**
+     * @return the delay of the links between the processes, as set by Install()
+     */
+    Time GetLookahead() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    friend class NrDistributedHelperTestCase; ///< Checks the summaries and the lookahead
+
+    /// Type of a summarized signal
+    enum class SignalType : uint8_t
+    {
+        DATA,    //!< NrSpectrumSignalParametersDataFrame
+        DL_CTRL, //!< NrSpectrumSignalParametersDlCtrlFrame
+        UL_CTRL, //!< NrSpectrumSignalParametersUlCtrlFrame
+    };
+
+    /// Summary of a signal transmitted by an NR device
+    struct SignalSummary
+    {
+        uint32_t phyIndex{0};                              //!< Index of the PHY in m_phys
+        SignalType type{SignalType::DATA};                 //!< Type of the signal
+        uint16_t cellId{0};                                //!< Cell ID of the signal
+        uint16_t rnti{0};                                  //!< RNTI of a data signal
+        Time txTime;                                       //!< Start of the signal
+        Time duration;                                     //!< Duration of the signal
+        uint32_t numRbs{0};                                //!< RBs of the spectrum model
+        double centralFrequency{0};                        //!< Central frequency (Hz)
+        uint32_t subcarrierSpacing{0};                     //!< Subcarrier spacing (Hz)
+        Ptr<SpectrumValue> psd;                            //!< PSD, with numRbs values
+        uint8_t panel{0};                                  //!< Active panel of the PHY
+        PhasedArrayModel::ComplexVector beamformingVector; //!< Beamforming of the panel
+        Ptr<const ComplexMatrixArray> precodingMatrix;     //!< Precoding matrix, if any
+    };
+
+    /**
+     * @brief Compute the minimum propagation delay between NR devices of different processes
+     * @param devices the NR devices
+     * @return the minimum propagation delay
+     */
+    static Time GetMinPropagationDelay(const NetDeviceContainer& devices);
+
+    /**
+     * @brief Append a summary to a sequence of summaries
+     * @param summary the summary
+     * @param buffer the sequence of summaries
+     */
+    static void WriteSummary(const SignalSummary& summary, std::vector<uint8_t>& buffer);
+
+    /**
+     * @brief Get the size of the first summary of a sequence of summaries
+     * @param data the start of the sequence
+     * @param end the end of the sequence
+     * @return the size of the summary, or 0 if the sequence ends before the summary
+     */
+    static size_t GetSummarySize(const uint8_t* data, const uint8_t* end);
+
+    /**
+     * @brief Read a summary, whose size was checked with GetSummarySize()
+     * @param data the start of the summary
+     * @param end the end of the summary
+     * @return the summary
+     */
+    static SignalSummary ReadSummary(const uint8_t* data, const uint8_t* end);
+
+    /**
+     * @brief Summarize a signal transmitted by a local NR device, to be sent to the other
+     * processes at the end of the current time stamp
+     * @param params the signal
+     */
+    void TxSignal(Ptr<SpectrumSignalParameters> params);
+
+    /**
+     * @brief Send the summaries of the current time stamp to the other processes
+     */
+    void SendSummaries();
+
+    /**
+     * @brief Receive the summaries sent by another process
+     * @param device the receiving device
+     * @param packet the packet with the summaries
+     * @param protocol the protocol number
+     * @param from the sender address
+     * @param to the destination address
+     * @param packetType the packet type
+     */
+    void Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from,
+                 const Address& to,
+                 NetDevice::PacketType packetType);
+
+    /**
+     * @brief Transmit again the signal of a summary with the passive copy of its device
+     * @param summary the summary
+     */
+    void RxSignal(const SignalSummary& summary);
+
+    Time m_lookahead{0}; //!< The `Lookahead` attribute, then the delay of the links
+
+    std::vector<Ptr<NrSpectrumPhy>> m_phys; //!< The spectrum PHYs, same order in all processes
+    std::unordered_map<const NrSpectrumPhy*, uint32_t> m_phyIndex; //!< Index in m_phys
+    NodeContainer m_exchangeNodes; //!< Node of each process, connected to the others
+    std::vector<Ptr<NetDevice>> m_exchangeDevices; //!< Local devices linked to other processes
+
+    std::vector<uint8_t> m_summaries;  //!< Summaries of the current time stamp
+    std::vector<size_t> m_summaryEnds; //!< End offset of each summary in m_summaries
+    EventId m_sendEvent;               //!< Event that sends the summaries
+};
+
+} // namespace ns3
+
+#endif // NR_DISTRIBUTED_HELPER_H
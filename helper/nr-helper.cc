@@ -6,6 +6,7 @@
 
 #include "nr-bearer-stats-calculator.h"
 #include "nr-channel-helper.h"
+#include "nr-distributed-helper.h"
 #include "nr-epc-helper.h"
 #include "nr-mac-rx-trace.h"
 #include "nr-phy-rx-trace.h"
@@ -23,6 +24,7 @@
 #include "ns3/names.h"
 #include "ns3/nr-ch-access-manager.h"
 #include "ns3/nr-chunk-processor.h"
+#include "ns3/nr-csi-batch.h"
 #include "ns3/nr-epc-gnb-application.h"
 #include "ns3/nr-epc-ue-nas.h"
 #include "ns3/nr-epc-x2.h"
@@ -32,6 +34,7 @@
 #include "ns3/nr-gnb-phy.h"
 #include "ns3/nr-initial-association.h"
 #include "ns3/nr-mac-scheduler-tdma-rr.h"
+#include "ns3/nr-parallel-scheduling.h"
 #include "ns3/nr-pm-search-full.h"
 #include "ns3/nr-rrc-protocol-ideal.h"
 #include "ns3/nr-rrc-protocol-real.h"
@@ -362,7 +365,11 @@ NrHelper::CreateUePhy(const Ptr<Node>& n,
 
     phy->InstallCentralFrequency(bwp->m_centralFrequency);
 
-    phy->ScheduleStartEventLoop(n->GetId(), 0, 0, 0);
+    phy->SetLocal(NrDistributedHelper::IsLocal(n));
+    if (phy->IsLocal())
+    {
+        phy->ScheduleStartEventLoop(n->GetId(), 0, 0, 0);
+    }
 
     // connect CAM and PHY
     Ptr<NrChAccessManager> cam =
@@ -621,7 +628,11 @@ NrHelper::CreateGnbPhy(const Ptr<Node>& n,
     DoubleValue frequency;
     phy->InstallCentralFrequency(bwp->m_centralFrequency);
 
-    phy->ScheduleStartEventLoop(n->GetId(), 0, 0, 0);
+    phy->SetLocal(NrDistributedHelper::IsLocal(n));
+    if (phy->IsLocal())
+    {
+        phy->ScheduleStartEventLoop(n->GetId(), 0, 0, 0);
+    }
 
     // PHY <--> CAM
     Ptr<NrChAccessManager> cam =
@@ -779,6 +790,10 @@ NrHelper::InstallSingleGnbDevice(
 
         auto mac = CreateGnbMac();
         cc->SetMac(mac);
+        if (m_parallelScheduling)
+        {
+            mac->SetParallelScheduling(m_parallelScheduling);
+        }
         phy->GetCam()->SetNrGnbMac(mac);
 
         auto sched = CreateGnbSched();
@@ -1036,6 +1051,11 @@ NrHelper::AttachToMaxRsrpGnb(const NetDeviceContainer& ueDevices,
     NS_ASSERT_MSG(enbDevices.GetN() > 0, "gNB container should not be empty");
     for (auto i = ueDevices.Begin(); i != ueDevices.End(); i++)
     {
+        if (!NrDistributedHelper::IsLocal((*i)->GetNode()))
+        {
+            continue;
+        }
+
         // Since UE may not be attached to any gNB, it won't be properly configured via MIB
         // so we configure its numerology manually here. All gNBs numerology must match.
         {
@@ -1055,12 +1075,27 @@ NrHelper::AttachToMaxRsrpGnb(const Ptr<NetDevice>& ueDevice, const NetDeviceCont
     NS_LOG_FUNCTION(this);
 
     NS_ASSERT_MSG(enbDevices.GetN() > 0, "empty enb device container");
+    if (!NrDistributedHelper::IsLocal(ueDevice->GetNode()))
+    {
+        return;
+    }
+
+    // In a distributed simulation, only the gNBs of the process of the UE are candidates
+    NetDeviceContainer localEnbDevices;
+    for (auto i = enbDevices.Begin(); i != enbDevices.End(); ++i)
+    {
+        if (NrDistributedHelper::IsLocal((*i)->GetNode()))
+        {
+            localEnbDevices.Add(*i);
+        }
+    }
+    NS_ABORT_MSG_IF(localEnbDevices.GetN() == 0, "No gNB in the process of the UE");
 
     auto nrInitAssoc = m_initialAttachmentFactory.Create<NrInitialAssociation>();
     ueDevice->GetObject<NrUeNetDevice>()->SetInitAssoc(nrInitAssoc);
 
     nrInitAssoc->SetUeDevice(ueDevice);
-    nrInitAssoc->SetGnbDevices(enbDevices);
+    nrInitAssoc->SetGnbDevices(localEnbDevices);
     nrInitAssoc->SetColBeamAngles(m_initialParams.colAngles);
     nrInitAssoc->SetRowBeamAngles(m_initialParams.rowAngles);
     nrInitAssoc->FindAssociatedGnb();
@@ -1087,12 +1122,21 @@ NrHelper::AttachToClosestGnb(const Ptr<NetDevice>& ueDevice, const NetDeviceCont
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT_MSG(gnbDevices.GetN() > 0, "empty gnb device container");
+    if (!NrDistributedHelper::IsLocal(ueDevice->GetNode()))
+    {
+        return;
+    }
     double minDistance = std::numeric_limits<double>::infinity();
     Ptr<NetDevice> closestGnbDevice;
     Ptr<MobilityModel> ueMm = ueDevice->GetNode()->GetObject<MobilityModel>();
     Ptr<SpectrumChannel> channel = GetUePhy(ueDevice, 0)->GetSpectrumPhy()->GetSpectrumChannel();
     for (auto i = gnbDevices.Begin(); i != gnbDevices.End(); ++i)
     {
+        if (!NrDistributedHelper::IsLocal((*i)->GetNode()))
+        {
+            // In a distributed simulation, only the gNBs of the process of the UE
+            continue;
+        }
         auto gnbMm =
             GetVirtualMobilityModel(channel, (*i)->GetNode()->GetObject<MobilityModel>(), ueMm);
         Vector gnbpos = gnbMm->GetPosition();
@@ -1118,6 +1162,14 @@ NrHelper::AttachToGnb(const Ptr<NetDevice>& ueDevice, const Ptr<NetDevice>& gnbD
 
     NS_ABORT_IF(gnbNetDev == nullptr || ueNetDev == nullptr);
 
+    if (!NrDistributedHelper::IsLocal(ueDevice->GetNode()))
+    {
+        NS_LOG_INFO("UE of another process, not attached");
+        return;
+    }
+    NS_ABORT_MSG_IF(!NrDistributedHelper::IsLocal(gnbDevice->GetNode()),
+                    "The UE and the gNB must belong to the same process");
+
     if (!gnbNetDev->IsCellConfigured())
     {
         gnbNetDev->ConfigureCell();
@@ -1152,6 +1204,10 @@ NrHelper::AttachToGnb(const Ptr<NetDevice>& ueDevice, const Ptr<NetDevice>& gnbD
                                    gnbAnt->GetNumVerticalPorts());
             pmSearch->SetUeParams(ueAnt->GetNumPorts());
             pmSearch->InitCodebooks();
+            if (m_csiBatch)
+            {
+                ueNetDev->GetPhy(i)->SetCsiBatch(m_csiBatch);
+            }
         }
     }
 
@@ -1401,6 +1457,30 @@ NrHelper::EnableFhControl()
     m_fhEnabled = true;
 }
 
+Ptr<NrParallelScheduling>
+NrHelper::EnableParallelScheduling(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    if (!m_parallelScheduling)
+    {
+        m_parallelScheduling = CreateObject<NrParallelScheduling>();
+    }
+    m_parallelScheduling->SetNumThreads(numThreads);
+    return m_parallelScheduling;
+}
+
+Ptr<NrCsiBatch>
+NrHelper::EnableCsiBatching(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    if (!m_csiBatch)
+    {
+        m_csiBatch = CreateObject<NrCsiBatch>();
+    }
+    m_csiBatch->SetNumThreads(numThreads);
+    return m_csiBatch;
+}
+
 void
 NrHelper::ConfigureFhControl(NetDeviceContainer gnbNetDevices)
 {
@@ -1650,8 +1730,9 @@ NrHelper::ActivateDataRadioBearer(Ptr<NetDevice> ueDevice, NrEpsBearer bearer)
 }
 
 void
-NrHelper::EnableTraces()
+NrHelper::EnableTraces(NrTraceWriter::Format format)
 {
+    GetPhyRxTrace()->SetTraceFormat(format);
     EnableDlDataPhyTraces();
     EnableDlCtrlPhyTraces();
     EnableUlPhyTraces();
@@ -1668,6 +1749,7 @@ NrHelper::EnableTraces()
     EnableUeMacCtrlMsgsTraces();
     EnableDlMacSchedTraces();
     EnableUlMacSchedTraces();
+    m_macSchedStats->SetTraceFormat(format);
     EnablePathlossTraces();
 }
 
@@ -38,6 +38,8 @@ class NrUeMac;
 class BwpManagerGnb;
 class BwpManagerUe;
 class NrFhControl;
+class NrParallelScheduling;
+class NrCsiBatch;
 
 /**
  * @ingroup helper
@@ -200,7 +202,9 @@ AttachToMaxRsrpGnb(),
  * the SINR, as well as RLC and PDCP statistics such as the packet size.
  * Please refer to their documentation for more information.
  * Enabling the traces is done by simply calling the method `EnableTraces()` in the
- * scenario.
+ * scenario. The RxPacketTrace, DL SINR and MAC scheduling files can be written in a
+ * binary format, which is smaller and faster to write, by calling
+ * `EnableTraces(NrTraceWriter::BINARY)`; see NrTraceWriter.
  *
  */
 class NrHelper : public Object
@@ -323,8 +327,10 @@ class NrHelper : public Object
      * RLC traces
      * PDCP traces
      *
+     * @param format the format of the RxPacketTrace, DlDataSinr, DlCtrlSinr and MAC
+     * scheduling files. The other files are always written as text.
      */
-    void EnableTraces();
+    void EnableTraces(NrTraceWriter::Format format = NrTraceWriter::TEXT);
 
     /**
      * @brief Activate a Data Radio Bearer on a given UE devices
@@ -695,6 +701,32 @@ class NrHelper : public Object
      */
     void SetFhControlAttribute(const std::string& n, const AttributeValue& v);
 
+    /**
+     * @brief Enable the parallel scheduling of the gNBs installed afterwards
+     *
+     * The scheduling triggers of the gNBs installed by this helper after the call run
+     * in parallel at each slot start, and their allocations are passed to the PHYs in
+     * cell ID order, so that the results do not depend on the number of threads. See
+     * NrParallelScheduling for the details and the limitations.
+     *
+     * @param numThreads the number of threads, or 0 to use all the available cores
+     * @return the NrParallelScheduling instance shared by the gNBs
+     */
+    Ptr<NrParallelScheduling> EnableParallelScheduling(uint32_t numThreads = 0);
+
+    /**
+     * @brief Enable the batching of the MIMO CSI searches of the UEs attached afterwards
+     *
+     * The PMI, RI and CQI searches of the UEs attached by this helper after the call, with
+     * MIMO feedback enabled, are queued and executed together at the end of each time stamp,
+     * in parallel, and their feedback is sent in the order the searches were queued. See
+     * NrCsiBatch for the details and the limitations.
+     *
+     * @param numThreads the number of threads, or 0 to use all the available cores
+     * @return the NrCsiBatch instance shared by the UEs
+     */
+    Ptr<NrCsiBatch> EnableCsiBatching(uint32_t numThreads = 0);
+
     /**
      * @brief Enable DL DATA PHY traces
      */
@@ -1073,6 +1105,8 @@ class NrHelper : public Object
 
     bool m_snrTest{false};
     bool m_fhEnabled{false};
+    Ptr<NrParallelScheduling> m_parallelScheduling; //!< Parallel scheduling of the gNBs, if any
+    Ptr<NrCsiBatch> m_csiBatch; //!< Batch of the CSI searches of the UEs, if any
 
     Ptr<NrPhyRxTrace> m_phyStats; //!< Pointer to the PhyRx stats
     Ptr<NrMacRxTrace> m_macStats; //!< Pointer to the MacRx stats
@@ -4,6 +4,7 @@
 
 #include "nr-mac-scheduling-stats.h"
 
+#include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
@@ -18,21 +19,11 @@ NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulingStats);
 NrMacSchedulingStats::NrMacSchedulingStats()
 {
     NS_LOG_FUNCTION(this);
-    SetDlOutputFilename(GetDlOutputFilename());
-    SetUlOutputFilename(GetUlOutputFilename());
 }
 
 NrMacSchedulingStats::~NrMacSchedulingStats()
 {
     NS_LOG_FUNCTION(this);
-    if (outDlFile.is_open())
-    {
-        outDlFile.close();
-    }
-    if (outUlFile.is_open())
-    {
-        outUlFile.close();
-    }
 }
 
 TypeId
@@ -52,7 +43,18 @@ NrMacSchedulingStats::GetTypeId()
                           "Name of the file where the uplink results will be saved.",
                           StringValue("NrUlMacStats.txt"),
                           MakeStringAccessor(&NrMacSchedulingStats::SetUlOutputFilename),
-                          MakeStringChecker());
+                          MakeStringChecker())
+            .AddAttribute("TraceFormat",
+                          "Format of the files. The BINARY files have the .bin extension, "
+                          "and can be converted to text with the nr-trace-converter example.",
+                          EnumValue(NrTraceWriter::TEXT),
+                          MakeEnumAccessor<NrTraceWriter::Format>(
+                              &NrMacSchedulingStats::SetTraceFormat,
+                              &NrMacSchedulingStats::GetTraceFormat),
+                          MakeEnumChecker(NrTraceWriter::TEXT,
+                                          "TEXT",
+                                          NrTraceWriter::BINARY,
+                                          "BINARY"));
     return tid;
 }
 
@@ -60,21 +62,8 @@ void
 NrMacSchedulingStats::SetUlOutputFilename(std::string outputFilename)
 {
     NrStatsCalculator::SetUlOutputFilename(outputFilename);
-    if (outUlFile.is_open())
-    {
-        outUlFile.close();
-    }
-    outUlFile.open(GetUlOutputFilename().c_str());
-    if (!outUlFile.is_open())
-    {
-        NS_LOG_ERROR("Can't open file " << GetUlOutputFilename().c_str());
-        return;
-    }
-    outUlFile << "% "
-                 "time(s)"
-                 "\tcellId\tbwpId\tIMSI\tRNTI\tframe\tsframe\tslot\tsymStart\tnumSym\thar"
-                 "qId\tndi\trv\tmcs\ttbSize";
-    outUlFile << std::endl;
+    // Close the current file, the new one is opened at the next scheduling
+    m_ulWriter.reset();
 }
 
 std::string
@@ -87,21 +76,8 @@ void
 NrMacSchedulingStats::SetDlOutputFilename(std::string outputFilename)
 {
     NrStatsCalculator::SetDlOutputFilename(outputFilename);
-    if (outDlFile.is_open())
-    {
-        outDlFile.close();
-    }
-    outDlFile.open(GetDlOutputFilename().c_str());
-    if (!outDlFile.is_open())
-    {
-        NS_LOG_ERROR("Can't open file " << GetDlOutputFilename().c_str());
-        return;
-    }
-    outDlFile << "% "
-                 "time(s)"
-                 "\tcellId\tbwpId\tIMSI\tRNTI\tframe\tsframe\tslot\tsymStart\tnumSym\thar"
-                 "qId\tndi\trv\tmcs\ttbSize";
-    outDlFile << std::endl;
+    // Close the current file, the new one is opened at the next scheduling
+    m_dlWriter.reset();
 }
 
 std::string
@@ -110,6 +86,57 @@ NrMacSchedulingStats::GetDlOutputFilename()
     return NrStatsCalculator::GetDlOutputFilename();
 }
 
+void
+NrMacSchedulingStats::SetTraceFormat(NrTraceWriter::Format format)
+{
+    m_traceFormat = format;
+    m_dlWriter.reset();
+    m_ulWriter.reset();
+}
+
+NrTraceWriter::Format
+NrMacSchedulingStats::GetTraceFormat() const
+{
+    return m_traceFormat;
+}
+
+void
+NrMacSchedulingStats::WriteRow(std::unique_ptr<NrTraceWriter>& writer,
+                               const std::string& fileName,
+                               uint16_t cellId,
+                               uint64_t imsi,
+                               const NrSchedulingCallbackInfo& traceInfo)
+{
+    if (!writer)
+    {
+        writer = NrTraceWriter::Create(m_traceFormat,
+                                       NrTraceWriter::GetFileName(fileName, m_traceFormat),
+                                       {{"time(s)", NrTraceWriter::ColumnType::DOUBLE, {}},
+                                        {"cellId", NrTraceWriter::ColumnType::UINT16, {}},
+                                        {"bwpId", NrTraceWriter::ColumnType::UINT8, {}},
+                                        {"IMSI", NrTraceWriter::ColumnType::UINT64, {}},
+                                        {"RNTI", NrTraceWriter::ColumnType::UINT16, {}},
+                                        {"frame", NrTraceWriter::ColumnType::UINT16, {}},
+                                        {"sframe", NrTraceWriter::ColumnType::UINT8, {}},
+                                        {"slot", NrTraceWriter::ColumnType::UINT16, {}},
+                                        {"symStart", NrTraceWriter::ColumnType::UINT8, {}},
+                                        {"numSym", NrTraceWriter::ColumnType::UINT8, {}},
+                                        {"harqId", NrTraceWriter::ColumnType::UINT8, {}},
+                                        {"ndi", NrTraceWriter::ColumnType::UINT8, {}},
+                                        {"rv", NrTraceWriter::ColumnType::UINT8, {}},
+                                        {"mcs", NrTraceWriter::ColumnType::UINT8, {}},
+                                        {"tbSize", NrTraceWriter::ColumnType::UINT32, {}}},
+                                       "% ");
+    }
+
+    *writer << Simulator::Now().GetSeconds() << cellId << traceInfo.m_bwpId << imsi
+            << traceInfo.m_rnti << traceInfo.m_frameNum << traceInfo.m_subframeNum
+            << traceInfo.m_slotNum << traceInfo.m_symStart << traceInfo.m_numSym
+            << traceInfo.m_harqId << traceInfo.m_ndi << traceInfo.m_rv << traceInfo.m_mcs
+            << traceInfo.m_tbSize;
+    writer->EndRow();
+}
+
 void
 NrMacSchedulingStats::DlScheduling(uint16_t cellId,
                                    uint64_t imsi,
@@ -119,21 +146,7 @@ NrMacSchedulingStats::DlScheduling(uint16_t cellId,
                          << traceInfo.m_rnti << (uint32_t)traceInfo.m_mcs << traceInfo.m_tbSize);
     NS_LOG_INFO("Write DL Mac Stats in " << GetDlOutputFilename().c_str());
 
-    outDlFile << Simulator::Now().GetSeconds() << "\t";
-    outDlFile << (uint32_t)cellId << "\t";
-    outDlFile << (uint32_t)traceInfo.m_bwpId << "\t";
-    outDlFile << imsi << "\t";
-    outDlFile << traceInfo.m_rnti << "\t";
-    outDlFile << traceInfo.m_frameNum << "\t";
-    outDlFile << (uint32_t)traceInfo.m_subframeNum << "\t";
-    outDlFile << traceInfo.m_slotNum << "\t";
-    outDlFile << (uint32_t)traceInfo.m_symStart << "\t";
-    outDlFile << (uint32_t)traceInfo.m_numSym << "\t";
-    outDlFile << (uint32_t)traceInfo.m_harqId << "\t";
-    outDlFile << (uint32_t)traceInfo.m_ndi << "\t";
-    outDlFile << (uint32_t)traceInfo.m_rv << "\t";
-    outDlFile << (uint32_t)traceInfo.m_mcs << "\t";
-    outDlFile << traceInfo.m_tbSize << std::endl;
+    WriteRow(m_dlWriter, GetDlOutputFilename(), cellId, imsi, traceInfo);
 }
 
 void
@@ -145,21 +158,7 @@ NrMacSchedulingStats::UlScheduling(uint16_t cellId,
                          << traceInfo.m_rnti << (uint32_t)traceInfo.m_mcs << traceInfo.m_tbSize);
     NS_LOG_INFO("Write UL Mac Stats in " << GetUlOutputFilename().c_str());
 
-    outUlFile << Simulator::Now().GetSeconds() << "\t";
-    outUlFile << (uint32_t)cellId << "\t";
-    outUlFile << (uint32_t)traceInfo.m_bwpId << "\t";
-    outUlFile << imsi << "\t";
-    outUlFile << traceInfo.m_rnti << "\t";
-    outUlFile << traceInfo.m_frameNum << "\t";
-    outUlFile << (uint32_t)traceInfo.m_subframeNum << "\t";
-    outUlFile << traceInfo.m_slotNum << "\t";
-    outUlFile << (uint32_t)traceInfo.m_symStart << "\t";
-    outUlFile << (uint32_t)traceInfo.m_numSym << "\t";
-    outUlFile << (uint32_t)traceInfo.m_harqId << "\t";
-    outUlFile << (uint32_t)traceInfo.m_ndi << "\t";
-    outUlFile << (uint32_t)traceInfo.m_rv << "\t";
-    outUlFile << (uint32_t)traceInfo.m_mcs << "\t";
-    outUlFile << traceInfo.m_tbSize << std::endl;
+    WriteRow(m_ulWriter, GetUlOutputFilename(), cellId, imsi, traceInfo);
 }
 
 void
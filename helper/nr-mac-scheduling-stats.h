@@ -8,10 +8,11 @@
 #include "nr-stats-calculator.h"
 
 #include "ns3/nr-gnb-mac.h"
+#include "ns3/nr-trace-writer.h"
 #include "ns3/nstime.h"
 #include "ns3/uinteger.h"
 
-#include <fstream>
+#include <memory>
 #include <string>
 
 namespace ns3
@@ -78,6 +79,20 @@ class NrMacSchedulingStats : public NrStatsCalculator
      */
     std::string GetDlOutputFilename();
 
+    /**
+     * Set the format of the statistics files. In the BINARY format, the extension of the
+     * names of the files is ".bin".
+     *
+     * @param format the trace format
+     */
+    void SetTraceFormat(NrTraceWriter::Format format);
+
+    /**
+     * Get the format of the statistics files.
+     * @return the trace format
+     */
+    NrTraceWriter::Format GetTraceFormat() const;
+
     /**
      * Notifies the stats calculator that an downlink scheduling has occurred.
      * @param cellId Cell ID of the attached gNb
@@ -121,17 +136,34 @@ class NrMacSchedulingStats : public NrStatsCalculator
 
   private:
     /**
-     * DL MAC statistics file stream. When the filename
-     * is changed, columns description are added. Then
-     * next lines are appended to file.
+     * Write a row of a statistics file, opening it with the columns description
+     * if needed.
+     *
+     * @param writer the writer of the file
+     * @param fileName the name of the file in the TEXT format
+     * @param cellId Cell ID of the gNB
+     * @param imsi IMSI of the scheduled UE
+     * @param traceInfo the scheduling information
+     */
+    void WriteRow(std::unique_ptr<NrTraceWriter>& writer,
+                  const std::string& fileName,
+                  uint16_t cellId,
+                  uint64_t imsi,
+                  const NrSchedulingCallbackInfo& traceInfo);
+
+    /**
+     * DL MAC statistics writer. It is created, and the columns description
+     * written, at the first scheduling after the filename or the format is set.
+     * Then next rows are appended to file.
      */
-    std::ofstream outDlFile;
+    std::unique_ptr<NrTraceWriter> m_dlWriter;
     /**
-     * UL MAC statistics file stream. When the filename
-     * is changed, columns description are added. Then
-     * next lines are appended to file.
+     * UL MAC statistics writer. It is created, and the columns description
+     * written, at the first scheduling after the filename or the format is set.
+     * Then next rows are appended to file.
      */
-    std::ofstream outUlFile;
+    std::unique_ptr<NrTraceWriter> m_ulWriter;
+    NrTraceWriter::Format m_traceFormat{NrTraceWriter::TEXT}; //!< Format of the files
 };
 
 } // namespace ns3
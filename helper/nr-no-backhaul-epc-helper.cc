@@ -7,6 +7,8 @@
 
 #include "nr-no-backhaul-epc-helper.h"
 
+#include "nr-distributed-helper.h"
+
 #include "ns3/boolean.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
@@ -65,10 +67,12 @@ NrNoBackhaulEpcHelper::NotifyConstructionCompleted()
     // we use a /64 IPv6 net all UEs
     m_uePgwAddressHelper6.SetBase("7777:f00d::", Ipv6Prefix(64));
 
-    // Create PGW, SGW and MME nodes
-    m_pgw = CreateObject<Node>();
-    m_sgw = CreateObject<Node>();
-    m_mme = CreateObject<Node>();
+    // Create PGW, SGW and MME nodes. In a distributed simulation, each process has its
+    // own copy of them, which serves the gNBs of that process
+    auto systemId = NrDistributedHelper::GetLocalSystemId();
+    m_pgw = CreateObject<Node>(systemId);
+    m_sgw = CreateObject<Node>(systemId);
+    m_mme = CreateObject<Node>(systemId);
     InternetStackHelper internet;
     internet.Install(m_pgw);
     internet.Install(m_sgw);
@@ -636,7 +640,7 @@ NrNoBackhaulEpcHelper::SetupRemoteHost(std::optional<std::string> dataRate,
     // get SGW/PGW and create a single RemoteHost
     Ptr<Node> pgw = GetPgwNode();
     NodeContainer remoteHostContainer;
-    remoteHostContainer.Create(1);
+    remoteHostContainer.Create(1, NrDistributedHelper::GetLocalSystemId());
     Ptr<Node> remoteHost = remoteHostContainer.Get(0);
     InternetStackHelper internet;
     internet.Install(remoteHostContainer);
@@ -677,7 +681,7 @@ NrNoBackhaulEpcHelper::SetupRemoteHost6(std::optional<std::string> dataRate,
     // get SGW/PGW and create a single RemoteHost
     Ptr<Node> pgw = GetPgwNode();
     NodeContainer remoteHostContainer;
-    remoteHostContainer.Create(1);
+    remoteHostContainer.Create(1, NrDistributedHelper::GetLocalSystemId());
     Ptr<Node> remoteHost = remoteHostContainer.Get(0);
     InternetStackHelper internet;
     internet.Install(remoteHostContainer);
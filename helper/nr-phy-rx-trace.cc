@@ -5,12 +5,15 @@
 
 #include "nr-phy-rx-trace.h"
 
+#include "ns3/abort.h"
+#include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/nr-gnb-net-device.h"
 #include "ns3/nr-ue-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 
+#include <iomanip>
 #include <stdio.h>
 #include <string>
 
@@ -21,16 +24,22 @@ NS_LOG_COMPONENT_DEFINE("NrPhyRxTrace");
 
 NS_OBJECT_ENSURE_REGISTERED(NrPhyRxTrace);
 
-std::ofstream NrPhyRxTrace::m_dlDataSinrFile;
+std::unique_ptr<NrTraceWriter> NrPhyRxTrace::m_dlDataSinrWriter;
 std::string NrPhyRxTrace::m_dlDataSinrFileName;
 
-std::ofstream NrPhyRxTrace::m_dlCtrlSinrFile;
+std::unique_ptr<NrTraceWriter> NrPhyRxTrace::m_dlCtrlSinrWriter;
 std::string NrPhyRxTrace::m_dlCtrlSinrFileName;
 
-std::ofstream NrPhyRxTrace::m_rxPacketTraceFile;
+std::unique_ptr<NrTraceWriter> NrPhyRxTrace::m_rxPacketTraceWriter;
 std::string NrPhyRxTrace::m_rxPacketTraceFilename;
 std::string NrPhyRxTrace::m_simTag;
 std::string NrPhyRxTrace::m_resultsFolder;
+NrTraceWriter::Format NrPhyRxTrace::m_traceFormat = NrTraceWriter::TEXT;
+std::unordered_map<uint64_t, std::unique_ptr<NrPhyRxTrace::UlSinrTraceFile>>
+    NrPhyRxTrace::m_ulSinrFiles;
+
+/// Size of the buffer of each per-UE UL SINR file
+static const size_t UL_SINR_FILE_BUFFER = 64 * 1024;
 
 std::ofstream NrPhyRxTrace::m_rxedGnbPhyCtrlMsgsFile;
 std::string NrPhyRxTrace::m_rxedGnbPhyCtrlMsgsFileName;
@@ -60,20 +69,11 @@ NrPhyRxTrace::NrPhyRxTrace()
 
 NrPhyRxTrace::~NrPhyRxTrace()
 {
-    if (m_dlDataSinrFile.is_open())
-    {
-        m_dlDataSinrFile.close();
-    }
-
-    if (m_dlCtrlSinrFile.is_open())
-    {
-        m_dlCtrlSinrFile.close();
-    }
-
-    if (m_rxPacketTraceFile.is_open())
-    {
-        m_rxPacketTraceFile.close();
-    }
+    // Destroying the writers flushes and closes the files
+    m_dlDataSinrWriter.reset();
+    m_dlCtrlSinrWriter.reset();
+    m_rxPacketTraceWriter.reset();
+    m_ulSinrFiles.clear();
 
     if (m_rxedGnbPhyCtrlMsgsFile.is_open())
     {
@@ -134,7 +134,19 @@ NrPhyRxTrace::GetTypeId()
                 "in order to distinguish them, for example: RxPacketTrace-${SimTag}.out. ",
                 StringValue(""),
                 MakeStringAccessor(&NrPhyRxTrace::SetSimTag),
-                MakeStringChecker());
+                MakeStringChecker())
+            .AddAttribute("TraceFormat",
+                          "Format of the RxPacketTrace, DlDataSinr, DlCtrlSinr and per-UE "
+                          "UL SINR files. "
+                          "The BINARY files have the .bin extension, and can be converted "
+                          "to text with the nr-trace-converter example.",
+                          EnumValue(NrTraceWriter::TEXT),
+                          MakeEnumAccessor<NrTraceWriter::Format>(&NrPhyRxTrace::SetTraceFormat,
+                                                                  &NrPhyRxTrace::GetTraceFormat),
+                          MakeEnumChecker(NrTraceWriter::TEXT,
+                                          "TEXT",
+                                          NrTraceWriter::BINARY,
+                                          "BINARY"));
     return tid;
 }
 
@@ -150,6 +162,85 @@ NrPhyRxTrace::SetResultsFolder(const std::string& resultsFolder)
     m_resultsFolder = resultsFolder;
 }
 
+void
+NrPhyRxTrace::SetTraceFormat(NrTraceWriter::Format format)
+{
+    m_traceFormat = format;
+}
+
+NrTraceWriter::Format
+NrPhyRxTrace::GetTraceFormat() const
+{
+    return m_traceFormat;
+}
+
+void
+NrPhyRxTrace::WriteDlSinrTrace(std::unique_ptr<NrTraceWriter>& writer,
+                               std::string& fileName,
+                               const std::string& prefix,
+                               uint16_t cellId,
+                               uint16_t rnti,
+                               uint16_t bwpId,
+                               double avgSinr)
+{
+    if (!writer)
+    {
+        std::ostringstream oss;
+        oss << m_resultsFolder << prefix << m_simTag.c_str() << ".txt";
+        fileName = NrTraceWriter::GetFileName(oss.str(), m_traceFormat);
+        writer = NrTraceWriter::Create(m_traceFormat,
+                                       fileName,
+                                       {{"Time", NrTraceWriter::ColumnType::DOUBLE, {}},
+                                        {"CellId", NrTraceWriter::ColumnType::UINT16, {}},
+                                        {"RNTI", NrTraceWriter::ColumnType::UINT16, {}},
+                                        {"BWPId", NrTraceWriter::ColumnType::UINT16, {}},
+                                        {"SINR(dB)", NrTraceWriter::ColumnType::DOUBLE, {}}});
+    }
+
+    *writer << Simulator::Now().GetSeconds() << cellId << rnti << bwpId << 10 * log10(avgSinr);
+    writer->EndRow();
+}
+
+void
+NrPhyRxTrace::WriteRxPacketTrace(const char* direction, const RxPacketTraceParams& params)
+{
+    if (!m_rxPacketTraceWriter)
+    {
+        std::ostringstream oss;
+        oss << m_resultsFolder << "RxPacketTrace" << m_simTag.c_str() << ".txt";
+        m_rxPacketTraceFilename = NrTraceWriter::GetFileName(oss.str(), m_traceFormat);
+        m_rxPacketTraceWriter =
+            NrTraceWriter::Create(m_traceFormat,
+                                  m_rxPacketTraceFilename,
+                                  {{"Time", NrTraceWriter::ColumnType::DOUBLE, {}},
+                                   {"direction", NrTraceWriter::ColumnType::LABEL, {"DL", "UL"}},
+                                   {"frame", NrTraceWriter::ColumnType::UINT32, {}},
+                                   {"subF", NrTraceWriter::ColumnType::UINT8, {}},
+                                   {"slot", NrTraceWriter::ColumnType::UINT16, {}},
+                                   {"1stSym", NrTraceWriter::ColumnType::UINT8, {}},
+                                   {"nSymbol", NrTraceWriter::ColumnType::UINT8, {}},
+                                   {"cellId", NrTraceWriter::ColumnType::UINT64, {}},
+                                   {"bwpId", NrTraceWriter::ColumnType::UINT16, {}},
+                                   {"rnti", NrTraceWriter::ColumnType::UINT16, {}},
+                                   {"tbSize", NrTraceWriter::ColumnType::UINT32, {}},
+                                   {"mcs", NrTraceWriter::ColumnType::UINT8, {}},
+                                   {"rank", NrTraceWriter::ColumnType::UINT8, {}},
+                                   {"rv", NrTraceWriter::ColumnType::UINT8, {}},
+                                   {"SINR(dB)", NrTraceWriter::ColumnType::DOUBLE, {}},
+                                   {"CQI", NrTraceWriter::ColumnType::UINT8, {}},
+                                   {"corrupt", NrTraceWriter::ColumnType::UINT8, {}},
+                                   {"TBler", NrTraceWriter::ColumnType::DOUBLE, {}}});
+    }
+
+    *m_rxPacketTraceWriter << Simulator::Now().GetNanoSeconds() / (double)1e9 << direction
+                           << params.m_frameNum << params.m_subframeNum << params.m_slotNum
+                           << params.m_symStart << params.m_numSym << params.m_cellId
+                           << params.m_bwpId << params.m_rnti << params.m_tbSize << params.m_mcs
+                           << params.m_rank << params.m_rv << 10 * log10(params.m_sinr)
+                           << params.m_cqi << params.m_corrupt << params.m_tbler;
+    m_rxPacketTraceWriter->EndRow();
+}
+
 void
 NrPhyRxTrace::DlDataSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
                                  [[maybe_unused]] std::string path,
@@ -160,31 +251,13 @@ NrPhyRxTrace::DlDataSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
 {
     NS_LOG_INFO("UE" << rnti << "of " << cellId << " over bwp ID " << bwpId
                      << "->Generate RsrpSinrTrace");
-    if (!m_dlDataSinrFile.is_open())
-    {
-        std::ostringstream oss;
-        oss << m_resultsFolder << "DlDataSinr" << m_simTag.c_str() << ".txt";
-        m_dlDataSinrFileName = oss.str();
-        m_dlDataSinrFile.open(m_dlDataSinrFileName.c_str());
-
-        m_dlDataSinrFile << "Time"
-                         << "\t"
-                         << "CellId"
-                         << "\t"
-                         << "RNTI"
-                         << "\t"
-                         << "BWPId"
-                         << "\t"
-                         << "SINR(dB)" << std::endl;
-
-        if (!m_dlDataSinrFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-
-    m_dlDataSinrFile << Simulator::Now().GetSeconds() << "\t" << cellId << "\t" << rnti << "\t"
-                     << bwpId << "\t" << 10 * log10(avgSinr) << std::endl;
+    WriteDlSinrTrace(m_dlDataSinrWriter,
+                     m_dlDataSinrFileName,
+                     "DlDataSinr",
+                     cellId,
+                     rnti,
+                     bwpId,
+                     avgSinr);
 }
 
 void
@@ -198,31 +271,13 @@ NrPhyRxTrace::DlCtrlSinrCallback([[maybe_unused]] Ptr<NrPhyRxTrace> phyStats,
     NS_LOG_INFO("UE" << rnti << "of " << cellId << " over bwp ID " << bwpId
                      << "->Generate DlCtrlSinrTrace");
 
-    if (!m_dlCtrlSinrFile.is_open())
-    {
-        std::ostringstream oss;
-        oss << m_resultsFolder << "DlCtrlSinr" << m_simTag.c_str() << ".txt";
-        m_dlCtrlSinrFileName = oss.str();
-        m_dlCtrlSinrFile.open(m_dlCtrlSinrFileName.c_str());
-
-        m_dlCtrlSinrFile << "Time"
-                         << "\t"
-                         << "CellId"
-                         << "\t"
-                         << "RNTI"
-                         << "\t"
-                         << "BWPId"
-                         << "\t"
-                         << "SINR(dB)" << std::endl;
-
-        if (!m_dlCtrlSinrFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-
-    m_dlCtrlSinrFile << Simulator::Now().GetSeconds() << "\t" << cellId << "\t" << rnti << "\t"
-                     << bwpId << "\t" << 10 * log10(avgSinr) << std::endl;
+    WriteDlSinrTrace(m_dlCtrlSinrWriter,
+                     m_dlCtrlSinrFileName,
+                     "DlCtrlSinr",
+                     cellId,
+                     rnti,
+                     bwpId,
+                     avgSinr);
 }
 
 void
@@ -234,25 +289,55 @@ NrPhyRxTrace::UlSinrTraceCallback(Ptr<NrPhyRxTrace> phyStats,
 {
     NS_LOG_INFO("UE" << imsi << "->Generate UlSinrTrace");
     uint64_t tti_count = Now().GetMicroSeconds() / 125;
+
+    auto& file = m_ulSinrFiles[imsi];
+    if (!file)
+    {
+        file = std::make_unique<UlSinrTraceFile>();
+        std::string fname = "UE_" + std::to_string(imsi) + "_UL_SINR_dB.txt";
+        if (m_traceFormat == NrTraceWriter::BINARY)
+        {
+            auto writer = std::make_unique<NrBinaryTraceWriter>(
+                NrTraceWriter::GetFileName(fname, m_traceFormat),
+                std::vector<NrTraceWriter::Column>{
+                    {"subframe", NrTraceWriter::ColumnType::UINT64, {}},
+                    {"slot", NrTraceWriter::ColumnType::UINT8, {}},
+                    {"SINR(dB)", NrTraceWriter::ColumnType::DOUBLE_ARRAY, {}}},
+                "");
+            writer->SetMaxBlockSize(UL_SINR_FILE_BUFFER);
+            file->m_writer = std::move(writer);
+        }
+        else
+        {
+            // The buffer must be set before opening the file
+            file->m_buffer.resize(UL_SINR_FILE_BUFFER);
+            file->m_text.rdbuf()->pubsetbuf(file->m_buffer.data(), file->m_buffer.size());
+            file->m_text.open(fname, std::ios::app);
+            NS_ABORT_MSG_IF(!file->m_text.is_open(), "Can't open file " << fname);
+            file->m_text << std::fixed << std::setprecision(6);
+        }
+    }
+
+    if (file->m_writer)
+    {
+        auto& sinrDb = file->m_sinrDb;
+        sinrDb.clear();
+        for (auto it = sinr.ConstValuesBegin(); it != sinr.ConstValuesEnd(); ++it)
+        {
+            sinrDb.push_back(10 * log10(*it));
+        }
+        *file->m_writer << tti_count / 8 + 1 << tti_count % 8 + 1 << sinrDb;
+        file->m_writer->EndRow();
+        return;
+    }
+
     uint32_t rb_count = 1;
-    FILE* log_file;
-    std::string fname = "UE_" + std::to_string(imsi) + "_UL_SINR_dB.txt";
-    log_file = fopen(fname.c_str(), "a");
-    auto it = sinr.ValuesBegin();
-    while (it != sinr.ValuesEnd())
+    for (auto it = sinr.ConstValuesBegin(); it != sinr.ConstValuesEnd(); ++it)
     {
-        // fprintf(log_file, "%d\t%d\t%f\t \n", tti_count/2, rb_count, 10*log10(*it));
-        fprintf(log_file,
-                "%llu\t%llu\t%d\t%f\t \n",
-                (long long unsigned)tti_count / 8 + 1,
-                (long long unsigned)tti_count % 8 + 1,
-                rb_count,
-                10 * log10(*it));
+        file->m_text << tti_count / 8 + 1 << '\t' << tti_count % 8 + 1 << '\t' << rb_count
+                     << '\t' << 10 * log10(*it) << "\t \n";
         rb_count++;
-        it++;
     }
-    fflush(log_file);
-    fclose(log_file);
     // phyStats->ReportInterferenceTrace (imsi, sinr);
     // phyStats->ReportPowerTrace (imsi, power);
 }
@@ -801,65 +886,7 @@ NrPhyRxTrace::RxPacketTraceUeCallback(Ptr<NrPhyRxTrace> phyStats,
                                       std::string path,
                                       RxPacketTraceParams params)
 {
-    if (!m_rxPacketTraceFile.is_open())
-    {
-        std::ostringstream oss;
-        oss << m_resultsFolder << "RxPacketTrace" << m_simTag.c_str() << ".txt";
-        m_rxPacketTraceFilename = oss.str();
-        m_rxPacketTraceFile.open(m_rxPacketTraceFilename.c_str());
-
-        m_rxPacketTraceFile << "Time"
-                            << "\t"
-                            << "direction"
-                            << "\t"
-                            << "frame"
-                            << "\t"
-                            << "subF"
-                            << "\t"
-                            << "slot"
-                            << "\t"
-                            << "1stSym"
-                            << "\t"
-                            << "nSymbol"
-                            << "\t"
-                            << "cellId"
-                            << "\t"
-                            << "bwpId"
-                            << "\t"
-                            << "rnti"
-                            << "\t"
-                            << "tbSize"
-                            << "\t"
-                            << "mcs"
-                            << "\t"
-                            << "rank"
-                            << "\t"
-                            << "rv"
-                            << "\t"
-                            << "SINR(dB)"
-                            << "\t"
-                            << "CQI"
-                            << "\t"
-                            << "corrupt"
-                            << "\t"
-                            << "TBler" << std::endl;
-
-        if (!m_rxPacketTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-
-    m_rxPacketTraceFile << Simulator::Now().GetNanoSeconds() / (double)1e9 << "\t"
-                        << "DL"
-                        << "\t" << params.m_frameNum << "\t" << (unsigned)params.m_subframeNum
-                        << "\t" << (unsigned)params.m_slotNum << "\t" << (unsigned)params.m_symStart
-                        << "\t" << (unsigned)params.m_numSym << "\t" << params.m_cellId << "\t"
-                        << (unsigned)params.m_bwpId << "\t" << params.m_rnti << "\t"
-                        << params.m_tbSize << "\t" << (unsigned)params.m_mcs << "\t"
-                        << (unsigned)params.m_rank << "\t" << (unsigned)params.m_rv << "\t"
-                        << 10 * log10(params.m_sinr) << "\t" << std::to_string(params.m_cqi) << "\t"
-                        << params.m_corrupt << "\t" << params.m_tbler << std::endl;
+    WriteRxPacketTrace("DL", params);
 
     if (params.m_corrupt)
     {
@@ -880,64 +907,7 @@ NrPhyRxTrace::RxPacketTraceGnbCallback(Ptr<NrPhyRxTrace> phyStats,
                                        std::string path,
                                        RxPacketTraceParams params)
 {
-    if (!m_rxPacketTraceFile.is_open())
-    {
-        std::ostringstream oss;
-        oss << m_resultsFolder << "RxPacketTrace" << m_simTag.c_str() << ".txt";
-        m_rxPacketTraceFilename = oss.str();
-        m_rxPacketTraceFile.open(m_rxPacketTraceFilename.c_str());
-
-        m_rxPacketTraceFile << "Time"
-                            << "\t"
-                            << "direction"
-                            << "\t"
-                            << "frame"
-                            << "\t"
-                            << "subF"
-                            << "\t"
-                            << "slot"
-                            << "\t"
-                            << "1stSym"
-                            << "\t"
-                            << "nSymbol"
-                            << "\t"
-                            << "cellId"
-                            << "\t"
-                            << "bwpId"
-                            << "\t"
-                            << "rnti"
-                            << "\t"
-                            << "tbSize"
-                            << "\t"
-                            << "mcs"
-                            << "\t"
-                            << "rank"
-                            << "\t"
-                            << "rv"
-                            << "\t"
-                            << "SINR(dB)"
-                            << "\t"
-                            << "CQI"
-                            << "\t"
-                            << "corrupt"
-                            << "\t"
-                            << "TBler" << std::endl;
-
-        if (!m_rxPacketTraceFile.is_open())
-        {
-            NS_FATAL_ERROR("Could not open tracefile");
-        }
-    }
-    m_rxPacketTraceFile << Simulator::Now().GetNanoSeconds() / (double)1e9 << "\t"
-                        << "UL"
-                        << "\t" << params.m_frameNum << "\t" << (unsigned)params.m_subframeNum
-                        << "\t" << (unsigned)params.m_slotNum << "\t" << (unsigned)params.m_symStart
-                        << "\t" << (unsigned)params.m_numSym << "\t" << params.m_cellId << "\t"
-                        << (unsigned)params.m_bwpId << "\t" << params.m_rnti << "\t"
-                        << params.m_tbSize << "\t" << (unsigned)params.m_mcs << "\t"
-                        << (unsigned)params.m_rank << "\t" << (unsigned)params.m_rv << "\t"
-                        << 10 * log10(params.m_sinr) << "\t" << std::to_string(params.m_cqi) << "\t"
-                        << params.m_corrupt << "\t" << params.m_tbler << std::endl;
+    WriteRxPacketTrace("UL", params);
 
     if (params.m_corrupt)
     {
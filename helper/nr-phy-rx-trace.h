@@ -9,12 +9,14 @@
 #include "ns3/nr-control-messages.h"
 #include "ns3/nr-phy-mac-common.h"
 #include "ns3/nr-spectrum-phy.h"
+#include "ns3/nr-trace-writer.h"
 #include "ns3/object.h"
 #include "ns3/spectrum-phy.h"
 #include "ns3/spectrum-value.h"
 
 #include <fstream>
 #include <iostream>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -39,6 +41,24 @@ class NrPhyRxTrace : public Object
      */
     void SetResultsFolder(const std::string& resultsFolder);
 
+    /**
+     * @brief Set the format of the RxPacketTrace, DlDataSinr, DlCtrlSinr and per-UE UL
+     * SINR files
+     *
+     * It applies to the files that are opened after the call. In the BINARY format the
+     * files have the ".bin" extension, and can be converted to text with
+     * NrBinaryTraceReader or the nr-trace-converter example.
+     *
+     * @param format the trace format
+     */
+    void SetTraceFormat(NrTraceWriter::Format format);
+
+    /**
+     * @return the format of the RxPacketTrace, DlDataSinr, DlCtrlSinr and per-UE UL SINR
+     * files
+     */
+    NrTraceWriter::Format GetTraceFormat() const;
+
     /**
      * @brief Trace sink for DL Average SINR of DATA (in dB).
      * @param [in] phyStats NrPhyRxTrace object
@@ -71,6 +91,20 @@ class NrPhyRxTrace : public Object
                                    double avgSinr,
                                    uint16_t bwpId);
 
+    /**
+     * @brief Trace sink for the UL SINR of each RB, written to a file per UE
+     *
+     * In the TEXT format, a line per RB is appended to UE_<IMSI>_UL_SINR_dB.txt. In the
+     * BINARY format, a row with the SINR of all the RBs is written to
+     * UE_<IMSI>_UL_SINR_dB.bin. The files stay open, and are written when their buffer is
+     * full and when the trace objects are destroyed.
+     *
+     * @param [in] phyStats NrPhyRxTrace object
+     * @param [in] path context path
+     * @param [in] imsi the IMSI of the UE
+     * @param [in] sinr the SINR of each RB
+     * @param [in] power the received power of each RB
+     */
     static void UlSinrTraceCallback(Ptr<NrPhyRxTrace> phyStats,
                                     std::string path,
                                     uint64_t imsi,
@@ -286,18 +320,58 @@ class NrPhyRxTrace : public Object
                               Ptr<NrSpectrumPhy> rxNrSpectrumPhy,
                               double lossDb);
 
-    static std::string m_simTag;        //!< The `SimTag` attribute.
-    static std::string m_resultsFolder; //!< The results folder path
+    /**
+     * @brief Write a row of the RxPacketTrace file, opening it if needed
+     * @param direction "DL" or "UL"
+     * @param params the parameters of the received TB
+     */
+    static void WriteRxPacketTrace(const char* direction, const RxPacketTraceParams& params);
+
+    /**
+     * @brief Write a row of a DL SINR file, opening it if needed
+     * @param writer the writer of the file
+     * @param fileName the name of the file, set when it is opened
+     * @param prefix the prefix of the name of the file
+     * @param cellId the cell ID
+     * @param rnti the RNTI
+     * @param bwpId the BWP ID
+     * @param avgSinr the average SINR, in linear units
+     */
+    static void WriteDlSinrTrace(std::unique_ptr<NrTraceWriter>& writer,
+                                 std::string& fileName,
+                                 const std::string& prefix,
+                                 uint16_t cellId,
+                                 uint16_t rnti,
+                                 uint16_t bwpId,
+                                 double avgSinr);
+
+    static std::string m_simTag;                //!< The `SimTag` attribute.
+    static std::string m_resultsFolder;         //!< The results folder path
+    static NrTraceWriter::Format m_traceFormat; //!< The `TraceFormat` attribute.
 
-    static std::ofstream m_dlDataSinrFile;
+    static std::unique_ptr<NrTraceWriter> m_dlDataSinrWriter;
     static std::string m_dlDataSinrFileName;
 
-    static std::ofstream m_dlCtrlSinrFile;
+    static std::unique_ptr<NrTraceWriter> m_dlCtrlSinrWriter;
     static std::string m_dlCtrlSinrFileName;
 
-    static std::ofstream m_rxPacketTraceFile;
+    static std::unique_ptr<NrTraceWriter> m_rxPacketTraceWriter;
     static std::string m_rxPacketTraceFilename;
 
+    /**
+     * @brief File of the UL SINR trace of a UE, kept open during the simulation
+     */
+    struct UlSinrTraceFile
+    {
+        std::vector<char> m_buffer;              //!< Buffer of the text file
+        std::ofstream m_text;                    //!< Text file, in the TEXT format
+        std::unique_ptr<NrTraceWriter> m_writer; //!< Writer, in the BINARY format
+        std::vector<double> m_sinrDb;            //!< SINR of the RBs of the current row
+    };
+
+    /// Files of the UL SINR trace, per IMSI
+    static std::unordered_map<uint64_t, std::unique_ptr<UlSinrTraceFile>> m_ulSinrFiles;
+
     static std::ofstream m_rxedGnbPhyCtrlMsgsFile;
     static std::string m_rxedGnbPhyCtrlMsgsFileName;
     static std::ofstream m_txedGnbPhyCtrlMsgsFile;
@@ -7,11 +7,14 @@
 #include "nr-spectrum-value-helper.h"
 
 #include "ns3/abort.h"
+#include "ns3/beam-manager.h"
 #include "ns3/beamforming-vector.h"
+#include "ns3/boolean.h"
 #include "ns3/buildings-module.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/enum.h"
+#include "ns3/integer.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/node.h"
@@ -26,6 +29,7 @@
 
 #include <fstream>
 #include <limits>
+#include <thread>
 
 namespace ns3
 {
@@ -151,7 +155,34 @@ NrRadioEnvironmentMapHelper::GetTypeId()
                 "depends on RRC message timing.",
                 TimeValue(MilliSeconds(100)),
                 MakeTimeAccessor(&NrRadioEnvironmentMapHelper::SetInstallationDelay),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("NumThreads",
+                          "The number of threads that compute the REM points. "
+                          "If 0, one thread per hardware thread is used. The REM map "
+                          "is the same for any number of threads.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&NrRadioEnvironmentMapHelper::SetNumThreads,
+                                               &NrRadioEnvironmentMapHelper::GetNumThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("StreamBase",
+                          "The first RNG stream assigned to the propagation models of the "
+                          "REM. Each REM point uses its own block of consecutive streams, "
+                          "after the ones of the previous REM points. The default value "
+                          "is far from the streams usually assigned by the scenarios.",
+                          IntegerValue(int64_t(1) << 62),
+                          MakeIntegerAccessor(&NrRadioEnvironmentMapHelper::SetStreamBase,
+                                              &NrRadioEnvironmentMapHelper::GetStreamBase),
+                          MakeIntegerChecker<int64_t>(0))
+            .AddAttribute("ReuseRtdChannels",
+                          "If true, in CoverageArea mode the pathloss and the channel between "
+                          "each RTD and a REM point are computed once per iteration, and reused "
+                          "for all the beams of the RRD, of which only the beamforming gain is "
+                          "computed. If false, they are computed again for each beam of the "
+                          "RRD. The REM map is the same in both cases.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&NrRadioEnvironmentMapHelper::SetReuseRtdChannels,
+                                              &NrRadioEnvironmentMapHelper::GetReuseRtdChannels),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -221,6 +252,24 @@ NrRadioEnvironmentMapHelper::SetInstallationDelay(const Time& installationDelay)
     m_installationDelay = installationDelay;
 }
 
+void
+NrRadioEnvironmentMapHelper::SetNumThreads(uint32_t numThreads)
+{
+    m_numThreads = numThreads;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetStreamBase(int64_t streamBase)
+{
+    m_streamBase = streamBase;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetReuseRtdChannels(bool reuseRtdChannels)
+{
+    m_reuseRtdChannels = reuseRtdChannels;
+}
+
 NrRadioEnvironmentMapHelper::RemMode
 NrRadioEnvironmentMapHelper::GetRemMode() const
 {
@@ -269,6 +318,24 @@ NrRadioEnvironmentMapHelper::GetZ() const
     return m_z;
 }
 
+uint32_t
+NrRadioEnvironmentMapHelper::GetNumThreads() const
+{
+    return m_numThreads;
+}
+
+int64_t
+NrRadioEnvironmentMapHelper::GetStreamBase() const
+{
+    return m_streamBase;
+}
+
+bool
+NrRadioEnvironmentMapHelper::GetReuseRtdChannels() const
+{
+    return m_reuseRtdChannels;
+}
+
 double
 NrRadioEnvironmentMapHelper::DbmToW(double dBm) const
 {
@@ -312,9 +379,6 @@ NrRadioEnvironmentMapHelper::ConfigureRrd(const Ptr<NetDevice>& rrdDevice)
 
     m_rrd.antenna = m_deviceToAntenna.find(rrdDevice)->second;
 
-    m_noisePsd = NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(m_rrdPhy->GetNoiseFigure(),
-                                                                        m_rrd.spectrumModel);
-
     ConfigurePropagationModelsFactories(
         m_rrdPhy); // we can call only once configuration of prop.models
 }
@@ -672,7 +736,7 @@ NrRadioEnvironmentMapHelper::ConfigureQuasiOmniBfv(RemDevice& device)
     device.antenna->GetAttribute("NumRows", numRows);
     device.antenna->GetAttribute("NumColumns", numColumns);
     // configure RRD antenna to have quasi omni beamforming vector
-    device.antenna->SetBeamformingVector(CreateQuasiOmniBfv(device.antenna));
+    device.antenna->SetBeamformingVector(BeamManager::GetQuasiOmniBfv(device.antenna));
 }
 
 void
@@ -685,9 +749,29 @@ NrRadioEnvironmentMapHelper::ConfigureDirectPathBfv(RemDevice& device,
 }
 
 Ptr<SpectrumValue>
-NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const
+NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device,
+                                            RemDevice& otherDevice,
+                                            RemContext& ctx) const
+{
+    RemChannel channel = CreateRemChannel(device, otherDevice, ctx);
+    Ptr<SpectrumValue> rxPsd = CalcBeamformedRxPsd(channel, device, otherDevice);
+    ReleaseRemChannel(channel);
+    return rxPsd;
+}
+
+NrRadioEnvironmentMapHelper::RemChannel
+NrRadioEnvironmentMapHelper::CreateRemChannel(RemDevice& device,
+                                              RemDevice& otherDevice,
+                                              RemContext& ctx) const
 {
-    PropagationModels tempPropModels = CreateTemporalPropagationModels();
+    RemChannel channel;
+    {
+        // The creation of ns-3 objects is not thread safe
+        std::lock_guard<std::mutex> lock(m_modelsMutex);
+        channel.propModels = CreateTemporalPropagationModels();
+        ctx.nextStream += AssignStreams(channel.propModels, ctx.nextStream);
+    }
+    NS_ASSERT_MSG(ctx.nextStream <= ctx.endStream, "RNG streams of the REM point exhausted");
 
     std::vector<int> activeRbs(device.spectrumModel->GetNumBands());
     std::iota(activeRbs.begin(), activeRbs.end(), 0);
@@ -718,40 +802,59 @@ NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherD
     }
 
     // Copy TX PSD to RX PSD, they are now equal rxPsd == txPsd
-    Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
-    rxParams->psd = convertedTxPsd->Copy();
+    channel.pathLossRxPsd = convertedTxPsd->Copy();
     double pathLossDb =
-        tempPropModels.remPropagationLossModelCopy->CalcRxPower(0, device.mob, otherDevice.mob);
+        channel.propModels.remPropagationLossModelCopy->CalcRxPower(0, device.mob, otherDevice.mob);
     double pathGainLinear = DbToRatio(pathLossDb);
 
     NS_LOG_DEBUG("Tx power in dBm:" << WToDbm(Integral(*convertedTxPsd)));
     NS_LOG_DEBUG("PathlosDb:" << pathLossDb);
 
     // Apply now calculated pathloss to rxPsd, now rxPsd < txPsd because we had some losses
-    *(rxParams->psd) *= pathGainLinear;
+    *(channel.pathLossRxPsd) *= pathGainLinear;
+
+    NS_LOG_DEBUG("RX power in dBm after pathloss:" << WToDbm(Integral(*channel.pathLossRxPsd)));
+    return channel;
+}
 
-    NS_LOG_DEBUG("RX power in dBm after pathloss:" << WToDbm(Integral(*(rxParams->psd))));
+Ptr<SpectrumValue>
+NrRadioEnvironmentMapHelper::CalcBeamformedRxPsd(const RemChannel& channel,
+                                                 RemDevice& device,
+                                                 RemDevice& otherDevice) const
+{
+    // The signal parameters are not an ns-3 Object, and they only point to the PSD, antennas
+    // and channel of this thread, so they are created and destroyed without m_modelsMutex
+    Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
+    rxParams->psd = channel.pathLossRxPsd->Copy();
 
-    // Now we call spectrum model, which in this keys add a beamforming gain
-    rxParams =
-        tempPropModels.remSpectrumLossModelCopy->DoCalcRxPowerSpectralDensity(rxParams,
-                                                                              device.mob,
-                                                                              otherDevice.mob,
-                                                                              device.antenna,
-                                                                              otherDevice.antenna);
+    // Now we call spectrum model, which in this keys add a beamforming gain. The channel
+    // matrix is generated by the first call, and reused by the next ones.
+    rxParams = channel.propModels.remSpectrumLossModelCopy->DoCalcRxPowerSpectralDensity(
+        rxParams,
+        device.mob,
+        otherDevice.mob,
+        device.antenna,
+        otherDevice.antenna);
 
     NS_LOG_DEBUG("RX power in dBm after fading: " << WToDbm(Integral(*(rxParams->psd))));
 
     return rxParams->psd;
 }
 
+void
+NrRadioEnvironmentMapHelper::ReleaseRemChannel(RemChannel& channel) const
+{
+    std::lock_guard<std::mutex> lock(m_modelsMutex);
+    channel = RemChannel();
+}
+
 Ptr<SpectrumValue>
 NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<Ptr<SpectrumValue>>& values) const
 {
     // TODO add this abort, if necessary add include for abort.h
     NS_ABORT_MSG_IF(values.empty(), "Must provide a list of values.");
 
-    Ptr<SpectrumValue> maxValue = Create<SpectrumValue>(m_rrd.spectrumModel);
+    Ptr<SpectrumValue> maxValue = Create<SpectrumValue>(values.front()->GetSpectrumModel());
     *maxValue = **(values.begin());
 
     for (const auto& value : values)
@@ -765,36 +868,37 @@ NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<Ptr<SpectrumValue>>& va
 }
 
 double
-NrRadioEnvironmentMapHelper::CalculateMaxSnr(
-    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
+NrRadioEnvironmentMapHelper::CalculateMaxSnr(const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+                                             const Ptr<const SpectrumValue>& noisePsd) const
 {
     Ptr<SpectrumValue> maxSnr = GetMaxValue(receivedPowerList);
-    SpectrumValue snr = (*maxSnr) / (*m_noisePsd);
+    SpectrumValue snr = (*maxSnr) / (*noisePsd);
     return RatioToDb(Sum(snr) / snr.GetSpectrumModel()->GetNumBands());
 }
 
 double
-NrRadioEnvironmentMapHelper::CalculateSnr(const Ptr<SpectrumValue>& usefulSignal) const
+NrRadioEnvironmentMapHelper::CalculateSnr(const Ptr<SpectrumValue>& usefulSignal,
+                                          const Ptr<const SpectrumValue>& noisePsd) const
 {
-    SpectrumValue snr = (*usefulSignal) / (*m_noisePsd);
+    SpectrumValue snr = (*usefulSignal) / (*noisePsd);
 
     return RatioToDb(Sum(snr) / snr.GetSpectrumModel()->GetNumBands());
 }
 
 double
-NrRadioEnvironmentMapHelper::CalculateSinr(
-    const Ptr<SpectrumValue>& usefulSignal,
-    const std::list<Ptr<SpectrumValue>>& interferenceSignals) const
+NrRadioEnvironmentMapHelper::CalculateSinr(const Ptr<SpectrumValue>& usefulSignal,
+                                           const std::list<Ptr<SpectrumValue>>& interferenceSignals,
+                                           const Ptr<const SpectrumValue>& noisePsd) const
 {
     Ptr<SpectrumValue> interferencePsd = nullptr;
 
     if (interferenceSignals.empty())
     {
-        return CalculateSnr(usefulSignal);
+        return CalculateSnr(usefulSignal, noisePsd);
     }
     else
     {
-        interferencePsd = Create<SpectrumValue>(m_rrd.spectrumModel);
+        interferencePsd = Create<SpectrumValue>(usefulSignal->GetSpectrumModel());
     }
 
     // sum all interfering signals
@@ -804,7 +908,7 @@ NrRadioEnvironmentMapHelper::CalculateSinr(
     }
     // calculate sinr
 
-    SpectrumValue sinr = (*usefulSignal) / (*interferencePsd + *m_noisePsd);
+    SpectrumValue sinr = (*usefulSignal) / (*interferencePsd + *noisePsd);
 
     // calculate average sinr over RBs, convert it from linear to dB units, and return it
     return RatioToDb(Sum(sinr) / sinr.GetSpectrumModel()->GetNumBands());
@@ -825,7 +929,7 @@ NrRadioEnvironmentMapHelper::CalculateSir(
     }
     else
     {
-        interferencePsd = Create<SpectrumValue>(m_rrd.spectrumModel);
+        interferencePsd = Create<SpectrumValue>(usefulSignal->GetSpectrumModel());
     }
 
     // sum all interfering signals
@@ -843,7 +947,8 @@ NrRadioEnvironmentMapHelper::CalculateSir(
 
 double
 NrRadioEnvironmentMapHelper::CalculateMaxSinr(
-    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
+    const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+    const Ptr<const SpectrumValue>& noisePsd) const
 {
     // we calculate sinr considering for each RTD as if it would be TX device, and the rest of RTDs
     // interferers
@@ -862,7 +967,7 @@ NrRadioEnvironmentMapHelper::CalculateMaxSinr(
 
         interferenceSignals.insert(interferenceSignals.end(), ++tempit, receivedPowerList.end());
         NS_ASSERT(interferenceSignals.size() == receivedPowerList.size() - 1);
-        sinrList.push_back(CalculateSinr(*it, interferenceSignals));
+        sinrList.push_back(CalculateSinr(*it, interferenceSignals, noisePsd));
     }
     return GetMaxValue(sinrList);
 }
@@ -897,66 +1002,125 @@ void
 NrRadioEnvironmentMapHelper::CalcBeamShapeRemMap()
 {
     NS_LOG_FUNCTION(this);
+    CalcRemMap(&NrRadioEnvironmentMapHelper::CalcBeamShapeRemPoint,
+               m_numOfIterationsToAverage * m_remDev.size());
+}
 
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+void
+NrRadioEnvironmentMapHelper::CalcBeamShapeRemPoint(RemPoint& remPoint, RemContext& ctx)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    double sumSir = 0.0;
+    std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
+                                       // each Iteration (linear)
+    ctx.rrd.mob->SetPosition(remPoint.pos);
 
-    for (auto itRemPoint = m_rem.begin(); itRemPoint != m_rem.end(); ++itRemPoint)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        double sumSir = 0.0;
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
-        m_rrd.mob->SetPosition(itRemPoint->pos);
-
-        Ptr<MobilityBuildingInfo> buildingInfo = m_rrd.mob->GetObject<MobilityBuildingInfo>();
-        buildingInfo->MakeConsistent(m_rrd.mob);
+        // The buildings are shared by all the threads
+        std::lock_guard<std::mutex> lock(m_modelsMutex);
+        Ptr<MobilityBuildingInfo> buildingInfo = ctx.rrd.mob->GetObject<MobilityBuildingInfo>();
         NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
+        buildingInfo->MakeConsistent(ctx.rrd.mob);
+    }
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        std::list<Ptr<SpectrumValue>>
+            receivedPowerList; // RTD node id, rxPsd of the signal coming from that node
+
+        for (auto& itRtd : ctx.remDev)
         {
-            std::list<Ptr<SpectrumValue>>
-                receivedPowerList; // RTD node id, rxPsd of the signal coming from that node
+            // calculate received power from the current RTD device
+            receivedPowerList.push_back(CalcRxPsdValue(itRtd, ctx.rrd, ctx));
+        } // end for std::list<RemDev>::iterator  (RTDs)
 
-            for (auto& itRtd : m_remDev)
-            {
-                // calculate received power from the current RTD device
-                receivedPowerList.push_back(CalcRxPsdValue(itRtd, m_rrd));
-            } // end for std::list<RemDev>::iterator  (RTDs)
+        sumSnr += CalculateMaxSnr(receivedPowerList, ctx.noisePsd);
+        sumSinr += CalculateMaxSinr(receivedPowerList, ctx.noisePsd);
+        sumSir += CalculateMaxSir(receivedPowerList);
+
+        // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
+        // Iteration (linear)
+        rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
+
+        receivedPowerList.clear();
+    } // end for m_numOfIterationsToAverage  (Average)
+
+    // Sum the rxPower for all the Iterations (linear)
+    double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
+    // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+    remPoint.avRxPowerDbm = WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+
+    NS_LOG_INFO("Avg snr value saved:" << remPoint.avgSnrDb);
+    NS_LOG_INFO("Avg sinr value saved:" << remPoint.avgSinrDb);
+    NS_LOG_INFO("Avg ipsd value saved (dBm):" << remPoint.avRxPowerDbm);
+}
+
+void
+NrRadioEnvironmentMapHelper::CalcRemMap(CalcRemPointFunction calcRemPoint,
+                                        uint32_t numRxPsdPerPoint)
+{
+    NS_LOG_FUNCTION(this);
 
-            sumSnr += CalculateMaxSnr(receivedPowerList);
-            sumSinr += CalculateMaxSinr(receivedPowerList);
-            sumSir += CalculateMaxSir(receivedPowerList);
+    std::vector<RemPoint*> remPoints;
+    remPoints.reserve(m_rem.size());
+    for (auto& remPoint : m_rem)
+    {
+        remPoints.push_back(&remPoint);
+    }
 
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
+    uint32_t numThreads = m_numThreads;
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    numThreads = std::max<size_t>(std::min<size_t>(numThreads, remPoints.size()), 1);
 
-            receivedPowerList.clear();
-        } // end for m_numOfIterationsToAverage  (Average)
+    // Each REM point has its own block of RNG streams, so that its values do not depend
+    // on the thread that computes it, nor on the points computed before by that thread
+    int64_t streamsPerRxPsd = AssignStreams(CreateTemporalPropagationModels(), m_streamBase);
+    int64_t streamsPerPoint = streamsPerRxPsd * numRxPsdPerPoint;
 
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+    std::vector<RemContext> contexts;
+    contexts.reserve(numThreads);
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        contexts.push_back(CreateRemContext());
+    }
 
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+    NS_LOG_INFO("Computing " << remPoints.size() << " REM points with " << numThreads
+                             << " threads");
 
-        NS_LOG_INFO("Avg snr value saved:" << itRemPoint->avgSnrDb);
-        NS_LOG_INFO("Avg sinr value saved:" << itRemPoint->avgSinrDb);
-        NS_LOG_INFO("Avg ipsd value saved (dBm):" << itRemPoint->avRxPowerDbm);
+    m_remPointsDone = 0;
+    m_remSizeNextReport = m_rem.size() / 100;
+    std::atomic<size_t> nextRemPoint{0};
 
-        if (++remPointCounter == remSizeNextReport)
+    auto worker = [&](RemContext& ctx) {
+        for (size_t i = nextRemPoint++; i < remPoints.size(); i = nextRemPoint++)
         {
-            PrintProgressReport(&remSizeNextReport);
+            ctx.nextStream = m_streamBase + static_cast<int64_t>(i) * streamsPerPoint;
+            ctx.endStream = ctx.nextStream + streamsPerPoint;
+            ctx.streamsPerRxPsd = streamsPerRxPsd;
+            (this->*calcRemPoint)(*remPoints[i], ctx);
+            NotifyRemPointDone();
         }
+    };
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < numThreads; ++i)
+    {
+        threads.emplace_back(worker, std::ref(contexts[i]));
+    }
+    worker(contexts[0]);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
 
     auto remEndTime = std::chrono::system_clock::now();
     std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
@@ -964,6 +1128,77 @@ NrRadioEnvironmentMapHelper::CalcBeamShapeRemMap()
                 << remElapsedSeconds.count() / 60 << " minutes.");
 }
 
+NrRadioEnvironmentMapHelper::RemContext
+NrRadioEnvironmentMapHelper::CreateRemContext() const
+{
+    NS_LOG_FUNCTION(this);
+    // The RTDs and the RRD of a thread share the copies of their spectrum models
+    std::map<SpectrumModelUid_t, Ptr<const SpectrumModel>> spectrumModels;
+
+    RemContext ctx{CopyRemDevice(m_rrd, spectrumModels), {}, nullptr};
+    for (const auto& rtd : m_remDev)
+    {
+        ctx.remDev.push_back(CopyRemDevice(rtd, spectrumModels));
+    }
+    ctx.noisePsd =
+        NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(m_rrdPhy->GetNoiseFigure(),
+                                                               ctx.rrd.spectrumModel);
+    return ctx;
+}
+
+NrRadioEnvironmentMapHelper::RemDevice
+NrRadioEnvironmentMapHelper::CopyRemDevice(
+    const RemDevice& device,
+    std::map<SpectrumModelUid_t, Ptr<const SpectrumModel>>& spectrumModels) const
+{
+    NS_LOG_FUNCTION(this);
+    RemDevice copy;
+    copy.mob->SetPosition(device.mob->GetPosition());
+    if (device.mob->GetObject<MobilityBuildingInfo>())
+    {
+        copy.mob->AggregateObject(CreateObject<MobilityBuildingInfo>());
+    }
+
+    // The reference counts of ns-3 objects are not thread safe, so the threads
+    // cannot share the antenna element, nor the spectrum model
+    copy.antenna = Copy(device.antenna);
+    PointerValue antennaElement;
+    device.antenna->GetAttribute("AntennaElement", antennaElement);
+    ObjectFactory antennaElementFactory =
+        ConfigureObjectFactory(antennaElement.Get<AntennaModel>());
+    copy.antenna->SetAttribute("AntennaElement",
+                               PointerValue(antennaElementFactory.Create<AntennaModel>()));
+
+    auto spectrumModel = spectrumModels.find(device.spectrumModel->GetUid());
+    if (spectrumModel == spectrumModels.end())
+    {
+        Bands bands(device.spectrumModel->Begin(), device.spectrumModel->End());
+        spectrumModel =
+            spectrumModels.emplace(device.spectrumModel->GetUid(), Create<SpectrumModel>(bands))
+                .first;
+    }
+    copy.spectrumModel = spectrumModel->second;
+
+    copy.txPower = device.txPower;
+    copy.bandwidth = device.bandwidth;
+    copy.frequency = device.frequency;
+    copy.numerology = device.numerology;
+    return copy;
+}
+
+void
+NrRadioEnvironmentMapHelper::NotifyRemPointDone()
+{
+    uint32_t remPointsDone = ++m_remPointsDone;
+
+    std::lock_guard<std::mutex> lock(m_progressMutex);
+    // the threads may notify out of order, so a report may be printed late
+    while (m_remSizeNextReport > 0 && remPointsDone >= m_remSizeNextReport)
+    {
+        PrintProgressReport(&m_remSizeNextReport);
+    }
+}
+
 double
 NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<double>& listOfValues) const
 {
@@ -987,8 +1222,10 @@ double
 NrRadioEnvironmentMapHelper::CalculateAggregatedIpsd(
     const std::list<Ptr<SpectrumValue>>& receivedSignals)
 {
+    NS_ABORT_MSG_IF(receivedSignals.empty(), "Must provide a list of received signals.");
+
     Ptr<SpectrumValue> sumRxPowers = nullptr;
-    sumRxPowers = Create<SpectrumValue>(m_rrd.spectrumModel);
+    sumRxPowers = Create<SpectrumValue>(receivedSignals.front()->GetSpectrumModel());
 
     // sum the received power of all the rtds
     for (auto rxPowersIt : receivedSignals)
@@ -1021,126 +1258,146 @@ void
 NrRadioEnvironmentMapHelper::CalcCoverageAreaRemMap()
 {
     NS_LOG_FUNCTION(this);
-    uint16_t calcRxPsdCounter = 0;
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+    CalcRemMap(&NrRadioEnvironmentMapHelper::CalcCoverageAreaRemPoint,
+               m_numOfIterationsToAverage * m_remDev.size());
+}
 
-    for (auto itRemPoint = m_rem.begin(); itRemPoint != m_rem.end(); ++itRemPoint)
+void
+NrRadioEnvironmentMapHelper::CalcCoverageAreaRemPoint(RemPoint& remPoint, RemContext& ctx)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    ctx.rrd.mob->SetPosition(remPoint.pos);
+
+    // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
+    // worst-case scenario
+    for (auto& itRtd : ctx.remDev)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint->pos);
-
-        // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
-        // worst-case scenario
-        for (auto& itRtd : m_remDev)
-        {
-            ConfigureDirectPathBfv(itRtd, m_rrd, itRtd.antenna);
-        }
+        ConfigureDirectPathBfv(itRtd, ctx.rrd, itRtd.antenna);
+    }
 
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
+    std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
+                                       // each Iteration (linear)
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    // In each iteration, the channel between an RTD and the RemPoint is the same for all the
+    // beams of the RRD, so each RTD has its own block of RNG streams in each iteration
+    const int64_t pointStream = ctx.nextStream;
+    const auto numRtds = static_cast<int64_t>(ctx.remDev.size());
+
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
+        std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+
+        std::list<Ptr<SpectrumValue>> rxPsdsList; // vector in which we will save the sum of
+                                                  // rxPowers per remPoint (linear)
+
+        const int64_t iterationStream = pointStream + i * numRtds * ctx.streamsPerRxPsd;
+
+        // The pathloss, shadowing, channel condition and channel matrix of each RTD do not
+        // depend on the RRD beam, so they are computed once per iteration if
+        // ReuseRtdChannels is set, and only the beamforming gain is computed for each beam
+        std::vector<RemChannel> rtdChannels;
+        if (m_reuseRtdChannels)
         {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+            rtdChannels.reserve(ctx.remDev.size());
+            for (auto& itRtd : ctx.remDev)
+            {
+                auto rtdIndex = static_cast<int64_t>(rtdChannels.size());
+                ctx.nextStream = iterationStream + rtdIndex * ctx.streamsPerRxPsd;
+                rtdChannels.push_back(CreateRemChannel(itRtd, ctx.rrd, ctx));
+            }
+        }
 
-            std::list<Ptr<SpectrumValue>> rxPsdsList; // vector in which we will save the sum of
-                                                      // rxPowers per remPoint (linear)
+        auto calcRxPsd = [&](RemDevice& rtd, size_t rtdIndex) {
+            if (m_reuseRtdChannels)
+            {
+                return CalcBeamformedRxPsd(rtdChannels[rtdIndex], rtd, ctx.rrd);
+            }
+            ctx.nextStream = iterationStream + static_cast<int64_t>(rtdIndex) * ctx.streamsPerRxPsd;
+            return CalcRxPsdValue(rtd, ctx.rrd, ctx);
+        };
 
-            // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
-            // many beam configurations at RemPoint as many RTDs
-            for (auto itRtdBeam = m_remDev.begin(); itRtdBeam != m_remDev.end(); ++itRtdBeam)
+        // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
+        // many beam configurations at RemPoint as many RTDs
+        size_t beamIndex = 0;
+        for (auto itRtdBeam = ctx.remDev.begin(); itRtdBeam != ctx.remDev.end();
+             ++itRtdBeam, ++beamIndex)
+        {
+            // configure RRD beam toward RTD
+            ConfigureDirectPathBfv(ctx.rrd, *itRtdBeam, ctx.rrd.antenna);
+
+            // Calculate the received power from this RTD for this RemPoint
+            Ptr<SpectrumValue> receivedPowerFromRtd = calcRxPsd(*itRtdBeam, beamIndex);
+            // and put it to the list of the received powers for this RemPoint (to sum all
+            // later)
+            rxPsdsList.push_back(receivedPowerFromRtd);
+
+            NS_LOG_DEBUG("beam node: " << itRtdBeam->dev->GetNode()->GetId()
+                                       << " is Rxed in RemPoint with Rx Power in W: "
+                                       << (Integral(*receivedPowerFromRtd)));
+            NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*receivedPowerFromRtd)));
+
+            std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
+            Ptr<SpectrumValue> usefulSignalRxPsd;
+
+            // For this configuration of beam at RRD, we need to calculate RX PSD,
+            // and in order to be able to calculate SINR for that beam,
+            // we need to calculate received PSD for each RTD using this beam at RRD
+            size_t calcIndex = 0;
+            for (auto& itRtdCalc : ctx.remDev)
             {
-                // configure RRD beam toward RTD
-                ConfigureDirectPathBfv(m_rrd, *itRtdBeam, m_rrd.antenna);
-
-                // Calculate the received power from this RTD for this RemPoint
-                Ptr<SpectrumValue> receivedPowerFromRtd = CalcRxPsdValue(*itRtdBeam, m_rrd);
-                // and put it to the list of the received powers for this RemPoint (to sum all
-                // later)
-                rxPsdsList.push_back(receivedPowerFromRtd);
-
-                NS_LOG_DEBUG("beam node: " << itRtdBeam->dev->GetNode()->GetId()
-                                           << " is Rxed in RemPoint with Rx Power in W: "
-                                           << (Integral(*receivedPowerFromRtd)));
-                NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*receivedPowerFromRtd)));
-
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
-
-                // For this configuration of beam at RRD, we need to calculate RX PSD,
-                // and in order to be able to calculate SINR for that beam,
-                // we need to calculate received PSD for each RTD using this beam at RRD
-                for (auto& itRtdCalc : m_remDev)
-                {
-                    // increase counter de calcRXPsd calls
-                    calcRxPsdCounter++;
-                    // calculate received power from the current RTD device
-                    Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(itRtdCalc, m_rrd);
+                // calculate received power from the current RTD device
+                Ptr<SpectrumValue> receivedPower = calcRxPsd(itRtdCalc, calcIndex++);
 
-                    // is this received power useful signal (from RTD for which I configured my
-                    // beam) or is interference signal
+                // is this received power useful signal (from RTD for which I configured my
+                // beam) or is interference signal
 
-                    if (itRtdBeam->dev->GetNode()->GetId() == itRtdCalc.dev->GetNode()->GetId())
-                    {
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
-                    }
-                    else
+                if (itRtdBeam->dev->GetNode()->GetId() == itRtdCalc.dev->GetNode()->GetId())
+                {
+                    if (usefulSignalRxPsd != nullptr)
                     {
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                        NS_FATAL_ERROR("Already assigned usefulSignal!");
                     }
+                    usefulSignalRxPsd = receivedPower;
+                }
+                else
+                {
+                    interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                }
 
-                } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
-
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
-
-                NS_LOG_INFO("Done:" << (double)calcRxPsdCounter /
-                                           (m_rem.size() * m_numOfIterationsToAverage *
-                                            m_remDev.size() * m_remDev.size()) *
-                                           100
-                                    << " %."); // how many times will be called CalcRxPsdValues
-
-            } // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
+            } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
 
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
+            sinrsPerBeam.push_back(
+                CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds, ctx.noisePsd));
+            snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd, ctx.noisePsd));
 
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
+        } // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
 
-        } // end for m_numOfIterationsToAverage  (Average)
+        for (auto& rtdChannel : rtdChannels)
+        {
+            ReleaseRemChannel(rtdChannel);
+        }
 
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+        sumSnr += GetMaxValue(snrsPerBeam);
+        sumSinr += GetMaxValue(sinrsPerBeam);
 
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+        // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
+        // Iteration (linear)
+        rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
 
-        if (++remPointCounter == remSizeNextReport)
-        {
-            PrintProgressReport(&remSizeNextReport);
-        }
+    } // end for m_numOfIterationsToAverage  (Average)
 
-        NS_LOG_DEBUG("itRemPoint->avRxPowerDb  in dB: " << itRemPoint->avRxPowerDbm);
+    // Sum the rxPower for all the Iterations (linear)
+    double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+    remPoint.avRxPowerDbm = WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
 
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+    NS_LOG_DEBUG("remPoint.avRxPowerDb  in dB: " << remPoint.avRxPowerDbm);
 }
 
 void
@@ -1170,86 +1427,77 @@ void
 NrRadioEnvironmentMapHelper::CalcUeCoverageRemMap()
 {
     NS_LOG_FUNCTION(this);
+    CalcRemMap(&NrRadioEnvironmentMapHelper::CalcUeCoverageRemPoint,
+               m_numOfIterationsToAverage * m_remDev.size() * m_remDev.size());
+}
 
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+void
+NrRadioEnvironmentMapHelper::CalcUeCoverageRemPoint(RemPoint& remPoint, RemContext& ctx)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    ctx.rrd.mob->SetPosition(remPoint.pos);
 
-    for (auto& itRemPoint : m_rem)
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint.pos);
+        std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
+        std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+        //"Associate" UE (RemPoint) with this RTD
+        for (auto& itRtdAssociated : ctx.remDev)
         {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+            // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
+            ConfigureDirectPathBfv(ctx.rrd, itRtdAssociated, ctx.rrd.antenna);
+            // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
+            ConfigureDirectPathBfv(itRtdAssociated, ctx.rrd, itRtdAssociated.antenna);
 
-            //"Associate" UE (RemPoint) with this RTD
-            for (auto& itRtdAssociated : m_remDev)
-            {
-                // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
-                ConfigureDirectPathBfv(m_rrd, itRtdAssociated, m_rrd.antenna);
-                // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
-                ConfigureDirectPathBfv(itRtdAssociated, m_rrd, itRtdAssociated.antenna);
-
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
+            std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
+            Ptr<SpectrumValue> usefulSignalRxPsd;
 
-                for (auto& itRtdInterferer : m_remDev)
+            for (auto& itRtdInterferer : ctx.remDev)
+            {
+                if (itRtdAssociated.dev->GetNode()->GetId() !=
+                    itRtdInterferer.dev->GetNode()->GetId())
                 {
-                    if (itRtdAssociated.dev->GetNode()->GetId() !=
-                        itRtdInterferer.dev->GetNode()->GetId())
-                    {
-                        // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
-                        ConfigureDirectPathBfv(itRtdInterferer,
-                                               itRtdAssociated,
-                                               itRtdInterferer.antenna);
+                    // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
+                    ConfigureDirectPathBfv(itRtdInterferer,
+                                           itRtdAssociated,
+                                           itRtdInterferer.antenna);
 
-                        // calculate received power (interference) from the current RTD device
-                        Ptr<SpectrumValue> receivedPower =
-                            CalcRxPsdValue(itRtdInterferer, itRtdAssociated);
+                    // calculate received power (interference) from the current RTD device
+                    Ptr<SpectrumValue> receivedPower =
+                        CalcRxPsdValue(itRtdInterferer, itRtdAssociated, ctx);
 
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
-                    }
-                    else
+                    interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                }
+                else
+                {
+                    // calculate received power (useful Signal) from the current RRD device
+                    Ptr<SpectrumValue> receivedPower =
+                        CalcRxPsdValue(ctx.rrd, itRtdAssociated, ctx);
+                    if (usefulSignalRxPsd != nullptr)
                     {
-                        // calculate received power (useful Signal) from the current RRD device
-                        Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(m_rrd, itRtdAssociated);
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
+                        NS_FATAL_ERROR("Already assigned usefulSignal!");
                     }
+                    usefulSignalRxPsd = receivedPower;
+                }
 
-                } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
-
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
-
-            } // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
+            } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
 
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
+            sinrsPerBeam.push_back(
+                CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds, ctx.noisePsd));
+            snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd, ctx.noisePsd));
 
-        } // end for m_numOfIterationsToAverage  (Average)
+        } // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
 
-        itRemPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+        sumSnr += GetMaxValue(snrsPerBeam);
+        sumSinr += GetMaxValue(sinrsPerBeam);
 
-        if (++remPointCounter == remSizeNextReport)
-        {
-            PrintProgressReport(&remSizeNextReport);
-        }
+    } // end for m_numOfIterationsToAverage  (Average)
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
-
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
 }
 
 NrRadioEnvironmentMapHelper::PropagationModels
@@ -1267,6 +1515,7 @@ NrRadioEnvironmentMapHelper::CreateTemporalPropagationModels() const
     propModels.remPropagationLossModelCopy =
         propLossModelFactory.Create<ThreeGppPropagationLossModel>();
     propModels.remPropagationLossModelCopy->SetChannelConditionModel(condModelCopy);
+    propModels.remChannelConditionModelCopy = condModelCopy;
 
     // create rem copy of spectrum loss model
     ObjectFactory spectrumLossModelFactory = ConfigureObjectFactory(m_phasedArraySpectrumLossModel);
@@ -1278,10 +1527,27 @@ NrRadioEnvironmentMapHelper::CreateTemporalPropagationModels() const
         spectrumLossModelFactory.Set("ChannelModel", PointerValue(channelModelCopy));
         propModels.remSpectrumLossModelCopy =
             spectrumLossModelFactory.Create<ThreeGppSpectrumPropagationLossModel>();
+        propModels.remChannelModelCopy = channelModelCopy;
     }
     return propModels;
 }
 
+int64_t
+NrRadioEnvironmentMapHelper::AssignStreams(const PropagationModels& models, int64_t stream)
+{
+    int64_t currentStream = stream;
+    currentStream += models.remPropagationLossModelCopy->AssignStreams(currentStream);
+    if (models.remChannelConditionModelCopy)
+    {
+        currentStream += models.remChannelConditionModelCopy->AssignStreams(currentStream);
+    }
+    if (models.remChannelModelCopy)
+    {
+        currentStream += models.remChannelModelCopy->AssignStreams(currentStream);
+    }
+    return currentStream - stream;
+}
+
 void
 NrRadioEnvironmentMapHelper::PrintGnuplottableGnbListToFile(const std::string& filename)
 {
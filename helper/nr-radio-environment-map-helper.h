@@ -14,8 +14,10 @@
 #include "ns3/three-gpp-propagation-loss-model.h"
 #include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 
+#include <atomic>
 #include <chrono>
 #include <fstream>
+#include <mutex>
 
 namespace ns3
 {
@@ -27,6 +29,8 @@ class MobilityModel;
 class MobilityHelper;
 class ChannelConditionModel;
 class UniformPlanarArray;
+class NrRemCoverageAreaTestCase;
+class NrRemNumThreadsTestCase;
 
 /**
  * @brief Generate a radio environment map
@@ -80,6 +84,20 @@ $  remHelper->CreateRem (gnbNetDev, ueRemDevice, indexPhy);
  * Please refer to the rest parameters of the REM map that can be set
  * through the command line (e.g. x, y, z coordinates and resolution)
  *
+ * The REM points can be computed in parallel, by setting the attribute NumThreads.
+ * Each thread works on its own copies of the RTDs and the RRD (nodes, antennas and
+ * spectrum models), and takes the next REM point to compute until all of them are
+ * done. The random variables of the propagation models created for a REM point use
+ * a block of RNG streams reserved for that point (starting at the attribute
+ * StreamBase), so the map does not depend on the number of threads.
+ * In CoverageArea mode, the pathloss and the channel matrix between each RTD and a
+ * REM point are computed once per iteration and reused for all the beams of the RRD
+ * (attribute ReuseRtdChannels), so that only the beamforming gain is computed for
+ * each beam.
+ * The propagation models are created (and the building information of the RRD is
+ * updated) under a lock, but they are used concurrently afterwards, so the
+ * propagation and channel models must not share mutable state between instances.
+ *
  * The output of the NrRadioEnvironmentMapHelper are REM csv files from which
  * the REM figures can be generated with the following command:
  * \code{.unparsed}
@@ -90,6 +108,8 @@ nr-rem-SimTag-plot-rem.gnuplot \endcode
 class NrRadioEnvironmentMapHelper : public Object
 {
   public:
+    friend NrRemCoverageAreaTestCase;
+    friend NrRemNumThreadsTestCase;
     enum RemMode
     {
         BEAM_SHAPE,
@@ -183,6 +203,25 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void SetInstallationDelay(const Time& installationDelay);
 
+    /**
+     * @brief Sets the number of threads that compute the REM points
+     * @param numThreads The number of threads (0 to use one per hardware thread)
+     */
+    void SetNumThreads(uint32_t numThreads);
+
+    /**
+     * @brief Sets the first RNG stream used by the propagation models of the REM
+     * @param streamBase The first RNG stream
+     */
+    void SetStreamBase(int64_t streamBase);
+
+    /**
+     * @brief Sets whether the channels of the RTDs are reused for all the beams of
+     * the RRD, in CoverageArea mode
+     * @param reuseRtdChannels True to compute the channel of each RTD once per iteration
+     */
+    void SetReuseRtdChannels(bool reuseRtdChannels);
+
     /**
      * @brief Get the type of REM Map to be generated
      * @return The type of the map (BeamShape/CoverageArea/UeCoverage)
@@ -226,6 +265,21 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     double GetZ() const;
 
+    /**
+     * @return Gets the number of threads that compute the REM points
+     */
+    uint32_t GetNumThreads() const;
+
+    /**
+     * @return Gets the first RNG stream used by the propagation models of the REM
+     */
+    int64_t GetStreamBase() const;
+
+    /**
+     * @return Gets whether the channels of the RTDs are reused for all the beams of the RRD
+     */
+    bool GetReuseRtdChannels() const;
+
     /**
      * @brief Convert from Watts to dBm.
      * @param w the power in Watts
@@ -320,8 +374,41 @@ class NrRadioEnvironmentMapHelper : public Object
     {
         Ptr<ThreeGppPropagationLossModel> remPropagationLossModelCopy;
         Ptr<ThreeGppSpectrumPropagationLossModel> remSpectrumLossModelCopy;
+        Ptr<ChannelConditionModel> remChannelConditionModelCopy;
+        Ptr<MatrixBasedChannelModel> remChannelModelCopy;
     };
 
+    /**
+     * @brief The copies of the devices used by a thread to compute REM points,
+     * and the RNG stream to assign to the next propagation models it creates
+     */
+    struct RemContext
+    {
+        RemDevice rrd;               //!< Copy of the RRD
+        std::list<RemDevice> remDev; //!< Copies of the RTDs
+        Ptr<SpectrumValue> noisePsd; //!< Noise PSD, with the spectrum model of rrd
+        int64_t nextStream{0};       //!< Next RNG stream to assign
+        int64_t endStream{0};        //!< End of the block of RNG streams of the REM point
+        int64_t streamsPerRxPsd{0};  //!< RNG streams assigned to the models of a RemChannel
+    };
+
+    /**
+     * @brief The part of the received PSD of a device that does not depend on the
+     * beams: the propagation models, whose channel matrix is generated by the first
+     * call to CalcBeamformedRxPsd(), and the PSD received after the pathloss
+     */
+    struct RemChannel
+    {
+        PropagationModels propModels;     //!< The propagation models of the channel
+        Ptr<SpectrumValue> pathLossRxPsd; //!< The received PSD without beamforming gain
+    };
+
+    /**
+     * @brief Pointer to the function that computes the values of a REM point
+     */
+    typedef void (NrRadioEnvironmentMapHelper::*CalcRemPointFunction)(RemPoint& remPoint,
+                                                                      RemContext& ctx);
+
     /**
      * @brief This method creates the list of Rem Points (coordinates) based on
      * the min/max coprdinates and the resolution defined by the user
@@ -364,6 +451,13 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void CalcBeamShapeRemMap();
 
+    /**
+     * @brief Calculates the values of a REM point of a BeamShape map
+     * @param remPoint The REM point
+     * @param ctx The devices of the thread computing the point
+     */
+    void CalcBeamShapeRemPoint(RemPoint& remPoint, RemContext& ctx);
+
     /**
      * @brief This function generates a CoverageArea map. In this case, all the
      * antennas of the rtds are set to point towards the rem point and the antenna
@@ -371,6 +465,13 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void CalcCoverageAreaRemMap();
 
+    /**
+     * @brief Calculates the values of a REM point of a CoverageArea map
+     * @param remPoint The REM point
+     * @param ctx The devices of the thread computing the point
+     */
+    void CalcCoverageAreaRemPoint(RemPoint& remPoint, RemContext& ctx);
+
     /**
      * @brief This function generates a Ue Coverage map that depicts the SNR of
      * this UE with respect to its UL transmission towards the gNB form various
@@ -380,18 +481,86 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void CalcUeCoverageRemMap();
 
+    /**
+     * @brief Calculates the values of a REM point of a Ue Coverage map
+     * @param remPoint The REM point
+     * @param ctx The devices of the thread computing the point
+     */
+    void CalcUeCoverageRemPoint(RemPoint& remPoint, RemContext& ctx);
+
+    /**
+     * @brief Calculates the values of all the REM points, with NumThreads threads
+     * @param calcRemPoint The function that calculates the values of a REM point
+     * @param numRxPsdPerPoint The number of RemChannel created for each REM point, each
+     * one with its own RNG streams
+     */
+    void CalcRemMap(CalcRemPointFunction calcRemPoint, uint32_t numRxPsdPerPoint);
+
+    /**
+     * @brief Creates the copies of the RTDs and the RRD used by a thread
+     * @return The copies of the devices
+     */
+    RemContext CreateRemContext() const;
+
+    /**
+     * @brief Creates the copy of a device used by a thread
+     * @param device The device to copy
+     * @param spectrumModels The copies of the spectrum models used by the thread,
+     * indexed by the UID of the original spectrum model
+     * @return The copy of the device
+     */
+    RemDevice CopyRemDevice(
+        const RemDevice& device,
+        std::map<SpectrumModelUid_t, Ptr<const SpectrumModel>>& spectrumModels) const;
+
     /**
      * @brief This method calculates the PSD
+     * @param device The transmitting device
+     * @param otherDevice The receiving device
+     * @param ctx The context of the thread, whose next RNG streams are assigned to
+     * the propagation models
+     * @return The PSD (spectrumValue)
+     */
+    Ptr<SpectrumValue> CalcRxPsdValue(RemDevice& device,
+                                      RemDevice& otherDevice,
+                                      RemContext& ctx) const;
+
+    /**
+     * @brief Creates the propagation models of the channel between two devices, and
+     * computes the PSD received after the pathloss
+     * @param device The transmitting device
+     * @param otherDevice The receiving device
+     * @param ctx The context of the thread, whose next RNG streams are assigned to
+     * the propagation models
+     * @return The channel, to be released with ReleaseRemChannel()
+     */
+    RemChannel CreateRemChannel(RemDevice& device, RemDevice& otherDevice, RemContext& ctx) const;
+
+    /**
+     * @brief Calculates the received PSD of a channel, with the current beams of the devices
+     * @param channel The channel created by CreateRemChannel() for these devices
+     * @param device The transmitting device
+     * @param otherDevice The receiving device
      * @return The PSD (spectrumValue)
      */
-    Ptr<SpectrumValue> CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const;
+    Ptr<SpectrumValue> CalcBeamformedRxPsd(const RemChannel& channel,
+                                           RemDevice& device,
+                                           RemDevice& otherDevice) const;
+
+    /**
+     * @brief Destroys the propagation models of a channel
+     * @param channel The channel
+     */
+    void ReleaseRemChannel(RemChannel& channel) const;
 
     /**
      * @brief This function calculates the SNR.
      * @param usefulSignal The useful Signal
+     * @param noisePsd The noise PSD
      * @return The snr
      */
-    double CalculateSnr(const Ptr<SpectrumValue>& usefulSignal) const;
+    double CalculateSnr(const Ptr<SpectrumValue>& usefulSignal,
+                        const Ptr<const SpectrumValue>& noisePsd) const;
 
     /**
      * @brief This function finds the max value in a space of frequency-dependent
@@ -405,17 +574,21 @@ class NrRadioEnvironmentMapHelper : public Object
      * @brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
      * @param values The list of spectrumValues for which we want to find the max
+     * @param noisePsd The noise PSD
      * @return The max value (snr)
      */
-    double CalculateMaxSnr(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+    double CalculateMaxSnr(const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+                           const Ptr<const SpectrumValue>& noisePsd) const;
 
     /**
      * @brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
      * @param values The list of spectrumValues for which we want to find the max
+     * @param noisePsd The noise PSD
      * @return The max value (sinr)
      */
-    double CalculateMaxSinr(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+    double CalculateMaxSinr(const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+                            const Ptr<const SpectrumValue>& noisePsd) const;
 
     /**
      * @brief This function finds the max value in a space of frequency-dependent
@@ -430,10 +603,12 @@ class NrRadioEnvironmentMapHelper : public Object
      * values (such as PSD).
      * @param usefulSignal The spectrumValue considered as useful signal
      * @param interferenceSignals The list of spectrumValues considered as interference
+     * @param noisePsd The noise PSD
      * @return The max value (sinr)
      */
     double CalculateSinr(const Ptr<SpectrumValue>& usefulSignal,
-                         const std::list<Ptr<SpectrumValue>>& interferenceSignals) const;
+                         const std::list<Ptr<SpectrumValue>>& interferenceSignals,
+                         const Ptr<const SpectrumValue>& noisePsd) const;
 
     /**
      * @brief This function calculates the SIR for a given space of frequency-dependent
@@ -484,11 +659,25 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     PropagationModels CreateTemporalPropagationModels() const;
 
+    /**
+     * @brief Assigns RNG streams to the temporal Propagation Models
+     * @param models The temporal propagation models
+     * @param stream The first stream index to use
+     * @return The number of stream indices assigned
+     */
+    static int64_t AssignStreams(const PropagationModels& models, int64_t stream);
+
     /**
      * @brief Prints REM generation progress report
      */
     void PrintProgressReport(uint32_t* remSizeNextReport);
 
+    /**
+     * @brief Counts a computed REM point, and prints the progress report when needed.
+     * It can be called concurrently by the threads that compute the REM points.
+     */
+    void NotifyRemPointDone();
+
     /**
      * @brief Prints the position of the RTDs.
      */
@@ -557,6 +746,14 @@ class NrRadioEnvironmentMapHelper : public Object
 
     uint16_t m_numOfIterationsToAverage{1};
     Time m_installationDelay{Seconds(0)};
+    uint32_t m_numThreads{1};      ///< The `NumThreads` attribute.
+    int64_t m_streamBase{0};       ///< The `StreamBase` attribute.
+    bool m_reuseRtdChannels{true}; ///< The `ReuseRtdChannels` attribute.
+
+    mutable std::mutex m_modelsMutex;         ///< Serializes the creation of ns-3 objects
+    std::mutex m_progressMutex;               ///< Serializes the progress reports
+    std::atomic<uint32_t> m_remPointsDone{0}; ///< Number of REM points computed
+    uint32_t m_remSizeNextReport{0};          ///< REM points computed at the next report
 
     RemDevice m_rrd;
 
@@ -570,8 +767,6 @@ class NrRadioEnvironmentMapHelper : public Object
     ObjectFactory m_channelConditionModelFactory;
     ObjectFactory m_matrixBasedChannelModelFactory;
 
-    Ptr<SpectrumValue> m_noisePsd; // noise figure PSD that will be used for calculations
-
     std::string m_simTag; ///< The `SimTag` attribute.
 
 }; // end of `class NrRadioEnvironmentMapHelper`
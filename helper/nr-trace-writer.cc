@@ -0,0 +1,732 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-trace-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrTraceWriter");
+
+namespace
+{
+
+/// Magic bytes at the beginning of the binary trace files
+const char NR_TRACE_MAGIC[8] = {'N', 'R', 'T', 'R', 'A', 'C', 'E', '1'};
+
+/// Size of the buffer of the text trace files
+const size_t NR_TEXT_TRACE_BUFFER = 1 << 20;
+
+/**
+ * @brief Append an unsigned LEB128 variable-length integer to a buffer
+ * @param out the buffer
+ * @param value the value
+ */
+void
+PutVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+/**
+ * @brief Decode an unsigned LEB128 variable-length integer
+ * @param data the encoded bytes
+ * @param size the number of encoded bytes
+ * @param pos the position of the integer, advanced past it
+ * @return the value
+ */
+uint64_t
+GetVarint(const uint8_t* data, size_t size, size_t& pos)
+{
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        NS_ABORT_MSG_IF(pos >= size, "Truncated binary trace block");
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+    NS_FATAL_ERROR("Malformed integer in binary trace block");
+    return 0;
+}
+
+/**
+ * @brief Write an unsigned LEB128 variable-length integer to a file
+ * @param file the file
+ * @param value the value
+ */
+void
+WriteVarint(std::ofstream& file, uint64_t value)
+{
+    std::vector<uint8_t> bytes;
+    PutVarint(bytes, value);
+    file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+/**
+ * @brief Read an unsigned LEB128 variable-length integer from a file
+ * @param file the file
+ * @param value the value read
+ * @return false at the end of the file
+ */
+bool
+ReadVarint(std::ifstream& file, uint64_t& value)
+{
+    value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        int byte = file.get();
+        if (byte == std::ifstream::traits_type::eof())
+        {
+            NS_ABORT_MSG_IF(shift > 0, "Truncated binary trace file");
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    NS_FATAL_ERROR("Malformed integer in binary trace file");
+    return false;
+}
+
+/**
+ * @brief Write a string, preceded by its length, to a file
+ * @param file the file
+ * @param str the string
+ */
+void
+WriteString(std::ofstream& file, const std::string& str)
+{
+    WriteVarint(file, str.size());
+    file.write(str.data(), str.size());
+}
+
+/**
+ * @brief Read a string, preceded by its length, from a file
+ * @param file the file
+ * @return the string
+ */
+std::string
+ReadString(std::ifstream& file)
+{
+    uint64_t size = 0;
+    NS_ABORT_MSG_IF(!ReadVarint(file, size), "Truncated binary trace header");
+    std::string str(size, '\0');
+    file.read(str.data(), size);
+    NS_ABORT_MSG_IF(!file, "Truncated binary trace header");
+    return str;
+}
+
+/**
+ * @param type a column type
+ * @return true for the integer types
+ */
+bool
+IsInteger(NrTraceWriter::ColumnType type)
+{
+    return type <= NrTraceWriter::ColumnType::UINT64;
+}
+
+/**
+ * @brief Append values to a buffer as 8-byte little-endian words
+ * @param out the buffer
+ * @param values the values
+ */
+void
+PutWords(std::vector<uint8_t>& out, const std::vector<uint64_t>& values)
+{
+    for (uint64_t bits : values)
+    {
+        for (uint32_t byte = 0; byte < 8; ++byte)
+        {
+            out.push_back(static_cast<uint8_t>(bits >> (8 * byte)));
+        }
+    }
+}
+
+/**
+ * @brief Decode 8-byte little-endian words
+ * @param data the encoded bytes
+ * @param size the number of encoded bytes
+ * @param pos the position of the first word, advanced past the last one
+ * @param values the decoded values, already sized to the number of words
+ */
+void
+GetWords(const uint8_t* data, size_t size, size_t& pos, std::vector<uint64_t>& values)
+{
+    NS_ABORT_MSG_IF(values.size() > (size - pos) / 8, "Truncated binary trace block");
+    for (auto& bits : values)
+    {
+        bits = 0;
+        for (uint32_t byte = 0; byte < 8; ++byte)
+        {
+            bits |= static_cast<uint64_t>(data[pos++]) << (8 * byte);
+        }
+    }
+}
+
+/**
+ * @brief Append values to a buffer as the zigzag-encoded differences between consecutive
+ * values, packed as variable-length integers
+ * @param out the buffer
+ * @param values the values
+ */
+void
+PutDeltas(std::vector<uint8_t>& out, const std::vector<uint64_t>& values)
+{
+    uint64_t previous = 0;
+    for (uint64_t value : values)
+    {
+        // Zigzag encoding of the signed difference, so that small decrements are as short
+        // as small increments
+        auto delta = static_cast<int64_t>(value - previous);
+        PutVarint(out, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+        previous = value;
+    }
+}
+
+/**
+ * @brief Decode values encoded by PutDeltas
+ * @param data the encoded bytes
+ * @param size the number of encoded bytes
+ * @param pos the position of the first value, advanced past the last one
+ * @param values the decoded values, already sized to the number of values
+ */
+void
+GetDeltas(const uint8_t* data, size_t size, size_t& pos, std::vector<uint64_t>& values)
+{
+    uint64_t previous = 0;
+    for (auto& value : values)
+    {
+        uint64_t zigzag = GetVarint(data, size, pos);
+        previous += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        value = previous;
+    }
+}
+
+/**
+ * @param column a column
+ * @return the maximum value of an integer or label column
+ */
+uint64_t
+GetMaxValue(const NrTraceWriter::Column& column)
+{
+    switch (column.type)
+    {
+    case NrTraceWriter::ColumnType::UINT8:
+        return UINT8_MAX;
+    case NrTraceWriter::ColumnType::UINT16:
+        return UINT16_MAX;
+    case NrTraceWriter::ColumnType::UINT32:
+        return UINT32_MAX;
+    case NrTraceWriter::ColumnType::LABEL:
+        return column.labels.size() - 1;
+    default:
+        return UINT64_MAX;
+    }
+}
+
+} // namespace
+
+std::unique_ptr<NrTraceWriter>
+NrTraceWriter::Create(Format format,
+                      const std::string& fileName,
+                      const std::vector<Column>& columns,
+                      const std::string& headerPrefix)
+{
+    if (format == BINARY)
+    {
+        return std::make_unique<NrBinaryTraceWriter>(fileName, columns, headerPrefix);
+    }
+    return std::make_unique<NrTextTraceWriter>(fileName, columns, headerPrefix);
+}
+
+std::string
+NrTraceWriter::GetFileName(const std::string& textFileName, Format format)
+{
+    if (format == TEXT)
+    {
+        return textFileName;
+    }
+    const std::string extension = ".txt";
+    if (textFileName.size() >= extension.size() &&
+        textFileName.compare(textFileName.size() - extension.size(),
+                             extension.size(),
+                             extension) == 0)
+    {
+        return textFileName.substr(0, textFileName.size() - extension.size()) + ".bin";
+    }
+    return textFileName + ".bin";
+}
+
+NrTraceWriter::NrTraceWriter(const std::vector<Column>& columns)
+    : m_columns(columns)
+{
+    NS_ABORT_MSG_IF(m_columns.empty(), "A trace table needs at least one column");
+    for (const auto& column : m_columns)
+    {
+        NS_ABORT_MSG_IF(column.type == ColumnType::LABEL && column.labels.empty(),
+                        "Column " << column.name << " has no labels");
+    }
+}
+
+size_t
+NrTraceWriter::NextColumn(ColumnType type)
+{
+    NS_ASSERT_MSG(m_column < m_columns.size(), "Too many values in the row");
+    const auto& column = m_columns[m_column];
+    NS_ASSERT_MSG(column.type == type || (IsInteger(column.type) && IsInteger(type)),
+                  "Value of the wrong type for column " << column.name);
+    return m_column++;
+}
+
+void
+NrTraceWriter::CheckEndRow()
+{
+    NS_ASSERT_MSG(m_column == m_columns.size(),
+                  "Row ended after " << m_column << " of " << m_columns.size() << " values");
+    m_column = 0;
+}
+
+NrTextTraceWriter::NrTextTraceWriter(const std::string& fileName,
+                                     const std::vector<Column>& columns,
+                                     const std::string& headerPrefix)
+    : NrTraceWriter(columns),
+      m_buffer(NR_TEXT_TRACE_BUFFER)
+{
+    // The buffer must be set before opening the file
+    m_file.rdbuf()->pubsetbuf(m_buffer.data(), m_buffer.size());
+    m_file.open(fileName);
+    NS_ABORT_MSG_IF(!m_file.is_open(), "Can't open file " << fileName);
+
+    m_file << headerPrefix;
+    for (size_t i = 0; i < m_columns.size(); ++i)
+    {
+        Separate(i);
+        m_file << m_columns[i].name;
+    }
+    m_file << '\n';
+}
+
+NrTextTraceWriter::~NrTextTraceWriter()
+{
+    m_file.close();
+}
+
+void
+NrTextTraceWriter::Separate(size_t column)
+{
+    if (column > 0)
+    {
+        m_file << '\t';
+    }
+}
+
+void
+NrTextTraceWriter::WriteUint(uint64_t value)
+{
+    Separate(NextColumn(ColumnType::UINT64));
+    m_file << value;
+}
+
+void
+NrTextTraceWriter::WriteDouble(double value)
+{
+    Separate(NextColumn(ColumnType::DOUBLE));
+    m_file << value;
+}
+
+void
+NrTextTraceWriter::WriteLabel(const std::string& label)
+{
+    Separate(NextColumn(ColumnType::LABEL));
+    m_file << label;
+}
+
+void
+NrTextTraceWriter::WriteDoubleArray(const std::vector<double>& values)
+{
+    Separate(NextColumn(ColumnType::DOUBLE_ARRAY));
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (i > 0)
+        {
+            m_file << '\t';
+        }
+        m_file << values[i];
+    }
+}
+
+void
+NrTextTraceWriter::EndRow()
+{
+    CheckEndRow();
+    m_file << '\n';
+}
+
+void
+NrTextTraceWriter::Flush()
+{
+    m_file.flush();
+}
+
+NrBinaryTraceWriter::NrBinaryTraceWriter(const std::string& fileName,
+                                         const std::vector<Column>& columns,
+                                         const std::string& headerPrefix)
+    : NrTraceWriter(columns),
+      m_values(columns.size()),
+      m_arrays(columns.size())
+{
+    m_file.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_IF(!m_file.is_open(), "Can't open file " << fileName);
+
+    m_file.write(NR_TRACE_MAGIC, sizeof(NR_TRACE_MAGIC));
+    WriteString(m_file, headerPrefix);
+    WriteVarint(m_file, m_columns.size());
+    for (const auto& column : m_columns)
+    {
+        m_file.put(static_cast<char>(column.type));
+        WriteString(m_file, column.name);
+        if (column.type == ColumnType::LABEL)
+        {
+            WriteVarint(m_file, column.labels.size());
+            for (const auto& label : column.labels)
+            {
+                WriteString(m_file, label);
+            }
+        }
+    }
+    for (auto& values : m_values)
+    {
+        values.reserve(GetBlockRows());
+    }
+}
+
+NrBinaryTraceWriter::~NrBinaryTraceWriter()
+{
+    Flush();
+    m_file.close();
+}
+
+void
+NrBinaryTraceWriter::SetMaxBlockSize(size_t bytes)
+{
+    m_maxBlockSize = bytes;
+}
+
+void
+NrBinaryTraceWriter::WriteUint(uint64_t value)
+{
+    size_t column = NextColumn(ColumnType::UINT64);
+    NS_ASSERT_MSG(value <= GetMaxValue(m_columns[column]),
+                  "Value " << value << " out of the range of column " << m_columns[column].name);
+    m_values[column].push_back(value);
+    m_blockSize += sizeof(value);
+}
+
+void
+NrBinaryTraceWriter::WriteDouble(double value)
+{
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(value), "Unexpected size of double");
+    std::memcpy(&bits, &value, sizeof(bits));
+    m_values[NextColumn(ColumnType::DOUBLE)].push_back(bits);
+    m_blockSize += sizeof(bits);
+}
+
+void
+NrBinaryTraceWriter::WriteLabel(const std::string& label)
+{
+    size_t column = NextColumn(ColumnType::LABEL);
+    const auto& labels = m_columns[column].labels;
+    auto it = std::find(labels.begin(), labels.end(), label);
+    NS_ASSERT_MSG(it != labels.end(),
+                  "Unknown label " << label << " for column " << m_columns[column].name);
+    m_values[column].push_back(it - labels.begin());
+    m_blockSize += sizeof(uint64_t);
+}
+
+void
+NrBinaryTraceWriter::WriteDoubleArray(const std::vector<double>& values)
+{
+    size_t column = NextColumn(ColumnType::DOUBLE_ARRAY);
+    m_values[column].push_back(values.size());
+    auto& array = m_arrays[column];
+    for (double value : values)
+    {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        array.push_back(bits);
+    }
+    m_blockSize += (1 + values.size()) * sizeof(uint64_t);
+}
+
+void
+NrBinaryTraceWriter::EndRow()
+{
+    CheckEndRow();
+    if (++m_rows == GetBlockRows() || m_blockSize >= m_maxBlockSize)
+    {
+        WriteBlock();
+    }
+}
+
+void
+NrBinaryTraceWriter::Flush()
+{
+    if (m_rows > 0)
+    {
+        WriteBlock();
+    }
+    m_file.flush();
+}
+
+void
+NrBinaryTraceWriter::WriteBlock()
+{
+    NS_ASSERT_MSG(m_column == 0, "Block written in the middle of a row");
+    m_encoded.clear();
+    for (size_t c = 0; c < m_columns.size(); ++c)
+    {
+        auto& values = m_values[c];
+        NS_ASSERT(values.size() == m_rows);
+        if (m_columns[c].type == ColumnType::DOUBLE)
+        {
+            PutWords(m_encoded, values);
+        }
+        else if (m_columns[c].type == ColumnType::DOUBLE_ARRAY)
+        {
+            // The lengths of the arrays, then their concatenated values
+            PutDeltas(m_encoded, values);
+            PutWords(m_encoded, m_arrays[c]);
+            m_arrays[c].clear();
+        }
+        else
+        {
+            PutDeltas(m_encoded, values);
+        }
+        values.clear();
+    }
+
+    WriteVarint(m_file, m_rows);
+    WriteVarint(m_file, m_encoded.size());
+    m_file.write(reinterpret_cast<const char*>(m_encoded.data()), m_encoded.size());
+    m_rows = 0;
+    m_blockSize = 0;
+}
+
+NrBinaryTraceReader::NrBinaryTraceReader(const std::string& fileName)
+{
+    m_file.open(fileName, std::ios::in | std::ios::binary);
+    NS_ABORT_MSG_IF(!m_file.is_open(), "Can't open file " << fileName);
+
+    char magic[sizeof(NR_TRACE_MAGIC)];
+    m_file.read(magic, sizeof(magic));
+    NS_ABORT_MSG_IF(!m_file || std::memcmp(magic, NR_TRACE_MAGIC, sizeof(magic)) != 0,
+                    fileName << " is not a binary trace file");
+
+    m_headerPrefix = ReadString(m_file);
+    uint64_t columns = 0;
+    NS_ABORT_MSG_IF(!ReadVarint(m_file, columns), "Truncated binary trace header");
+    for (uint64_t c = 0; c < columns; ++c)
+    {
+        NrTraceWriter::Column column;
+        int type = m_file.get();
+        NS_ABORT_MSG_IF(type < 0 ||
+                            type > static_cast<int>(NrTraceWriter::ColumnType::DOUBLE_ARRAY),
+                        "Unknown column type in " << fileName);
+        column.type = static_cast<NrTraceWriter::ColumnType>(type);
+        column.name = ReadString(m_file);
+        if (column.type == NrTraceWriter::ColumnType::LABEL)
+        {
+            uint64_t labels = 0;
+            NS_ABORT_MSG_IF(!ReadVarint(m_file, labels), "Truncated binary trace header");
+            for (uint64_t l = 0; l < labels; ++l)
+            {
+                column.labels.push_back(ReadString(m_file));
+            }
+        }
+        m_columns.push_back(std::move(column));
+    }
+    m_values.resize(m_columns.size());
+    m_arrays.resize(m_columns.size());
+    m_offsets.resize(m_columns.size());
+}
+
+const std::vector<NrTraceWriter::Column>&
+NrBinaryTraceReader::GetColumns() const
+{
+    return m_columns;
+}
+
+const std::string&
+NrBinaryTraceReader::GetHeaderPrefix() const
+{
+    return m_headerPrefix;
+}
+
+bool
+NrBinaryTraceReader::ReadRow()
+{
+    // The first call positions the reader on the first row
+    if (m_rows > 0 && ++m_row < m_rows)
+    {
+        return true;
+    }
+    if (!ReadBlock())
+    {
+        return false;
+    }
+    m_row = 0;
+    return true;
+}
+
+bool
+NrBinaryTraceReader::ReadBlock()
+{
+    uint64_t rows = 0;
+    do
+    {
+        if (!ReadVarint(m_file, rows))
+        {
+            m_rows = 0;
+            return false;
+        }
+        NS_ABORT_MSG_IF(rows > NrBinaryTraceWriter::GetBlockRows(), "Malformed binary trace block");
+    } while (rows == 0);
+
+    uint64_t size = 0;
+    NS_ABORT_MSG_IF(!ReadVarint(m_file, size), "Truncated binary trace file");
+    std::vector<uint8_t> encoded(size);
+    m_file.read(reinterpret_cast<char*>(encoded.data()), size);
+    NS_ABORT_MSG_IF(!m_file, "Truncated binary trace file");
+
+    size_t pos = 0;
+    for (size_t c = 0; c < m_columns.size(); ++c)
+    {
+        auto& values = m_values[c];
+        values.resize(rows);
+        if (m_columns[c].type == NrTraceWriter::ColumnType::DOUBLE)
+        {
+            GetWords(encoded.data(), size, pos, values);
+        }
+        else if (m_columns[c].type == NrTraceWriter::ColumnType::DOUBLE_ARRAY)
+        {
+            GetDeltas(encoded.data(), size, pos, values);
+            auto& offsets = m_offsets[c];
+            offsets.resize(rows + 1);
+            offsets[0] = 0;
+            for (uint32_t row = 0; row < rows; ++row)
+            {
+                NS_ABORT_MSG_IF(values[row] > size, "Malformed binary trace block");
+                offsets[row + 1] = offsets[row] + values[row];
+            }
+            m_arrays[c].resize(offsets[rows]);
+            GetWords(encoded.data(), size, pos, m_arrays[c]);
+        }
+        else
+        {
+            GetDeltas(encoded.data(), size, pos, values);
+            if (m_columns[c].type == NrTraceWriter::ColumnType::LABEL)
+            {
+                NS_ABORT_MSG_IF(*std::max_element(values.begin(), values.end()) >=
+                                    m_columns[c].labels.size(),
+                                "Unknown label in column " << m_columns[c].name);
+            }
+        }
+    }
+    NS_ABORT_MSG_IF(pos != size, "Malformed binary trace block");
+    m_rows = rows;
+    return true;
+}
+
+uint64_t
+NrBinaryTraceReader::GetUint(size_t column) const
+{
+    NS_ASSERT_MSG(m_row < m_rows, "No current row");
+    NS_ASSERT(IsInteger(m_columns.at(column).type));
+    return m_values[column][m_row];
+}
+
+double
+NrBinaryTraceReader::GetDouble(size_t column) const
+{
+    NS_ASSERT_MSG(m_row < m_rows, "No current row");
+    NS_ASSERT(m_columns.at(column).type == NrTraceWriter::ColumnType::DOUBLE);
+    double value;
+    std::memcpy(&value, &m_values[column][m_row], sizeof(value));
+    return value;
+}
+
+const std::string&
+NrBinaryTraceReader::GetLabel(size_t column) const
+{
+    NS_ASSERT_MSG(m_row < m_rows, "No current row");
+    NS_ASSERT(m_columns.at(column).type == NrTraceWriter::ColumnType::LABEL);
+    return m_columns[column].labels[m_values[column][m_row]];
+}
+
+std::vector<double>
+NrBinaryTraceReader::GetDoubleArray(size_t column) const
+{
+    NS_ASSERT_MSG(m_row < m_rows, "No current row");
+    NS_ASSERT(m_columns.at(column).type == NrTraceWriter::ColumnType::DOUBLE_ARRAY);
+    const auto& offsets = m_offsets[column];
+    std::vector<double> values(offsets[m_row + 1] - offsets[m_row]);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        std::memcpy(&values[i], &m_arrays[column][offsets[m_row] + i], sizeof(double));
+    }
+    return values;
+}
+
+uint64_t
+NrBinaryTraceReader::ConvertToText(const std::string& textFileName)
+{
+    NrTextTraceWriter writer(textFileName, m_columns, m_headerPrefix);
+    uint64_t rows = 0;
+    while (ReadRow())
+    {
+        for (size_t c = 0; c < m_columns.size(); ++c)
+        {
+            switch (m_columns[c].type)
+            {
+            case NrTraceWriter::ColumnType::DOUBLE:
+                writer << GetDouble(c);
+                break;
+            case NrTraceWriter::ColumnType::LABEL:
+                writer << GetLabel(c);
+                break;
+            case NrTraceWriter::ColumnType::DOUBLE_ARRAY:
+                writer << GetDoubleArray(c);
+                break;
+            default:
+                writer << GetUint(c);
+                break;
+            }
+        }
+        writer.EndRow();
+        ++rows;
+    }
+    return rows;
+}
+
+} // namespace ns3
@@ -0,0 +1,410 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_TRACE_WRITER_H
+#define NR_TRACE_WRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup helper
+ * @brief Sink of the rows of a trace table, written to a file in a given format
+ *
+ * The trace helpers describe the columns of each trace file once, and then write each
+ * row by streaming its values in column order, followed by EndRow():
+ *
+ * @code
+ *   *writer << Simulator::Now().GetSeconds() << "DL" << cellId << rnti;
+ *   writer->EndRow();
+ * @endcode
+ *
+ * Two formats are available:
+ * - TEXT: one line per row, with tab-separated values and a header with the names of
+ *   the columns. The lines are buffered, and written when the buffer is full, when
+ *   Flush() is called, or when the writer is destroyed.
+ * - BINARY: a header with the schema of the table, followed by blocks of rows. Each
+ *   block stores the values column after column. The integer and label columns are
+ *   delta-encoded and packed as variable-length integers, and the double columns are
+ *   stored as their 8-byte IEEE 754 representation. See NrBinaryTraceReader to read
+ *   the files, and to convert them to the TEXT format.
+ *
+ * A DOUBLE_ARRAY column holds a whole vector per row, such as the SINR of each RB. In
+ * the TEXT format its values are tab-separated, so the rows have a variable number of
+ * fields.
+ */
+class NrTraceWriter
+{
+  public:
+    /// Format of the trace files
+    enum Format
+    {
+        TEXT,   //!< Tab-separated text
+        BINARY, //!< Blocks of binary columns (varint deltas and raw doubles)
+    };
+
+    /// Type of the values of a column
+    enum class ColumnType : uint8_t
+    {
+        UINT8 = 0,        //!< Unsigned integer of 8 bits
+        UINT16 = 1,       //!< Unsigned integer of 16 bits
+        UINT32 = 2,       //!< Unsigned integer of 32 bits
+        UINT64 = 3,       //!< Unsigned integer of 64 bits
+        DOUBLE = 4,       //!< Double-precision floating point
+        LABEL = 5,        //!< One of a fixed list of strings
+        DOUBLE_ARRAY = 6, //!< Variable-length array of doubles
+    };
+
+    /// Description of a column of a trace table
+    struct Column
+    {
+        std::string name;                //!< Name of the column
+        ColumnType type;                 //!< Type of the values
+        std::vector<std::string> labels; //!< Possible values of a LABEL column
+    };
+
+    /**
+     * @brief Create a writer, and write the header of the file
+     * @param format the format of the file
+     * @param fileName the name of the file
+     * @param columns the columns of the table
+     * @param headerPrefix text written before the names of the columns in the TEXT format
+     * @return the writer
+     */
+    static std::unique_ptr<NrTraceWriter> Create(Format format,
+                                                 const std::string& fileName,
+                                                 const std::vector<Column>& columns,
+                                                 const std::string& headerPrefix = "");
+
+    /**
+     * @brief Get the name of a trace file in a given format
+     *
+     * The names are given for the TEXT format. In the BINARY format, the extension
+     * ".txt", if any, is replaced by ".bin", and ".bin" is appended otherwise.
+     *
+     * @param textFileName the name of the file in the TEXT format
+     * @param format the format
+     * @return the name of the file in the given format
+     */
+    static std::string GetFileName(const std::string& textFileName, Format format);
+
+    virtual ~NrTraceWriter() = default;
+
+    /**
+     * @brief Write the value of the next column of an integer or double type
+     * @param value the value
+     * @return this writer
+     */
+    template <typename T>
+    NrTraceWriter& operator<<(T value)
+    {
+        static_assert(std::is_arithmetic_v<T>, "Only numbers and labels can be traced");
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            WriteDouble(value);
+        }
+        else
+        {
+            WriteUint(static_cast<uint64_t>(value));
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Write the value of the next column of LABEL type
+     * @param label the value, which must be one of the labels of the column
+     * @return this writer
+     */
+    NrTraceWriter& operator<<(const std::string& label)
+    {
+        WriteLabel(label);
+        return *this;
+    }
+
+    /**
+     * @brief Write the value of the next column of LABEL type
+     * @param label the value, which must be one of the labels of the column
+     * @return this writer
+     */
+    NrTraceWriter& operator<<(const char* label)
+    {
+        WriteLabel(label);
+        return *this;
+    }
+
+    /**
+     * @brief Write the value of the next column of DOUBLE_ARRAY type
+     * @param values the values
+     * @return this writer
+     */
+    NrTraceWriter& operator<<(const std::vector<double>& values)
+    {
+        WriteDoubleArray(values);
+        return *this;
+    }
+
+    /**
+     * @brief Complete the current row, after the values of all its columns
+     */
+    virtual void EndRow() = 0;
+
+    /**
+     * @brief Write to the file all the rows that have been completed
+     */
+    virtual void Flush() = 0;
+
+  protected:
+    /**
+     * @brief Constructor
+     * @param columns the columns of the table
+     */
+    NrTraceWriter(const std::vector<Column>& columns);
+
+    /**
+     * @brief Write the value of the next column of an integer type
+     * @param value the value
+     */
+    virtual void WriteUint(uint64_t value) = 0;
+
+    /**
+     * @brief Write the value of the next column of DOUBLE type
+     * @param value the value
+     */
+    virtual void WriteDouble(double value) = 0;
+
+    /**
+     * @brief Write the value of the next column of LABEL type
+     * @param label the value
+     */
+    virtual void WriteLabel(const std::string& label) = 0;
+
+    /**
+     * @brief Write the value of the next column of DOUBLE_ARRAY type
+     * @param values the values
+     */
+    virtual void WriteDoubleArray(const std::vector<double>& values) = 0;
+
+    /**
+     * @brief Advance to the next column, checking that its type is compatible with a value
+     * @param type the type of the value, any integer type for integers
+     * @return the index of the column
+     */
+    size_t NextColumn(ColumnType type);
+
+    /**
+     * @brief Check that all the columns of the current row were written, and start a new one
+     */
+    void CheckEndRow();
+
+    std::vector<Column> m_columns; //!< Columns of the table
+    size_t m_column{0};            //!< Index of the next column of the current row
+};
+
+/**
+ * @ingroup helper
+ * @brief Writer of trace tables as tab-separated text
+ */
+class NrTextTraceWriter : public NrTraceWriter
+{
+  public:
+    /**
+     * @brief Open the file and write the names of the columns
+     * @param fileName the name of the file
+     * @param columns the columns of the table
+     * @param headerPrefix text written before the names of the columns
+     */
+    NrTextTraceWriter(const std::string& fileName,
+                      const std::vector<Column>& columns,
+                      const std::string& headerPrefix);
+    ~NrTextTraceWriter() override;
+
+    void EndRow() override;
+    void Flush() override;
+
+  protected:
+    void WriteUint(uint64_t value) override;
+    void WriteDouble(double value) override;
+    void WriteLabel(const std::string& label) override;
+    void WriteDoubleArray(const std::vector<double>& values) override;
+
+  private:
+    /**
+     * @brief Write the separator before the value of a column, if it is not the first one
+     * @param column the index of the column
+     */
+    void Separate(size_t column);
+
+    std::vector<char> m_buffer; //!< Buffer of the stream
+    std::ofstream m_file;       //!< Output file
+};
+
+/**
+ * @ingroup helper
+ * @brief Writer of trace tables as blocks of binary columns
+ *
+ * File layout, in which all the integers are unsigned LEB128 variable-length integers,
+ * and the strings are their length followed by their characters:
+ * - The 8 bytes "NRTRACE1"
+ * - The text prefix of the header, the number of columns, and for each column its type
+ *   (ColumnType), its name, and for LABEL columns the number of labels and the labels
+ * - Blocks of up to GetBlockRows() rows, each made of the number of rows, the size in
+ *   bytes of the encoded columns, and the encoded columns. The integer and label
+ *   columns store the difference of each value with the previous one in the block,
+ *   zigzag-encoded, and the double columns store each value in 8 bytes, little endian.
+ *   The DOUBLE_ARRAY columns store the lengths of the arrays as an integer column,
+ *   followed by all their values as a double column.
+ *
+ * The rows of a block are kept in memory until it is written, when it reaches
+ * GetBlockRows() rows or the size set with SetMaxBlockSize(), or on Flush().
+ */
+class NrBinaryTraceWriter : public NrTraceWriter
+{
+  public:
+    /**
+     * @brief Open the file and write the schema of the table
+     * @param fileName the name of the file
+     * @param columns the columns of the table
+     * @param headerPrefix text written before the names of the columns when converted
+     * to the TEXT format
+     */
+    NrBinaryTraceWriter(const std::string& fileName,
+                        const std::vector<Column>& columns,
+                        const std::string& headerPrefix);
+    ~NrBinaryTraceWriter() override;
+
+    void EndRow() override;
+    void Flush() override;
+
+    /**
+     * @return the maximum number of rows of a block
+     */
+    static constexpr uint32_t GetBlockRows()
+    {
+        return 8192;
+    }
+
+    /**
+     * @brief Set the maximum size of the values kept in memory for a block, to bound the
+     * memory of files with large rows, or of many files open at once
+     * @param bytes the size, counting 8 bytes per value
+     */
+    void SetMaxBlockSize(size_t bytes);
+
+  protected:
+    void WriteUint(uint64_t value) override;
+    void WriteDouble(double value) override;
+    void WriteLabel(const std::string& label) override;
+    void WriteDoubleArray(const std::vector<double>& values) override;
+
+  private:
+    /**
+     * @brief Encode the rows that have been completed and write them as a block
+     */
+    void WriteBlock();
+
+    std::ofstream m_file;                        //!< Output file
+    std::vector<std::vector<uint64_t>> m_values; //!< Values of the block, per column
+    std::vector<std::vector<uint64_t>> m_arrays; //!< Array values of the block, per column
+    uint32_t m_rows{0};                          //!< Completed rows of the block
+    size_t m_blockSize{0};                       //!< Size of the values of the block
+    size_t m_maxBlockSize{SIZE_MAX};             //!< Maximum size of the values of a block
+    std::vector<uint8_t> m_encoded;              //!< Encoded block
+};
+
+/**
+ * @ingroup helper
+ * @brief Reader of the trace files written by NrBinaryTraceWriter
+ *
+ * @code
+ *   NrBinaryTraceReader reader("RxPacketTrace.bin");
+ *   while (reader.ReadRow())
+ *   {
+ *       double sinr = reader.GetDouble(14);
+ *   }
+ * @endcode
+ */
+class NrBinaryTraceReader
+{
+  public:
+    /**
+     * @brief Open a file and read its schema. It is a fatal error if the file cannot be
+     * opened, or if it is not a binary trace file.
+     * @param fileName the name of the file
+     */
+    NrBinaryTraceReader(const std::string& fileName);
+
+    /**
+     * @return the columns of the table
+     */
+    const std::vector<NrTraceWriter::Column>& GetColumns() const;
+
+    /**
+     * @return the text prefix of the header
+     */
+    const std::string& GetHeaderPrefix() const;
+
+    /**
+     * @brief Read the next row
+     * @return false if there are no more rows
+     */
+    bool ReadRow();
+
+    /**
+     * @param column the index of an integer column
+     * @return the value of the column in the current row
+     */
+    uint64_t GetUint(size_t column) const;
+
+    /**
+     * @param column the index of a DOUBLE column
+     * @return the value of the column in the current row
+     */
+    double GetDouble(size_t column) const;
+
+    /**
+     * @param column the index of a LABEL column
+     * @return the value of the column in the current row
+     */
+    const std::string& GetLabel(size_t column) const;
+
+    /**
+     * @param column the index of a DOUBLE_ARRAY column
+     * @return the values of the column in the current row
+     */
+    std::vector<double> GetDoubleArray(size_t column) const;
+
+    /**
+     * @brief Write the remaining rows to a text trace file, as NrTextTraceWriter does
+     * @param textFileName the name of the text file
+     * @return the number of rows written
+     */
+    uint64_t ConvertToText(const std::string& textFileName);
+
+  private:
+    /**
+     * @brief Read and decode the next block
+     * @return false if there are no more blocks
+     */
+    bool ReadBlock();
+
+    std::ifstream m_file;                        //!< Input file
+    std::string m_headerPrefix;                  //!< Text prefix of the header
+    std::vector<NrTraceWriter::Column> m_columns; //!< Columns of the table
+    std::vector<std::vector<uint64_t>> m_values; //!< Values of the block, per column
+    std::vector<std::vector<uint64_t>> m_arrays; //!< Array values of the block, per column
+    std::vector<std::vector<size_t>> m_offsets;  //!< Start of the array of each row
+    uint32_t m_rows{0};                          //!< Rows of the block
+    uint32_t m_row{0};                           //!< Index of the next row in the block
+};
+
+} // namespace ns3
+
+#endif // NR_TRACE_WRITER_H
@@ -10,12 +10,92 @@
 #include "ns3/simulator.h"
 #include "ns3/uinteger.h"
 
+#include <mutex>
+#include <tuple>
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("BeamManager");
 NS_OBJECT_ENSURE_REGISTERED(BeamManager);
 
+namespace
+{
+
+/// Kinds of beams of the codebook cache
+enum class CodebookKind
+{
+    DIRECTIONAL,
+    KRONECKER,
+    QUASI_OMNI,
+};
+
+/**
+ * Key of a beam of the codebook cache: the kind of beam, the geometry of the antenna array
+ * (rows, columns, horizontal and vertical spacing, bearing and downtilt angles, polarization,
+ * vertical and horizontal elements per port) and the two angles of the beam
+ */
+using CodebookKey = std::tuple<CodebookKind,
+                               size_t,
+                               size_t,
+                               double,
+                               double,
+                               double,
+                               double,
+                               bool,
+                               size_t,
+                               size_t,
+                               double,
+                               double>;
+
+/**
+ * @brief Get a beamforming vector from the codebook cache, creating it if needed
+ * @param kind the kind of beam
+ * @param antenna the antenna array
+ * @param angle1 the first angle of the beam
+ * @param angle2 the second angle of the beam
+ * @param create the function that creates the beamforming vector
+ * @return a reference to the cached beamforming vector
+ */
+template <typename F>
+const PhasedArrayModel::ComplexVector&
+GetCodebookBfv(CodebookKind kind,
+               const Ptr<const UniformPlanarArray>& antenna,
+               double angle1,
+               double angle2,
+               F create)
+{
+    CodebookKey key{kind,
+                    antenna->GetNumRows(),
+                    antenna->GetNumColumns(),
+                    antenna->GetAntennaHorizontalSpacing(),
+                    antenna->GetAntennaVerticalSpacing(),
+                    antenna->GetAlpha(),
+                    antenna->GetBeta(),
+                    antenna->IsDualPol(),
+                    antenna->GetVElemsPerPort(),
+                    antenna->GetHElemsPerPort(),
+                    angle1,
+                    angle2};
+
+    // The nodes of a std::map are never moved, so the references returned remain valid while
+    // other beams are added
+    static std::mutex cacheMutex;
+    static std::map<CodebookKey, PhasedArrayModel::ComplexVector> cache;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(key);
+    if (it == cache.end())
+    {
+        NS_LOG_LOGIC("Creating the beam (" << angle1 << ", " << angle2 << ") of a "
+                                           << antenna->GetNumRows() << "x"
+                                           << antenna->GetNumColumns() << " antenna array");
+        it = cache.emplace(key, create()).first;
+    }
+    return it->second;
+}
+
+} // namespace
+
 BeamManager::BeamManager()
 {
     // TODO Auto-generated constructor stub
@@ -74,7 +154,7 @@ void
 BeamManager::SetPredefinedBeam(uint16_t sector, double elevation)
 {
     NS_LOG_FUNCTION(this);
-    m_predefinedDirTxRxW = std::make_pair(CreateDirectionalBfv(m_antennaArray, sector, elevation),
+    m_predefinedDirTxRxW = std::make_pair(GetDirectionalBfv(m_antennaArray, sector, elevation),
                                           BeamId(sector, elevation));
 }
 
@@ -223,7 +303,35 @@ void
 BeamManager::SetSector(double sector, double elevation) const
 {
     NS_LOG_INFO("Set sector to : " << (unsigned)sector << ", and elevation to: " << elevation);
-    m_antennaArray->SetBeamformingVector(CreateDirectionalBfv(m_antennaArray, sector, elevation));
+    m_antennaArray->SetBeamformingVector(GetDirectionalBfv(m_antennaArray, sector, elevation));
+}
+
+const PhasedArrayModel::ComplexVector&
+BeamManager::GetDirectionalBfv(const Ptr<const UniformPlanarArray>& antenna,
+                               double sector,
+                               double elevation)
+{
+    return GetCodebookBfv(CodebookKind::DIRECTIONAL, antenna, sector, elevation, [&]() {
+        return CreateDirectionalBfv(antenna, sector, elevation);
+    });
+}
+
+const PhasedArrayModel::ComplexVector&
+BeamManager::GetKroneckerBfv(const Ptr<const UniformPlanarArray>& antenna,
+                             double rowAngle,
+                             double colAngle)
+{
+    return GetCodebookBfv(CodebookKind::KRONECKER, antenna, rowAngle, colAngle, [&]() {
+        return CreateKroneckerBfv(antenna, rowAngle, colAngle);
+    });
+}
+
+const PhasedArrayModel::ComplexVector&
+BeamManager::GetQuasiOmniBfv(const Ptr<const UniformPlanarArray>& antenna)
+{
+    return GetCodebookBfv(CodebookKind::QUASI_OMNI, antenna, 0, 0, [&]() {
+        return CreateQuasiOmniBfv(antenna);
+    });
 }
 
 } /* namespace ns3 */
@@ -137,11 +137,54 @@ class BeamManager : public Object
 
     /**
      * @brief Set the Sector
+     *
+     * The beamforming vector is taken from the codebook cache of GetDirectionalBfv().
+     *
      * @param sector sector
      * @param elevation elevation
      */
     void SetSector(double sector, double elevation) const;
 
+    /**
+     * @brief Get the beamforming vector of CreateDirectionalBfv() from a codebook cache
+     *
+     * The vectors are shared by all the antenna arrays with the same geometry (number of
+     * rows and columns, spacing, orientation, polarization and elements per port), and are
+     * created the first time that a (sector, elevation) pair is requested. The cache is never
+     * emptied, so it should only be used with a discrete grid of beams.
+     *
+     * @param antenna the antenna array
+     * @param sector the sector of the beam
+     * @param elevation the elevation of the beam
+     * @return a reference to the cached beamforming vector, valid until the end of the program
+     */
+    static const PhasedArrayModel::ComplexVector& GetDirectionalBfv(
+        const Ptr<const UniformPlanarArray>& antenna,
+        double sector,
+        double elevation);
+
+    /**
+     * @brief Get the beamforming vector of CreateKroneckerBfv() from a codebook cache
+     * @see GetDirectionalBfv
+     * @param antenna the antenna array
+     * @param rowAngle the row angle of the beam
+     * @param colAngle the column angle of the beam
+     * @return a reference to the cached beamforming vector, valid until the end of the program
+     */
+    static const PhasedArrayModel::ComplexVector& GetKroneckerBfv(
+        const Ptr<const UniformPlanarArray>& antenna,
+        double rowAngle,
+        double colAngle);
+
+    /**
+     * @brief Get the beamforming vector of CreateQuasiOmniBfv() from a codebook cache
+     * @see GetDirectionalBfv
+     * @param antenna the antenna array
+     * @return a reference to the cached beamforming vector, valid until the end of the program
+     */
+    static const PhasedArrayModel::ComplexVector& GetQuasiOmniBfv(
+        const Ptr<const UniformPlanarArray>& antenna);
+
   private:
     Ptr<UniformPlanarArray>
         m_antennaArray;    //!< the antenna array instance for which is responsible this BeamManager
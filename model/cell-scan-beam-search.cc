@@ -0,0 +1,256 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "cell-scan-beam-search.h"
+
+#include "beam-manager.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CellScanBeamSearch");
+
+namespace
+{
+
+/// Maximum number of elements of the long-term responses computed by a matrix product
+constexpr size_t MAX_RESPONSE_ELEMS = 1 << 20;
+
+/// Relative margin of the upper bounds, which covers the rounding of the metric
+constexpr double BOUND_TOLERANCE = 1e-6;
+
+} // namespace
+
+CellScanBeamSearch::CellScanBeamSearch(const Ptr<const UniformPlanarArray>& gnbAntenna,
+                                       const Ptr<const UniformPlanarArray>& ueAntenna,
+                                       uint8_t oversamplingFactor)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(gnbAntenna->GetNumElems() && ueAntenna->GetNumElems());
+
+    uint16_t txNumRows = gnbAntenna->GetNumRows();
+    uint16_t rxNumRows = ueAntenna->GetNumRows();
+    double txZenithStep = 180 / ((txNumRows > 1 ? oversamplingFactor : 1) * txNumRows);
+    double rxZenithStep = 180 / ((rxNumRows > 1 ? oversamplingFactor : 1) * rxNumRows);
+    NS_ABORT_MSG_IF(txZenithStep == 0, "Too many gNB antenna rows for the oversampling factor");
+
+    m_txBeams = CreateBeams(gnbAntenna, oversamplingFactor, txZenithStep, txZenithStep);
+    m_rxBeams = CreateBeams(ueAntenna, oversamplingFactor, txZenithStep, rxZenithStep);
+
+    // With several ports or polarizations, the received power is not given by a single
+    // long-term response per cluster
+    m_isBoundValid = gnbAntenna->GetNumPorts() == 1 && ueAntenna->GetNumPorts() == 1 &&
+                     !gnbAntenna->IsDualPol() && !ueAntenna->IsDualPol();
+    NS_LOG_LOGIC("Created " << m_txBeams.size() << " gNB beams and " << m_rxBeams.size()
+                            << " UE beams");
+}
+
+std::vector<CellScanBeamSearch::Beam>
+CellScanBeamSearch::CreateBeams(const Ptr<const UniformPlanarArray>& antenna,
+                                uint8_t oversamplingFactor,
+                                double zenithLoopStep,
+                                double zenithStep)
+{
+    uint16_t numCols = antenna->GetNumColumns();
+    uint16_t sectorFactor = numCols > 1 ? oversamplingFactor : 1;
+    double sectorStep = 1.0 / sectorFactor;
+
+    std::vector<Beam> beams;
+    for (double zenith = 0; zenith < 180; zenith += zenithLoopStep)
+    {
+        // Calculate beam elevation to center it into the middle of the wedge, and not at the start
+        double theta = zenith + zenithStep * 0.5;
+        for (double sector = 0; sector < numCols; sector += sectorStep)
+        {
+            NS_ASSERT(sector < UINT16_MAX);
+            beams.push_back({sector,
+                             theta,
+                             BeamId(static_cast<uint16_t>(sector) * sectorFactor, theta),
+                             BeamManager::GetDirectionalBfv(antenna, sector, theta)});
+        }
+    }
+    return beams;
+}
+
+const std::vector<CellScanBeamSearch::Beam>&
+CellScanBeamSearch::GetTxBeams() const
+{
+    return m_txBeams;
+}
+
+const std::vector<CellScanBeamSearch::Beam>&
+CellScanBeamSearch::GetRxBeams() const
+{
+    return m_rxBeams;
+}
+
+bool
+CellScanBeamSearch::IsMetricBoundValid() const
+{
+    return m_isBoundValid;
+}
+
+CellScanBeamSearch::Result
+CellScanBeamSearch::Search(const MetricFunction& metric) const
+{
+    NS_LOG_FUNCTION(this);
+    Result result;
+    for (size_t txBeam = 0; txBeam < m_txBeams.size(); ++txBeam)
+    {
+        for (size_t rxBeam = 0; rxBeam < m_rxBeams.size(); ++rxBeam)
+        {
+            double value = metric(txBeam, rxBeam);
+            ++result.numEvaluations;
+            if (result.metric < value)
+            {
+                result.txBeam = txBeam;
+                result.rxBeam = rxBeam;
+                result.metric = value;
+            }
+        }
+    }
+    return result;
+}
+
+CellScanBeamSearch::Result
+CellScanBeamSearch::Search(const MetricFunction& metric,
+                           const ComplexMatrixArray& channel,
+                           bool isReverse,
+                           double boundScale) const
+{
+    NS_LOG_FUNCTION(this << isReverse << boundScale);
+    if (!m_isBoundValid)
+    {
+        return Search(metric);
+    }
+    return Search(metric, GetMetricBounds(channel, isReverse, boundScale));
+}
+
+CellScanBeamSearch::Result
+CellScanBeamSearch::Search(const MetricFunction& metric, const std::vector<double>& bounds) const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(bounds.size() == m_txBeams.size() * m_rxBeams.size(),
+                  "There must be a bound per pair of beams");
+    size_t numRx = m_rxBeams.size();
+
+    // Start from the pair with the largest bound, whose metric is usually close to the best
+    // one, so that most of the other pairs are skipped
+    Result result;
+    size_t first = std::max_element(bounds.begin(), bounds.end()) - bounds.begin();
+    size_t bestPair = bounds.size();
+    double value = metric(first / numRx, first % numRx);
+    ++result.numEvaluations;
+    if (result.metric < value)
+    {
+        result.metric = value;
+        bestPair = first;
+    }
+
+    // Scan the other pairs in order, so that the first pair with the maximum metric is selected
+    for (size_t pair = 0; pair < bounds.size(); ++pair)
+    {
+        if (pair == first || bounds[pair] * (1 + BOUND_TOLERANCE) < result.metric)
+        {
+            continue;
+        }
+        value = metric(pair / numRx, pair % numRx);
+        ++result.numEvaluations;
+        if (result.metric < value || (result.metric == value && pair < bestPair))
+        {
+            result.metric = value;
+            bestPair = pair;
+        }
+    }
+
+    if (bestPair < bounds.size())
+    {
+        result.txBeam = bestPair / numRx;
+        result.rxBeam = bestPair % numRx;
+    }
+    NS_LOG_LOGIC("Evaluated " << result.numEvaluations << " of " << bounds.size() << " pairs");
+    return result;
+}
+
+std::vector<double>
+CellScanBeamSearch::GetMetricBounds(const ComplexMatrixArray& channel,
+                                    bool isReverse,
+                                    double boundScale) const
+{
+    size_t numTx = m_txBeams.size();
+    size_t numRx = m_rxBeams.size();
+    size_t numTxElems = m_txBeams[0].weights.GetSize();
+    size_t numRxElems = m_rxBeams[0].weights.GetSize();
+    size_t numClusters = channel.GetNumPages();
+    NS_ASSERT_MSG(channel.GetNumRows() == (isReverse ? numTxElems : numRxElems) &&
+                      channel.GetNumCols() == (isReverse ? numRxElems : numTxElems),
+                  "The channel matrix does not match the antenna arrays");
+
+    // The UE beams multiply the channel on the side of the UE antenna elements
+    ComplexMatrixArray rxCodebook(isReverse ? numRxElems : numRx, isReverse ? numRx : numRxElems);
+    for (size_t rxBeam = 0; rxBeam < numRx; ++rxBeam)
+    {
+        for (size_t elem = 0; elem < numRxElems; ++elem)
+        {
+            auto weight = m_rxBeams[rxBeam].weights[elem];
+            if (isReverse)
+            {
+                rxCodebook(elem, rxBeam) = weight;
+            }
+            else
+            {
+                rxCodebook(rxBeam, elem) = weight;
+            }
+        }
+    }
+
+    // The responses of a block of gNB beams, with all the UE beams, in all the clusters
+    size_t blockSize = std::max<size_t>(1, MAX_RESPONSE_ELEMS / (numRx * numClusters));
+    std::vector<double> bounds(numTx * numRx);
+    for (size_t blockStart = 0; blockStart < numTx; blockStart += blockSize)
+    {
+        size_t blockTx = std::min(blockSize, numTx - blockStart);
+        ComplexMatrixArray txCodebook(isReverse ? blockTx : numTxElems,
+                                      isReverse ? numTxElems : blockTx);
+        for (size_t txBeam = 0; txBeam < blockTx; ++txBeam)
+        {
+            for (size_t elem = 0; elem < numTxElems; ++elem)
+            {
+                auto weight = m_txBeams[blockStart + txBeam].weights[elem];
+                if (isReverse)
+                {
+                    txCodebook(txBeam, elem) = weight;
+                }
+                else
+                {
+                    txCodebook(elem, txBeam) = weight;
+                }
+            }
+        }
+
+        ComplexMatrixArray responses =
+            isReverse ? channel.MultiplyByLeftAndRightMatrix(txCodebook, rxCodebook)
+                      : channel.MultiplyByLeftAndRightMatrix(rxCodebook, txCodebook);
+        for (size_t txBeam = 0; txBeam < blockTx; ++txBeam)
+        {
+            for (size_t rxBeam = 0; rxBeam < numRx; ++rxBeam)
+            {
+                double sumAbs = 0;
+                for (size_t cluster = 0; cluster < numClusters; ++cluster)
+                {
+                    sumAbs += std::abs(isReverse ? responses(txBeam, rxBeam, cluster)
+                                                 : responses(rxBeam, txBeam, cluster));
+                }
+                bounds[(blockStart + txBeam) * numRx + rxBeam] = boundScale * sumAbs * sumAbs;
+            }
+        }
+    }
+    return bounds;
+}
+
+} // namespace ns3
@@ -0,0 +1,172 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef CELL_SCAN_BEAM_SEARCH_H
+#define CELL_SCAN_BEAM_SEARCH_H
+
+#include "beam-id.h"
+#include "beamforming-vector.h"
+
+#include "ns3/matrix-array.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <functional>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup gnb-phy
+ * @brief Exhaustive search of the pair of gNB and UE beams of the cell scan methods
+ *
+ * The candidate beams of the gNB and of the UE are the directional beams that
+ * CellScanBeamforming and RealisticBeamformingAlgorithm scan: for each zenith and each
+ * sector, sampled with the oversampling factor, the beam created by CreateDirectionalBfv().
+ * They are created once, when the object is constructed, instead of once per pair of beams.
+ *
+ * The pairs of beams are scanned in the order of the original nested loops (gNB zenith,
+ * gNB sector, UE zenith, UE sector), and the selected pair is the first one with the
+ * maximum metric, so the selected beams are the same as with the nested loops.
+ *
+ * When the metric has a known upper bound as a function of the per-cluster long-term
+ * response of the channel, i.e., of the product (UE beam) x H x (gNB beam) for each cluster,
+ * the responses of all the pairs are computed with a single matrix product per block of gNB
+ * beams, and the metric is evaluated only for the pairs whose bound is not below the best
+ * metric found. The bound holds only when both antenna arrays have a single port and a single
+ * polarization; otherwise, the searches with a bound evaluate all the pairs.
+ */
+class CellScanBeamSearch
+{
+  public:
+    /// Candidate beam
+    struct Beam
+    {
+        double sector;                           //!< Sector, as passed to CreateDirectionalBfv()
+        double theta;                            //!< Elevation, in degrees
+        BeamId beamId;                           //!< ID of the beam
+        PhasedArrayModel::ComplexVector weights; //!< Beamforming vector
+    };
+
+    /// Result of a search
+    struct Result
+    {
+        size_t txBeam{0};         //!< Index of the selected gNB beam
+        size_t rxBeam{0};         //!< Index of the selected UE beam
+        double metric{0};         //!< Metric of the selected pair, 0 if none is positive
+        size_t numEvaluations{0}; //!< Number of pairs whose metric was evaluated
+    };
+
+    /**
+     * @brief Metric of a pair of beams, to be maximized
+     *
+     * The arguments are the indices of the gNB beam and of the UE beam.
+     */
+    using MetricFunction = std::function<double(size_t txBeam, size_t rxBeam)>;
+
+    /**
+     * @brief Create the candidate beams of a gNB and a UE
+     *
+     * As in the original scan, the zenith of the UE beams advances by the zenith step of the
+     * gNB beams, while the UE beams are centered with the zenith step of the UE.
+     *
+     * @param gnbAntenna the antenna array of the gNB
+     * @param ueAntenna the antenna array of the UE
+     * @param oversamplingFactor the number of samples per antenna row and column
+     */
+    CellScanBeamSearch(const Ptr<const UniformPlanarArray>& gnbAntenna,
+                       const Ptr<const UniformPlanarArray>& ueAntenna,
+                       uint8_t oversamplingFactor);
+
+    /**
+     * @return the candidate beams of the gNB
+     */
+    const std::vector<Beam>& GetTxBeams() const;
+
+    /**
+     * @return the candidate beams of the UE
+     */
+    const std::vector<Beam>& GetRxBeams() const;
+
+    /**
+     * @return whether the metric can be bounded by the per-cluster long-term response of the
+     * channel, i.e., whether both antenna arrays have a single port and a single polarization
+     */
+    bool IsMetricBoundValid() const;
+
+    /**
+     * @brief Evaluate the metric of all the pairs of beams and select the best one
+     * @param metric the metric of a pair of beams
+     * @return the selected pair
+     */
+    Result Search(const MetricFunction& metric) const;
+
+    /**
+     * @brief Select the best pair of beams, skipping the pairs whose upper bound is below the
+     * best metric found
+     *
+     * The metric of a pair must not exceed boundScale * (sum over the clusters of
+     * |L_c|)^2, where L_c is the long-term response of the pair in cluster c. This is the case
+     * of the received power of a signal through a channel whose frequency response is
+     * sum_c L_c g_c(f), with |g_c(f)| = 1, when boundScale is the transmitted power. If
+     * IsMetricBoundValid() is false, all the pairs are evaluated, as in Search(metric).
+     *
+     * @param metric the metric of a pair of beams
+     * @param channel the channel matrix, with a page per cluster
+     * @param isReverse whether the rows of the channel matrix are the gNB antenna elements
+     * @param boundScale the scale of the upper bound of the metric
+     * @return the selected pair
+     */
+    Result Search(const MetricFunction& metric,
+                  const ComplexMatrixArray& channel,
+                  bool isReverse,
+                  double boundScale) const;
+
+    /**
+     * @brief Select the best pair of beams, skipping the pairs whose upper bound is below the
+     * best metric found
+     * @param metric the metric of a pair of beams
+     * @param bounds the upper bounds of the metric of the pairs, as given by
+     * GetMetricBounds()
+     * @return the selected pair
+     */
+    Result Search(const MetricFunction& metric, const std::vector<double>& bounds) const;
+
+    /**
+     * @brief Compute the upper bound of the metric of every pair of beams
+     *
+     * The bound of the pair (t, r) is at index t * GetRxBeams().size() + r. It does not log,
+     * so it can run in the threads of IdealBeamformingHelper.
+     *
+     * @param channel the channel matrix, with a page per cluster
+     * @param isReverse whether the rows of the channel matrix are the gNB antenna elements
+     * @param boundScale the scale of the upper bound of the metric
+     * @return the bounds of the pairs, in scan order
+     */
+    std::vector<double> GetMetricBounds(const ComplexMatrixArray& channel,
+                                        bool isReverse,
+                                        double boundScale) const;
+
+  private:
+    /**
+     * @brief Create the beams of an antenna array
+     * @param antenna the antenna array
+     * @param oversamplingFactor the number of samples per antenna row and column
+     * @param zenithLoopStep the step of the zenith between beams
+     * @param zenithStep the zenith step used to center the beams
+     * @return the beams, in scan order
+     */
+    static std::vector<Beam> CreateBeams(const Ptr<const UniformPlanarArray>& antenna,
+                                         uint8_t oversamplingFactor,
+                                         double zenithLoopStep,
+                                         double zenithStep);
+
+    std::vector<Beam> m_txBeams; //!< Candidate beams of the gNB, in scan order
+    std::vector<Beam> m_rxBeams; //!< Candidate beams of the UE, in scan order
+    bool m_isBoundValid;         //!< Whether the metric can be bounded
+};
+
+} // namespace ns3
+
+#endif // CELL_SCAN_BEAM_SEARCH_H
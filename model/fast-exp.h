@@ -5,7 +5,12 @@
 #ifndef FAST_EXP_H
 #define FAST_EXP_H
 
+#include <cmath>
+#include <cstdint>
 #include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
 
 /*
 These functions return an approximation of exp(x) with a relative error <0.173%.
@@ -4,6 +4,8 @@
 
 #include "ideal-beamforming-algorithm.h"
 
+#include "beam-manager.h"
+#include "cell-scan-beam-search.h"
 #include "nr-spectrum-phy.h"
 
 #include "ns3/double.h"
@@ -13,7 +15,9 @@
 #include "ns3/nr-spectrum-value-helper.h"
 #include "ns3/nr-wraparound-utils.h"
 #include "ns3/parse-string-to-vector.h"
+#include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 #include "ns3/uinteger.h"
 #include "ns3/uniform-planar-array.h"
 
@@ -37,6 +41,13 @@ IdealBeamformingAlgorithm::GetTypeId()
     return tid;
 }
 
+std::function<void()>
+IdealBeamformingAlgorithm::PrepareBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                                     const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+{
+    return nullptr;
+}
+
 TypeId
 CellScanBeamforming::GetTypeId()
 {
@@ -53,6 +64,92 @@ CellScanBeamforming::GetTypeId()
     return tid;
 }
 
+/**
+ * @brief Create the PSD of a signal with 0 dBm spread over all the RBs of a spectrum PHY
+ * @param spectrumPhy the spectrum PHY
+ * @return the PSD
+ */
+static Ptr<const SpectrumValue>
+CreateFakePsd(const Ptr<NrSpectrumPhy>& spectrumPhy)
+{
+    std::vector<int> activeRbs;
+    for (size_t rbId = 0; rbId < spectrumPhy->GetRxSpectrumModel()->GetNumBands(); rbId++)
+    {
+        activeRbs.push_back(rbId);
+    }
+
+    return NrSpectrumValueHelper::CreateTxPowerSpectralDensity(
+        0.0,
+        activeRbs,
+        spectrumPhy->GetRxSpectrumModel(),
+        NrSpectrumValueHelper::UNIFORM_POWER_ALLOCATION_BW);
+}
+
+CellScanBeamforming::PreparedSearch
+CellScanBeamforming::PrepareSearch(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                   const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+{
+    Ptr<UniformPlanarArray> gnbUpa = DynamicCast<UniformPlanarArray>(gnbSpectrumPhy->GetAntenna());
+    Ptr<UniformPlanarArray> ueUpa = DynamicCast<UniformPlanarArray>(ueSpectrumPhy->GetAntenna());
+    NS_ASSERT_MSG(gnbUpa, "gNB antenna should be UniformPlanarArray");
+    NS_ASSERT_MSG(ueUpa, "UE antenna should be UniformPlanarArray");
+
+    PreparedSearch prepared;
+    prepared.time = Simulator::Now();
+    prepared.beamSearch =
+        std::make_shared<const CellScanBeamSearch>(gnbUpa, ueUpa, m_oversamplingFactor);
+
+    // The 3GPP model multiplies the PSD by |sum_c L_c g_c(f)|^2, where L_c is the long-term
+    // response of cluster c and the Doppler and delay term g_c(f) has unit modulus, so the
+    // received power of a pair of beams is at most the transmitted power times
+    // (sum_c |L_c|)^2, if both arrays have a single port and polarization. For other models
+    // and arrays, all the pairs are evaluated.
+    Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+        DynamicCast<ThreeGppSpectrumPropagationLossModel>(
+            gnbSpectrumPhy->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel());
+    if (threeGppSplm && prepared.beamSearch->IsMetricBoundValid())
+    {
+        auto gnbMobility = GetVirtualMobilityModel(gnbSpectrumPhy->GetSpectrumChannel(),
+                                                   gnbSpectrumPhy->GetMobility(),
+                                                   ueSpectrumPhy->GetMobility());
+        prepared.channel = threeGppSplm->GetChannelModel()->GetChannel(gnbMobility,
+                                                                       ueSpectrumPhy->GetMobility(),
+                                                                       gnbUpa,
+                                                                       ueUpa);
+        prepared.isReverse = prepared.channel->IsReverse(gnbUpa->GetId(), ueUpa->GetId());
+        prepared.boundScale = Sum(*CreateFakePsd(gnbSpectrumPhy));
+    }
+    return prepared;
+}
+
+std::function<void()>
+CellScanBeamforming::PrepareBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                               const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+{
+    NS_LOG_FUNCTION(this);
+    auto key = std::make_pair(PeekPointer(gnbSpectrumPhy), PeekPointer(ueSpectrumPhy));
+    auto it = m_preparedSearches.find(key);
+    if (it != m_preparedSearches.end() && it->second.time == Simulator::Now())
+    {
+        // Already prepared by a previous task of the same pair, which will use it
+        return nullptr;
+    }
+
+    // The nodes of a std::map are never moved, so the entry can be filled by another thread
+    // while other pairs are prepared
+    PreparedSearch& prepared = m_preparedSearches[key];
+    prepared = PrepareSearch(gnbSpectrumPhy, ueSpectrumPhy);
+    if (!prepared.channel)
+    {
+        return nullptr;
+    }
+    return [&prepared]() {
+        prepared.bounds = prepared.beamSearch->GetMetricBounds(prepared.channel->m_channel,
+                                                               prepared.isReverse,
+                                                               prepared.boundScale);
+    };
+}
+
 BeamformingVectorPair
 CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
                                            const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
@@ -79,27 +176,8 @@ CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrum
     NS_ASSERT_MSG(gnbThreeGppSpectrumPropModel == ueThreeGppSpectrumPropModel,
                   "Devices should be connected on the same spectrum channel");
 
-    std::vector<int> activeRbs;
-    for (size_t rbId = 0; rbId < gnbSpectrumPhy->GetRxSpectrumModel()->GetNumBands(); rbId++)
-    {
-        activeRbs.push_back(rbId);
-    }
-
-    Ptr<const SpectrumValue> fakePsd = NrSpectrumValueHelper::CreateTxPowerSpectralDensity(
-        0.0,
-        activeRbs,
-        gnbSpectrumPhy->GetRxSpectrumModel(),
-        NrSpectrumValueHelper::UNIFORM_POWER_ALLOCATION_BW);
     Ptr<SpectrumSignalParameters> fakeParams = Create<SpectrumSignalParameters>();
-    fakeParams->psd = fakePsd->Copy();
-
-    double max = 0;
-    double maxTxTheta = 0;
-    double maxRxTheta = 0;
-    uint16_t maxTxSector = 0;
-    uint16_t maxRxSector = 0;
-    PhasedArrayModel::ComplexVector maxTxW;
-    PhasedArrayModel::ComplexVector maxRxW;
+    fakeParams->psd = CreateFakePsd(gnbSpectrumPhy)->Copy();
 
     Ptr<UniformPlanarArray> gnbUpa = DynamicCast<UniformPlanarArray>(gnbSpectrumPhy->GetAntenna());
     Ptr<UniformPlanarArray> ueUpa = DynamicCast<UniformPlanarArray>(ueSpectrumPhy->GetAntenna());
@@ -107,91 +185,95 @@ CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrum
     NS_ASSERT_MSG(ueUpa, "UE antenna should be UniformPlanarArray");
 
     uint16_t txNumCols = gnbUpa->GetNumColumns();
-    uint16_t txNumRows = gnbUpa->GetNumRows();
     uint16_t rxNumCols = ueUpa->GetNumColumns();
-    uint16_t rxNumRows = ueUpa->GetNumRows();
-
-    NS_ASSERT(gnbUpa->GetNumElems() && ueUpa->GetNumElems());
 
-    double txZenithStep = 180 / ((txNumRows > 1 ? m_oversamplingFactor : 1) * txNumRows);
-    double txSectorStep = 1.0 / (txNumCols > 1 ? m_oversamplingFactor : 1);
-    double rxZenithStep = 180 / ((rxNumRows > 1 ? m_oversamplingFactor : 1) * rxNumRows);
-    double rxSectorStep = 1.0 / (rxNumCols > 1 ? m_oversamplingFactor : 1);
-
-    for (double txZenith = 0; txZenith < 180; txZenith += txZenithStep)
+    // Use the search prepared by PrepareBeamformingVectors() in this time stamp, if any
+    PreparedSearch prepared;
+    auto it = m_preparedSearches.find(
+        std::make_pair(PeekPointer(gnbSpectrumPhy), PeekPointer(ueSpectrumPhy)));
+    if (it != m_preparedSearches.end())
     {
-        // Calculate beam elevation to center it into the middle of the wedge, and not at the start
-        double txTheta = txZenith + txZenithStep * 0.5;
-        for (double txSector = 0; txSector < txNumCols; txSector += txSectorStep)
+        if (it->second.time == Simulator::Now())
         {
-            NS_ASSERT(txSector < UINT16_MAX);
-            gnbSpectrumPhy->GetBeamManager()->SetSector(txSector, txTheta);
-            PhasedArrayModel::ComplexVector txW =
-                gnbSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-            if (maxTxW.GetSize() == 0)
-            {
-                maxTxW = txW; // initialize maxTxW
-            }
-
-            for (double rxZenith = 0; rxZenith < 180; rxZenith += txZenithStep)
-            {
-                // Calculate beam elevation to center it into the middle of the wedge, and not at
-                // the start
-                double rxTheta = rxZenith + rxZenithStep * 0.5;
-                for (double rxSector = 0; rxSector < rxNumCols; rxSector += rxSectorStep)
-                {
-                    NS_ASSERT(rxSector < UINT16_MAX);
-
-                    ueSpectrumPhy->GetBeamManager()->SetSector(rxSector, rxTheta);
-                    PhasedArrayModel::ComplexVector rxW =
-                        ueSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
+            prepared = std::move(it->second);
+        }
+        m_preparedSearches.erase(it);
+    }
+    if (!prepared.beamSearch)
+    {
+        prepared = PrepareSearch(gnbSpectrumPhy, ueSpectrumPhy);
+    }
 
-                    if (maxRxW.GetSize() == 0)
-                    {
-                        maxRxW = rxW; // initialize maxRxW
-                    }
+    const CellScanBeamSearch& beamSearch = *prepared.beamSearch;
+    const auto& txBeams = beamSearch.GetTxBeams();
+    const auto& rxBeams = beamSearch.GetRxBeams();
 
-                    NS_ABORT_MSG_IF(txW.GetSize() == 0 || rxW.GetSize() == 0,
-                                    "Beamforming vectors must be initialized in order to calculate "
-                                    "the long term matrix.");
+    size_t currentTxBeam = txBeams.size();
+    size_t currentRxBeam = rxBeams.size();
+    auto rxPower = [&](size_t txBeam, size_t rxBeam) {
+        if (txBeam != currentTxBeam)
+        {
+            gnbUpa->SetBeamformingVector(txBeams[txBeam].weights);
+            currentTxBeam = txBeam;
+        }
+        if (rxBeam != currentRxBeam)
+        {
+            ueUpa->SetBeamformingVector(rxBeams[rxBeam].weights);
+            currentRxBeam = rxBeam;
+        }
 
-                    Ptr<SpectrumSignalParameters> rxParams =
-                        gnbThreeGppSpectrumPropModel->CalcRxPowerSpectralDensity(
-                            fakeParams,
-                            gnbMobility,
-                            ueSpectrumPhy->GetMobility(),
-                            gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>(),
-                            ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>());
-
-                    double power = Sum(*(rxParams->psd));
-
-                    NS_LOG_LOGIC(
-                        " Rx power: "
-                        << power << " txTheta " << txTheta << " rxTheta " << rxTheta
-                        << " tx sector "
-                        << (M_PI * static_cast<double>(txSector) / static_cast<double>(txNumCols) -
-                            0.5 * M_PI) /
-                               M_PI * 180
-                        << " rx sector "
-                        << (M_PI * static_cast<double>(rxSector) / static_cast<double>(rxNumCols) -
-                            0.5 * M_PI) /
-                               M_PI * 180);
-
-                    if (max < power)
-                    {
-                        max = power;
-                        maxTxSector = txSector;
-                        maxRxSector = rxSector;
-                        maxTxTheta = txTheta;
-                        maxRxTheta = rxTheta;
-                        maxTxW = txW;
-                        maxRxW = rxW;
-                    }
-                }
-            }
+        Ptr<SpectrumSignalParameters> rxParams =
+            gnbThreeGppSpectrumPropModel->CalcRxPowerSpectralDensity(fakeParams,
+                                                                     gnbMobility,
+                                                                     ueSpectrumPhy->GetMobility(),
+                                                                     gnbUpa,
+                                                                     ueUpa);
+
+        double power = Sum(*(rxParams->psd));
+
+        NS_LOG_LOGIC(" Rx power: "
+                     << power << " txTheta " << txBeams[txBeam].theta << " rxTheta "
+                     << rxBeams[rxBeam].theta << " tx sector "
+                     << (M_PI * txBeams[txBeam].sector / static_cast<double>(txNumCols) -
+                         0.5 * M_PI) /
+                            M_PI * 180
+                     << " rx sector "
+                     << (M_PI * rxBeams[rxBeam].sector / static_cast<double>(rxNumCols) -
+                         0.5 * M_PI) /
+                            M_PI * 180);
+        return power;
+    };
+
+    CellScanBeamSearch::Result best;
+    if (prepared.channel)
+    {
+        if (prepared.bounds.empty())
+        {
+            prepared.bounds = beamSearch.GetMetricBounds(prepared.channel->m_channel,
+                                                         prepared.isReverse,
+                                                         prepared.boundScale);
         }
+        best = beamSearch.Search(rxPower, prepared.bounds);
     }
+    else
+    {
+        best = beamSearch.Search(rxPower);
+    }
+
+    // Leave the antennas with the last beams of the scan, as the exhaustive loops did
+    gnbUpa->SetBeamformingVector(txBeams.back().weights);
+    ueUpa->SetBeamformingVector(rxBeams.back().weights);
+
+    // If no pair has a positive power, the first beams are used, with sector and elevation 0
+    double max = best.metric;
+    const auto& maxTxBeam = txBeams[best.txBeam];
+    const auto& maxRxBeam = rxBeams[best.rxBeam];
+    auto maxTxSector = static_cast<uint16_t>(max > 0 ? maxTxBeam.sector : 0);
+    auto maxRxSector = static_cast<uint16_t>(max > 0 ? maxRxBeam.sector : 0);
+    double maxTxTheta = max > 0 ? maxTxBeam.theta : 0;
+    double maxRxTheta = max > 0 ? maxRxBeam.theta : 0;
+    const PhasedArrayModel::ComplexVector& maxTxW = maxTxBeam.weights;
+    const PhasedArrayModel::ComplexVector& maxRxW = maxRxBeam.weights;
 
     BeamformingVector gnbBfv = BeamformingVector(std::make_pair(
         maxTxW,
@@ -419,7 +501,7 @@ QuasiOmniDirectPathBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>&
     UintegerValue numColumns;
     gnbAntenna->GetAttribute("NumColumns", numCols);
     gnbAntenna->GetAttribute("NumColumns", numColumns);
-    BeamformingVector gnbBfv = {CreateQuasiOmniBfv(gnbAntenna), OMNI_BEAM_ID};
+    BeamformingVector gnbBfv = {BeamManager::GetQuasiOmniBfv(gnbAntenna), OMNI_BEAM_ID};
 
     // configure UE beamforming vector to be directed towards gNB
     PhasedArrayModel::ComplexVector ueAntennaWeights =
@@ -456,7 +538,7 @@ DirectPathQuasiOmniBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>&
     UintegerValue numColumns;
     ueAntenna->GetAttribute("NumColumns", numCols);
     ueAntenna->GetAttribute("NumColumns", numColumns);
-    BeamformingVector ueBfv = {CreateQuasiOmniBfv(ueAntenna), OMNI_BEAM_ID};
+    BeamformingVector ueBfv = {BeamManager::GetQuasiOmniBfv(ueAntenna), OMNI_BEAM_ID};
 
     // configure gNB beamforming vector to be directed towards UE
     PhasedArrayModel::ComplexVector gnbAntennaWeights =
@@ -768,7 +850,7 @@ KroneckerQuasiOmniBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& g
     // configure ue beamforming vector to be quasi
     Ptr<const UniformPlanarArray> ueAntenna =
         ueSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>();
-    PhasedArrayModel::ComplexVector uebfV = CreateQuasiOmniBfv(ueAntenna);
+    const auto& uebfV = BeamManager::GetQuasiOmniBfv(ueAntenna);
     BeamformingVector ueBfv = {uebfV, OMNI_BEAM_ID};
     ueSpectrumPhy->GetAntenna()->GetObject<UniformPlanarArray>()->SetBeamformingVector(uebfV);
 
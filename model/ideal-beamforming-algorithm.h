@@ -8,8 +8,14 @@
 #include "beam-id.h"
 #include "beamforming-vector.h"
 
+#include "ns3/matrix-based-channel-model.h"
+#include "ns3/nstime.h"
 #include "ns3/object.h"
 
+#include <functional>
+#include <map>
+#include <memory>
+
 namespace ns3
 {
 
@@ -18,6 +24,7 @@ class SpectrumValue;
 class NrGnbNetDevice;
 class NrUeNetDevice;
 class NrSpectrumPhy;
+class CellScanBeamSearch;
 
 /**
  * @ingroup gnb-phy
@@ -46,6 +53,24 @@ class IdealBeamformingAlgorithm : public Object
     virtual BeamformingVectorPair GetBeamformingVectors(
         const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
         const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const = 0;
+
+    /**
+     * @brief Prepare the part of GetBeamformingVectors() for a pair of devices that does not
+     * access any simulation object, so that it can run in another thread
+     *
+     * IdealBeamformingHelper calls it in the main thread, runs the returned function in a
+     * thread of NrThreadPool, and then calls GetBeamformingVectors() for the same pair in the
+     * main thread, at the same time stamp, which uses the prepared result. The returned
+     * function must only compute with data owned by the algorithm. The default
+     * implementation returns nullptr, i.e., all the work is done by GetBeamformingVectors().
+     *
+     * @param [in] gnbSpectrumPhy gNb spectrum phy instance
+     * @param [in] ueSpectrumPhy UE spectrum phy instance
+     * @return the function to run in any thread, or nullptr
+     */
+    virtual std::function<void()> PrepareBeamformingVectors(
+        const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+        const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const;
 };
 
 /**
@@ -82,8 +107,42 @@ class CellScanBeamforming : public IdealBeamformingAlgorithm
         const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
         const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const override;
 
+    /**
+     * @brief Create the candidate beams of a pair of devices and, when the channel uses
+     * ThreeGppSpectrumPropagationLossModel, return the computation of the upper bounds of
+     * their received power, which only uses the channel matrix and the beams
+     * @param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * @param [in] ueSpectrumPhy the spectrum phy of the UE device
+     * @return the computation of the bounds, or nullptr
+     */
+    std::function<void()> PrepareBeamformingVectors(
+        const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+        const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const override;
+
   private:
+    /// Candidate beams of a pair of devices and the upper bounds of their received power
+    struct PreparedSearch
+    {
+        Time time;                                                 //!< Time of preparation
+        std::shared_ptr<const CellScanBeamSearch> beamSearch;      //!< Candidate beams
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix> channel; //!< Channel, if 3GPP
+        bool isReverse{false};      //!< Whether the channel is from the UE to the gNB
+        double boundScale{0};       //!< Transmitted power used by the bounds
+        std::vector<double> bounds; //!< Upper bounds of the pairs, if computed
+    };
+
+    /**
+     * @brief Create the candidate beams of a pair of devices and get their channel
+     * @param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * @param [in] ueSpectrumPhy the spectrum phy of the UE device
+     * @return the search, without the bounds
+     */
+    PreparedSearch PrepareSearch(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                 const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const;
+
     uint8_t m_oversamplingFactor; //!< Number of samples per row and per column
+    mutable std::map<std::pair<const NrSpectrumPhy*, const NrSpectrumPhy*>, PreparedSearch>
+        m_preparedSearches; //!< Searches prepared by PrepareBeamformingVectors(), by pair
 };
 
 /**
@@ -8,6 +8,7 @@
 #include "nr-error-model.h"
 #include "nr-lte-mi-error-model.h"
 
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/enum.h"
 #include "ns3/log.h"
@@ -16,6 +17,8 @@
 #include "ns3/object-factory.h"
 #include "ns3/uinteger.h"
 
+#include <mutex>
+
 namespace ns3
 {
 
@@ -36,6 +39,7 @@ NrAmc::SetDlMode()
 {
     NS_LOG_FUNCTION(this);
     m_emMode = NrErrorModel::DL;
+    m_tbSizeMemo.clear();
 }
 
 void
@@ -43,6 +47,7 @@ NrAmc::SetUlMode()
 {
     NS_LOG_FUNCTION(this);
     m_emMode = NrErrorModel::UL;
+    m_tbSizeMemo.clear();
 }
 
 TypeId
@@ -71,6 +76,14 @@ NrAmc::GetTypeId()
                           TypeIdValue(NrLteMiErrorModel::GetTypeId()),
                           MakeTypeIdAccessor(&NrAmc::SetErrorModelType, &NrAmc::GetErrorModelType),
                           MakeTypeIdChecker())
+            .AddAttribute("UseSinrThresholdTable",
+                          "If true, and ErrorModelType is an EESM error model, the MCS is "
+                          "selected by comparing the effective SINR against a table of SINR "
+                          "thresholds instead of computing the TBLER of each MCS",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrAmc::SetUseSinrThresholdTable,
+                                              &NrAmc::GetUseSinrThresholdTable),
+                          MakeBooleanChecker())
             .AddConstructor<NrAmc>();
     return tid;
 }
@@ -110,6 +123,7 @@ NrAmc::SetNumRefScPerRb(uint8_t nref)
 {
     NS_LOG_FUNCTION(this);
     m_numRefScPerRb = nref;
+    m_tbSizeMemo.clear();
 }
 
 uint32_t
@@ -121,6 +135,30 @@ NrAmc::CalculateTbSize(uint8_t mcs, uint8_t rank, uint32_t nprb) const
                   "MCS=" << static_cast<uint32_t>(mcs) << " while maximum MCS is "
                          << static_cast<uint32_t>(m_errorModel->GetMaxMcs()));
 
+    if (mcs >= TB_SIZE_MEMO_MCS || rank > TB_SIZE_MEMO_RANK || nprb > TB_SIZE_MEMO_NPRB)
+    {
+        return ComputeTbSize(mcs, rank, nprb);
+    }
+
+    if (m_tbSizeMemo.empty())
+    {
+        m_tbSizeMemo.resize((TB_SIZE_MEMO_RANK + 1) * TB_SIZE_MEMO_MCS);
+    }
+    auto& tbSizes = m_tbSizeMemo[rank * TB_SIZE_MEMO_MCS + mcs];
+    if (nprb >= tbSizes.size())
+    {
+        tbSizes.resize(nprb + 1, TB_SIZE_UNKNOWN);
+    }
+    if (tbSizes[nprb] == TB_SIZE_UNKNOWN)
+    {
+        tbSizes[nprb] = ComputeTbSize(mcs, rank, nprb);
+    }
+    return tbSizes[nprb];
+}
+
+uint32_t
+NrAmc::ComputeTbSize(uint8_t mcs, uint8_t rank, uint32_t nprb) const
+{
     uint32_t payloadSize = GetPayloadSize(mcs, rank, nprb);
     uint32_t tbSize = payloadSize;
 
@@ -219,21 +257,40 @@ NrAmc::CreateCqiFeedbackSiso(const SpectrumValue& sinr, uint8_t& mcs) const
         }
 
         mcs = 0;
-        Ptr<NrErrorModelOutput> output;
-        while (mcs <= m_errorModel->GetMaxMcs())
+        bool aboveTarget = false;
+        uint8_t rank = 1; // This function is SISO only
+        if (m_useSinrThresholdTable && m_eesmErrorModel)
         {
-            uint8_t rank = 1; // This function is SISO only
-            auto tbSize = CalculateTbSize(mcs, rank, rbMap.size());
-            output = m_errorModel->GetTbDecodificationStats(sinr,
-                                                            rbMap,
-                                                            tbSize,
-                                                            mcs,
-                                                            NrErrorModel::NrErrorModelHistory());
-            if (output->m_tbler > 0.1)
+            auto sinrEff = m_eesmErrorModel->GetSinrEffPerMcs(sinr, rbMap);
+            while (mcs <= m_errorModel->GetMaxMcs())
             {
-                break;
+                auto tbSize = CalculateTbSize(mcs, rank, rbMap.size());
+                if (!m_eesmErrorModel->IsTblerWithinTarget(sinrEff.at(mcs), tbSize, mcs, 0.1))
+                {
+                    aboveTarget = true;
+                    break;
+                }
+                mcs++;
+            }
+        }
+        else
+        {
+            while (mcs <= m_errorModel->GetMaxMcs())
+            {
+                auto tbSize = CalculateTbSize(mcs, rank, rbMap.size());
+                auto output =
+                    m_errorModel->GetTbDecodificationStats(sinr,
+                                                           rbMap,
+                                                           tbSize,
+                                                           mcs,
+                                                           NrErrorModel::NrErrorModelHistory());
+                if (output->m_tbler > 0.1)
+                {
+                    aboveTarget = true;
+                    break;
+                }
+                mcs++;
             }
-            mcs++;
         }
 
         if (mcs > 0)
@@ -241,7 +298,7 @@ NrAmc::CreateCqiFeedbackSiso(const SpectrumValue& sinr, uint8_t& mcs) const
             mcs--;
         }
 
-        if ((output->m_tbler > 0.1) && (mcs == 0))
+        if (aboveTarget && (mcs == 0))
         {
             cqi = 0;
         }
@@ -323,7 +380,9 @@ NrAmc::SetErrorModelType(const TypeId& type)
     factory.SetTypeId(m_errorModelType);
     m_errorModel = DynamicCast<NrErrorModel>(factory.Create());
     NS_ASSERT(m_errorModel != nullptr);
+    m_eesmErrorModel = DynamicCast<NrEesmErrorModel>(m_errorModel);
     m_cachedCqiToMcsMap.clear(); // clear stale cache
+    m_tbSizeMemo.clear();
 }
 
 TypeId
@@ -333,6 +392,20 @@ NrAmc::GetErrorModelType() const
     return m_errorModelType;
 }
 
+void
+NrAmc::SetUseSinrThresholdTable(bool useSinrThresholdTable)
+{
+    NS_LOG_FUNCTION(this << useSinrThresholdTable);
+    m_useSinrThresholdTable = useSinrThresholdTable;
+}
+
+bool
+NrAmc::GetUseSinrThresholdTable() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_useSinrThresholdTable;
+}
+
 double
 NrAmc::GetBer() const
 {
@@ -349,11 +422,11 @@ NrAmc::GetBer() const
 }
 
 NrAmc::McsParams
-NrAmc::GetMaxMcsParams(const NrSinrMatrix& sinrMat, size_t subbandSize) const
+NrAmc::GetMaxMcsParams(const NrSinrMatrix& sinrMat, size_t subbandSize, bool bisection) const
 {
-    auto wbMcs = GetMcs(sinrMat);
+    auto wbMcs = GetMcs(sinrMat, bisection);
     auto wbCqi = GetWbCqiFromMcs(wbMcs);
-    auto sbMcs = GetSbMcs(subbandSize, sinrMat);
+    auto sbMcs = GetSbMcs(subbandSize, sinrMat, bisection);
 
     std::vector<uint8_t> sbCqis;
     sbCqis.resize(sbMcs.size());
@@ -367,7 +440,7 @@ NrAmc::GetMaxMcsParams(const NrSinrMatrix& sinrMat, size_t subbandSize) const
 }
 
 std::vector<uint8_t>
-NrAmc::GetSbMcs(const size_t subbandSize, const NrSinrMatrix& sinrMat) const
+NrAmc::GetSbMcs(const size_t subbandSize, const NrSinrMatrix& sinrMat, bool bisection) const
 {
     auto nRbs = sinrMat.GetNumRbs();
     auto nSbs = (nRbs + subbandSize - 1) / subbandSize;
@@ -377,7 +450,7 @@ NrAmc::GetSbMcs(const size_t subbandSize, const NrSinrMatrix& sinrMat) const
     for (size_t i = 0; i < sbMcs.size(); i++)
     {
         auto sinrSb = ExtractSbFromMat(i, i != (nSbs - 1) ? subbandSize : lastSubbandSize, sinrMat);
-        sbMcs[i] = GetMcs(sinrSb);
+        sbMcs[i] = GetMcs(sinrSb, bisection);
     }
     return sbMcs;
 }
@@ -415,7 +488,7 @@ NrAmc::CreateSinrMatForSb(const NrSinrMatrix& avgSinrSb, const NrSinrMatrix& sin
 }
 
 uint8_t
-NrAmc::GetMcs(const NrSinrMatrix& sinrMat) const
+NrAmc::GetMcs(const NrSinrMatrix& sinrMat, bool bisection) const
 {
     auto mcs = uint8_t{0};
     switch (m_amcModel)
@@ -424,7 +497,7 @@ NrAmc::GetMcs(const NrSinrMatrix& sinrMat) const
         NS_ABORT_MSG("ShannonModel is not yet supported");
         break;
     case ErrorModel:
-        mcs = GetMaxMcsForErrorModel(sinrMat);
+        mcs = GetMaxMcsForErrorModel(sinrMat, bisection);
         break;
     default:
         NS_ABORT_MSG("AMC model not supported");
@@ -434,29 +507,94 @@ NrAmc::GetMcs(const NrSinrMatrix& sinrMat) const
 }
 
 uint8_t
-NrAmc::GetMaxMcsForErrorModel(const NrSinrMatrix& sinrMat) const
+NrAmc::GetMaxMcsForErrorModel(const NrSinrMatrix& sinrMat, bool bisection) const
+{
+    if (m_useSinrThresholdTable && m_eesmErrorModel)
+    {
+        return GetMaxMcsForSinrThresholds(sinrMat, bisection);
+    }
+
+    return FindMaxMcs(
+        [&](uint8_t mcs) {
+            // TODO: Change target TBLER from default 0.1 when using MCS table 3
+            return CalcTblerForMimoMatrix(mcs, sinrMat) <= 0.1;
+        },
+        bisection);
+}
+
+uint8_t
+NrAmc::FindMaxMcs(const std::function<bool(uint8_t)>& isWithinTarget, bool bisection) const
 {
+    auto maxMcs = m_errorModel->GetMaxMcs();
     auto mcs = uint8_t{0};
-    while (mcs <= m_errorModel->GetMaxMcs())
+    if (bisection)
     {
-        auto tbler = CalcTblerForMimoMatrix(mcs, sinrMat);
-        // TODO: Change target TBLER from default 0.1 when using MCS table 3
-        if (tbler > 0.1)
+        // Find the first MCS out of target in [0, maxMcs + 1]
+        auto high = static_cast<uint8_t>(maxMcs + 1);
+        while (mcs < high)
         {
-            break;
+            auto mid = static_cast<uint8_t>((mcs + high) / 2);
+            if (isWithinTarget(mid))
+            {
+                mcs = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+    }
+    else
+    {
+        while (mcs <= maxMcs && isWithinTarget(mcs))
+        {
+            // The current configuration produces a sufficiently low TBLER, try next value
+            mcs++;
         }
-        // The current configuration produces a sufficiently low TBLER, try next value
-        mcs++;
     }
     if (mcs > 0)
     {
-        // The loop exited because the MCS exceeded max MCS or because of high TBLER. Reduce MCS
+        // The search stopped because the MCS exceeded max MCS or because of high TBLER. Reduce MCS
         mcs--;
     }
 
     return mcs;
 }
 
+uint8_t
+NrAmc::GetMaxMcsForSinrThresholds(const NrSinrMatrix& sinrMat, bool bisection) const
+{
+    // Same RB map and vectorized SINR of CalcTblerForMimoMatrix, but computed only
+    // once for all the MCSs
+    std::vector<int> rbMap{};
+    int nRbs = static_cast<int>(sinrMat.GetNumRbs());
+    for (int rbIdx = 0; rbIdx < nRbs; rbIdx++)
+    {
+        if (sinrMat(0, rbIdx) != 0.0)
+        {
+            rbMap.push_back(rbIdx);
+        }
+    }
+
+    if (rbMap.empty())
+    {
+        return 0;
+    }
+
+    // The SINR values are read without a SpectrumValue, whose SpectrumModel is not thread safe
+    auto vectorizedMap = m_eesmErrorModel->CreateVectorizedRbMap(rbMap, sinrMat.GetRank());
+    auto sinrEff = m_eesmErrorModel->GetSinrEffPerMcs(sinrMat.GetVectorizedValues(),
+                                                      sinrMat.GetNumRows() * sinrMat.GetNumCols(),
+                                                      vectorizedMap);
+
+    return FindMaxMcs(
+        [&](uint8_t mcs) {
+            auto tbSize = CalcTbSizeForMimoMatrix(mcs, sinrMat);
+            return m_eesmErrorModel->IsTblerWithinTarget(sinrEff.at(mcs), tbSize, mcs, 0.1);
+        },
+        bisection);
+}
+
 uint8_t
 NrAmc::GetWbCqiFromMcs(uint8_t mcs) const
 {
@@ -487,10 +625,6 @@ NrAmc::GetWbCqiFromMcs(uint8_t mcs) const
 double
 NrAmc::CalcTblerForMimoMatrix(uint8_t mcs, const NrSinrMatrix& sinrMat) const
 {
-    auto dummyRnti = uint16_t{0};
-    auto duration = Time{1.0}; // Use an arbitrary non-zero time as the chunk duration
-    auto mimoChunk = MimoSinrChunk{sinrMat, dummyRnti, duration};
-    auto mimoChunks = std::vector<MimoSinrChunk>{mimoChunk};
     auto rank = sinrMat.GetRank();
 
     // Create the RB map (indices of used RBs, i.e., indices of RBs where SINR is non-zero)
@@ -511,15 +645,36 @@ NrAmc::CalcTblerForMimoMatrix(uint8_t mcs, const NrSinrMatrix& sinrMat) const
 
     auto tbSize = CalcTbSizeForMimoMatrix(mcs, sinrMat);
     auto dummyHistory = NrErrorModel::NrErrorModelHistory{}; // Create empty HARQ history
-    auto outputOfEm = m_errorModel->GetTbDecodificationStatsMimo(mimoChunks,
-                                                                 rbMap,
-                                                                 tbSize,
-                                                                 mcs,
-                                                                 rank,
-                                                                 dummyHistory);
+    // Same as GetTbDecodificationStatsMimo() with a single chunk, but with the SpectrumModel of
+    // the vectorized SINR cached by this AMC
+    auto outputOfEm =
+        m_errorModel->GetTbDecodificationStats(GetVectorizedSinr(sinrMat),
+                                               m_errorModel->CreateVectorizedRbMap(rbMap, rank),
+                                               tbSize,
+                                               mcs,
+                                               dummyHistory);
     return outputOfEm->m_tbler;
 }
 
+SpectrumValue
+NrAmc::GetVectorizedSinr(const NrSinrMatrix& sinrMat) const
+{
+    auto numValues = sinrMat.GetNumRows() * sinrMat.GetNumCols();
+    auto& model = m_vectorizedSinrModels[numValues];
+    if (!model)
+    {
+        // Creating a SpectrumModel is not thread safe, while the AMCs of different bandwidth
+        // parts may be used by the threads of NrCsiBatch at the same time
+        static std::mutex modelMutex;
+        std::lock_guard<std::mutex> lock(modelMutex);
+        model = Create<SpectrumModel>(std::vector<BandInfo>(numValues));
+    }
+
+    SpectrumValue vectorizedSinr{model};
+    std::copy_n(sinrMat.GetVectorizedValues(), numValues, vectorizedSinr.ValuesBegin());
+    return vectorizedSinr;
+}
+
 uint32_t
 NrAmc::CalcTbSizeForMimoMatrix(uint8_t mcs, const NrSinrMatrix& sinrMat) const
 {
@@ -5,9 +5,12 @@
 #ifndef NR_AMC_H
 #define NR_AMC_H
 
+#include "nr-eesm-error-model.h"
 #include "nr-error-model.h"
 #include "nr-phy-mac-common.h"
 
+#include <functional>
+
 namespace ns3
 {
 
@@ -165,6 +168,24 @@ class NrAmc : public Object
      */
     TypeId GetErrorModelType() const;
 
+    /**
+     * @brief Enable or disable the SINR threshold table for MCS selection
+     *
+     * When enabled, and the error model is an EESM error model, the MCS search
+     * compares the effective SINR of each MCS against a table of SINR thresholds
+     * instead of computing the full TB decodification statistics for each MCS.
+     * The selected MCS is the same in both cases.
+     *
+     * @param useSinrThresholdTable true to enable the SINR threshold table
+     * @see NrEesmErrorModel::IsTblerWithinTarget
+     */
+    void SetUseSinrThresholdTable(bool useSinrThresholdTable);
+    /**
+     * @brief Get if the SINR threshold table is used for MCS selection
+     * @return true if the SINR threshold table is enabled
+     */
+    bool GetUseSinrThresholdTable() const;
+
     /**
      * @brief Calculate the TransportBlock size (in bytes) giving the MCS and the number of RB
      * assigned
@@ -172,6 +193,10 @@ class NrAmc : public Object
      * It depends on the error model and the "mode" configured with SetMode().
      * Please note that this function expects in input the RB, not the RBG of the transmission.
      *
+     * The TB sizes are memoized by MCS, rank and number of RBs, so the error model is
+     * only called the first time that a combination is requested. The memo is cleared
+     * when the error model, the mode or the number of reference subcarriers changes.
+     *
      * @param mcs the MCS of the transmission
      * @param rank the MIMO rank
      * @param nprb The number of physical resource blocks used in the transmission
@@ -202,19 +227,37 @@ class NrAmc : public Object
     /// @brief Find maximum MCS supported for this channel and obtain related parameters
     /// @param sinrMat the MIMO SINR matrix (rank * nRbs)
     /// @param subbandSize the size of each subband, used to create subband CQI values
+    /// @param bisection if true, bisect the MCS instead of scanning it from MCS 0 (see GetMcs)
     /// @return a struct with the optimal MCS and corresponding CQI and TB size
-    McsParams GetMaxMcsParams(const NrSinrMatrix& sinrMat, size_t subbandSize) const;
+    ///
+    /// It creates a SpectrumModel only the first time it evaluates the TBLER of a matrix size,
+    /// so the threads of NrCsiBatch can call it as long as each AMC is used by one thread at a
+    /// time. With the SINR threshold table of the EESM error models, it reads the SINR values
+    /// directly, without any SpectrumModel. The AMC and its error model log from the thread
+    /// that calls it.
+    McsParams GetMaxMcsParams(const NrSinrMatrix& sinrMat,
+                              size_t subbandSize,
+                              bool bisection = false) const;
 
     /// @brief Find Sb MCS supported for this channel
     /// @param subbandSize the size of each subband, used to create subband CQI values
     /// @param sinrMat the MIMO SINR matrix (rank * nRbs)
+    /// @param bisection if true, bisect the MCS instead of scanning it from MCS 0 (see GetMcs)
     /// @return the vector of MCS for subband
-    std::vector<uint8_t> GetSbMcs(const size_t subbandSize, const NrSinrMatrix& sinrMat) const;
+    std::vector<uint8_t> GetSbMcs(const size_t subbandSize,
+                                  const NrSinrMatrix& sinrMat,
+                                  bool bisection = false) const;
 
     /// @brief Find MCS supported for this channel
+    ///
+    /// The MCS is the highest one whose TBLER is within the target, scanning from MCS 0 up
+    /// to the first MCS out of target. With bisection, the TBLER is assumed to increase
+    /// with the MCS, and only O(log(maxMcs)) MCSs are evaluated; the result is the same
+    /// when the TBLER is monotone.
     /// @param sinrMat the MIMO SINR matrix (rank * nRbs)
+    /// @param bisection if true, bisect the MCS instead of scanning it from MCS 0
     /// @return the MCS
-    uint8_t GetMcs(const NrSinrMatrix& sinrMat) const;
+    uint8_t GetMcs(const NrSinrMatrix& sinrMat, bool bisection = false) const;
 
     /// @brief Create wide-band matrix based on average sinr of particular sub-band
     /// @param avgSinrSb the average sinr of sub-band
@@ -258,8 +301,22 @@ class NrAmc : public Object
   private:
     /// @brief Find maximum MCS supported for this channel, using the NR error model
     /// @param sinrMat the MIMO SINR matrix (rank * nRbs)
+    /// @param bisection if true, bisect the MCS instead of scanning it from MCS 0
+    /// @return the maximum MCS
+    uint8_t GetMaxMcsForErrorModel(const NrSinrMatrix& sinrMat, bool bisection) const;
+
+    /// @brief Find maximum MCS supported for this channel, using the SINR threshold table
+    /// of the EESM error model
+    /// @param sinrMat the MIMO SINR matrix (rank * nRbs)
+    /// @param bisection if true, bisect the MCS instead of scanning it from MCS 0
     /// @return the maximum MCS
-    uint8_t GetMaxMcsForErrorModel(const NrSinrMatrix& sinrMat) const;
+    uint8_t GetMaxMcsForSinrThresholds(const NrSinrMatrix& sinrMat, bool bisection) const;
+
+    /// @brief Find the highest MCS within the TBLER target
+    /// @param isWithinTarget returns true if the TBLER of an MCS is within the target
+    /// @param bisection if true, bisect the MCS instead of scanning it from MCS 0
+    /// @return the highest MCS below the first MCS out of target, or 0
+    uint8_t FindMaxMcs(const std::function<bool(uint8_t)>& isWithinTarget, bool bisection) const;
 
     /// @brief Compute the CQI value that corresponds to this MCS
     /// @param mcs the MCS
@@ -278,20 +335,48 @@ class NrAmc : public Object
     /// @return the TBLER
     double CalcTblerForMimoMatrix(uint8_t mcs, const NrSinrMatrix& sinrMat) const;
 
+    /// @brief Vectorize a SINR matrix as NrSinrMatrix::GetVectorizedSpecVal() does, but with the
+    /// SpectrumModel of its size cached by this AMC, instead of a new one for each call
+    /// @param sinrMat the MIMO SINR matrix (rank * nRbs)
+    /// @return A SpectrumValue with the (nRB * nMimoLayers) SINR values
+    SpectrumValue GetVectorizedSinr(const NrSinrMatrix& sinrMat) const;
+
     /**
      * @brief Get the requested BER in assigning MCS (Shannon-bound model)
      * @return BER
      */
     double GetBer() const;
 
+    /**
+     * @brief Compute the TB size with the error model, without the memo
+     * @param mcs the MCS of the transmission
+     * @param rank the MIMO rank
+     * @param nprb The number of physical resource blocks used in the transmission
+     * @return the TBS in bytes
+     */
+    uint32_t ComputeTbSize(uint8_t mcs, uint8_t rank, uint32_t nprb) const;
+
   private:
+    friend class NrAmcMcsBisectionTestCase; ///< Checks the TBLER around the bisected MCS
+
     AmcModel m_amcModel;                           //!< Type of the CQI feedback model
     Ptr<NrErrorModel> m_errorModel;                //!< Pointer to an instance of ErrorModel
     TypeId m_errorModelType;                       //!< Type of the error model
+    Ptr<NrEesmErrorModel> m_eesmErrorModel;        //!< m_errorModel, if it is an EESM model
+    bool m_useSinrThresholdTable{false};           //!< Use SINR threshold table for MCS selection
     uint8_t m_numRefScPerRb{1};                    //!< number of reference subcarriers per RB
     NrErrorModel::Mode m_emMode{NrErrorModel::DL}; //!< Error model mode
     static const unsigned int m_crcLen = 24 / 8;   //!< CRC length (in bytes)
     mutable std::unordered_map<uint8_t, uint8_t> m_cachedCqiToMcsMap; //!< Cached CQI to MCS
+
+    static constexpr uint8_t TB_SIZE_MEMO_MCS = 32;         //!< MCS slots per rank in the memo
+    static constexpr uint8_t TB_SIZE_MEMO_RANK = 8;         //!< Maximum rank kept in the memo
+    static constexpr uint32_t TB_SIZE_MEMO_NPRB = 275 * 14; //!< Maximum RBs kept in the memo
+    static constexpr uint32_t TB_SIZE_UNKNOWN = UINT32_MAX; //!< Not yet computed TB size
+    /// TB size of each number of RBs, for each rank * TB_SIZE_MEMO_MCS + mcs
+    mutable std::vector<std::vector<uint32_t>> m_tbSizeMemo;
+    /// SpectrumModel of the vectorized SINR matrices, for each number of values
+    mutable std::unordered_map<size_t, Ptr<const SpectrumModel>> m_vectorizedSinrModels;
 };
 
 } // end namespace ns3
@@ -7,6 +7,10 @@
 #include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
 namespace ns3
 {
 
@@ -53,4 +57,74 @@ NrCbTypeOne::GetNumI2() const
     return m_numI2;
 }
 
+Ptr<const NrCbPrecoders>
+NrCbTypeOne::GetPrecoders() const
+{
+    // The codebook is fully defined by its TypeId and its attributes (derived parameters such as
+    // the number of ports, the oversampling factors and the indices are computed from them)
+    auto tid = GetInstanceTypeId();
+    auto key = tid.GetName();
+    for (; tid != Object::GetTypeId(); tid = tid.GetParent())
+    {
+        for (size_t i = 0; i < tid.GetAttributeN(); i++)
+        {
+            auto info = tid.GetAttribute(i);
+            auto value = info.checker->Create();
+            GetAttribute(info.name, *value);
+            key += ";" + info.name + "=" + value->SerializeToString(info.checker);
+        }
+    }
+
+    static std::mutex cacheMutex;
+    static std::unordered_map<std::string, Ptr<const NrCbPrecoders>> cache;
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto& precoders = cache[key];
+    if (!precoders)
+    {
+        NS_LOG_LOGIC("Creating the precoding matrices of " << key);
+        precoders = Create<NrCbPrecoders>(*this);
+    }
+    return precoders;
+}
+
+NrCbPrecoders::NrCbPrecoders(const NrCbTypeOne& cb)
+    : m_numI1(cb.GetNumI1()),
+      m_numI2(cb.GetNumI2())
+{
+    auto firstPrecMat = cb.GetBasePrecMat(0, 0);
+    auto nRows = firstPrecMat.GetNumRows();
+    auto nCols = firstPrecMat.GetNumCols();
+    m_precMats = ComplexMatrixArray{nRows, nCols, m_numI1 * m_numI2};
+    for (size_t i1 = 0; i1 < m_numI1; i1++)
+    {
+        for (size_t i2 = 0; i2 < m_numI2; i2++)
+        {
+            auto precMat = cb.GetBasePrecMat(i1, i2);
+            NS_ASSERT_MSG(precMat.GetNumRows() == nRows && precMat.GetNumCols() == nCols,
+                          "All the precoding matrices of a codebook must have the same size");
+            std::copy_n(precMat.GetPagePtr(0),
+                        nRows * nCols,
+                        m_precMats.GetPagePtr(GetPage(i1, i2)));
+        }
+    }
+}
+
+size_t
+NrCbPrecoders::GetNumI1() const
+{
+    return m_numI1;
+}
+
+size_t
+NrCbPrecoders::GetNumI2() const
+{
+    return m_numI2;
+}
+
+const ComplexMatrixArray&
+NrCbPrecoders::GetPrecMats() const
+{
+    return m_precMats;
+}
+
 } // namespace ns3
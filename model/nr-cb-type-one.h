@@ -20,6 +20,8 @@ constexpr size_t NR_CB_TYPE_ONE_INIT_NI1 = 1;
 constexpr size_t NR_CB_TYPE_ONE_INIT_NI2 = 1;
 constexpr size_t NR_CB_TYPE_ONE_INIT_NPORTS = 1;
 
+class NrCbPrecoders;
+
 /// @brief Wrapper class for implementations of Type-I precoding matrices in 3GPP TS 38.214.
 /// A separate object must be instantiated for each MIMO rank.
 class NrCbTypeOne : public Object
@@ -46,6 +48,13 @@ class NrCbTypeOne : public Object
     /// @return the precoding matrix of size m_nPorts x m_rank
     virtual ComplexMatrixArray GetBasePrecMat(size_t i1, size_t i2) const = 0;
 
+    /// @brief Get all the base precoding matrices of the codebook, from a process-wide cache.
+    /// The codebooks with the same TypeId and the same attribute values share the same
+    /// immutable NrCbPrecoders, which is created the first time it is requested.
+    /// @note Must be called after Init().
+    /// @return the precoding matrices of all the (i1, i2) indices
+    Ptr<const NrCbPrecoders> GetPrecoders() const;
+
   protected:
     // Constituting attributes
     size_t m_n1{NR_CB_TYPE_ONE_INIT_N1};       /// 3GPP n1-n2 config (num horiz gNB ports)
@@ -59,6 +68,43 @@ class NrCbTypeOne : public Object
     size_t m_nPorts{NR_CB_TYPE_ONE_INIT_NPORTS}; /// Total number of gNB ports
 };
 
+/// @brief The base precoding matrices of all the (i1, i2) indices of a Type-I codebook, stored
+/// contiguously as the pages of a single matrix array. Objects are immutable once created, and
+/// shared by all the codebooks with the same configuration (see NrCbTypeOne::GetPrecoders).
+class NrCbPrecoders : public SimpleRefCount<NrCbPrecoders>
+{
+  public:
+    /// @brief Create the precoding matrices of all the (i1, i2) indices of a codebook
+    /// @param cb the initialized codebook
+    NrCbPrecoders(const NrCbTypeOne& cb);
+
+    /// @brief Get number of i1 values.
+    /// @return the number of wideband precoding indices i1
+    size_t GetNumI1() const;
+
+    /// @brief Get number of i2 values.
+    /// @return the number of subband precoding indices i2
+    size_t GetNumI2() const;
+
+    /// @brief Get the page of a precoding matrix in GetPrecMats()
+    /// @param i1 the index of the wideband precoding
+    /// @param i2 the index of the subband precoding
+    /// @return the page index
+    size_t GetPage(size_t i1, size_t i2) const
+    {
+        return i1 * m_numI2 + i2;
+    }
+
+    /// @brief Get all the precoding matrices, one page per (i1, i2) pair (see GetPage)
+    /// @return the precoding matrices (dim: nPorts * rank * (numI1 * numI2))
+    const ComplexMatrixArray& GetPrecMats() const;
+
+  private:
+    size_t m_numI1;                ///< Number of wideband indices (i1)
+    size_t m_numI2;                ///< Number of subband indices (i2)
+    ComplexMatrixArray m_precMats; ///< The precoding matrices, one page per (i1, i2) pair
+};
+
 } // namespace ns3
 
 #endif // NR_CB_TYPE_ONE_H
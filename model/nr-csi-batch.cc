@@ -0,0 +1,155 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-csi-batch.h"
+
+#include "nr-thread-pool.h"
+#ifdef PMI_MALEKI
+#include "nr-pm-search-maleki.h"
+#endif
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <unordered_map>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrCsiBatch");
+NS_OBJECT_ENSURE_REGISTERED(NrCsiBatch);
+
+TypeId
+NrCsiBatch::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrCsiBatch")
+            .SetParent<Object>()
+            .AddConstructor<NrCsiBatch>()
+            .SetGroupName("Nr")
+            .AddAttribute("NumThreads",
+                          "Number of threads that run the CSI searches of the UEs. The value 0 "
+                          "uses all the available cores. The feedback does not depend on this "
+                          "value.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrCsiBatch::SetNumThreads,
+                                               &NrCsiBatch::GetNumThreads),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+NrCsiBatch::NrCsiBatch()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NrCsiBatch::~NrCsiBatch()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+NrCsiBatch::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_runEvent.Cancel();
+    m_jobs.clear();
+    Object::DoDispose();
+}
+
+void
+NrCsiBatch::SetNumThreads(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    m_numThreads = numThreads;
+}
+
+uint32_t
+NrCsiBatch::GetNumThreads() const
+{
+    return m_numThreads;
+}
+
+void
+NrCsiBatch::Enqueue(const Ptr<const NrAmc>& amc,
+                    const Ptr<NrPmSearch>& pmSearch,
+                    const NrMimoSignal& signal,
+                    NrPmSearch::PmiUpdate pmiUpdate,
+                    DeliverCallback deliver)
+{
+    NS_LOG_FUNCTION(this << amc << pmSearch << pmiUpdate.updateWb << pmiUpdate.updateSb);
+    m_jobs.push_back({PeekPointer(amc), pmSearch, signal, pmiUpdate, std::move(deliver), {}});
+    NS_LOG_LOGIC("Queued the search of " << pmSearch << ", " << m_jobs.size() << " in the batch");
+    if (!m_runEvent.IsPending())
+    {
+        m_runEvent = Simulator::ScheduleNow(&NrCsiBatch::Run, this);
+    }
+}
+
+void
+NrCsiBatch::Run()
+{
+    NS_LOG_FUNCTION(this << m_jobs.size());
+
+    // The feedback callbacks may queue new searches, which go to the next batch
+    std::vector<Job> batch = std::move(m_jobs);
+    m_jobs.clear();
+
+    std::unordered_map<const NrAmc*, size_t> groupOfAmc;
+    std::vector<std::vector<Job*>> groups;
+    std::vector<bool> inMainThread;
+    for (auto& job : batch)
+    {
+        auto [it, inserted] = groupOfAmc.emplace(job.amc, groups.size());
+        if (inserted)
+        {
+            groups.emplace_back();
+            inMainThread.push_back(false);
+        }
+        groups[it->second].push_back(&job);
+#ifdef PMI_MALEKI
+        // The Python interpreter of the Maleki search is not thread safe
+        if (DynamicCast<NrPmSearchMaleki>(job.pmSearch))
+        {
+            inMainThread[it->second] = true;
+        }
+#endif
+    }
+
+    auto runGroup = [](const std::vector<Job*>& group) {
+        for (auto job : group)
+        {
+            job->feedback = job->pmSearch->CreateCqiFeedbackMimo(job->signal, job->pmiUpdate);
+        }
+    };
+    std::vector<const std::vector<Job*>*> parallelGroups;
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        if (inMainThread[i])
+        {
+            runGroup(groups[i]);
+        }
+        else
+        {
+            parallelGroups.push_back(&groups[i]);
+        }
+    }
+
+    NS_LOG_LOGIC("Running " << batch.size() << " CSI searches in " << groups.size()
+                            << " groups, " << parallelGroups.size() << " of them in parallel");
+    NrThreadPool::Get().Run(m_numThreads, parallelGroups.size(), [&](size_t i) {
+        runGroup(*parallelGroups[i]);
+    });
+
+    for (auto& job : batch)
+    {
+        NS_LOG_LOGIC("Feedback of " << job.pmSearch << ": rank " << +job.feedback.m_rank
+                                    << ", WB PMI " << job.feedback.m_wbPmi << ", WB CQI "
+                                    << +job.feedback.m_wbCqi << ", MCS " << +job.feedback.m_mcs);
+        job.deliver(job.feedback);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,118 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_CSI_BATCH_H
+#define NR_CSI_BATCH_H
+
+#include "nr-pm-search.h"
+
+#include "ns3/event-id.h"
+#include "ns3/object.h"
+
+#include <functional>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup ue-phy
+ * @brief Runs the MIMO CSI searches of several UEs together, on the threads of NrThreadPool
+ *
+ * When a UE PHY is given an NrCsiBatch instance (see NrHelper::EnableCsiBatching()), it
+ * queues the PMI, RI and CQI search of each CSI-RS, CSI-IM or PDSCH signal with
+ * Enqueue(), instead of running it when the signal ends. The searches queued by all the
+ * UEs are executed at the end of the time stamp, by NumThreads threads, and their
+ * feedback is then passed to the UEs in the main thread, in the order the searches were
+ * queued.
+ *
+ * The searches of UEs that use the same NrAmc, i.e., of the UEs of the same bandwidth
+ * part of a gNB, run in the same thread, in the order they were queued, because the AMC
+ * and its error model keep caches that are not thread safe. The codebooks are shared by
+ * all the searches (see NrCbTypeOne::GetPrecoders()). The feedback does not depend on the
+ * number of threads. The Python interpreter of NrPmSearchMaleki is not thread safe, so the
+ * searches of an AMC with a Maleki search run in the main thread. The searches do not create
+ * spectrum models, which are not thread safe (see NrAmc::GetMaxMcsParams()), but the AMC and
+ * its error model log from the threads that run the searches, so enable the logs of NrAmc and
+ * of the error models only with NumThreads equal to 1. The same holds for the logs of the PM
+ * searches (NrPmSearch and its subclasses), while NrCsiBatch logs the queued searches and
+ * their feedback in the main thread. Compared to a simulation without this class, the
+ * feedback messages are sent later in the same time stamp, so the order of events that happen
+ * at the same time as the end of a signal may change.
+ */
+class NrCsiBatch : public Object
+{
+  public:
+    /**
+     * @brief Get the type ID
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief NrCsiBatch constructor
+     */
+    NrCsiBatch();
+
+    /**
+     * @brief ~NrCsiBatch
+     */
+    ~NrCsiBatch() override;
+
+    /**
+     * @brief Set the number of threads that run the searches
+     * @param numThreads the number of threads, or 0 to use all the available cores
+     */
+    void SetNumThreads(uint32_t numThreads);
+
+    /**
+     * @return the number of threads that run the searches
+     */
+    uint32_t GetNumThreads() const;
+
+    /// Callback that receives the feedback of a search
+    using DeliverCallback = std::function<void(const PmCqiInfo&)>;
+
+    /**
+     * @brief Queue a CSI search, to be executed at the end of the current time stamp
+     * @param amc the AMC used by the search
+     * @param pmSearch the search engine of the UE
+     * @param signal the channel and interference of the UE
+     * @param pmiUpdate whether to update the wideband and subband PMIs
+     * @param deliver the callback that receives the feedback, in the main thread
+     */
+    void Enqueue(const Ptr<const NrAmc>& amc,
+                 const Ptr<NrPmSearch>& pmSearch,
+                 const NrMimoSignal& signal,
+                 NrPmSearch::PmiUpdate pmiUpdate,
+                 DeliverCallback deliver);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Queued search
+    struct Job
+    {
+        const NrAmc* amc;                //!< AMC used by the search
+        Ptr<NrPmSearch> pmSearch;        //!< Search engine of the UE
+        NrMimoSignal signal;             //!< Channel and interference of the UE
+        NrPmSearch::PmiUpdate pmiUpdate; //!< Whether to update the PMIs
+        DeliverCallback deliver;         //!< Receives the feedback
+        PmCqiInfo feedback;              //!< Result of the search
+    };
+
+    /**
+     * @brief Execute the queued searches and deliver their feedback
+     */
+    void Run();
+
+    uint32_t m_numThreads{0}; //!< The `NumThreads` attribute
+    std::vector<Job> m_jobs;  //!< Searches queued in the current time stamp
+    EventId m_runEvent;       //!< Event that executes the queued searches
+};
+
+} // namespace ns3
+
+#endif // NR_CSI_BATCH_H
@@ -5,7 +5,7 @@
 
 #include "nr-eesm-error-model.h"
 
-#include "fast-exp.h"
+#include "nr-eesm-exp-sum.h"
 #include "nr-phy-mac-common.h"
 
 #include "ns3/enum.h"
@@ -61,48 +61,135 @@ NrEesmErrorModel::SinrEff(const SpectrumValue& sinr,
 
     double sinrExpSum = SinrExp(sinr, map, mcs);
     double beta = GetBetaTable()->at(mcs);
-    double SINR = -beta * log((a + sinrExpSum) / b);
-    SINR = std::max(SINR, 0.0);
+    double SINR = SinrEffFromExpSum(sinrExpSum, beta, a, b);
 
     NS_LOG_INFO(" Effective SINR = " << SINR);
 
     return SINR;
 }
 
+double
+NrEesmErrorModel::SinrEffFromExpSum(double sinrExpSum, double beta, double a, double b)
+{
+    double SINR = -beta * log((a + sinrExpSum) / b);
+    return std::max(SINR, 0.0);
+}
+
+std::vector<double>
+NrEesmErrorModel::GetSinrEffPerMcs(const SpectrumValue& sinr, const std::vector<int>& map) const
+{
+    NS_LOG_FUNCTION(this);
+    return GetSinrEffPerMcs(&(*sinr.ConstValuesBegin()), sinr.GetValuesN(), map);
+}
+
+std::vector<double>
+NrEesmErrorModel::GetSinrEffPerMcs(const double* sinr,
+                                   size_t numValues,
+                                   const std::vector<int>& map) const
+{
+    const uint8_t maxMcs = GetMaxMcs();
+    std::vector<double> sinrEff(maxMcs + 1);
+    // distinct beta values, and the index of the beta value of each MCS
+    std::vector<double> betas;
+    std::vector<size_t> betaIndex(maxMcs + 1);
+    betas.reserve(maxMcs + 1);
+
+    for (uint8_t mcs = 0; mcs <= maxMcs; ++mcs)
+    {
+        double beta = GetBetaTable()->at(mcs);
+        auto it = std::find(betas.begin(), betas.end(), beta);
+        if (it == betas.end())
+        {
+            betas.push_back(beta);
+            it = std::prev(betas.end());
+        }
+        betaIndex[mcs] = std::distance(betas.begin(), it);
+    }
+
+    // all the sums are computed reading the SINR values only once
+    std::vector<double> expSums = SinrExpBatch(sinr, numValues, map, betas);
+
+    for (uint8_t mcs = 0; mcs <= maxMcs; ++mcs)
+    {
+        // first transmission, as in GetTbBitDecodificationStats: a = 0, b = map.size ()
+        sinrEff[mcs] =
+            SinrEffFromExpSum(expSums[betaIndex[mcs]], betas[betaIndex[mcs]], 0, map.size());
+    }
+
+    return sinrEff;
+}
+
 double
 NrEesmErrorModel::SinrExp(const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs) const
 {
     // it returns sum_n (exp (-SINR/beta))
     NS_LOG_FUNCTION(sinr << &map << (uint8_t)mcs);
+
+    double beta = GetBetaTable()->at(mcs);
+    return SinrExpBatch(sinr, map, {beta}).front();
+}
+
+std::vector<double>
+NrEesmErrorModel::SinrExpBatch(const SpectrumValue& sinr,
+                               const std::vector<int>& map,
+                               const std::vector<double>& betas)
+{
+    return SinrExpBatch(&(*sinr.ConstValuesBegin()), sinr.GetValuesN(), map, betas);
+}
+
+std::vector<double>
+NrEesmErrorModel::SinrExpBatch(const double* sinr,
+                               size_t numValues,
+                               const std::vector<int>& map,
+                               const std::vector<double>& betas)
+{
     NS_ABORT_MSG_IF(map.empty(),
                     " Error: number of allocated RBs cannot be 0 - EESM method - SinrEff function");
+    NS_ASSERT(*std::max_element(map.begin(), map.end()) < static_cast<int>(numValues));
 
-    double SINRexp = 0.0;
-    double SINRsum = 0.0;
-    double beta = GetBetaTable()->at(mcs);
-    for (int i : map)
+    std::vector<double> sums(betas.size());
+    NrEesmExpSums(sinr, map.data(), map.size(), betas.data(), betas.size(), sums.data());
+    return sums;
+}
+
+const NrEesmErrorModel::SimulatedBlerFromSINR::Curve&
+NrEesmErrorModel::GetBlerCurve(NrEesmErrorModel::GraphType graphType,
+                               uint8_t mcs,
+                               uint32_t cbSizeBit) const
+{
+    const SimulatedBlerFromSINR* table = GetSimulatedBlerFromSINR();
+    NS_ASSERT(mcs < table->numMcs);
+
+    uint32_t index = graphType * table->numMcs + mcs;
+    const SimulatedBlerFromSINR::Curve* first = table->curves + table->firstCurve[index];
+    const SimulatedBlerFromSINR::Curve* last = table->curves + table->firstCurve[index + 1];
+    NS_ASSERT(first != last);
+
+    // take the lowest CBSIZE simulated including this CB
+    auto cbIt = std::upper_bound(first,
+                                 last,
+                                 cbSizeBit,
+                                 [](uint32_t size, const SimulatedBlerFromSINR::Curve& curve) {
+                                     return size < curve.cbSize;
+                                 });
+    if (cbIt != first)
     {
-        double sinrLin = sinr[i];
-        SINRexp = exp21d(-sinrLin / beta);
-        SINRsum += SINRexp;
+        cbIt--;
     }
-    return SINRsum;
+    return *cbIt;
 }
 
-const std::vector<double>&
-NrEesmErrorModel::GetSinrDbVectorFromSimulatedValues(NrEesmErrorModel::GraphType graphType,
-                                                     uint8_t mcs,
-                                                     uint32_t cbSizeIndex) const
+std::span<const double>
+NrEesmErrorModel::GetSinrDbVectorFromSimulatedValues(
+    const SimulatedBlerFromSINR::Curve& curve) const
 {
-    return std::get<0>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
+    return {GetSimulatedBlerFromSINR()->sinrDb + curve.offset, curve.length};
 }
 
-const std::vector<double>&
-NrEesmErrorModel::GetBLERVectorFromSimulatedValues(NrEesmErrorModel::GraphType graphType,
-                                                   uint8_t mcs,
-                                                   uint32_t cbSizeIndex) const
+std::span<const double>
+NrEesmErrorModel::GetBLERVectorFromSimulatedValues(const SimulatedBlerFromSINR::Curve& curve) const
 {
-    return std::get<1>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
+    return {GetSimulatedBlerFromSINR()->bler + curve.offset, curve.length};
 }
 
 double
@@ -112,55 +199,141 @@ NrEesmErrorModel::MappingSinrBler(double sinr, uint8_t mcs, uint32_t cbSizeBit)
     NS_ABORT_MSG_IF(mcs > GetMaxMcs(),
                     "MCS out of range [0..27/28]: " << static_cast<uint8_t>(mcs));
 
-    // use cbSize to obtain the index of CBSIZE in the map, jointly with mcs and sinr. take the
+    // use cbSize to obtain the curve of CBSIZE, jointly with mcs and sinr. take the
     // lowest CBSIZE simulated including this CB for removing CB size quatization
     // errors. sinr is also lower-bounded.
     double bler = 0.0;
     double sinr_db = 10 * log10(sinr);
     GraphType bg_type = GetBaseGraphType(cbSizeBit, mcs);
 
-    // Get the index of CBSIZE in the map
     NS_LOG_INFO("For sinr " << sinr << " and mcs " << +mcs << " CbSizebit " << cbSizeBit
                             << " we got bg type " << m_bgTypeName[bg_type]);
-    const auto& cbMap = GetSimulatedBlerFromSINR()->at(bg_type).at(mcs);
-    auto cbIt = cbMap.upper_bound(cbSizeBit);
-
-    if (cbIt != cbMap.begin())
-    {
-        cbIt--;
-    }
+    const auto& curve = GetBlerCurve(bg_type, mcs, cbSizeBit);
+    auto sinrDb = GetSinrDbVectorFromSimulatedValues(curve);
 
-    if (sinr_db < GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).front())
+    if (sinr_db < sinrDb.front())
     {
         bler = 1.0;
     }
-    else if (sinr_db > GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).back())
+    else if (sinr_db > sinrDb.back())
     {
         bler = 0.0;
     }
     else
     {
-        // Get the index of SINR in the vector
-        auto sinrIt =
-            std::upper_bound(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                             GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).end(),
-                             sinr_db);
+        // Get the index of SINR in the curve
+        auto sinrIt = std::upper_bound(sinrDb.begin(), sinrDb.end(), sinr_db);
 
-        if (sinrIt != GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin())
+        if (sinrIt != sinrDb.begin())
         {
             sinrIt--;
         }
 
-        auto sinr_index =
-            std::distance(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                          sinrIt);
-        bler = GetBLERVectorFromSimulatedValues(bg_type, mcs, cbIt->first).at(sinr_index);
+        auto sinr_index = std::distance(sinrDb.begin(), sinrIt);
+        bler = GetBLERVectorFromSimulatedValues(curve)[sinr_index];
     }
 
     NS_LOG_LOGIC("SINR effective: " << sinr << " BLER:" << bler);
     return bler;
 }
 
+double
+NrEesmErrorModel::CblerToTbler(double cbler, uint32_t numCb)
+{
+    if (numCb != 1)
+    {
+        return 1.0 - pow(1.0 - cbler, numCb);
+    }
+    return cbler;
+}
+
+const NrEesmErrorModel::SinrThreshold&
+NrEesmErrorModel::GetSinrThreshold(uint8_t mcs,
+                                   uint32_t cbSizeBit,
+                                   uint32_t numCb,
+                                   double targetTbler)
+{
+    NS_LOG_FUNCTION(this << +mcs << cbSizeBit << numCb << targetTbler);
+
+    if (targetTbler != m_sinrThresholdsTarget)
+    {
+        m_sinrThresholds.clear();
+        m_sinrThresholdsTarget = targetTbler;
+    }
+
+    uint64_t key = (static_cast<uint64_t>(mcs) << 56) | (static_cast<uint64_t>(cbSizeBit) << 24) |
+                   (numCb & 0xFFFFFF);
+    auto thIt = m_sinrThresholds.find(key);
+    if (thIt != m_sinrThresholds.end())
+    {
+        return thIt->second;
+    }
+
+    // Select the curve exactly as MappingSinrBler does
+    const auto& curve = GetBlerCurve(GetBaseGraphType(cbSizeBit, mcs), mcs, cbSizeBit);
+    auto sinrDb = GetSinrDbVectorFromSimulatedValues(curve);
+    auto bler = GetBLERVectorFromSimulatedValues(curve);
+
+    // Find the first point of the curve from which all the following points reach
+    // the target (above the last point of the curve, the BLER is 0).
+    size_t first = sinrDb.size();
+    while (first > 0 && CblerToTbler(bler[first - 1], numCb) <= targetTbler)
+    {
+        --first;
+    }
+
+    SinrThreshold th;
+    if (first == sinrDb.size())
+    {
+        th.sinrDb = sinrDb.back();
+        th.inclusive = false;
+    }
+    else
+    {
+        th.sinrDb = sinrDb[first];
+    }
+
+    // Below the first point of the curve the BLER is 1. If any point before the
+    // threshold reaches the target, the curve is not monotone and the
+    // threshold cannot be used.
+    th.exact = CblerToTbler(1.0, numCb) > targetTbler;
+    for (size_t i = 0; i < first && th.exact; ++i)
+    {
+        th.exact = CblerToTbler(bler[i], numCb) > targetTbler;
+    }
+
+    NS_LOG_INFO("SINR threshold for MCS " << +mcs << " CB size " << cbSizeBit << " CBs " << numCb
+                                          << ": " << th.sinrDb << " dB, exact " << th.exact);
+
+    return m_sinrThresholds.emplace(key, th).first->second;
+}
+
+bool
+NrEesmErrorModel::IsTblerWithinTarget(double sinrEff,
+                                      uint32_t size,
+                                      uint8_t mcs,
+                                      double targetTbler)
+{
+    NS_LOG_FUNCTION(this << sinrEff << size << +mcs << targetTbler);
+    NS_ABORT_IF(mcs > GetMaxMcs());
+
+    uint32_t sizeBit = size * 8;
+    GraphType bg_type = GetBaseGraphType(sizeBit, mcs);
+    std::pair<uint32_t, uint32_t> cbSeg = CodeBlockSegmentation(sizeBit + 24, bg_type);
+    uint32_t K = cbSeg.first;
+    uint32_t C = cbSeg.second;
+
+    const auto& th = GetSinrThreshold(mcs, K, C, targetTbler);
+    double sinr_db = 10 * log10(sinrEff);
+
+    if (!th.exact || std::isnan(sinr_db))
+    {
+        return CblerToTbler(MappingSinrBler(sinrEff, mcs, K), C) <= targetTbler;
+    }
+
+    return th.inclusive ? sinr_db >= th.sinrDb : sinr_db > th.sinrDb;
+}
+
 NrEesmErrorModel::GraphType
 NrEesmErrorModel::GetBaseGraphType(uint32_t tbSizeBit, uint8_t mcs) const
 {
@@ -283,9 +456,12 @@ NrEesmErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
     NS_LOG_FUNCTION(this);
     NS_ABORT_IF(mcs > GetMaxMcs());
 
-    double tbSinr = SinrEff(sinr, map, mcs, 0, map.size()); // effective SINR for this tx
-    double SINR = tbSinr;
     double sinrExpSum = SinrExp(sinr, map, mcs); // exponential sum of SINRs for this tx
+    double tbSinr = SinrEffFromExpSum(sinrExpSum,
+                                      GetBetaTable()->at(mcs),
+                                      0,
+                                      map.size()); // effective SINR for this tx
+    double SINR = tbSinr;
 
     NS_LOG_DEBUG(" mcs " << +mcs << " TBSize in bit " << sizeBit << " history elements: "
                          << sinrHistory.size() << " SINR of the tx: " << tbSinr << std::endl
@@ -320,16 +496,7 @@ NrEesmErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
     NS_LOG_INFO(" MCS of tx " << +mcs << " Equivalent MCS for PHY abstraction (just for HARQ-IR) "
                               << +mcs_eq);
 
-    double errorRate = 1.0;
-    if (C != 1)
-    {
-        double cbler = MappingSinrBler(SINR, mcs_eq, K);
-        errorRate = 1.0 - pow(1.0 - cbler, C);
-    }
-    else
-    {
-        errorRate = MappingSinrBler(SINR, mcs_eq, K);
-    }
+    double errorRate = CblerToTbler(MappingSinrBler(SINR, mcs_eq, K), C);
 
     NS_LOG_DEBUG("Calculated Error rate " << errorRate);
     NS_ASSERT(GetMcsEcrTable() != nullptr);
@@ -8,6 +8,8 @@
 #include "nr-error-model.h"
 
 #include <map>
+#include <span>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -151,9 +153,90 @@ class NrEesmErrorModel : public NrErrorModel
      */
     uint8_t GetMaxMcs() const override;
 
+    /**
+     * @brief Compute the effective SINR of a first transmission, for every MCS
+     *
+     * The sum of exponential SINRs is evaluated only once for each distinct
+     * beta value of the table, and then shared among the MCSs that use it. The
+     * values are the same as the ones computed by GetTbDecodificationStats()
+     * with an empty HARQ history.
+     *
+     * @param sinr the perceived sinrs in the whole bandwidth (vector, per RB)
+     * @param map the actives RBs for the TB
+     * @return the effective SINR, indexed by MCS
+     */
+    std::vector<double> GetSinrEffPerMcs(const SpectrumValue& sinr,
+                                         const std::vector<int>& map) const;
+
+    /**
+     * @brief Compute the effective SINR of a first transmission, for every MCS, from the
+     * SINR values without their SpectrumValue
+     *
+     * Same as GetSinrEffPerMcs(const SpectrumValue&, const std::vector<int>&), but it
+     * neither creates nor references a SpectrumModel, so it can be called by the threads of
+     * NrCsiBatch (see NrSinrMatrix::GetVectorizedValues()).
+     *
+     * @param sinr the perceived sinrs in the whole bandwidth (per RB and layer)
+     * @param numValues the number of SINR values
+     * @param map the actives RBs for the TB, indices of the SINR values
+     * @return the effective SINR, indexed by MCS
+     */
+    std::vector<double> GetSinrEffPerMcs(const double* sinr,
+                                         size_t numValues,
+                                         const std::vector<int>& map) const;
+
+    /**
+     * @brief Check if the first transmission of a TB would be decoded with a
+     * TBLER that does not exceed the target
+     *
+     * The result is the same as comparing the output of GetTbDecodificationStats()
+     * (with an empty HARQ history) against the target, but instead of mapping the
+     * effective SINR into a BLER, the effective SINR is compared against a table of
+     * SINR thresholds. The table is filled the first time a combination of MCS,
+     * code block size and number of code blocks is requested, and it is shared by
+     * all the following requests.
+     *
+     * @param sinrEff the effective SINR of the TB (see GetSinrEffPerMcs())
+     * @param size Transport block size in Bytes
+     * @param mcs MCS
+     * @param targetTbler the target TBLER
+     * @return true if the TBLER is lower than or equal to the target
+     */
+    bool IsTblerWithinTarget(double sinrEff, uint32_t size, uint8_t mcs, double targetTbler);
+
     typedef std::vector<double> DoubleVector;
-    typedef std::tuple<DoubleVector, DoubleVector> DoubleTuple;
-    typedef std::vector<std::vector<std::map<uint32_t, DoubleTuple>>> SimulatedBlerFromSINR;
+
+    /**
+     * @brief BLER-SINR curves obtained from link-level simulations, for each
+     * LDPC base graph, MCS and code block size
+     *
+     * The points of all the curves are packed in two contiguous arrays, one
+     * with the SINR (in dB) and one with the BLER, and each curve is a slice
+     * of them. The curves are sorted by base graph, MCS and CB size; the curves
+     * of a (base graph, MCS) pair are in the range
+     * [firstCurve[bg * numMcs + mcs], firstCurve[bg * numMcs + mcs + 1]).
+     *
+     * The tables (NrEesmT1, NrEesmT2) are constant expressions, so they do not
+     * need any initialization or heap memory when the library is loaded.
+     */
+    struct SimulatedBlerFromSINR
+    {
+        /**
+         * @brief A BLER-SINR curve, for a given CB size
+         */
+        struct Curve
+        {
+            uint32_t cbSize; //!< Size of the CB (in bits) of the curve
+            uint32_t offset; //!< Index of the first point of the curve in sinrDb and bler
+            uint32_t length; //!< Number of points of the curve
+        };
+
+        const double* sinrDb;       //!< SINR (in dB) of the points of all the curves
+        const double* bler;         //!< BLER of the points of all the curves
+        const Curve* curves;        //!< All the curves, sorted by base graph, MCS and CB size
+        const uint32_t* firstCurve; //!< Index of the first curve of each base graph and MCS
+        uint8_t numMcs;             //!< Number of MCSs for each base graph
+    };
 
   protected:
     /**
@@ -188,6 +271,18 @@ class NrEesmErrorModel : public NrErrorModel
                    double a,
                    double b) const;
 
+    /**
+     * @brief compute the effective SINR from the sum of exponential SINRs, as
+     * SINReff = - beta * ln [1/b * (sinrExpSum + a)]
+     *
+     * @param sinrExpSum the sum of exponential SINRs (see SinrExp())
+     * @param beta the beta value of the MCS
+     * @param a the sum term to the exponential SINR
+     * @param b the denominator for the exponentials sum
+     * @return the effective SINR
+     */
+    static double SinrEffFromExpSum(double sinrExpSum, double beta, double a, double b);
+
     /**
      * @brief compute the sum of exponential SINRs for the specified MCS and SINR, according
      * to the EESM method, used in HARQ-IR
@@ -199,6 +294,37 @@ class NrEesmErrorModel : public NrErrorModel
      */
     double SinrExp(const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs) const;
 
+    /**
+     * @brief compute the sum of exponential SINRs for several beta values at once
+     *
+     * The SINR values are read only once, and the sums are computed with a
+     * vectorized kernel when the CPU supports it (see NrEesmExpSums()). The sum
+     * of each beta value is the same as the one returned by SinrExp().
+     *
+     * @param sinr the perceived sinrs in the whole bandwidth (vector, per RB)
+     * @param map the actives RBs for the TB
+     * @param betas the beta values
+     * @return the sum of exponential SINR for each beta value
+     */
+    static std::vector<double> SinrExpBatch(const SpectrumValue& sinr,
+                                            const std::vector<int>& map,
+                                            const std::vector<double>& betas);
+
+    /**
+     * @brief compute the sum of exponential SINRs for several beta values at once, from the
+     * SINR values without their SpectrumValue
+     *
+     * @param sinr the perceived sinrs in the whole bandwidth
+     * @param numValues the number of SINR values
+     * @param map the actives RBs for the TB, indices of the SINR values
+     * @param betas the beta values
+     * @return the sum of exponential SINR for each beta value
+     */
+    static std::vector<double> SinrExpBatch(const double* sinr,
+                                            size_t numValues,
+                                            const std::vector<int>& map,
+                                            const std::vector<double>& betas);
+
     /**
      * @brief Compute the effective SINR after retransmission combining
      * @param sinr SINR of the new transmission
@@ -321,26 +447,66 @@ class NrEesmErrorModel : public NrErrorModel
      */
     std::pair<uint32_t, uint32_t> CodeBlockSegmentation(uint32_t B, GraphType bg_type) const;
 
+    /**
+     * @brief Compute the TBLER from the CBLER and the number of code blocks
+     * @param cbler the code block error rate
+     * @param numCb the number of code blocks of the TB
+     * @return the transport block error rate
+     */
+    static double CblerToTbler(double cbler, uint32_t numCb);
+
+    /**
+     * @brief Effective SINR (in dB) above which a TB reaches the target TBLER,
+     * for a given combination of MCS, code block size and number of code blocks
+     */
+    struct SinrThreshold
+    {
+        double sinrDb{0.0};   //!< The threshold, in dB
+        bool inclusive{true}; //!< True if a SINR equal to the threshold reaches the target
+        bool exact{true};     //!< False if the threshold cannot represent the BLER curve
+    };
+
+    /**
+     * @brief Get (and compute, if it is not yet in the table) the SINR threshold
+     * @param mcs the MCS of the TB
+     * @param cbSizeBit the size of the CB in BITS
+     * @param numCb the number of code blocks of the TB
+     * @param targetTbler the target TBLER
+     * @return the SINR threshold
+     */
+    const SinrThreshold& GetSinrThreshold(uint8_t mcs,
+                                          uint32_t cbSizeBit,
+                                          uint32_t numCb,
+                                          double targetTbler);
+
+    std::unordered_map<uint64_t, SinrThreshold> m_sinrThresholds; //!< SINR threshold table
+    double m_sinrThresholdsTarget{-1.0}; //!< Target TBLER of m_sinrThresholds
+
+    /**
+     * @brief Get the BLER-SINR curve of the lowest simulated CB size that
+     * includes the CB, for removing CB size quantization errors
+     * @param graphType the LDPC base graph type
+     * @param mcs the MCS of the TB
+     * @param cbSizeBit the size of the CB in BITS
+     * @return the curve
+     */
+    const SimulatedBlerFromSINR::Curve& GetBlerCurve(GraphType graphType,
+                                                     uint8_t mcs,
+                                                     uint32_t cbSizeBit) const;
     /**
      * @brief Get SinrDb Vector From Simulated Values
-     * @param graphType
-     * @param mcs
-     * @param cbSizeIndex
-     * @return
+     * @param curve the BLER-SINR curve
+     * @return the SINR (in dB) of the points of the curve
      */
-    const std::vector<double>& GetSinrDbVectorFromSimulatedValues(GraphType graphType,
-                                                                  uint8_t mcs,
-                                                                  uint32_t cbSizeIndex) const;
+    std::span<const double> GetSinrDbVectorFromSimulatedValues(
+        const SimulatedBlerFromSINR::Curve& curve) const;
     /**
      * @brief Get BLER Vector From Simulated Values
-     * @param graphType
-     * @param mcs
-     * @param cbSizeIndex
-     * @return
-     */
-    const std::vector<double>& GetBLERVectorFromSimulatedValues(GraphType graphType,
-                                                                uint8_t mcs,
-                                                                uint32_t cbSizeIndex) const;
+     * @param curve the BLER-SINR curve
+     * @return the BLER of the points of the curve
+     */
+    std::span<const double> GetBLERVectorFromSimulatedValues(
+        const SimulatedBlerFromSINR::Curve& curve) const;
 };
 
 } // namespace ns3
@@ -0,0 +1,375 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-eesm-exp-sum.h"
+
+#include "fast-exp.h"
+
+#include "ns3/abort.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NR_EESM_EXP_SUM_X86
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC warns about the undefined vectors used internally by the intrinsics
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#endif
+
+namespace ns3
+{
+
+/// Number of partial sums of each beta value. Element n of the map is added to the partial sum
+/// n % EXP_SUM_LANES, so that the scalar and vectorized kernels add the values in the same order
+static constexpr size_t EXP_SUM_LANES = 8;
+
+/**
+ * @brief Kernel computing the partial sums of NrEesmExpSums
+ * @param sinr the linear SINR values
+ * @param map the indexes of the SINR values to use
+ * @param mapSize the number of indexes in map
+ * @param betas the beta values
+ * @param numBetas the number of beta values
+ * @param lanes the partial sums (EXP_SUM_LANES for each beta), must be initialized to 0
+ */
+typedef void (*ExpSumsKernel)(const double* sinr,
+                              const int* map,
+                              size_t mapSize,
+                              const double* betas,
+                              size_t numBetas,
+                              double* lanes);
+
+/**
+ * @brief Add the elements of the map from first to mapSize to the partial sums, with exp21d
+ * @param sinr the linear SINR values
+ * @param map the indexes of the SINR values to use
+ * @param first the first element of the map to add
+ * @param mapSize the number of indexes in map
+ * @param betas the beta values
+ * @param numBetas the number of beta values
+ * @param lanes the partial sums (EXP_SUM_LANES for each beta)
+ */
+static void
+ExpSumsTail(const double* sinr,
+            const int* map,
+            size_t first,
+            size_t mapSize,
+            const double* betas,
+            size_t numBetas,
+            double* lanes)
+{
+    for (size_t n = first; n < mapSize; ++n)
+    {
+        double sinrLin = sinr[map[n]];
+        for (size_t b = 0; b < numBetas; ++b)
+        {
+            lanes[b * EXP_SUM_LANES + n % EXP_SUM_LANES] += exp21d(-sinrLin / betas[b]);
+        }
+    }
+}
+
+static void
+ExpSumsScalar(const double* sinr,
+              const int* map,
+              size_t mapSize,
+              const double* betas,
+              size_t numBetas,
+              double* lanes)
+{
+    ExpSumsTail(sinr, map, 0, mapSize, betas, numBetas, lanes);
+}
+
+#ifdef NR_EESM_EXP_SUM_X86
+
+// Constants of exp21d, with the same conversions to double done by the scalar code
+static constexpr double EXP21D_K1 = static_cast<double>(0x00171547652B82FE);
+static constexpr double EXP21D_K2 = static_cast<double>(0x3FF0000000000000);
+static constexpr int64_t EXP21D_D2 = 8771752971182036;
+static constexpr int64_t EXP21D_D3 = 11827349474026;
+static constexpr double EXP21D_D1 = 7.4871095977966e-17;
+static constexpr int64_t EXP21D_EXP_MASK = static_cast<int64_t>(0xfff0000000000000);
+static constexpr int64_t EXP21D_MANT_MASK = 0x000fffffffffffff;
+
+/**
+ * @brief Truncate (towards zero) non-negative doubles lower than 2^63 into int64,
+ * as the scalar conversion does. AVX2 has no instruction for it.
+ * @param v the values
+ * @return the truncated values
+ */
+__attribute__((target("avx2"))) static inline __m256i
+TruncToInt64Avx2(__m256d v)
+{
+    __m256i bits = _mm256_castpd_si256(_mm256_round_pd(v, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+    __m256i exponent = _mm256_srli_epi64(bits, 52);
+    __m256i mantissa = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(EXP21D_MANT_MASK)),
+                                       _mm256_set1_epi64x(0x0010000000000000));
+    // Integer = mantissa * 2^(exponent - 1075). Shift counts out of [0, 63] (including the
+    // negative ones, seen as unsigned) produce 0, so only one of the shifts contributes
+    __m256i left = _mm256_sub_epi64(exponent, _mm256_set1_epi64x(1075));
+    __m256i right = _mm256_sub_epi64(_mm256_set1_epi64x(1075), exponent);
+    return _mm256_or_si256(_mm256_sllv_epi64(mantissa, left), _mm256_srlv_epi64(mantissa, right));
+}
+
+/**
+ * @brief Convert non-negative int64 into doubles, rounding to nearest as the scalar
+ * conversion does. AVX2 has no instruction for it.
+ * @param v the values
+ * @return the converted values
+ */
+__attribute__((target("avx2"))) static inline __m256d
+Int64ToDoubleAvx2(__m256i v)
+{
+    // The high and the low 32 bits are converted exactly, and their sum is rounded once
+    __m256i lo = _mm256_blend_epi32(_mm256_set1_epi64x(0x4330000000000000), v, 0x55); // 2^52 + lo
+    __m256i hi = _mm256_or_si256(_mm256_srli_epi64(v, 32),
+                                 _mm256_set1_epi64x(0x4530000000000000)); // 2^84 + hi * 2^32
+    __m256d hiD = _mm256_sub_pd(_mm256_castsi256_pd(hi),
+                                _mm256_set1_pd(19342813118337666422669312.0)); // 2^84 + 2^52
+    return _mm256_add_pd(hiD, _mm256_castsi256_pd(lo));
+}
+
+/**
+ * @brief exp21d() of 4 values
+ * @param x the exponents
+ * @return the approximated exponentials
+ */
+__attribute__((target("avx2"))) static inline __m256d
+Exp21dAvx2(__m256d x)
+{
+    const __m256d low = _mm256_set1_pd(-708.0);
+    const __m256d high = _mm256_set1_pd(709.0);
+    __m256d isLow = _mm256_cmp_pd(x, low, _CMP_LT_OQ);
+    __m256d isHigh = _mm256_cmp_pd(x, high, _CMP_GT_OQ);
+    // Clamp, so that the conversions below stay in range for all the lanes
+    x = _mm256_min_pd(_mm256_max_pd(x, low), high);
+
+    __m256i z = TruncToInt64Avx2(
+        _mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(EXP21D_K1)), _mm256_set1_pd(EXP21D_K2)));
+    __m256i zi = _mm256_and_si256(z, _mm256_set1_epi64x(EXP21D_EXP_MASK));
+    __m256i zif = _mm256_and_si256(z, _mm256_set1_epi64x(EXP21D_MANT_MASK));
+    __m256d d2 = Int64ToDoubleAvx2(_mm256_add_epi64(zif, _mm256_set1_epi64x(EXP21D_D2)));
+    __m256d d3 = Int64ToDoubleAvx2(_mm256_add_epi64(zif, _mm256_set1_epi64x(EXP21D_D3)));
+    d2 = _mm256_mul_pd(_mm256_set1_pd(EXP21D_D1), d2);
+    zif = TruncToInt64Avx2(_mm256_mul_pd(d2, d3));
+    __m256d y = _mm256_castsi256_pd(_mm256_or_si256(zi, zif));
+
+    y = _mm256_blendv_pd(y, _mm256_setzero_pd(), isLow);
+    return _mm256_blendv_pd(y,
+                            _mm256_set1_pd(std::numeric_limits<double>::infinity()),
+                            isHigh);
+}
+
+__attribute__((target("avx2"))) static void
+ExpSumsAvx2(const double* sinr,
+            const int* map,
+            size_t mapSize,
+            const double* betas,
+            size_t numBetas,
+            double* lanes)
+{
+    const __m256d signMask = _mm256_set1_pd(-0.0);
+    size_t numFull = mapSize - mapSize % EXP_SUM_LANES;
+    for (size_t n = 0; n < numFull; n += EXP_SUM_LANES)
+    {
+        __m128i idxLo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(map + n));
+        __m128i idxHi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(map + n + 4));
+        __m256d negSinrLo = _mm256_xor_pd(_mm256_i32gather_pd(sinr, idxLo, 8), signMask);
+        __m256d negSinrHi = _mm256_xor_pd(_mm256_i32gather_pd(sinr, idxHi, 8), signMask);
+        for (size_t b = 0; b < numBetas; ++b)
+        {
+            __m256d beta = _mm256_set1_pd(betas[b]);
+            double* lane = lanes + b * EXP_SUM_LANES;
+            _mm256_storeu_pd(lane,
+                             _mm256_add_pd(_mm256_loadu_pd(lane),
+                                           Exp21dAvx2(_mm256_div_pd(negSinrLo, beta))));
+            _mm256_storeu_pd(lane + 4,
+                             _mm256_add_pd(_mm256_loadu_pd(lane + 4),
+                                           Exp21dAvx2(_mm256_div_pd(negSinrHi, beta))));
+        }
+    }
+    ExpSumsTail(sinr, map, numFull, mapSize, betas, numBetas, lanes);
+}
+
+/**
+ * @brief exp21d() of 8 values
+ * @param x the exponents
+ * @return the approximated exponentials
+ */
+__attribute__((target("avx512f,avx512dq"))) static inline __m512d
+Exp21dAvx512(__m512d x)
+{
+    const __m512d low = _mm512_set1_pd(-708.0);
+    const __m512d high = _mm512_set1_pd(709.0);
+    __mmask8 isLow = _mm512_cmp_pd_mask(x, low, _CMP_LT_OQ);
+    __mmask8 isHigh = _mm512_cmp_pd_mask(x, high, _CMP_GT_OQ);
+    x = _mm512_min_pd(_mm512_max_pd(x, low), high);
+
+    __m512i z = _mm512_cvttpd_epi64(
+        _mm512_add_pd(_mm512_mul_pd(x, _mm512_set1_pd(EXP21D_K1)), _mm512_set1_pd(EXP21D_K2)));
+    __m512i zi = _mm512_and_si512(z, _mm512_set1_epi64(EXP21D_EXP_MASK));
+    __m512i zif = _mm512_and_si512(z, _mm512_set1_epi64(EXP21D_MANT_MASK));
+    __m512d d2 = _mm512_cvtepi64_pd(_mm512_add_epi64(zif, _mm512_set1_epi64(EXP21D_D2)));
+    __m512d d3 = _mm512_cvtepi64_pd(_mm512_add_epi64(zif, _mm512_set1_epi64(EXP21D_D3)));
+    d2 = _mm512_mul_pd(_mm512_set1_pd(EXP21D_D1), d2);
+    zif = _mm512_cvttpd_epi64(_mm512_mul_pd(d2, d3));
+    __m512d y = _mm512_castsi512_pd(_mm512_or_si512(zi, zif));
+
+    y = _mm512_mask_blend_pd(isLow, y, _mm512_setzero_pd());
+    return _mm512_mask_blend_pd(isHigh, y, _mm512_set1_pd(std::numeric_limits<double>::infinity()));
+}
+
+__attribute__((target("avx512f,avx512dq"))) static void
+ExpSumsAvx512(const double* sinr,
+              const int* map,
+              size_t mapSize,
+              const double* betas,
+              size_t numBetas,
+              double* lanes)
+{
+    static_assert(EXP_SUM_LANES == 8, "The AVX-512 kernel assumes 8 partial sums");
+    const __m512d zero = _mm512_setzero_pd();
+    size_t numFull = mapSize - mapSize % EXP_SUM_LANES;
+    for (size_t n = 0; n < numFull; n += EXP_SUM_LANES)
+    {
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(map + n));
+        __m512d negSinr = _mm512_sub_pd(zero, _mm512_i32gather_pd(idx, sinr, 8));
+        for (size_t b = 0; b < numBetas; ++b)
+        {
+            double* lane = lanes + b * EXP_SUM_LANES;
+            _mm512_storeu_pd(
+                lane,
+                _mm512_add_pd(_mm512_loadu_pd(lane),
+                              Exp21dAvx512(_mm512_div_pd(negSinr, _mm512_set1_pd(betas[b])))));
+        }
+    }
+    ExpSumsTail(sinr, map, numFull, mapSize, betas, numBetas, lanes);
+}
+
+#endif // NR_EESM_EXP_SUM_X86
+
+/// Kernel and name of an implementation of NrEesmExpSums
+typedef std::pair<ExpSumsKernel, const char*> NamedExpSumsKernel;
+
+/**
+ * @brief Get the kernels that the CPU running the simulation supports, detected the first
+ * time they are requested
+ * @return the kernels, from the fastest one to the scalar one
+ */
+static const std::vector<NamedExpSumsKernel>&
+GetSupportedExpSumsKernels()
+{
+    static const std::vector<NamedExpSumsKernel> kernels = []() {
+        std::vector<NamedExpSumsKernel> supported;
+#ifdef NR_EESM_EXP_SUM_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+        {
+            supported.emplace_back(ExpSumsAvx512, "avx512");
+        }
+        if (__builtin_cpu_supports("avx2"))
+        {
+            supported.emplace_back(ExpSumsAvx2, "avx2");
+        }
+#endif
+        supported.emplace_back(ExpSumsScalar, "scalar");
+        return supported;
+    }();
+    return kernels;
+}
+
+/**
+ * @brief Run a kernel and reduce its partial sums
+ * @param kernel the kernel
+ * @param sinr the linear SINR values
+ * @param map the indexes of the SINR values to use
+ * @param mapSize the number of indexes in map
+ * @param betas the beta values
+ * @param numBetas the number of beta values
+ * @param sums output: the sum of exponential SINRs for each beta value
+ */
+static void
+RunExpSumsKernel(ExpSumsKernel kernel,
+                 const double* sinr,
+                 const int* map,
+                 size_t mapSize,
+                 const double* betas,
+                 size_t numBetas,
+                 double* sums)
+{
+    std::vector<double> lanes(numBetas * EXP_SUM_LANES, 0.0);
+    kernel(sinr, map, mapSize, betas, numBetas, lanes.data());
+
+    for (size_t b = 0; b < numBetas; ++b)
+    {
+        double sum = 0.0;
+        for (size_t l = 0; l < EXP_SUM_LANES; ++l)
+        {
+            sum += lanes[b * EXP_SUM_LANES + l];
+        }
+        sums[b] = sum;
+    }
+}
+
+void
+NrEesmExpSums(const double* sinr,
+              const int* map,
+              size_t mapSize,
+              const double* betas,
+              size_t numBetas,
+              double* sums)
+{
+    RunExpSumsKernel(GetSupportedExpSumsKernels().front().first,
+                     sinr,
+                     map,
+                     mapSize,
+                     betas,
+                     numBetas,
+                     sums);
+}
+
+const char*
+NrEesmExpSumsImplementation()
+{
+    return GetSupportedExpSumsKernels().front().second;
+}
+
+std::vector<std::string>
+NrEesmExpSumsImplementations()
+{
+    std::vector<std::string> names;
+    for (const auto& kernel : GetSupportedExpSumsKernels())
+    {
+        names.emplace_back(kernel.second);
+    }
+    return names;
+}
+
+void
+NrEesmExpSumsWith(const std::string& implementation,
+                  const double* sinr,
+                  const int* map,
+                  size_t mapSize,
+                  const double* betas,
+                  size_t numBetas,
+                  double* sums)
+{
+    for (const auto& kernel : GetSupportedExpSumsKernels())
+    {
+        if (implementation == kernel.second)
+        {
+            RunExpSumsKernel(kernel.first, sinr, map, mapSize, betas, numBetas, sums);
+            return;
+        }
+    }
+    NS_ABORT_MSG("Implementation " << implementation << " not supported by this CPU");
+}
+
+} // namespace ns3
@@ -0,0 +1,80 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_EESM_EXP_SUM_H
+#define NR_EESM_EXP_SUM_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup error-models
+ * @brief Compute the EESM sums of exponential SINRs for several beta values
+ *
+ * For each beta value b, it computes sum_n (exp (-sinr[map[n]] / b)), with the
+ * exponential approximated by exp21d() (see fast-exp.h). Each SINR value is read
+ * only once, and used for all the beta values.
+ *
+ * The kernel is vectorized with AVX-512 or AVX2 when the CPU supports them
+ * (checked at runtime), with a scalar fallback. All the implementations compute
+ * each exponential exactly as exp21d(), and add them in the same order (8
+ * partial sums, interleaved over the RBs), so that the result does not depend
+ * on the implementation selected, nor on the number of beta values.
+ *
+ * @param sinr the linear SINR values
+ * @param map the indexes of the SINR values to use
+ * @param mapSize the number of indexes in map
+ * @param betas the beta values
+ * @param numBetas the number of beta values
+ * @param sums output: the sum of exponential SINRs for each beta value
+ */
+void NrEesmExpSums(const double* sinr,
+                   const int* map,
+                   size_t mapSize,
+                   const double* betas,
+                   size_t numBetas,
+                   double* sums);
+
+/**
+ * @ingroup error-models
+ * @brief Get the name of the implementation used by NrEesmExpSums()
+ * @return "avx512", "avx2" or "scalar"
+ */
+const char* NrEesmExpSumsImplementation();
+
+/**
+ * @ingroup error-models
+ * @brief Get the names of the implementations of NrEesmExpSums() that the CPU supports
+ * @return the names, from the one used by NrEesmExpSums() to "scalar"
+ */
+std::vector<std::string> NrEesmExpSumsImplementations();
+
+/**
+ * @ingroup error-models
+ * @brief Compute the sums of NrEesmExpSums() with a given implementation, e.g., to compare
+ * the implementations with each other
+ *
+ * @param implementation the name of the implementation, one of NrEesmExpSumsImplementations()
+ * @param sinr the linear SINR values
+ * @param map the indexes of the SINR values to use
+ * @param mapSize the number of indexes in map
+ * @param betas the beta values
+ * @param numBetas the number of beta values
+ * @param sums output: the sum of exponential SINRs for each beta value
+ */
+void NrEesmExpSumsWith(const std::string& implementation,
+                       const double* sinr,
+                       const int* map,
+                       size_t mapSize,
+                       const double* betas,
+                       size_t numBetas,
+                       double* sums);
+
+} // namespace ns3
+
+#endif // NR_EESM_EXP_SUM_H
@@ -12,19 +12,15 @@
 
 #include "nr-epc-tft.h"
 
-#include "ns3/icmpv4-l4-protocol.h"
-#include "ns3/icmpv6-l4-protocol.h"
-#include "ns3/ipv4-header.h"
 #include "ns3/ipv4-l3-protocol.h"
-#include "ns3/ipv6-header.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
-#include "ns3/tcp-header.h"
 #include "ns3/tcp-l4-protocol.h"
-#include "ns3/udp-header.h"
 #include "ns3/udp-l4-protocol.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -35,11 +31,15 @@ NrEpcTftClassifier::NrEpcTftClassifier()
     NS_LOG_FUNCTION(this);
 }
 
+/// Maximum number of flows whose result is cached per IP version
+static constexpr size_t MAX_CACHED_FLOWS = 1024;
+
 void
 NrEpcTftClassifier::Add(Ptr<NrEpcTft> tft, uint32_t id)
 {
     NS_LOG_FUNCTION(this << tft << id);
     m_tftMap[id] = tft;
+    m_compiled = false;
 
     // simple sanity check: there shouldn't be more than 16 bearers (hence TFTs) per UE
     NS_ASSERT(m_tftMap.size() <= 16);
@@ -50,56 +50,257 @@ NrEpcTftClassifier::Delete(uint32_t id)
 {
     NS_LOG_FUNCTION(this << id);
     m_tftMap.erase(id);
+    m_compiled = false;
 }
 
-uint32_t
-NrEpcTftClassifier::Classify(Ptr<Packet> p, NrEpcTft::Direction direction, uint16_t protocolNumber)
+bool
+NrEpcTftClassifier::FlowKey::operator==(const FlowKey& other) const
 {
-    NS_LOG_FUNCTION(this << p << p->GetSize() << direction);
+    return remoteAddress == other.remoteAddress && localAddress == other.localAddress &&
+           remotePort == other.remotePort && localPort == other.localPort &&
+           direction == other.direction && tos == other.tos;
+}
+
+size_t
+NrEpcTftClassifier::FlowKeyHash::operator()(const FlowKey& key) const
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](uint8_t byte) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    };
+    for (size_t i = 0; i < 16; ++i)
+    {
+        add(key.remoteAddress[i]);
+        add(key.localAddress[i]);
+    }
+    add(key.remotePort >> 8);
+    add(key.remotePort & 0xff);
+    add(key.localPort >> 8);
+    add(key.localPort & 0xff);
+    add(key.direction);
+    add(key.tos);
+    return static_cast<size_t>(hash);
+}
+
+bool
+NrEpcTftClassifier::IsCompiled() const
+{
+    if (!m_compiled || m_compiledTfts.size() != m_tftMap.size())
+    {
+        return false;
+    }
+    // Filters may have been added to a TFT after it was added to the classifier
+    for (const auto& [tft, numFilters] : m_compiledTfts)
+    {
+        if (tft->GetNumFilters() != numFilters)
+        {
+            return false;
+        }
+    }
+    return true;
+}
 
-    Ptr<Packet> pCopy = p->Copy();
+void
+NrEpcTftClassifier::Compile()
+{
+    NS_LOG_FUNCTION(this);
 
-    Ipv4Address localAddressIpv4;
-    Ipv4Address remoteAddressIpv4;
+    m_ipv4Index = FilterIndex();
+    m_ipv6Index = FilterIndex();
+    m_compiledTfts.clear();
+
+    // Add a filter to the shape of its masks and single-valued ports, for each of its
+    // directions
+    auto addFilter = [](FilterIndex& index,
+                        const std::array<uint8_t, 16>& remoteAddress,
+                        const std::array<uint8_t, 16>& remoteMask,
+                        const std::array<uint8_t, 16>& localAddress,
+                        const std::array<uint8_t, 16>& localMask,
+                        const NrEpcTft::PacketFilter& f,
+                        uint32_t id) {
+        bool remotePortExact = f.remotePortStart == f.remotePortEnd;
+        bool localPortExact = f.localPortStart == f.localPortEnd;
+        FilterShape* shape = nullptr;
+        for (auto& s : index.shapes)
+        {
+            if (s.remoteMask == remoteMask && s.localMask == localMask &&
+                s.remotePortExact == remotePortExact && s.localPortExact == localPortExact)
+            {
+                shape = &s;
+                break;
+            }
+        }
+        if (shape == nullptr)
+        {
+            shape = &index.shapes.emplace_back();
+            shape->remoteMask = remoteMask;
+            shape->localMask = localMask;
+            shape->remotePortExact = remotePortExact;
+            shape->localPortExact = localPortExact;
+        }
 
-    Ipv6Address localAddressIpv6;
-    Ipv6Address remoteAddressIpv6;
+        FlowKey key;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            key.remoteAddress[i] = remoteAddress[i] & remoteMask[i];
+            key.localAddress[i] = localAddress[i] & localMask[i];
+        }
+        key.remotePort = remotePortExact ? f.remotePortStart : 0;
+        key.localPort = localPortExact ? f.localPortStart : 0;
+        CompiledFilter compiled{id,
+                                f.remotePortStart,
+                                f.remotePortEnd,
+                                f.localPortStart,
+                                f.localPortEnd,
+                                f.typeOfService,
+                                f.typeOfServiceMask};
+        for (uint8_t direction : {NrEpcTft::DOWNLINK, NrEpcTft::UPLINK})
+        {
+            if (f.direction & direction)
+            {
+                key.direction = direction;
+                shape->filters[key].push_back(compiled);
+            }
+        }
+    };
 
-    uint8_t protocol;
-    uint8_t tos;
+    // m_tftMap is iterated by decreasing identifier, so that the filters of each key are
+    // sorted by decreasing identifier too
+    for (auto it = m_tftMap.rbegin(); it != m_tftMap.rend(); ++it)
+    {
+        m_compiledTfts.emplace_back(it->second, it->second->GetNumFilters());
+        for (const auto& f : it->second->GetPacketFilters())
+        {
+            std::array<uint8_t, 16> remoteAddress{};
+            std::array<uint8_t, 16> remoteMask{};
+            std::array<uint8_t, 16> localAddress{};
+            std::array<uint8_t, 16> localMask{};
+            f.remoteAddress.Serialize(remoteAddress.data());
+            f.localAddress.Serialize(localAddress.data());
+            for (size_t i = 0; i < 4; ++i)
+            {
+                remoteMask[i] = (f.remoteMask.Get() >> (24 - 8 * i)) & 0xff;
+                localMask[i] = (f.localMask.Get() >> (24 - 8 * i)) & 0xff;
+            }
+            addFilter(m_ipv4Index,
+                      remoteAddress,
+                      remoteMask,
+                      localAddress,
+                      localMask,
+                      f,
+                      it->first);
+
+            f.remoteIpv6Address.GetBytes(remoteAddress.data());
+            f.remoteIpv6Prefix.GetBytes(remoteMask.data());
+            f.localIpv6Address.GetBytes(localAddress.data());
+            f.localIpv6Prefix.GetBytes(localMask.data());
+            addFilter(m_ipv6Index,
+                      remoteAddress,
+                      remoteMask,
+                      localAddress,
+                      localMask,
+                      f,
+                      it->first);
+        }
+    }
+    m_compiled = true;
+}
 
-    uint16_t localPort = 0;
-    uint16_t remotePort = 0;
+uint32_t
+NrEpcTftClassifier::Lookup(FilterIndex& index, const FlowKey& flow)
+{
+    auto cached = index.flows.find(flow);
+    if (cached != index.flows.end())
+    {
+        NS_LOG_LOGIC("cached flow, TFT ID = " << cached->second);
+        return cached->second;
+    }
 
-    if (protocolNumber == Ipv4L3Protocol::PROT_NUMBER)
+    uint32_t id = 0;
+    for (const auto& shape : index.shapes)
     {
-        Ipv4Header ipv4Header;
-        pCopy->RemoveHeader(ipv4Header);
+        FlowKey key;
+        for (size_t i = 0; i < 16; ++i)
+        {
+            key.remoteAddress[i] = flow.remoteAddress[i] & shape.remoteMask[i];
+            key.localAddress[i] = flow.localAddress[i] & shape.localMask[i];
+        }
+        key.remotePort = shape.remotePortExact ? flow.remotePort : 0;
+        key.localPort = shape.localPortExact ? flow.localPort : 0;
+        key.direction = flow.direction;
 
-        if (direction == NrEpcTft::UPLINK)
+        auto it = shape.filters.find(key);
+        if (it == shape.filters.end())
         {
-            localAddressIpv4 = ipv4Header.GetSource();
-            remoteAddressIpv4 = ipv4Header.GetDestination();
+            continue;
         }
-        else
+        for (const auto& f : it->second)
         {
-            NS_ASSERT(direction == NrEpcTft::DOWNLINK);
-            remoteAddressIpv4 = ipv4Header.GetSource();
-            localAddressIpv4 = ipv4Header.GetDestination();
+            if (f.id <= id)
+            {
+                break;
+            }
+            if (f.remotePortStart <= flow.remotePort && flow.remotePort <= f.remotePortEnd &&
+                f.localPortStart <= flow.localPort && flow.localPort <= f.localPortEnd &&
+                (flow.tos & f.typeOfServiceMask) == (f.typeOfService & f.typeOfServiceMask))
+            {
+                id = f.id;
+                break;
+            }
         }
-        NS_LOG_INFO("local address: " << localAddressIpv4
-                                      << " remote address: " << remoteAddressIpv4);
+    }
 
-        uint16_t payloadSize = ipv4Header.GetPayloadSize();
-        uint16_t fragmentOffset = ipv4Header.GetFragmentOffset();
-        bool isLastFragment = ipv4Header.IsLastFragment();
+    if (index.flows.size() >= MAX_CACHED_FLOWS)
+    {
+        index.flows.clear();
+    }
+    index.flows.emplace(flow, id);
+    return id;
+}
 
-        // NS_LOG_DEBUG ("PayloadSize = " << payloadSize);
-        // NS_LOG_DEBUG ("fragmentOffset " << fragmentOffset << " isLastFragment " <<
-        // isLastFragment);
+uint32_t
+NrEpcTftClassifier::Classify(Ptr<Packet> p, NrEpcTft::Direction direction, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << p << p->GetSize() << direction);
+    NS_ASSERT(direction == NrEpcTft::UPLINK || direction == NrEpcTft::DOWNLINK);
+
+    // Enough for an IPv4 header with options, or an IPv6 header, and the ports
+    uint8_t buffer[64];
+    uint32_t size = p->CopyData(buffer, sizeof(buffer));
+    auto readU16 = [&buffer](uint32_t offset) -> uint16_t {
+        return (buffer[offset] << 8) | buffer[offset + 1];
+    };
+
+    FlowKey flow;
+    flow.direction = direction;
+    uint32_t sourceOffset = 0;
+    uint32_t destinationOffset = 0;
+    uint32_t addressSize = 0;
+    uint32_t l4Offset = 0;
+    bool hasPorts = false;
 
-        protocol = ipv4Header.GetProtocol();
-        tos = ipv4Header.GetTos();
+    if (protocolNumber == Ipv4L3Protocol::PROT_NUMBER)
+    {
+        NS_ASSERT_MSG(size >= 20, "Packet too short for an IPv4 header");
+        uint32_t headerSize = (buffer[0] & 0x0f) * 4;
+        uint16_t payloadSize = readU16(2) - headerSize;
+        uint16_t identification = readU16(4);
+        bool isLastFragment = !(buffer[6] & 0x20);
+        uint16_t fragmentOffset = (readU16(6) & 0x1fff) * 8;
+        uint8_t protocol = buffer[9];
+        flow.tos = buffer[1];
+        sourceOffset = 12;
+        destinationOffset = 16;
+        addressSize = 4;
+        l4Offset = headerSize;
+
+        std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
+            std::make_tuple((uint32_t(readU16(12)) << 16) | readU16(14),
+                            (uint32_t(readU16(16)) << 16) | readU16(18),
+                            protocol,
+                            identification);
 
         // Port info only can be get if it is the first fragment and
         // there is enough data in the payload
@@ -107,55 +308,18 @@ NrEpcTftClassifier::Classify(Ptr<Packet> p, NrEpcTft::Direction direction, uint1
         // i.e. it is the first one but it is not the last one
         if (fragmentOffset == 0)
         {
-            if (protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8)
+            if ((protocol == UdpL4Protocol::PROT_NUMBER && payloadSize >= 8) ||
+                (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20))
             {
-                UdpHeader udpHeader;
-                pCopy->RemoveHeader(udpHeader);
-                if (direction == NrEpcTft::UPLINK)
-                {
-                    localPort = udpHeader.GetSourcePort();
-                    remotePort = udpHeader.GetDestinationPort();
-                }
-                else
-                {
-                    remotePort = udpHeader.GetSourcePort();
-                    localPort = udpHeader.GetDestinationPort();
-                }
-                if (!isLastFragment)
-                {
-                    std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-                        std::make_tuple(ipv4Header.GetSource().Get(),
-                                        ipv4Header.GetDestination().Get(),
-                                        protocol,
-                                        ipv4Header.GetIdentification());
-
-                    m_classifiedIpv4Fragments[fragmentKey] = std::make_pair(localPort, remotePort);
-                }
-            }
-            else if (protocol == TcpL4Protocol::PROT_NUMBER && payloadSize >= 20)
-            {
-                TcpHeader tcpHeader;
-                pCopy->RemoveHeader(tcpHeader);
-                if (direction == NrEpcTft::UPLINK)
-                {
-                    localPort = tcpHeader.GetSourcePort();
-                    remotePort = tcpHeader.GetDestinationPort();
-                }
-                else
+                hasPorts = size >= l4Offset + 4;
+                if (hasPorts && !isLastFragment)
                 {
-                    remotePort = tcpHeader.GetSourcePort();
-                    localPort = tcpHeader.GetDestinationPort();
-                }
-
-                if (!isLastFragment)
-                {
-                    std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-                        std::make_tuple(ipv4Header.GetSource().Get(),
-                                        ipv4Header.GetDestination().Get(),
-                                        protocol,
-                                        ipv4Header.GetIdentification());
-
-                    m_classifiedIpv4Fragments[fragmentKey] = std::make_pair(localPort, remotePort);
+                    uint16_t sourcePort = readU16(l4Offset);
+                    uint16_t destinationPort = readU16(l4Offset + 2);
+                    m_classifiedIpv4Fragments[fragmentKey] =
+                        direction == NrEpcTft::UPLINK
+                            ? std::make_pair(sourcePort, destinationPort)
+                            : std::make_pair(destinationPort, sourcePort);
                 }
             }
 
@@ -167,149 +331,90 @@ NrEpcTftClassifier::Classify(Ptr<Packet> p, NrEpcTft::Direction direction, uint1
         {
             // Not first fragment, so port info is not available but
             // port info should already be known (if there is not fragment reordering)
-            std::tuple<uint32_t, uint32_t, uint8_t, uint16_t> fragmentKey =
-                std::make_tuple(ipv4Header.GetSource().Get(),
-                                ipv4Header.GetDestination().Get(),
-                                protocol,
-                                ipv4Header.GetIdentification());
-
             auto it = m_classifiedIpv4Fragments.find(fragmentKey);
 
             if (it != m_classifiedIpv4Fragments.end())
             {
-                localPort = it->second.first;
-                remotePort = it->second.second;
+                flow.localPort = it->second.first;
+                flow.remotePort = it->second.second;
 
                 if (isLastFragment)
                 {
-                    m_classifiedIpv4Fragments.erase(fragmentKey);
+                    m_classifiedIpv4Fragments.erase(it);
                 }
             }
         }
     }
     else if (protocolNumber == Ipv6L3Protocol::PROT_NUMBER)
     {
-        Ipv6Header ipv6Header;
-        pCopy->RemoveHeader(ipv6Header);
-
-        if (direction == NrEpcTft::UPLINK)
-        {
-            localAddressIpv6 = ipv6Header.GetSource();
-            remoteAddressIpv6 = ipv6Header.GetDestination();
-        }
-        else
-        {
-            NS_ASSERT(direction == NrEpcTft::DOWNLINK);
-            remoteAddressIpv6 = ipv6Header.GetSource();
-            localAddressIpv6 = ipv6Header.GetDestination();
-        }
-        NS_LOG_INFO("local address: " << localAddressIpv6
-                                      << " remote address: " << remoteAddressIpv6);
-
-        protocol = ipv6Header.GetNextHeader();
-        tos = ipv6Header.GetTrafficClass();
-
-        if (protocol == UdpL4Protocol::PROT_NUMBER)
-        {
-            UdpHeader udpHeader;
-            pCopy->RemoveHeader(udpHeader);
+        NS_ASSERT_MSG(size >= 40, "Packet too short for an IPv6 header");
+        uint8_t protocol = buffer[6];
+        flow.tos = ((buffer[0] & 0x0f) << 4) | (buffer[1] >> 4);
+        sourceOffset = 8;
+        destinationOffset = 24;
+        addressSize = 16;
+        l4Offset = 40;
+        hasPorts = (protocol == UdpL4Protocol::PROT_NUMBER ||
+                    protocol == TcpL4Protocol::PROT_NUMBER) &&
+                   size >= l4Offset + 4;
+    }
+    else
+    {
+        NS_ABORT_MSG("NrEpcTftClassifier::Classify - Unknown IP type...");
+    }
 
-            if (direction == NrEpcTft::UPLINK)
-            {
-                localPort = udpHeader.GetSourcePort();
-                remotePort = udpHeader.GetDestinationPort();
-            }
-            else
-            {
-                remotePort = udpHeader.GetSourcePort();
-                localPort = udpHeader.GetDestinationPort();
-            }
-        }
-        else if (protocol == TcpL4Protocol::PROT_NUMBER)
+    if (direction == NrEpcTft::UPLINK)
+    {
+        std::copy_n(buffer + sourceOffset, addressSize, flow.localAddress.begin());
+        std::copy_n(buffer + destinationOffset, addressSize, flow.remoteAddress.begin());
+        if (hasPorts)
         {
-            TcpHeader tcpHeader;
-            pCopy->RemoveHeader(tcpHeader);
-            if (direction == NrEpcTft::UPLINK)
-            {
-                localPort = tcpHeader.GetSourcePort();
-                remotePort = tcpHeader.GetDestinationPort();
-            }
-            else
-            {
-                remotePort = tcpHeader.GetSourcePort();
-                localPort = tcpHeader.GetDestinationPort();
-            }
+            flow.localPort = readU16(l4Offset);
+            flow.remotePort = readU16(l4Offset + 2);
         }
     }
     else
     {
-        NS_ABORT_MSG("NrEpcTftClassifier::Classify - Unknown IP type...");
+        std::copy_n(buffer + sourceOffset, addressSize, flow.remoteAddress.begin());
+        std::copy_n(buffer + destinationOffset, addressSize, flow.localAddress.begin());
+        if (hasPorts)
+        {
+            flow.remotePort = readU16(l4Offset);
+            flow.localPort = readU16(l4Offset + 2);
+        }
     }
 
     if (protocolNumber == Ipv4L3Protocol::PROT_NUMBER)
     {
         NS_LOG_INFO("Classifying packet:"
-                    << " localAddr=" << localAddressIpv4 << " remoteAddr=" << remoteAddressIpv4
-                    << " localPort=" << localPort << " remotePort=" << remotePort << " tos=0x"
-                    << (uint16_t)tos);
-
-        // now it is possible to classify the packet!
-        // we use a reverse iterator since filter priority is not implemented properly.
-        // This way, since the default bearer is expected to be added first, it will be evaluated
-        // last.
-        std::map<uint32_t, Ptr<NrEpcTft>>::const_reverse_iterator it;
-        NS_LOG_LOGIC("TFT MAP size: " << m_tftMap.size());
-
-        for (it = m_tftMap.rbegin(); it != m_tftMap.rend(); ++it)
-        {
-            NS_LOG_LOGIC("TFT id: " << it->first);
-            NS_LOG_LOGIC(" Ptr<NrEpcTft>: " << it->second);
-            Ptr<NrEpcTft> tft = it->second;
-            if (tft->Matches(direction,
-                             remoteAddressIpv4,
-                             localAddressIpv4,
-                             remotePort,
-                             localPort,
-                             tos))
-            {
-                NS_LOG_LOGIC("matches with TFT ID = " << it->first);
-                return it->first; // the id of the matching TFT
-            }
-        }
+                    << " localAddr=" << Ipv4Address::Deserialize(flow.localAddress.data())
+                    << " remoteAddr=" << Ipv4Address::Deserialize(flow.remoteAddress.data())
+                    << " localPort=" << flow.localPort << " remotePort=" << flow.remotePort
+                    << " tos=0x" << (uint16_t)flow.tos);
     }
-    else if (protocolNumber == Ipv6L3Protocol::PROT_NUMBER)
+    else
     {
         NS_LOG_INFO("Classifying packet:"
-                    << " localAddr=" << localAddressIpv6 << " remoteAddr=" << remoteAddressIpv6
-                    << " localPort=" << localPort << " remotePort=" << remotePort << " tos=0x"
-                    << (uint16_t)tos);
-
-        // now it is possible to classify the packet!
-        // we use a reverse iterator since filter priority is not implemented properly.
-        // This way, since the default bearer is expected to be added first, it will be evaluated
-        // last.
-        std::map<uint32_t, Ptr<NrEpcTft>>::const_reverse_iterator it;
-        NS_LOG_LOGIC("TFT MAP size: " << m_tftMap.size());
-
-        for (it = m_tftMap.rbegin(); it != m_tftMap.rend(); ++it)
-        {
-            NS_LOG_LOGIC("TFT id: " << it->first);
-            NS_LOG_LOGIC(" Ptr<NrEpcTft>: " << it->second);
-            Ptr<NrEpcTft> tft = it->second;
-            if (tft->Matches(direction,
-                             remoteAddressIpv6,
-                             localAddressIpv6,
-                             remotePort,
-                             localPort,
-                             tos))
-            {
-                NS_LOG_LOGIC("matches with TFT ID = " << it->first);
-                return it->first; // the id of the matching TFT
-            }
-        }
+                    << " localAddr=" << Ipv6Address(flow.localAddress.data())
+                    << " remoteAddr=" << Ipv6Address(flow.remoteAddress.data())
+                    << " localPort=" << flow.localPort << " remotePort=" << flow.remotePort
+                    << " tos=0x" << (uint16_t)flow.tos);
+    }
+
+    if (!IsCompiled())
+    {
+        Compile();
     }
-    NS_LOG_LOGIC("no match");
-    return 0; // no match
+    NS_LOG_LOGIC("TFT MAP size: " << m_tftMap.size());
+
+    // Since filter priority is not implemented properly, the TFT with the highest identifier
+    // among the matching ones is selected. This way, since the default bearer is expected to
+    // be added first, it is selected last.
+    uint32_t id = Lookup(protocolNumber == Ipv4L3Protocol::PROT_NUMBER ? m_ipv4Index
+                                                                       : m_ipv6Index,
+                         flow);
+    NS_LOG_LOGIC(((id == 0) ? "no match" : "matches with TFT ID = ") << id);
+    return id;
 }
 
 } // namespace ns3
@@ -12,7 +12,10 @@
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
 
+#include <array>
 #include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -35,6 +38,15 @@ class Packet;
  *
  * When we cannot cache the port info, the TFT of the default bearer is used. This may happen
  * if there is reordering or losses of IP packets.
+ *
+ * The headers are read in place, without copying the packet. The packet filters of all the
+ * TFTs are compiled, on the first packet after a change, into an index per IP version, made
+ * of one hash table per filter shape, i.e. per combination of address masks and of port
+ * fields with a single value. The key of a table is the direction, the masked addresses and
+ * the single-valued ports; the port ranges and the type of service of the filters of a key
+ * are checked afterwards, from the highest TFT identifier down, which gives the same result
+ * as evaluating the TFTs one by one. The result of each flow is cached until the next change
+ * of the TFTs. Filters added to a TFT after it was added to the classifier are detected too.
  */
 class NrEpcTftClassifier : public SimpleRefCount<NrEpcTftClassifier>
 {
@@ -70,8 +82,90 @@ class NrEpcTftClassifier : public SimpleRefCount<NrEpcTftClassifier>
     uint32_t Classify(Ptr<Packet> p, NrEpcTft::Direction direction, uint16_t protocolNumber);
 
   protected:
+    /// Addresses and ports of a flow, or of a filter within a filter shape
+    struct FlowKey
+    {
+        std::array<uint8_t, 16> remoteAddress{}; ///< Remote address (IPv4 in the first 4 bytes)
+        std::array<uint8_t, 16> localAddress{};  ///< Local address (IPv4 in the first 4 bytes)
+        uint16_t remotePort{0};                  ///< Remote port
+        uint16_t localPort{0};                   ///< Local port
+        uint8_t direction{0};                    ///< Direction (UPLINK or DOWNLINK)
+        uint8_t tos{0};                          ///< Type of service (0 in the filter keys)
+
+        /**
+         * @param other another key
+         * @return true if the keys are equal
+         */
+        bool operator==(const FlowKey& other) const;
+    };
+
+    /// Hash of a FlowKey
+    struct FlowKeyHash
+    {
+        /**
+         * @param key the key
+         * @return the hash of the key
+         */
+        size_t operator()(const FlowKey& key) const;
+    };
+
+    /// Fields of a packet filter that are not part of the key of its filter shape
+    struct CompiledFilter
+    {
+        uint32_t id;               ///< Identifier of the TFT
+        uint16_t remotePortStart;  ///< Start of the remote port range
+        uint16_t remotePortEnd;    ///< End of the remote port range
+        uint16_t localPortStart;   ///< Start of the local port range
+        uint16_t localPortEnd;     ///< End of the local port range
+        uint8_t typeOfService;     ///< Type of service
+        uint8_t typeOfServiceMask; ///< Type of service mask
+    };
+
+    /// Packet filters with the same address masks and single-valued port fields
+    struct FilterShape
+    {
+        std::array<uint8_t, 16> remoteMask{}; ///< Mask of the remote address
+        std::array<uint8_t, 16> localMask{};  ///< Mask of the local address
+        bool remotePortExact{false};          ///< True if the remote port is in the key
+        bool localPortExact{false};           ///< True if the local port is in the key
+        std::unordered_map<FlowKey, std::vector<CompiledFilter>, FlowKeyHash>
+            filters; ///< Filters per key, by decreasing TFT identifier
+    };
+
+    /// Compiled filters and cached results of an IP version
+    struct FilterIndex
+    {
+        std::vector<FilterShape> shapes;                          ///< Filter shapes
+        std::unordered_map<FlowKey, uint32_t, FlowKeyHash> flows; ///< Cached results per flow
+    };
+
+    /**
+     * @return true if the index was compiled from the current TFTs
+     */
+    bool IsCompiled() const;
+
+    /**
+     * Compile the packet filters of all the TFTs into m_ipv4Index and m_ipv6Index
+     */
+    void Compile();
+
+    /**
+     * Find the TFT of a flow in an index
+     * @param index the index of the IP version of the flow
+     * @param flow the addresses, ports, type of service and direction of the flow
+     * @return the identifier of the matching TFT with the highest identifier; 0 if no TFT
+     * matched
+     */
+    uint32_t Lookup(FilterIndex& index, const FlowKey& flow);
+
     std::map<uint32_t, Ptr<NrEpcTft>> m_tftMap; ///< TFT map
 
+    FilterIndex m_ipv4Index; ///< Index of the IPv4 packet filters
+    FilterIndex m_ipv6Index; ///< Index of the IPv6 packet filters
+    bool m_compiled{false};  ///< True if the indexes are up to date with m_tftMap
+    std::vector<std::pair<Ptr<NrEpcTft>, uint8_t>>
+        m_compiledTfts; ///< TFTs and their number of filters when the indexes were compiled
+
     std::map<std::tuple<uint32_t, uint32_t, uint8_t, uint16_t>, std::pair<uint32_t, uint32_t>>
         m_classifiedIpv4Fragments; ///< Map with already classified IPv4 Fragments
                                    ///< An entry is added when the port info is available, i.e.
@@ -299,4 +299,10 @@ NrEpcTft::GetPacketFilters() const
     return m_filters;
 }
 
+uint8_t
+NrEpcTft::GetNumFilters() const
+{
+    return m_numFilters;
+}
+
 } // namespace ns3
@@ -178,6 +178,13 @@ class NrEpcTft : public SimpleRefCount<NrEpcTft>
      */
     std::list<PacketFilter> GetPacketFilters() const;
 
+    /**
+     * Get the number of packet filters. As filters can only be added, it changes whenever
+     * the TFT does.
+     * @return the number of packet filters
+     */
+    uint8_t GetNumFilters() const;
+
   private:
     std::list<PacketFilter> m_filters; ///< packet filter list
     uint8_t m_numFilters;              ///< number of packet filters applied to this TFT
@@ -491,6 +491,7 @@ NrGnbMac::DoDispose()
     m_ulCqiReceived.clear();
     m_ulCeReceived.clear();
     m_miDlHarqProcessesPackets.clear();
+    m_parallelScheduling = nullptr;
     delete m_macSapProvider;
     delete m_cmacSapProvider;
     delete m_macSchedSapUser;
@@ -634,7 +635,8 @@ NrGnbMac::DoSlotDlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
                                       m_dlCqiReceived.end());
         m_dlCqiReceived.erase(m_dlCqiReceived.begin(), m_dlCqiReceived.end());
 
-        m_macSchedSapProvider->SchedDlCqiInfoReq(dlCqiInfoReq);
+        CallScheduler(
+            [this, dlCqiInfoReq]() { m_macSchedSapProvider->SchedDlCqiInfoReq(dlCqiInfoReq); });
 
         for (const auto& v : dlCqiInfoReq.m_cqiList)
         {
@@ -672,11 +674,15 @@ NrGnbMac::DoSlotDlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
             params.m_beamId = m_phySapProvider->GetBeamId(ue.first);
             params.m_transmissionMode = 0; // set to default value (SISO) for avoiding random
                                            // initialization (valgrind error)
-            m_macCschedSapProvider->CschedUeConfigReq(params);
+            CallScheduler([this, params]() { m_macCschedSapProvider->CschedUeConfigReq(params); });
         }
     }
 
-    m_macSchedSapProvider->SchedDlTriggerReq(dlParams);
+    CallScheduler(
+        [this, dlParams = std::move(dlParams)]() {
+            m_macSchedSapProvider->SchedDlTriggerReq(dlParams);
+        },
+        true);
 }
 
 void
@@ -731,7 +737,9 @@ NrGnbMac::ProcessRaPreambles(const SfnSf& sfnSf)
     }
 
     m_receivedRachPreambleCount.clear();
-    m_macSchedSapProvider->SchedDlRachInfoReq(rachInfoReqParams);
+    CallScheduler([this, rachInfoReqParams = std::move(rachInfoReqParams)]() {
+        m_macSchedSapProvider->SchedDlRachInfoReq(rachInfoReqParams);
+    });
 }
 
 void
@@ -751,7 +759,9 @@ NrGnbMac::DoSlotUlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
     {
         // m_ulCqiReceived.at (i).m_sfnSf = ((0x3FF & frameNum) << 16) | ((0xFF & subframeNum) << 8)
         // | (0xFF & varTtiNum);
-        m_macSchedSapProvider->SchedUlCqiInfoReq(i);
+        CallScheduler([this, ulCqi = std::move(i)]() {
+            m_macSchedSapProvider->SchedUlCqiInfoReq(ulCqi);
+        });
     }
     m_ulCqiReceived.clear();
 
@@ -762,7 +772,7 @@ NrGnbMac::DoSlotUlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
         params.m_srList.insert(params.m_srList.begin(), m_srRntiList.begin(), m_srRntiList.end());
         m_srRntiList.clear();
 
-        m_macSchedSapProvider->SchedUlSrInfoReq(params);
+        CallScheduler([this, params]() { m_macSchedSapProvider->SchedUlSrInfoReq(params); });
 
         for (const auto& v : params.m_srList)
         {
@@ -781,7 +791,8 @@ NrGnbMac::DoSlotUlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
                                     m_ulCeReceived.begin(),
                                     m_ulCeReceived.end());
         m_ulCeReceived.erase(m_ulCeReceived.begin(), m_ulCeReceived.end());
-        m_macSchedSapProvider->SchedUlMacCtrlInfoReq(ulMacReq);
+        CallScheduler(
+            [this, ulMacReq]() { m_macSchedSapProvider->SchedUlMacCtrlInfoReq(ulMacReq); });
 
         for (const auto& v : ulMacReq.m_macCeList)
         {
@@ -804,7 +815,40 @@ NrGnbMac::DoSlotUlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
         m_ulHarqInfoReceived.clear();
     }
 
-    m_macSchedSapProvider->SchedUlTriggerReq(ulParams);
+    CallScheduler(
+        [this, ulParams = std::move(ulParams)]() {
+            m_macSchedSapProvider->SchedUlTriggerReq(ulParams);
+        },
+        true);
+}
+
+void
+NrGnbMac::SetParallelScheduling(const Ptr<NrParallelScheduling>& parallelScheduling)
+{
+    NS_LOG_FUNCTION(this << parallelScheduling);
+    m_parallelScheduling = parallelScheduling;
+}
+
+void
+NrGnbMac::CallScheduler(std::function<void()> call, bool trigger)
+{
+    if (m_parallelScheduling)
+    {
+        m_parallelScheduling->Enqueue(GetCellId(), std::move(call), trigger);
+    }
+    else
+    {
+        call();
+    }
+}
+
+void
+NrGnbMac::FlushScheduling()
+{
+    if (m_parallelScheduling)
+    {
+        m_parallelScheduling->Flush(GetCellId());
+    }
 }
 
 void
@@ -1082,6 +1126,7 @@ void
 NrGnbMac::DoTransmitBufferStatusReport(NrMacSapProvider::BufferStatusReportParameters params)
 {
     NS_LOG_FUNCTION(this);
+    FlushScheduling();
     NrMacSchedSapProvider::SchedDlRlcBufferReqParameters schedParams;
     schedParams.m_logicalChannelIdentity = params.lcid;
     schedParams.m_rlcRetransmissionHolDelay = params.retxQueueHolDelay;
@@ -1193,6 +1238,14 @@ NrGnbMac::HasMsg3Allocations(const SlotAllocInfo& slotInfo)
 void
 NrGnbMac::DoSchedConfigIndication(NrMacSchedSapUser::SchedConfigIndParameters ind)
 {
+    if (NrParallelScheduling::IsInTrigger())
+    {
+        // The allocation reaches the PHY and the RLC in the main thread, in cell ID order
+        NrParallelScheduling::Defer(
+            [this, ind = std::move(ind)]() { DoSchedConfigIndication(ind); });
+        return;
+    }
+
     NS_ASSERT(ind.m_sfnSf.GetNumerology() == m_currentSlot.GetNumerology());
     std::stable_sort(ind.m_slotAllocInfo.m_varTtiAllocInfo.begin(),
                      ind.m_slotAllocInfo.m_varTtiAllocInfo.end());
@@ -1372,6 +1425,7 @@ NrGnbMac::DoConfigureMac(uint16_t ulBandwidth, uint16_t dlBandwidth)
 void
 NrGnbMac::BeamChangeReport(BeamId beamId, uint8_t rnti)
 {
+    FlushScheduling();
     NrMacCschedSapProvider::CschedUeConfigReqParameters params;
     params.m_rnti = rnti;
     params.m_beamId = beamId;
@@ -1441,6 +1495,7 @@ void
 NrGnbMac::DoAddUe(uint16_t rnti)
 {
     NS_LOG_FUNCTION(this << " rnti=" << rnti);
+    FlushScheduling();
     std::unordered_map<uint8_t, NrMacSapUser*> empty;
     std::pair<std::unordered_map<uint16_t, std::unordered_map<uint8_t, NrMacSapUser*>>::iterator,
               bool>
@@ -1471,6 +1526,7 @@ void
 NrGnbMac::DoRemoveUe(uint16_t rnti)
 {
     NS_LOG_FUNCTION(this << " rnti=" << rnti);
+    FlushScheduling();
     NrMacCschedSapProvider::CschedUeReleaseReqParameters params;
     params.m_rnti = rnti;
     m_macCschedSapProvider->CschedUeReleaseReq(params);
@@ -1502,6 +1558,7 @@ NrGnbMac::DoAddLc(NrGnbCmacSapProvider::LcInfo lcinfo, NrMacSapUser* msu)
 {
     NS_LOG_FUNCTION(this);
     NS_LOG_FUNCTION(this);
+    FlushScheduling();
 
     auto rntiIt = m_rlcAttached.find(lcinfo.rnti);
     NS_ASSERT_MSG(rntiIt != m_rlcAttached.end(), "RNTI not found");
@@ -1553,6 +1610,7 @@ NrGnbMac::DoReconfigureLc(NrGnbCmacSapProvider::LcInfo lcinfo)
 void
 NrGnbMac::DoReleaseLc(uint16_t rnti, uint8_t lcid)
 {
+    FlushScheduling();
     // Find user based on rnti and then erase lcid stored against the same
     auto rntiIt = m_rlcAttached.find(rnti);
     rntiIt->second.erase(lcid);
@@ -1567,6 +1625,7 @@ void
 NrGnbMac::UeUpdateConfigurationReq(NrGnbCmacSapProvider::UeConfig params)
 {
     NS_LOG_FUNCTION(this);
+    FlushScheduling();
     // propagates to scheduler
     NrMacCschedSapProvider::CschedUeConfigReqParameters req;
     req.m_rnti = params.m_rnti;
@@ -11,6 +11,7 @@
 #include "nr-mac-sap.h"
 #include "nr-mac-sched-sap.h"
 #include "nr-mac-scheduler.h"
+#include "nr-parallel-scheduling.h"
 #include "nr-phy-mac-common.h"
 #include "nr-phy-sap.h"
 
@@ -175,6 +176,18 @@ class NrGnbMac : public Object
      */
     void BeamChangeReport(BeamId beamId, uint8_t rnti);
 
+    /**
+     * @brief Run the scheduling triggers of this MAC together with those of other gNBs
+     *
+     * The calls to the scheduler made during the slot indications are queued in
+     * the NrParallelScheduling instance, which executes them at the end of the time
+     * stamp, running the scheduling triggers of all its gNBs in parallel.
+     *
+     * @param parallelScheduling the instance shared by the gNBs, or nullptr to call
+     * the scheduler directly (the default)
+     */
+    void SetParallelScheduling(const Ptr<NrParallelScheduling>& parallelScheduling);
+
     /**
      * TracedCallback signature for DL and UL data scheduling events.
      *
@@ -333,6 +346,20 @@ class NrGnbMac : public Object
   private:
     bool HasMsg3Allocations(const SlotAllocInfo& slotInfo);
 
+    /**
+     * @brief Call the scheduler during a slot indication, or queue the call if the
+     * scheduling is parallel
+     * @param call the call to the scheduler
+     * @param trigger whether the call is a DL or UL scheduling trigger
+     */
+    void CallScheduler(std::function<void()> call, bool trigger = false);
+
+    /**
+     * @brief Execute the calls to the scheduler still queued for parallel scheduling,
+     * before calling the scheduler or changing the state used by its allocations
+     */
+    void FlushScheduling();
+
     struct NrDlHarqProcessInfo
     {
         Ptr<PacketBurst> m_pktBurst;
@@ -416,6 +443,8 @@ class NrGnbMac : public Object
 
     SfnSf m_currentSlot;
 
+    Ptr<NrParallelScheduling> m_parallelScheduling; //!< Parallel scheduling, if any
+
     /**
      * Trace information regarding gNB MAC Received Control Messages
      * Frame number, Subframe number, slot, VarTtti, nodeId, rnti,
@@ -4,6 +4,7 @@
 
 #include "nr-initial-association.h"
 
+#include "beam-manager.h"
 #include "beamforming-vector.h"
 
 #include "ns3/nr-module.h"
@@ -296,13 +297,12 @@ NrInitialAssociation::ExtractGnbParameters(const Ptr<NetDevice>& gnbDevice,
     return antenna.gnbArrayModel;
 }
 
-PhasedArrayModel::ComplexVector
+const PhasedArrayModel::ComplexVector&
 NrInitialAssociation::GenBeamforming(double angRow,
                                      double angCol,
                                      Ptr<UniformPlanarArray> gnbArrayModel) const
 {
-    auto bfVector = CreateKroneckerBfv(gnbArrayModel, angRow, angCol);
-    return bfVector;
+    return BeamManager::GetKroneckerBfv(gnbArrayModel, angRow, angCol);
 }
 
 double
@@ -363,7 +363,7 @@ NrInitialAssociation::ComputeMaxRsrp(const Ptr<NetDevice>& gnbDevice, LocalSearc
         {
             for (size_t i = 0; i < m_colBeamAngles.size(); i++)
             {
-                auto bf =
+                const auto& bf =
                     GenBeamforming(m_rowBeamAngles[j], m_colBeamAngles[i], antennas.gnbArrayModel);
                 antennas.gnbArrayModel->SetBeamformingVector(bf);
                 txParams->psd = Copy<SpectrumValue>(fakePsd);
@@ -243,10 +243,11 @@ class NrInitialAssociation : public Object
     /// @param angRow Angle of beam direction in degrees for the row vector
     /// @param angCols Angle of beam direction in degree for the col vector
     /// @param gnbArrayModel array model for gNB
-    /// @return beam forming vector
-    PhasedArrayModel::ComplexVector GenBeamforming(double angRow,
-                                                   double angCol,
-                                                   Ptr<UniformPlanarArray> gnbArrayModel) const;
+    /// @return beam forming vector, from the codebook cache of BeamManager
+    const PhasedArrayModel::ComplexVector& GenBeamforming(
+        double angRow,
+        double angCol,
+        Ptr<UniformPlanarArray> gnbArrayModel) const;
 
     /// @brief Compute the RSRP ratio
     /// @param totalRsrp total received RSRP
@@ -9,6 +9,7 @@
 
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
 
@@ -54,7 +55,15 @@ NrInterference::GetTypeId()
             .AddTraceSource("RssiPerProcessedChunk",
                             "Rssi per processed chunk.",
                             MakeTraceSourceAccessor(&NrInterference::m_rssiPerProcessedChunk),
-                            "ns3::RssiPerProcessedChunk::TracedCallback");
+                            "ns3::RssiPerProcessedChunk::TracedCallback")
+            .AddAttribute("MimoCovRecomputeInterval",
+                          "Number of signal starts and ends after which the running sum of the "
+                          "out-of-cell interference covariance of the MIMO signals is recomputed "
+                          "from all the signals, to bound the floating-point error of the "
+                          "incremental updates. If 0, the covariance is recomputed for each chunk.",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&NrInterference::m_covRecomputeInterval),
+                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
@@ -151,27 +160,32 @@ NrInterference::ConditionallyEvaluateChunk()
             it->EvaluateChunk(sinr, duration);
         }
 
-        for (auto& cp : m_mimoChunkProcessors)
+        if (!m_mimoChunkProcessors.empty())
         {
-            // Covariance matrix of noise plus out-of-cell interference
-            auto outOfCellInterfCov = CalcOutOfCellInterfCov();
-
-            // Compute the MIMO SINR separately for each received signal.
-            for (auto& rxSignal : m_rxSignalsMimo)
+            // Covariance matrix of noise plus out-of-cell interference, common to all the
+            // processors
+            const auto& outOfCellInterfCov = CalcOutOfCellInterfCov();
+            for (auto& cp : m_mimoChunkProcessors)
             {
-                // Use the UE's RNTI to distinguish multiple received signals
-                auto nrRxSignal = DynamicCast<const NrSpectrumSignalParametersDataFrame>(rxSignal);
-                uint16_t rnti = nrRxSignal ? nrRxSignal->rnti : 0;
-
-                // MimoSinrChunk is used to store SINR and compute TBLER of the data transmission
-                auto sinrMatrix = ComputeSinr(outOfCellInterfCov, rxSignal);
-                MimoSinrChunk mimoSinr{sinrMatrix, rnti, duration};
-                cp->EvaluateChunk(mimoSinr);
-
-                // MimoSignalChunk is used to compute PMI feedback.
-                auto& chanSpct = *(rxSignal->spectrumChannelMatrix);
-                MimoSignalChunk mimoSignal{chanSpct, outOfCellInterfCov, rnti, duration};
-                cp->EvaluateChunk(mimoSignal);
+                // Compute the MIMO SINR separately for each received signal.
+                for (auto& rxSignal : m_rxSignalsMimo)
+                {
+                    // Use the UE's RNTI to distinguish multiple received signals
+                    auto nrRxSignal =
+                        DynamicCast<const NrSpectrumSignalParametersDataFrame>(rxSignal);
+                    uint16_t rnti = nrRxSignal ? nrRxSignal->rnti : 0;
+
+                    // MimoSinrChunk is used to store SINR and compute TBLER of the data
+                    // transmission
+                    auto sinrMatrix = ComputeSinr(outOfCellInterfCov, rxSignal);
+                    MimoSinrChunk mimoSinr{sinrMatrix, rnti, duration};
+                    cp->EvaluateChunk(mimoSinr);
+
+                    // MimoSignalChunk is used to compute PMI feedback.
+                    auto& chanSpct = *(rxSignal->spectrumChannelMatrix);
+                    MimoSignalChunk mimoSignal{chanSpct, outOfCellInterfCov, rnti, duration};
+                    cp->EvaluateChunk(mimoSignal);
+                }
             }
         }
         m_lastChangeTime = Now();
@@ -332,7 +346,8 @@ NrInterference::AddSignalMimo(Ptr<const SpectrumSignalParameters> params, const
 
     NS_LOG_FUNCTION(this << *params->psd << duration);
     NrInterferenceBase::DoAddSignal(params->psd);
-    m_allSignalsMimo.push_back(params);
+    m_allSignalsMimo.push_back({params, false});
+    UpdateInterfCovSum(params, false);
     // Update signal ID to match signal ID in NrInterferenceBase
     if (++m_lastSignalId == m_lastSignalIdBeforeReset)
     {
@@ -355,8 +370,30 @@ NrInterference::StartRxMimo(Ptr<const SpectrumSignalParameters> params)
     {
         // This must be the first receive signal, clear any lingering previous signals
         m_rxSignalsMimo.clear();
+        for (auto& signal : m_allSignalsMimo)
+        {
+            if (signal.isRxSignal)
+            {
+                // The previous receive signal becomes an interferer
+                signal.isRxSignal = false;
+                UpdateInterfCovSum(signal.params, false);
+            }
+        }
     }
     m_rxSignalsMimo.push_back(params);
+    // The signal was usually the last one added
+    for (auto it = m_allSignalsMimo.rbegin(); it != m_allSignalsMimo.rend(); ++it)
+    {
+        if (it->params == params)
+        {
+            if (!it->isRxSignal)
+            {
+                it->isRxSignal = true;
+                UpdateInterfCovSum(params, true);
+            }
+            break;
+        }
+    }
     for (auto& cp : m_mimoChunkProcessors)
     {
         // Clear the list of stored chunks
@@ -369,22 +406,21 @@ void
 NrInterference::DoSubtractSignalMimo(Ptr<const SpectrumSignalParameters> params, uint32_t signalId)
 {
     DoSubtractSignal(params->psd, signalId);
-    auto numSignals = m_allSignalsMimo.size();
-    // In many instances the signal subtracted is the last signal. Check first for speedup.
-    if (m_allSignalsMimo.back() == params)
+    // In many instances the signal subtracted is the last signal, so search from the end
+    auto it = std::find_if(m_allSignalsMimo.rbegin(),
+                           m_allSignalsMimo.rend(),
+                           [params](const MimoSignal& s) { return s.params == params; });
+    NS_ASSERT_MSG(it != m_allSignalsMimo.rend(), "MIMO signal was not found for removal");
+    if (!it->isRxSignal)
     {
-        m_allSignalsMimo.pop_back();
+        UpdateInterfCovSum(params, true);
     }
-    else
+    m_allSignalsMimo.erase(std::next(it).base());
+    if (m_allSignalsMimo.empty())
     {
-        m_allSignalsMimo.erase(
-            std::remove_if(m_allSignalsMimo.begin(),
-                           m_allSignalsMimo.end(),
-                           [params](Ptr<const SpectrumSignalParameters> p) { return p == params; }),
-            m_allSignalsMimo.end());
+        // Start again from an exact zero sum
+        m_interfCovSumValid = false;
     }
-    NS_ASSERT_MSG(m_allSignalsMimo.size() == (numSignals - 1),
-                  "MIMO signal was not found for removal");
 }
 
 void
@@ -400,8 +436,8 @@ NrInterference::IsChunkProcessorSet()
     return (!m_mimoChunkProcessors.empty());
 }
 
-NrCovMat
-NrInterference::CalcOutOfCellInterfCov() const
+const NrCovMat&
+NrInterference::CalcOutOfCellInterfCov()
 {
     // Extract dimensions from first receive signal. Interference signals have equal dimensions
     NS_ASSERT_MSG(!(m_rxSignalsMimo.empty()), "At least one receive signal is required");
@@ -410,55 +446,83 @@ NrInterference::CalcOutOfCellInterfCov() const
     auto nRbs = firstSignal->spectrumChannelMatrix->GetNumPages();
     auto nRxPorts = firstSignal->spectrumChannelMatrix->GetNumRows();
 
-    // Create white noise covariance matrix
-    auto allSignalsNoiseCov = NrCovMat{ComplexMatrixArray(nRxPorts, nRxPorts, nRbs)};
-    for (size_t iRb = 0; iRb < nRbs; iRb++)
+    if (!m_interfCovSumValid || m_interfCovSum.GetNumRows() != nRxPorts ||
+        m_interfCovSum.GetNumPages() != nRbs)
     {
-        for (size_t iRxPort = 0; iRxPort < nRxPorts; iRxPort++)
+        // Add all external interference signals to the covariance matrix
+        m_interfCovSum.SetZero(nRxPorts, nRbs);
+        for (const auto& intfSignal : m_allSignalsMimo)
         {
-            allSignalsNoiseCov(iRxPort, iRxPort, iRb) = m_noise->ValuesAt(iRb);
+            if (intfSignal.isRxSignal)
+            {
+                // This is one of the signals in the current cell
+                continue;
+            }
+
+            AddInterference(m_interfCovSum, intfSignal.params);
         }
+        m_interfCovSumValid = m_covRecomputeInterval > 0;
+        m_interfCovSumUpdates = 0;
     }
 
-    // Add all external interference signals to the covariance matrix
-    for (const auto& intfSignal : m_allSignalsMimo)
-    {
-        if (std::find(m_rxSignalsMimo.begin(), m_rxSignalsMimo.end(), intfSignal) !=
-            m_rxSignalsMimo.end())
-        {
-            // This is one of the signals in the current cell
-            continue;
-        }
+    // Create white noise covariance matrix, and add the interference
+    m_outOfCellInterfCov.SetDiagonal(nRxPorts, nRbs, *m_noise);
+    m_outOfCellInterfCov += m_interfCovSum;
+    return m_outOfCellInterfCov;
+}
 
-        AddInterference(allSignalsNoiseCov, intfSignal);
+void
+NrInterference::UpdateInterfCovSum(Ptr<const SpectrumSignalParameters> signal, bool subtract)
+{
+    if (!m_interfCovSumValid)
+    {
+        return;
+    }
+    if (++m_interfCovSumUpdates > m_covRecomputeInterval || !signal->spectrumChannelMatrix ||
+        signal->spectrumChannelMatrix->GetNumRows() != m_interfCovSum.GetNumRows() ||
+        signal->spectrumChannelMatrix->GetNumPages() != m_interfCovSum.GetNumPages())
+    {
+        m_interfCovSumValid = false;
+        return;
     }
-    return allSignalsNoiseCov;
+    AddInterference(m_interfCovSum, signal, subtract);
 }
 
-NrCovMat
+const NrCovMat&
 NrInterference::CalcCurrInterfCov(Ptr<const SpectrumSignalParameters> rxSignal,
-                                  const NrCovMat& outOfCellInterfCov) const
+                                  const NrCovMat& outOfCellInterfCov)
 {
+    if (m_rxSignalsMimo.size() == 1)
+    {
+        NS_ASSERT_MSG(m_rxSignalsMimo[0] == rxSignal, "Unknown receive signal");
+        return outOfCellInterfCov;
+    }
+
     // Add also the potential interfering signals intended for this device but belonging to other
     // transmissions. This is required for a gNB receiving MU-MIMO UL signals from multiple UEs
-    auto interfNoiseCov = outOfCellInterfCov;
+    m_currInterfCov = outOfCellInterfCov;
     for (auto& otherSignal : m_rxSignalsMimo)
     {
         if (otherSignal == rxSignal)
         {
             continue; // this is the current receive signal of interest, do not add to interference
         }
-        NS_ASSERT_MSG((std::find(m_allSignalsMimo.begin(), m_allSignalsMimo.end(), otherSignal) !=
-                       m_allSignalsMimo.end()),
+        NS_ASSERT_MSG(std::any_of(m_allSignalsMimo.begin(),
+                                  m_allSignalsMimo.end(),
+                                  [&otherSignal](const MimoSignal& s) {
+                                      return s.params == otherSignal;
+                                  }),
                       "RX signal already deleted from m_allSignalsMimo");
 
-        AddInterference(interfNoiseCov, otherSignal);
+        AddInterference(m_currInterfCov, otherSignal);
     }
-    return interfNoiseCov;
+    return m_currInterfCov;
 }
 
 void
-NrInterference::AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParameters> signal) const
+NrInterference::AddInterference(NrCovMat& covMat,
+                                Ptr<const SpectrumSignalParameters> signal,
+                                bool subtract) const
 {
     const auto& chanSpct = *(signal->spectrumChannelMatrix);
     if (signal->precodingMatrix)
@@ -469,7 +533,18 @@ NrInterference::AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParame
         NS_ASSERT_MSG(precMats.GetNumPages() == chanSpct.GetNumPages(),
                       "dim mismatch " << precMats.GetNumPages() << " vs "
                                       << chanSpct.GetNumPages());
-        covMat.AddInterferenceSignal(chanSpct * precMats);
+        if (subtract)
+        {
+            covMat.SubtractPrecodedInterferenceSignal(chanSpct, precMats);
+        }
+        else
+        {
+            covMat.AddPrecodedInterferenceSignal(chanSpct, precMats);
+        }
+    }
+    else if (subtract)
+    {
+        covMat.SubtractInterferenceSignal(chanSpct);
     }
     else
     {
@@ -478,12 +553,12 @@ NrInterference::AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParame
 }
 
 NrSinrMatrix
-NrInterference::ComputeSinr(NrCovMat& outOfCellInterfCov,
-                            Ptr<const SpectrumSignalParameters> rxSignal) const
+NrInterference::ComputeSinr(const NrCovMat& outOfCellInterfCov,
+                            Ptr<const SpectrumSignalParameters> rxSignal)
 {
     // Calculate the interference+noise (I+N) covariance matrix for this signal,
     // including interference from other RX signals
-    auto interfNoiseCov = CalcCurrInterfCov(rxSignal, outOfCellInterfCov);
+    const auto& interfNoiseCov = CalcCurrInterfCov(rxSignal, outOfCellInterfCov);
 
     // Interference whitening: normalize the signal such that interference + noise covariance matrix
     // is the identity matrix
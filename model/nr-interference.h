@@ -7,6 +7,7 @@
 
 #include "nr-chunk-processor.h"
 #include "nr-interference-base.h"
+#include "nr-mimo-matrices.h"
 
 #include "ns3/nstime.h"
 #include "ns3/object.h"
@@ -21,8 +22,6 @@ namespace ns3
 // Signal ID increment used in LteInterference
 static constexpr uint32_t NR_LTE_SIGNALID_INCR = 0x10000000;
 
-class NrCovMat;
-class NrSinrMatrix;
 class NrErrorModel;
 class NrMimoChunkProcessor;
 
@@ -130,32 +129,54 @@ class NrInterference : public NrInterferenceBase
     /// @brief Calculate interference-plus-noise covariance matrix for signals not in m_rxSignals
     /// This function computes the interference signals from all out-of-cell interferers. The
     /// intra-cell interference signals that are part of m_rxSignals are skipped.
+    /// The matrix is the noise plus m_interfCovSum, which is recomputed from all the signals only
+    /// when it is not valid. It is stored in m_outOfCellInterfCov, reusing its pages.
     /// @return the interference+noise covariance matrix for out-of-cell interference
-    NrCovMat CalcOutOfCellInterfCov() const;
+    const NrCovMat& CalcOutOfCellInterfCov();
+
+    /// @brief Add or subtract the covariance of a signal to or from m_interfCovSum, if it is
+    /// valid. After MimoCovRecomputeInterval updates, or if the signal has no channel matrix or
+    /// different dimensions, m_interfCovSum is invalidated instead, so that it is recomputed from
+    /// all the signals at the next chunk.
+    /// @param signal the signal that is added to or subtracted from the out-of-cell interference
+    /// @param subtract true to subtract the signal, false to add it
+    void UpdateInterfCovSum(Ptr<const SpectrumSignalParameters> signal, bool subtract);
 
     /// @brief Add the remaining interference to the interference-and-noise covariance matrix
     /// This function is required for MU-MIMO UL, where the signal from a different UE within the
     /// same cell can act as interference towards the current signal.
+    /// When there is no other receive signal, outOfCellInterfCov is returned without a copy.
+    /// Otherwise, the matrix is accumulated in m_currInterfCov, reusing its pages.
     /// @param rxSignal the parameters of the received signal-of-interest
     /// @param outOfCellInterfCov the covariance matrix of out-of-cell signals, plus noise
     /// @return the interference+noise covariance matrix for the current signal
-    NrCovMat CalcCurrInterfCov(Ptr<const SpectrumSignalParameters> rxSignal,
-                               const NrCovMat& outOfCellInterfCov) const;
+    const NrCovMat& CalcCurrInterfCov(Ptr<const SpectrumSignalParameters> rxSignal,
+                                      const NrCovMat& outOfCellInterfCov);
 
     /// @brief Add the covariance of the signal to an existing covariance matrix
     /// @param covMat the existing interference-and-noise covariance matrix
     /// @param signal the signal to be added
-    void AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParameters> signal) const;
+    /// @param subtract true to subtract the covariance of the signal instead
+    void AddInterference(NrCovMat& covMat,
+                         Ptr<const SpectrumSignalParameters> signal,
+                         bool subtract = false) const;
 
     /// @brief Compute the SINR of the current receive signal
     /// @param outOfCellInterfCov the covariance matrix of out-of-cell signals, plus noise
     /// @param rxSignal the receive signal
     /// @return the SINR of the receive signal
-    NrSinrMatrix ComputeSinr(NrCovMat& outOfCellInterfCov,
-                             Ptr<const SpectrumSignalParameters> rxSignal) const;
+    NrSinrMatrix ComputeSinr(const NrCovMat& outOfCellInterfCov,
+                             Ptr<const SpectrumSignalParameters> rxSignal);
+
+    /// An incoming MIMO signal
+    struct MimoSignal
+    {
+        Ptr<const SpectrumSignalParameters> params; ///< The spectrum signal parameters
+        bool isRxSignal;                            ///< True if it is also in m_rxSignalsMimo
+    };
 
     /// Stores the params of all incoming signals, including the interference signals
-    std::vector<Ptr<const SpectrumSignalParameters>> m_allSignalsMimo;
+    std::vector<MimoSignal> m_allSignalsMimo;
 
     /// Stores the params of all incoming signals intended for this receiver
     std::vector<Ptr<const SpectrumSignalParameters>> m_rxSignalsMimo;
@@ -163,6 +184,17 @@ class NrInterference : public NrInterferenceBase
     /// The processor instances that are notified whenever a new interference chunk is calculated
     std::list<Ptr<NrMimoChunkProcessor>> m_mimoChunkProcessors;
 
+    NrCovMat m_outOfCellInterfCov; ///< Workspace of the out-of-cell interference+noise covariance
+    NrCovMat m_currInterfCov;      ///< Workspace of the interference+noise covariance of a signal
+
+    /// Running sum of the covariance of the signals of m_allSignalsMimo that are not in
+    /// m_rxSignalsMimo, without noise. It is updated when a signal starts or ends, and when the
+    /// receive signals change.
+    NrCovMat m_interfCovSum;
+    bool m_interfCovSumValid{false};     ///< True if m_interfCovSum matches the current signals
+    uint32_t m_interfCovSumUpdates{0};   ///< Updates of m_interfCovSum since its recomputation
+    uint32_t m_covRecomputeInterval{64}; ///< Updates after which m_interfCovSum is recomputed
+
     /**
      * Noise and Interference (thus Ni) event.
      */
@@ -15,6 +15,7 @@
 #include "nr-mac-scheduler-lc-rr.h"
 #include "nr-mac-scheduler-srs-default.h"
 #include "nr-mac-short-bsr-ce.h"
+#include "nr-parallel-scheduling.h"
 #include "resource-assignment-matrix.h"
 
 #include "ns3/boolean.h"
@@ -1878,11 +1879,27 @@ NrMacSchedulerNs3::ScheduleDl(const NrMacSchedSapProvider::SchedDlTriggerReqPara
                 NrFhControl::FhControlMethod::Dropping &&
             m_nrFhSchedSapProvider->GetFhControlMethod() != UINT8_MAX)
         {
-            Simulator::Schedule(NanoSeconds(1),
-                                &NrMacSchedulerNs3::CallNrFhControlForMapUpdate,
-                                this,
-                                dlSlot.m_slotAllocInfo.m_varTtiAllocInfo,
-                                m_ueMap); // 1ns delay to give time for scheduling in all cells
+            if (NrParallelScheduling::IsInTrigger())
+            {
+                // Events can only be scheduled from the main thread
+                auto allocations = dlSlot.m_slotAllocInfo.m_varTtiAllocInfo;
+                NrParallelScheduling::Defer([this, allocations, ueMap = m_ueMap]() {
+                    Simulator::Schedule(NanoSeconds(1),
+                                        &NrMacSchedulerNs3::CallNrFhControlForMapUpdate,
+                                        this,
+                                        allocations,
+                                        ueMap);
+                });
+            }
+            else
+            {
+                Simulator::Schedule(
+                    NanoSeconds(1),
+                    &NrMacSchedulerNs3::CallNrFhControlForMapUpdate,
+                    this,
+                    dlSlot.m_slotAllocInfo.m_varTtiAllocInfo,
+                    m_ueMap); // 1ns delay to give time for scheduling in all cells
+            }
         }
     }
 
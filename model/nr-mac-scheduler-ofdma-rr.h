@@ -122,6 +122,16 @@ class NrMacSchedulerOfdmaRR : public NrMacSchedulerOfdma
     {
     }
 
+    /**
+     * @brief The metrics of RR and of its subclasses (PF, MR, QoS) only depend on the
+     * resources of the UE and on the number of assigned symbols
+     * @return true
+     */
+    bool HasIdempotentNotAssignedUpdates() const override
+    {
+        return true;
+    }
+
   private:
     /**
      * Deque used to keep priority order of round-robin.
@@ -11,10 +11,13 @@
 #include "nr-mac-scheduler-ofdma.h"
 
 #include "nr-fh-control.h"
+#include "nr-parallel-scheduling.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 
 #include <algorithm>
+#include <optional>
 #include <random>
 
 namespace ns3
@@ -38,6 +41,14 @@ NrMacSchedulerOfdma::GetTypeId()
                                                           "ROUND_ROBIN",
                                                           SymPerBeamType::PROPORTIONAL_FAIR,
                                                           "PROPORTIONAL_FAIR"))
+            .AddAttribute("IncrementalUeSort",
+                          "If true, and the scheduler allows it, after each RBG assignment only "
+                          "the UE that got the RBG is moved in the sorted vector of UEs, and the "
+                          "metrics of the other UEs are only updated when the number of assigned "
+                          "symbols changes. The resulting allocation does not change",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&NrMacSchedulerOfdma::m_incrementalUeSort),
+                          MakeBooleanChecker())
             .AddTraceSource(
                 "SymPerBeam",
                 "Number of assigned symbol per beam. Gets called every time an assignment is made",
@@ -89,14 +100,90 @@ NrMacSchedulerOfdma::GetSymPerBeam(uint32_t symAvail,
     }
 
     // Trigger the trace source firing, using const_cast as we don't change
-    // the internal state of the class
-    for (const auto& v : ret)
+    // the internal state of the class. The trace sinks run in the main thread,
+    // so a trigger executed by NrParallelScheduling defers the firing
+    auto self = const_cast<NrMacSchedulerOfdma*>(this);
+    auto fireTrace = [self, ret]() {
+        for (const auto& v : ret)
+        {
+            self->m_tracedValueSymPerBeam = v.second;
+        }
+    };
+    if (NrParallelScheduling::IsInTrigger())
+    {
+        NrParallelScheduling::Defer(fireTrace);
+    }
+    else
     {
-        const_cast<NrMacSchedulerOfdma*>(this)->m_tracedValueSymPerBeam = v.second;
+        fireTrace();
     }
     return ret;
 }
 
+NrMacSchedulerOfdma::FreeRbgSet::FreeRbgSet(const std::vector<bool>& bitmask)
+    : m_words((bitmask.size() + 63) / 64, 0)
+{
+    for (size_t i = 0; i < bitmask.size(); i++)
+    {
+        if (bitmask[i])
+        {
+            Insert(i);
+        }
+    }
+}
+
+uint32_t
+NrMacSchedulerOfdma::FreeRbgSet::First() const
+{
+    NS_ASSERT(m_count > 0);
+    size_t w = 0;
+    while (m_words[w] == 0)
+    {
+        ++w;
+    }
+    return w * 64 + std::countr_zero(m_words[w]);
+}
+
+void
+NrMacSchedulerOfdma::FreeRbgSet::Insert(uint32_t rbg)
+{
+    const uint64_t bit = uint64_t{1} << (rbg % 64);
+    if ((m_words.at(rbg / 64) & bit) == 0)
+    {
+        m_words[rbg / 64] |= bit;
+        ++m_count;
+    }
+}
+
+void
+NrMacSchedulerOfdma::FreeRbgSet::Erase(uint32_t rbg)
+{
+    const uint64_t bit = uint64_t{1} << (rbg % 64);
+    if ((m_words.at(rbg / 64) & bit) != 0)
+    {
+        m_words[rbg / 64] &= ~bit;
+        --m_count;
+    }
+}
+
+void
+NrMacSchedulerOfdma::ResortUe(std::vector<UePtrAndBufferReq>& ueVector,
+                              size_t pos,
+                              const CompareUeFn& compare)
+{
+    NS_ASSERT(pos < ueVector.size());
+    // Move the UE to the end, to search its position among the other UEs, which are sorted
+    const auto first = ueVector.begin();
+    std::rotate(first + pos, first + pos + 1, ueVector.end());
+    const auto last = std::prev(ueVector.end());
+
+    // Range of the UEs that compare equal to the UE, where it keeps its relative position
+    const auto lo = std::lower_bound(first, last, *last, compare);
+    const auto hi = std::upper_bound(lo, last, *last, compare);
+    const auto target = std::clamp(first + pos, lo, hi);
+    std::rotate(target, last, ueVector.end());
+}
+
 bool
 NrMacSchedulerOfdma::AdvanceToNextUeToSchedule(
     std::vector<UePtrAndBufferReq>::iterator& schedInfoIt,
@@ -198,7 +285,7 @@ NrMacSchedulerOfdma::DeallocateCurrentResourceFromUe(
 bool
 NrMacSchedulerOfdma::AttemptAllocationOfCurrentResourceToUe(
     std::vector<UePtrAndBufferReq>::iterator schedInfoIt,
-    std::set<uint32_t>& remainingRbgSet,
+    FreeRbgSet& remainingRbgSet,
     const uint32_t beamSym,
     FTResources& assignedResources,
     std::vector<bool>& availableRbgs) const
@@ -211,21 +298,20 @@ NrMacSchedulerOfdma::AttemptAllocationOfCurrentResourceToUe(
     if (currentUe->m_dlSbMcsInfo.empty() ||
         m_mcsCsiSource == NrMacSchedulerUeInfo::McsCsiSource::WIDEBAND_MCS)
     {
-        currentRbgPos = *remainingRbgSet.begin();
+        currentRbgPos = remainingRbgSet.First();
     }
     else
     {
         // Find the best resource for UE among the available ones
         int maxCqi = 0;
-        for (auto resourcePos : remainingRbgSet)
-        {
+        remainingRbgSet.ForEach([&](uint32_t resourcePos) {
             const auto resourceSb = currentUe->m_rbgToSb.at(resourcePos);
             if (currentUe->m_dlSbMcsInfo.at(resourceSb).cqi > maxCqi)
             {
                 currentRbgPos = resourcePos;
                 maxCqi = currentUe->m_dlSbMcsInfo.at(resourceSb).cqi;
             }
-        }
+        });
 
         // Do not schedule RBGs that are lower than 4 CQI than maximum
         if (!currentUe->m_dlRBG.empty())
@@ -271,7 +357,7 @@ NrMacSchedulerOfdma::AttemptAllocationOfCurrentResourceToUe(
         AssignedDlResources(*schedInfoIt, FTResources(beamSym, beamSym), assignedResources);
         return false; // Unsuccessful allocation
     }
-    remainingRbgSet.erase(currentRbgPos);
+    remainingRbgSet.Erase(currentRbgPos);
     return true; // Successful allocation
 }
 
@@ -332,6 +418,9 @@ NrMacSchedulerOfdma::DeallocateResourcesDueToFronthaulConstraint(
  * </pre>
  *
  * To sort the UEs, the method uses the function returned by GetUeCompareDlFn().
+ * If the incremental sort is enabled (see HasIdempotentNotAssignedUpdates()), the
+ * vector is only sorted again when the metric of more than one UE has changed;
+ * otherwise, only the UE that got the RBG is moved to its new position.
  * Two fairness helper are hard-coded in the method: the first one is avoid
  * to assign resources to UEs that already have their buffer requirement covered,
  * and the other one is avoid to assign symbols when all the UEs have their
@@ -356,40 +445,49 @@ NrMacSchedulerOfdma::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl)
         std::vector<UePtrAndBufferReq> ueVector;
         FTResources assignedResources(0, 0);
         std::vector<bool> availableRbgs = GetDlBitmask();
-        std::set<uint32_t> remainingRbgSet;
-        for (size_t i = 0; i < availableRbgs.size(); i++)
-        {
-            if (availableRbgs.at(i))
-            {
-                remainingRbgSet.emplace(i);
-            }
-        }
+        FreeRbgSet remainingRbgSet(availableRbgs);
 
-        NS_ASSERT(!remainingRbgSet.empty());
+        NS_ASSERT(!remainingRbgSet.Empty());
 
         for (const auto& ue : GetUeVector(el))
         {
             ueVector.emplace_back(ue);
             BeforeDlSched(ueVector.back(), FTResources(beamSym, beamSym));
         }
+
+        const bool incrementalSort =
+            m_incrementalUeSort && HasIdempotentNotAssignedUpdates() && !m_activeDlAi;
+        const CompareUeFn compareUe = GetUeCompareDlFn();
+        bool sortAll = true; // The metric of more than one UE changed since the last sort
+        // Symbols assigned at the last update of the metrics of all the UEs
+        std::optional<uint32_t> updatedSym;
+        // UE that got the last RBG, when the update of the other UEs has been skipped
+        std::shared_ptr<NrMacSchedulerUeInfo> skippedUpdateUe;
+
         bool reapingResources = true;
         while (reapingResources)
         {
             // While there are resources to schedule
-            while (!remainingRbgSet.empty())
+            while (!remainingRbgSet.Empty())
             {
                 // Keep track if resources are being allocated. If not, then stop.
-                const auto prevRemaining = remainingRbgSet.size();
+                const auto prevRemaining = remainingRbgSet.Size();
 
                 if (m_activeDlAi)
                 {
                     CallNotifyDlFn(ueVector);
                 }
                 // Sort UEs based on the selected scheduler policy (PF, RR, QoS, AI)
-                SortUeVector(&ueVector, std::bind(&NrMacSchedulerOfdma::GetUeCompareDlFn, this));
+                if (!incrementalSort || sortAll)
+                {
+                    SortUeVector(&ueVector,
+                                 std::bind(&NrMacSchedulerOfdma::GetUeCompareDlFn, this));
+                    sortAll = false;
+                }
 
                 // Select the first UE
                 auto schedInfoIt = ueVector.begin();
+                bool failedAttempt = false;
 
                 // Advance schedInfoIt iterator to the next UE to schedule
                 while (AdvanceToNextUeToSchedule(schedInfoIt, ueVector.end(), beamSym))
@@ -402,6 +500,8 @@ NrMacSchedulerOfdma::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl)
                                                                 assignedResources,
                                                                 availableRbgs))
                     {
+                        // The undo of the allocation may have changed the UE metric
+                        failedAttempt = true;
                         std::advance(schedInfoIt, 1); // Get the next UE
                         continue;
                     }
@@ -411,29 +511,61 @@ NrMacSchedulerOfdma::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl)
                                  << GetUe(*schedInfoIt)->m_dlRBG.back() << " DL RBG, spanned over "
                                  << beamSym << " SYM, to UE " << GetUe(*schedInfoIt)->m_rnti);
 
-                    // Update metrics for the unsuccessful UEs (who did not get any resource in this
-                    // iteration)
-                    for (auto& ue : ueVector)
+                    if (!incrementalSort || updatedSym != assignedResources.m_sym)
                     {
-                        if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                        // Update metrics for the unsuccessful UEs (who did not get any resource
+                        // in this iteration)
+                        for (auto& ue : ueVector)
                         {
-                            NotAssignedDlResources(ue,
-                                                   FTResources(beamSym, beamSym),
-                                                   assignedResources);
+                            if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                            {
+                                NotAssignedDlResources(ue,
+                                                       FTResources(beamSym, beamSym),
+                                                       assignedResources);
+                            }
                         }
+                        updatedSym = assignedResources.m_sym;
+                        skippedUpdateUe = nullptr;
+                        sortAll = true;
+                    }
+                    else if (failedAttempt)
+                    {
+                        skippedUpdateUe = GetUe(*schedInfoIt);
+                        sortAll = true;
+                    }
+                    else
+                    {
+                        // Only the metric of this UE changed
+                        skippedUpdateUe = GetUe(*schedInfoIt);
+                        ResortUe(ueVector, std::distance(ueVector.begin(), schedInfoIt), compareUe);
                     }
                     break; // Successful allocation
                 }
                 // No more UEs to allocate in the current beam
-                if (prevRemaining == remainingRbgSet.size())
+                if (prevRemaining == remainingRbgSet.Size())
                 {
                     break;
                 }
             }
 
-            // If we got here, we either allocated all resources (remainingRbgSet.empty()),
+            // If we got here, we either allocated all resources (remainingRbgSet.Empty()),
             // or the remaining RBGs do not improve TBS of UEs (prevRemaining ==
-            // remainingRbgSet.size()).
+            // remainingRbgSet.Size()).
+
+            // Apply the last update of the unsuccessful UEs, if it has been skipped
+            if (skippedUpdateUe)
+            {
+                for (auto& ue : ueVector)
+                {
+                    if (ue.first != skippedUpdateUe)
+                    {
+                        NotAssignedDlResources(ue,
+                                               FTResources(beamSym, beamSym),
+                                               assignedResources);
+                    }
+                }
+                skippedUpdateUe = nullptr;
+            }
 
             // Now we need to check if there is a UE with less than the minimal TBS.
             std::sort(ueVector.begin(), ueVector.end(), [](auto a, auto b) {
@@ -453,7 +585,7 @@ NrMacSchedulerOfdma::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl)
                                                     beamSym,
                                                     assignedResources,
                                                     availableRbgs);
-                    remainingRbgSet.emplace(reapedRbg);
+                    remainingRbgSet.Insert(reapedRbg);
                 }
                 // Update DL metrics
                 AssignedDlResources(ue, FTResources(beamSym, beamSym), assignedResources);
@@ -463,6 +595,8 @@ NrMacSchedulerOfdma::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl)
                 {
                     NotAssignedDlResources(uev, FTResources(beamSym, beamSym), assignedResources);
                 }
+                updatedSym = assignedResources.m_sym;
+                sortAll = true;
 
                 // Remove UE from allocation vector (it won't receive more resources in this round)
                 ueVector.pop_back();
@@ -530,17 +664,9 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
         std::vector<UePtrAndBufferReq> ueVector;
         FTResources assigned(0, 0);
 
-        const std::vector<bool> availableRbgs = GetUlBitmask();
-        std::set<uint32_t> remainingRbgSet;
-        for (size_t i = 0; i < availableRbgs.size(); i++)
-        {
-            if (availableRbgs.at(i))
-            {
-                remainingRbgSet.emplace(i);
-            }
-        }
+        FreeRbgSet remainingRbgSet(GetUlBitmask());
 
-        NS_ASSERT(!remainingRbgSet.empty());
+        NS_ASSERT(!remainingRbgSet.Empty());
 
         for (const auto& ue : GetUeVector(el))
         {
@@ -552,14 +678,27 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
             BeforeUlSched(ue, FTResources(beamSym * beamSym, beamSym));
         }
 
-        while (!remainingRbgSet.empty())
+        const bool incrementalSort =
+            m_incrementalUeSort && HasIdempotentNotAssignedUpdates() && !m_activeUlAi;
+        const CompareUeFn compareUe = GetUeCompareUlFn();
+        bool sortAll = true; // The metric of more than one UE changed since the last sort
+        // Symbols assigned at the last update of the metrics of all the UEs
+        std::optional<uint32_t> updatedSym;
+        // UE that got the last RBG, when the update of the other UEs has been skipped
+        std::shared_ptr<NrMacSchedulerUeInfo> skippedUpdateUe;
+
+        while (!remainingRbgSet.Empty())
         {
             if (m_activeUlAi)
             {
                 CallNotifyUlFn(ueVector);
             }
             GetFirst GetUe;
-            SortUeVector(&ueVector, std::bind(&NrMacSchedulerOfdma::GetUeCompareUlFn, this));
+            if (!incrementalSort || sortAll)
+            {
+                SortUeVector(&ueVector, std::bind(&NrMacSchedulerOfdma::GetUeCompareUlFn, this));
+                sortAll = false;
+            }
             auto schedInfoIt = ueVector.begin();
 
             // Ensure fairness: pass over UEs which already has enough resources to transmit
@@ -583,13 +722,13 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
                 break;
             }
 
-            auto assignedRbg = remainingRbgSet.begin();
+            const uint32_t assignedRbg = remainingRbgSet.First();
             // Assign 1 RBG for each available symbols for the beam,
             // and then update the count of available resources
             auto& assignedRbgs = GetUe(*schedInfoIt)->m_ulRBG;
             auto existingRbgs = assignedRbgs.size();
             assignedRbgs.resize(assignedRbgs.size() + beamSym);
-            std::fill(assignedRbgs.begin() + existingRbgs, assignedRbgs.end(), *assignedRbg);
+            std::fill(assignedRbgs.begin() + existingRbgs, assignedRbgs.end(), assignedRbg);
             assigned.m_rbg++;
 
             auto& assignedSymbols = GetUe(*schedInfoIt)->m_ulSym;
@@ -598,7 +737,7 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
             std::iota(assignedSymbols.begin() + existingSymbols, assignedSymbols.end(), 0);
             assigned.m_sym = beamSym;
 
-            remainingRbgSet.erase(
+            remainingRbgSet.Erase(
                 assignedRbg); // Resources are RBG, so they do not consider the beamSym
 
             // Update metrics
@@ -606,11 +745,35 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
                                      << " SYM, to UE " << GetUe(*schedInfoIt)->m_rnti);
             AssignedUlResources(*schedInfoIt, FTResources(beamSym, beamSym), assigned);
 
-            // Update metrics for the unsuccessful UEs (who did not get any resource in this
-            // iteration)
+            if (!incrementalSort || updatedSym != assigned.m_sym)
+            {
+                // Update metrics for the unsuccessful UEs (who did not get any resource in this
+                // iteration)
+                for (auto& ue : ueVector)
+                {
+                    if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                    {
+                        NotAssignedUlResources(ue, FTResources(beamSym, beamSym), assigned);
+                    }
+                }
+                updatedSym = assigned.m_sym;
+                skippedUpdateUe = nullptr;
+                sortAll = true;
+            }
+            else
+            {
+                // Only the metric of this UE changed
+                skippedUpdateUe = GetUe(*schedInfoIt);
+                ResortUe(ueVector, std::distance(ueVector.begin(), schedInfoIt), compareUe);
+            }
+        }
+
+        // Apply the last update of the unsuccessful UEs, if it has been skipped
+        if (skippedUpdateUe)
+        {
             for (auto& ue : ueVector)
             {
-                if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                if (ue.first != skippedUpdateUe)
                 {
                     NotAssignedUlResources(ue, FTResources(beamSym, beamSym), assigned);
                 }
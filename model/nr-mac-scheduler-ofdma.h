@@ -9,6 +9,7 @@
 
 #include "ns3/traced-value.h"
 
+#include <bit>
 #include <set>
 #include <unordered_set>
 
@@ -49,6 +50,12 @@ class NrSchedOfdmaSymbolPerBeamTestCase;
  * The DCI is created by CreateDlDci() or CreateUlDci(), which call CreateDci()
  * to perform the "hard" work.
  *
+ * When the attribute IncrementalUeSort is true, and the subclass allows it
+ * (HasIdempotentNotAssignedUpdates()), the UEs are not sorted again for each RBG:
+ * only the UE that got the RBG is moved to its new position in the sorted vector,
+ * and the metrics of the other UEs are updated only when the number of assigned
+ * symbols changes. The allocation is the same as with a full sort for each RBG.
+ *
  * @see NrMacSchedulerOfdmaRR
  * @see NrMacSchedulerOfdmaPF
  * @see NrMacSchedulerOfdmaMR
@@ -109,6 +116,25 @@ class NrMacSchedulerOfdma : public NrMacSchedulerTdma
 
     uint8_t GetTpc() const override;
 
+    /**
+     * @brief Tell if the metric updates of the UEs that did not get a resource can be deferred
+     *
+     * AssignDLRBG() and AssignULRBG() call NotAssignedDlResources() or
+     * NotAssignedUlResources() for all the UEs that did not get the RBG. If these calls
+     * only depend on the resources of the UE and on the number of symbols in the total
+     * assigned resources, and calling them again with the same values has no effect, then
+     * they only need to be called when the number of assigned symbols changes, and only the
+     * UE that got the RBG has to be moved in the sorted vector of UEs. In that case, the
+     * UEs are ordered by the comparison functions of the scheduler, and the subclass must
+     * not override SortUeVector().
+     *
+     * @return true if the subclass meets these conditions, false by default
+     */
+    virtual bool HasIdempotentNotAssignedUpdates() const
+    {
+        return false;
+    }
+
     /**
      * @brief Enumeration of techniques to distribute the available symbols to the active beams
      */
@@ -120,6 +146,90 @@ class NrMacSchedulerOfdma : public NrMacSchedulerTdma
     };
 
   private:
+    /**
+     * @brief The free RBGs of a beam, stored as a bitmask of 64-bit words
+     *
+     * It replaces a std::set of RBG indexes: inserting and removing an RBG, and getting
+     * the number of free RBGs, take constant time, and the free RBGs are visited in
+     * increasing order by scanning the words.
+     */
+    class FreeRbgSet
+    {
+      public:
+        /**
+         * @brief Create the set from a bitmask of RBGs
+         * @param bitmask The bitmask, true for the free RBGs
+         */
+        explicit FreeRbgSet(const std::vector<bool>& bitmask);
+
+        /**
+         * @return true if there are no free RBGs
+         */
+        bool Empty() const
+        {
+            return m_count == 0;
+        }
+
+        /**
+         * @return the number of free RBGs
+         */
+        size_t Size() const
+        {
+            return m_count;
+        }
+
+        /**
+         * @return the lowest free RBG. The set must not be empty
+         */
+        uint32_t First() const;
+
+        /**
+         * @brief Mark an RBG as free
+         * @param rbg The RBG
+         */
+        void Insert(uint32_t rbg);
+
+        /**
+         * @brief Mark an RBG as used
+         * @param rbg The RBG
+         */
+        void Erase(uint32_t rbg);
+
+        /**
+         * @brief Call a function for each free RBG, in increasing order
+         * @param fn The function, which takes the RBG index
+         */
+        template <typename F>
+        void ForEach(F&& fn) const
+        {
+            for (size_t w = 0; w < m_words.size(); ++w)
+            {
+                for (uint64_t word = m_words[w]; word != 0; word &= word - 1)
+                {
+                    fn(static_cast<uint32_t>(w * 64 + std::countr_zero(word)));
+                }
+            }
+        }
+
+      private:
+        std::vector<uint64_t> m_words; //!< Bit i of word w is set if the RBG 64 * w + i is free
+        size_t m_count{0};             //!< Number of free RBGs
+    };
+
+    /**
+     * @brief Move an UE of a sorted vector to the position given by its updated metric
+     *
+     * All the other UEs must be sorted. The UE is placed where std::stable_sort would
+     * place it: after the UEs that compare before it, before the UEs that compare after
+     * it, and at its previous position relative to the UEs that compare equal.
+     * @param ueVector The vector of UEs
+     * @param pos The position of the UE whose metric has changed
+     * @param compare The comparison function of the scheduler
+     */
+    static void ResortUe(std::vector<UePtrAndBufferReq>& ueVector,
+                         size_t pos,
+                         const CompareUeFn& compare);
+
     /**
      * @brief Create RBG bitmask from allocated RBG vector
      * @param allocatedRbgs vector of allocated RBGs
@@ -217,7 +327,7 @@ class NrMacSchedulerOfdma : public NrMacSchedulerTdma
      */
     bool AttemptAllocationOfCurrentResourceToUe(
         std::vector<UePtrAndBufferReq>::iterator schedInfoIt,
-        std::set<uint32_t>& remainingRbgSet,
+        FreeRbgSet& remainingRbgSet,
         const uint32_t beamSym,
         FTResources& assignedResources,
         std::vector<bool>& availableRbgs) const;
@@ -227,6 +337,7 @@ class NrMacSchedulerOfdma : public NrMacSchedulerTdma
         m_tracedValueSymPerBeam; //!< Variable to trace symbols per beam allocation
 
     SymPerBeamType m_symPerBeamType; //!< Holds the type of symbol scheduling done for each beam
+    bool m_incrementalUeSort{true}; //!< Sort only the UE that got a resource, when possible
     Ptr<NrMacSchedulerOfdmaSymbolPerBeam> m_symPerBeam; //!< Holds a symbol per beam allocator
     /// Make it friend of the test case, so that the test case can access m_symPerBeam
     friend class NrSchedOfdmaSymbolPerBeamTestCase;
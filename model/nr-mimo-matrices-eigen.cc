@@ -57,12 +57,11 @@ NrCovMat::CalcIntfNormChannelMimo(const ComplexMatrixArray& chanMat) const
 }
 
 ComplexMatrixArray
-NrIntfNormChanMat::ComputeMseMimo(const ComplexMatrixArray& precMats) const
+NrIntfNormChanMat::ComputeMseMimo(const ComplexMatrixArray& chanPrec) const
 {
-    auto nDims = precMats.GetNumCols();
+    auto nDims = chanPrec.GetNumCols();
     auto identity = Eigen::MatrixXcd::Identity(nDims, nDims);
-    auto res = ComplexMatrixArray{nDims, nDims, precMats.GetNumPages()};
-    auto chanPrec = (*this) * precMats;
+    auto res = ComplexMatrixArray{nDims, nDims, chanPrec.GetNumPages()};
     auto chanCov = chanPrec.HermitianTranspose() * chanPrec;
     for (size_t iRb = 0; iRb < res.GetNumPages(); iRb++)
     {
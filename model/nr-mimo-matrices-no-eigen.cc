@@ -16,7 +16,7 @@ NrCovMat::CalcIntfNormChannelMimo([[maybe_unused]] const ComplexMatrixArray& cha
 }
 
 ComplexMatrixArray
-NrIntfNormChanMat::ComputeMseMimo([[maybe_unused]] const ComplexMatrixArray& precMats) const
+NrIntfNormChanMat::ComputeMseMimo([[maybe_unused]] const ComplexMatrixArray& chanPrec) const
 {
     NS_FATAL_ERROR("MIMO MSE computation requires Eigen matrix library.");
 }
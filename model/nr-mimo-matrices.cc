@@ -4,19 +4,217 @@
 
 #include "nr-mimo-matrices.h"
 
+#include <algorithm>
+#include <array>
+
 namespace ns3
 {
 
+/// @brief Compute the diagonal of the inverse of a small Hermitian positive-definite matrix
+/// @param mat the lower triangle of the matrix (column-major, rank x rank), overwritten by its
+/// Cholesky factor
+/// @param rank the size of the matrix
+/// @param invDiag the diagonal of the inverse of the matrix
+static void
+ComputeInverseDiagonal(std::array<std::complex<double>,
+                                  NrIntfNormChanMat::MAX_BATCHED_RANK *
+                                      NrIntfNormChanMat::MAX_BATCHED_RANK>& mat,
+                       size_t rank,
+                       std::array<double, NrIntfNormChanMat::MAX_BATCHED_RANK>& invDiag)
+{
+    // Cholesky decomposition mat = L * L'
+    for (size_t j = 0; j < rank; j++)
+    {
+        auto diag = std::real(mat[j + j * rank]);
+        for (size_t k = 0; k < j; k++)
+        {
+            diag -= std::norm(mat[j + k * rank]);
+        }
+        diag = std::sqrt(diag);
+        mat[j + j * rank] = diag;
+        for (size_t i = j + 1; i < rank; i++)
+        {
+            auto sum = mat[i + j * rank];
+            for (size_t k = 0; k < j; k++)
+            {
+                sum -= mat[i + k * rank] * std::conj(mat[j + k * rank]);
+            }
+            mat[i + j * rank] = sum / diag;
+        }
+    }
+
+    // inv(mat) = inv(L)' * inv(L), so its diagonal is the squared norm of the columns of inv(L)
+    std::array<std::complex<double>,
+               NrIntfNormChanMat::MAX_BATCHED_RANK * NrIntfNormChanMat::MAX_BATCHED_RANK>
+        invL{};
+    for (size_t l = 0; l < rank; l++)
+    {
+        invL[l + l * rank] = 1.0 / std::real(mat[l + l * rank]);
+        invDiag[l] = std::norm(invL[l + l * rank]);
+        for (size_t i = l + 1; i < rank; i++)
+        {
+            auto sum = std::complex<double>{0.0, 0.0};
+            for (size_t k = l; k < i; k++)
+            {
+                sum += mat[i + k * rank] * invL[k + l * rank];
+            }
+            invL[i + l * rank] = -sum / std::real(mat[i + i * rank]);
+            invDiag[l] += std::norm(invL[i + l * rank]);
+        }
+    }
+}
+
+/// @brief Copy the lower triangle of a Hermitian matrix to its upper triangle
+/// @param page the matrix (column-major, n x n)
+/// @param n the number of rows and columns
+static void
+MirrorLowerTriangle(std::complex<double>* page, size_t n)
+{
+    for (size_t b = 0; b < n; b++)
+    {
+        for (size_t a = b + 1; a < n; a++)
+        {
+            page[b + a * n] = std::conj(page[a + b * n]);
+        }
+    }
+}
+
+/// @brief Add or subtract the covariance of an interference signal in place:
+/// cov += sign * (H * W) * (H * W)', where W is the identity if there is no precoding
+/// @param cov the covariance matrix (dim: nRxPorts * nRxPorts * nRbs)
+/// @param chanMat the channel matrix H (dim: nRxPorts * nTxPorts * nRbs)
+/// @param precMats the precoding matrices W (dim: nTxPorts * rank * nRbs), or nullptr
+/// @param sign 1 to add the signal, -1 to subtract it
+static void
+AccumulateInterferenceSignal(ComplexMatrixArray& cov,
+                             const ComplexMatrixArray& chanMat,
+                             const ComplexMatrixArray* precMats,
+                             double sign)
+{
+    auto n = cov.GetNumRows();
+    NS_ASSERT_MSG(chanMat.GetNumRows() == n && cov.GetNumCols() == n &&
+                      chanMat.GetNumPages() == cov.GetNumPages(),
+                  "Dimensions mismatch");
+    auto nTxPorts = chanMat.GetNumCols();
+    if (precMats == nullptr)
+    {
+        for (size_t p = 0; p < cov.GetNumPages(); p++)
+        {
+            // Column-major pages: element (i, j) is at i + j * nRows
+            const auto* chan = chanMat.GetPagePtr(p);
+            auto* page = cov.GetPagePtr(p);
+            for (size_t b = 0; b < n; b++)
+            {
+                for (size_t a = b; a < n; a++)
+                {
+                    auto sum = std::complex<double>{0.0, 0.0};
+                    for (size_t k = 0; k < nTxPorts; k++)
+                    {
+                        sum += chan[a + k * n] * std::conj(chan[b + k * n]);
+                    }
+                    page[a + b * n] += sign * sum;
+                }
+            }
+            MirrorLowerTriangle(page, n);
+        }
+        return;
+    }
+
+    NS_ASSERT_MSG((precMats->GetNumPages() > 0) && (chanMat.GetNumPages() > 0),
+                  "precMats and channel cannot be empty");
+    NS_ASSERT_MSG(precMats->GetNumPages() == chanMat.GetNumPages(),
+                  "dim mismatch " << precMats->GetNumPages() << " vs " << chanMat.GetNumPages());
+    NS_ASSERT_MSG(nTxPorts == precMats->GetNumRows(), "Inner dimensions of matrices mismatch");
+    if (n > NrCovMat::MAX_FUSED_RX_PORTS)
+    {
+        AccumulateInterferenceSignal(cov, chanMat * (*precMats), nullptr, sign);
+        return;
+    }
+
+    auto rank = precMats->GetNumCols();
+    std::array<std::complex<double>, NrCovMat::MAX_FUSED_RX_PORTS> chanPrec;
+    for (size_t p = 0; p < cov.GetNumPages(); p++)
+    {
+        const auto* chan = chanMat.GetPagePtr(p);
+        const auto* prec = precMats->GetPagePtr(p);
+        auto* page = cov.GetPagePtr(p);
+        for (size_t j = 0; j < rank; j++)
+        {
+            // Column j of H * W
+            std::fill_n(chanPrec.begin(), n, std::complex<double>{0.0, 0.0});
+            for (size_t k = 0; k < nTxPorts; k++)
+            {
+                auto precElem = prec[k + j * nTxPorts];
+                for (size_t i = 0; i < n; i++)
+                {
+                    chanPrec[i] += chan[i + k * n] * precElem;
+                }
+            }
+            for (size_t b = 0; b < n; b++)
+            {
+                auto conjB = sign * std::conj(chanPrec[b]);
+                for (size_t a = b; a < n; a++)
+                {
+                    page[a + b * n] += chanPrec[a] * conjB;
+                }
+            }
+        }
+        MirrorLowerTriangle(page, n);
+    }
+}
+
 void
 NrCovMat::AddInterferenceSignal(const ComplexMatrixArray& rhs)
 {
-    *this += rhs * rhs.HermitianTranspose();
+    AccumulateInterferenceSignal(*this, rhs, nullptr, 1.0);
 }
 
 void
 NrCovMat::SubtractInterferenceSignal(const ComplexMatrixArray& rhs)
 {
-    *this -= rhs * rhs.HermitianTranspose();
+    AccumulateInterferenceSignal(*this, rhs, nullptr, -1.0);
+}
+
+void
+NrCovMat::AddPrecodedInterferenceSignal(const ComplexMatrixArray& chanMat,
+                                        const ComplexMatrixArray& precMats)
+{
+    AccumulateInterferenceSignal(*this, chanMat, &precMats, 1.0);
+}
+
+void
+NrCovMat::SubtractPrecodedInterferenceSignal(const ComplexMatrixArray& chanMat,
+                                             const ComplexMatrixArray& precMats)
+{
+    AccumulateInterferenceSignal(*this, chanMat, &precMats, -1.0);
+}
+
+void
+NrCovMat::SetZero(size_t nRxPorts, size_t nRbs)
+{
+    if (m_numRows != nRxPorts || m_numCols != nRxPorts || m_numPages != nRbs)
+    {
+        *this = NrCovMat{ComplexMatrixArray{nRxPorts, nRxPorts, nRbs}};
+        return;
+    }
+    for (size_t p = 0; p < nRbs; p++)
+    {
+        std::fill_n(GetPagePtr(p), nRxPorts * nRxPorts, std::complex<double>{0.0, 0.0});
+    }
+}
+
+void
+NrCovMat::SetDiagonal(size_t nRxPorts, size_t nRbs, const SpectrumValue& diag)
+{
+    SetZero(nRxPorts, nRbs);
+    for (size_t p = 0; p < nRbs; p++)
+    {
+        auto* cov = GetPagePtr(p);
+        for (size_t i = 0; i < nRxPorts; i++)
+        {
+            cov[i + i * nRxPorts] = diag.ValuesAt(p);
+        }
+    }
 }
 
 NrIntfNormChanMat
@@ -44,7 +242,147 @@ NrCovMat::CalcIntfNormChannel(const ComplexMatrixArray& chanMat) const
 NrSinrMatrix
 NrIntfNormChanMat::ComputeSinrForPrecoding(const ComplexMatrixArray& precMats) const
 {
-    auto mseMat = ComputeMse(precMats);
+    return ComputeSinrForChanPrec((*this) * precMats);
+}
+
+NrSinrMatrix
+NrIntfNormChanMat::ComputeSinrForPrecoding(const ComplexMatrixArray& precMats, size_t page) const
+{
+    NS_ASSERT_MSG(page < precMats.GetNumPages(), "Precoder page out of range");
+    NS_ASSERT_MSG(GetNumCols() == precMats.GetNumRows(), "Inner dimensions of matrices mismatch");
+
+    // Multiply each page of the channel by the same precoder (column-major storage)
+    auto nRows = GetNumRows();
+    auto nPorts = GetNumCols();
+    auto rank = precMats.GetNumCols();
+    const auto* prec = precMats.GetPagePtr(page);
+    auto chanPrec = ComplexMatrixArray{nRows, rank, GetNumPages()};
+    for (size_t p = 0; p < GetNumPages(); p++)
+    {
+        const auto* chan = GetPagePtr(p);
+        auto* res = chanPrec.GetPagePtr(p);
+        for (size_t j = 0; j < rank; j++)
+        {
+            for (size_t k = 0; k < nPorts; k++)
+            {
+                auto precElem = prec[k + j * nPorts];
+                for (size_t i = 0; i < nRows; i++)
+                {
+                    res[i + j * nRows] += chan[i + k * nRows] * precElem;
+                }
+            }
+        }
+    }
+    return ComputeSinrForChanPrec(chanPrec);
+}
+
+DoubleMatrixArray
+NrIntfNormChanMat::ComputeSinrForPrecoders(const ComplexMatrixArray& precMats,
+                                           size_t firstPage,
+                                           size_t numPrecoders) const
+{
+    NS_ASSERT_MSG(firstPage + numPrecoders <= precMats.GetNumPages(),
+                  "Precoder pages out of range");
+    NS_ASSERT_MSG(GetNumCols() == precMats.GetNumRows(), "Inner dimensions of matrices mismatch");
+
+    auto nRxPorts = GetNumRows();
+    auto nTxPorts = GetNumCols();
+    auto rank = precMats.GetNumCols();
+    auto nPages = GetNumPages();
+    auto res = DoubleMatrixArray{rank, nPages, numPrecoders};
+    if (rank > MAX_BATCHED_RANK)
+    {
+        for (size_t k = 0; k < numPrecoders; k++)
+        {
+            auto sinr = ComputeSinrForPrecoding(precMats, firstPage + k);
+            for (size_t p = 0; p < nPages; p++)
+            {
+                for (size_t layer = 0; layer < rank; layer++)
+                {
+                    res(layer, p, k) = sinr(layer, p);
+                }
+            }
+        }
+        return res;
+    }
+
+    // W' * H' * H * W is computed either as W' * (G * W), with the Gram matrix G = H' * H of the
+    // page, or as (H * W)' * (H * W); the first one is cheaper with fewer TX than RX ports
+    auto useGram = nTxPorts < nRxPorts;
+    auto prodRows = useGram ? nTxPorts : nRxPorts;
+    std::vector<std::complex<double>> gram(useGram ? nTxPorts * nTxPorts : 0);
+    std::vector<std::complex<double>> prod(prodRows * rank);
+    std::array<std::complex<double>, MAX_BATCHED_RANK * MAX_BATCHED_RANK> mmse;
+    std::array<double, MAX_BATCHED_RANK> invDiag;
+    for (size_t p = 0; p < nPages; p++)
+    {
+        // Column-major pages: element (i, j) is at i + j * nRows
+        const auto* chan = GetPagePtr(p);
+        if (useGram)
+        {
+            for (size_t b = 0; b < nTxPorts; b++)
+            {
+                for (size_t a = 0; a < nTxPorts; a++)
+                {
+                    auto sum = std::complex<double>{0.0, 0.0};
+                    for (size_t i = 0; i < nRxPorts; i++)
+                    {
+                        sum += std::conj(chan[i + a * nRxPorts]) * chan[i + b * nRxPorts];
+                    }
+                    gram[a + b * nTxPorts] = sum;
+                }
+            }
+        }
+        const auto* lhs = useGram ? gram.data() : chan;
+
+        for (size_t k = 0; k < numPrecoders; k++)
+        {
+            const auto* prec = precMats.GetPagePtr(firstPage + k);
+
+            // prod = G * W or H * W
+            std::fill(prod.begin(), prod.end(), std::complex<double>{0.0, 0.0});
+            for (size_t j = 0; j < rank; j++)
+            {
+                for (size_t c = 0; c < nTxPorts; c++)
+                {
+                    auto precElem = prec[c + j * nTxPorts];
+                    for (size_t i = 0; i < prodRows; i++)
+                    {
+                        prod[i + j * prodRows] += lhs[i + c * prodRows] * precElem;
+                    }
+                }
+            }
+
+            // Lower triangle of I + W' * H' * H * W
+            const auto* left = useGram ? prec : prod.data();
+            for (size_t b = 0; b < rank; b++)
+            {
+                for (size_t a = b; a < rank; a++)
+                {
+                    auto sum = std::complex<double>{a == b ? 1.0 : 0.0, 0.0};
+                    for (size_t i = 0; i < prodRows; i++)
+                    {
+                        sum += std::conj(left[i + a * prodRows]) * prod[i + b * prodRows];
+                    }
+                    mmse[a + b * rank] = sum;
+                }
+            }
+
+            // The MSE of each layer is the diagonal of inv(I + W' * H' * H * W)
+            ComputeInverseDiagonal(mmse, rank, invDiag);
+            for (size_t layer = 0; layer < rank; layer++)
+            {
+                res(layer, p, k) = 1.0 / invDiag[layer] - 1.0;
+            }
+        }
+    }
+    return res;
+}
+
+NrSinrMatrix
+NrIntfNormChanMat::ComputeSinrForChanPrec(const ComplexMatrixArray& chanPrec) const
+{
+    auto mseMat = ComputeMse(chanPrec);
 
     // Compute the SINR values from the diagonal elements of the mseMat.
     // Result is a 2D Matrix, size rank x nRbs.
@@ -61,14 +399,14 @@ NrIntfNormChanMat::ComputeSinrForPrecoding(const ComplexMatrixArray& precMats) c
 }
 
 ComplexMatrixArray
-NrIntfNormChanMat::ComputeMse(const ComplexMatrixArray& precMats) const
+NrIntfNormChanMat::ComputeMse(const ComplexMatrixArray& chanPrec) const
 {
-    // Compute the MSE of an MMSE receiver: inv(I + precMats' * this' * this * precMats)
+    // Compute the MSE of an MMSE receiver: inv(I + chanPrec' * chanPrec), where chanPrec is
+    // this * precMats
 
     if ((GetNumRows() == 1) && (GetNumCols() == 1)) // SISO
     {
         auto res = ComplexMatrixArray{1, 1, GetNumPages()};
-        auto chanPrec = (*this) * precMats;
         for (size_t iRb = 0; iRb < GetNumPages(); iRb++)
         {
             res(0, 0, iRb) = 1.0 / (1.0 + std::norm(chanPrec.Elem(0, 0, iRb)));
@@ -77,7 +415,7 @@ NrIntfNormChanMat::ComputeMse(const ComplexMatrixArray& precMats) const
     }
     else // MIMO
     {
-        return ComputeMseMimo(precMats);
+        return ComputeMseMimo(chanPrec);
     }
 }
 
@@ -127,4 +465,11 @@ NrSinrMatrix::GetVectorizedSpecVal() const
     }
     return vectorizedSinr;
 }
+
+const double*
+NrSinrMatrix::GetVectorizedValues() const
+{
+    // The values are stored column by column, i.e., layer by layer for each RB
+    return &m_values[0];
+}
 } // namespace ns3
@@ -26,13 +26,46 @@ class NrCovMat : public ComplexMatrixArray
         : ComplexMatrixArray(arr){};
 
     /// Add an interference signal: this += rhs * rhs.HermitianTranspose()
+    /// The lower triangle of each page is accumulated in place and mirrored to the upper one,
+    /// without temporary matrix arrays.
     /// @param rhs the full channel matrix (including precoding)
     virtual void AddInterferenceSignal(const ComplexMatrixArray& rhs);
 
+    /// Add a precoded interference signal: this += (H * W) * (H * W).HermitianTranspose(), where
+    /// H is the channel matrix and W the precoding matrix of each page. The columns of H * W are
+    /// formed one at a time on the stack and added to the lower triangle of each page, without
+    /// temporary matrix arrays, for up to MAX_FUSED_RX_PORTS receive ports.
+    /// @param chanMat the channel matrix without precoding (dim: nRxPorts * nTxPorts * nRbs)
+    /// @param precMats the precoding matrices (dim: nTxPorts * rank * nRbs)
+    void AddPrecodedInterferenceSignal(const ComplexMatrixArray& chanMat,
+                                       const ComplexMatrixArray& precMats);
+
     /// Subtract an interference signal: this -= rhs * rhs.HermitianTranspose()
     /// @param rhs the full channel matrix (including precoding)
     virtual void SubtractInterferenceSignal(const ComplexMatrixArray& rhs);
 
+    /// Subtract a precoded interference signal: this -= (H * W) * (H * W).HermitianTranspose(),
+    /// in place as in AddPrecodedInterferenceSignal()
+    /// @param chanMat the channel matrix without precoding (dim: nRxPorts * nTxPorts * nRbs)
+    /// @param precMats the precoding matrices (dim: nTxPorts * rank * nRbs)
+    void SubtractPrecodedInterferenceSignal(const ComplexMatrixArray& chanMat,
+                                            const ComplexMatrixArray& precMats);
+
+    /// Set each page to the zero matrix, reusing the allocated pages when the dimensions do not
+    /// change
+    /// @param nRxPorts the number of rows and columns of each page
+    /// @param nRbs the number of pages
+    void SetZero(size_t nRxPorts, size_t nRbs);
+
+    /// Set each page to a diagonal matrix, reusing the allocated pages when the dimensions do
+    /// not change
+    /// @param nRxPorts the number of rows and columns of each page
+    /// @param nRbs the number of pages
+    /// @param diag the value of the diagonal of each page (dim: at least nRbs)
+    void SetDiagonal(size_t nRxPorts, size_t nRbs, const SpectrumValue& diag);
+
+    static constexpr size_t MAX_FUSED_RX_PORTS = 64; ///< Maximum ports of the fused kernel
+
     /// @brief Calculate the interference-normalized channel matrix for SISO and MIMO.
     /// See NrIntfNormChanMat for details.
     /// @param chanMat the frequency-domain channel matrix without precoding
@@ -72,6 +105,32 @@ class NrIntfNormChanMat : public ComplexMatrixArray
     /// @returns the SINR values for each layer and RB (dim: rank x nRbs)
     virtual NrSinrMatrix ComputeSinrForPrecoding(const ComplexMatrixArray& precMats) const;
 
+    /// @brief Compute the MIMO SINR when the same precoder is applied to all the pages (RBs or
+    /// subbands) of the channel. The precoder is read in place, without copying it to each page.
+    /// @param precMats the precoding matrices (dim: nTxPorts * rank * nPrecoders)
+    /// @param page the page of precMats with the precoder to apply
+    /// @returns the SINR values for each layer and RB (dim: rank x nRbs)
+    NrSinrMatrix ComputeSinrForPrecoding(const ComplexMatrixArray& precMats, size_t page) const;
+
+    /// @brief Compute the MIMO SINR of a batch of precoders, each applied to all the pages (RBs or
+    /// subbands) of the channel.
+    ///
+    /// For ranks up to MAX_BATCHED_RANK, the MMSE matrices I + W' * H' * H * W are built in
+    /// place and their inverse diagonal is obtained from a Cholesky decomposition, without
+    /// intermediate matrix arrays. When the channel has more receive than transmit ports, the
+    /// Gram matrix H' * H of each page is computed once and shared by all the precoders. The
+    /// kernel does not depend on Eigen, so it is available in builds without it. Higher ranks
+    /// fall back to ComputeSinrForPrecoding() for each precoder.
+    /// @param precMats the precoding matrices (dim: nTxPorts * rank * nPrecoders)
+    /// @param firstPage the page of precMats with the first precoder of the batch
+    /// @param numPrecoders the number of consecutive pages of precMats in the batch
+    /// @returns the SINR values for each layer, RB and precoder (dim: rank x nRbs x numPrecoders)
+    DoubleMatrixArray ComputeSinrForPrecoders(const ComplexMatrixArray& precMats,
+                                              size_t firstPage,
+                                              size_t numPrecoders) const;
+
+    static constexpr size_t MAX_BATCHED_RANK = 4; ///< Maximum rank of ComputeSinrForPrecoders
+
     /**
      *  @brief Compute the average received signal parameters (channel and interference matrix)
      *  between the different channel subbands.
@@ -105,16 +164,21 @@ class NrIntfNormChanMat : public ComplexMatrixArray
     virtual ComplexMatrixArray ExtractOptimalPrecodingMatrices(uint8_t rank) const;
 
   private:
+    /// @brief Compute the SINR values from the diagonal elements of the MSE matrices
+    /// @param chanPrec the precoded channel matrices (dim: nRxPorts * rank * nRbs)
+    /// @returns the SINR values for each layer and RB (dim: rank x nRbs)
+    NrSinrMatrix ComputeSinrForChanPrec(const ComplexMatrixArray& chanPrec) const;
+
     /// @brief Compute the MSE (mean square error) for an MMSE receiver, for SISO and MIMO.
-    /// @param precMats the precoding matrices (dim: nTxPorts * rank * nRbs)
+    /// @param chanPrec the precoded channel matrices (dim: nRxPorts * rank * nRbs)
     /// @returns the MSE value or matrix
-    virtual ComplexMatrixArray ComputeMse(const ComplexMatrixArray& precMats) const;
+    virtual ComplexMatrixArray ComputeMse(const ComplexMatrixArray& chanPrec) const;
 
     /// @brief Compute the MSE (mean square error) matrix for a MIMO MMSE receiver
     /// When the simulation is SISO only, this method will not be called.
-    /// @param precMats the precoding matrices (dim: nTxPorts * rank * nRbs)
-    /// @returns the MSE matrix as inv(I + precMats' * this' * this * precMats).
-    virtual ComplexMatrixArray ComputeMseMimo(const ComplexMatrixArray& precMats) const;
+    /// @param chanPrec the precoded channel matrices (dim: nRxPorts * rank * nRbs)
+    /// @returns the MSE matrix as inv(I + chanPrec' * chanPrec).
+    virtual ComplexMatrixArray ComputeMseMimo(const ComplexMatrixArray& chanPrec) const;
 };
 
 /// @brief NrSinrMatrix stores the MIMO SINR matrix, with dimension rank x nRbs
@@ -135,6 +199,10 @@ class NrSinrMatrix : public DoubleMatrixArray
     /// Matches layer-to-codeword mapping in TR 38.211, Table 7.3.1.3-1
     /// @return A SpectrumValue with the (nRB * nMimoLayers) SINR values
     SpectrumValue GetVectorizedSpecVal() const;
+    /// @brief Get the SINR values in the order of GetVectorizedSpecVal(), without creating a
+    /// SpectrumModel, which is not thread safe
+    /// @return A pointer to the (nRB * nMimoLayers) SINR values
+    const double* GetVectorizedValues() const;
 };
 
 } // namespace ns3
@@ -0,0 +1,219 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-parallel-scheduling.h"
+
+#include "nr-thread-pool.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrParallelScheduling");
+NS_OBJECT_ENSURE_REGISTERED(NrParallelScheduling);
+
+thread_local std::vector<std::function<void()>>* NrParallelScheduling::t_actions = nullptr;
+
+TypeId
+NrParallelScheduling::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrParallelScheduling")
+            .SetParent<Object>()
+            .AddConstructor<NrParallelScheduling>()
+            .SetGroupName("Nr")
+            .AddAttribute("NumThreads",
+                          "Number of threads that run the scheduling triggers of the gNBs. "
+                          "The value 0 uses all the available cores. The results do not "
+                          "depend on this value.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrParallelScheduling::SetNumThreads,
+                                               &NrParallelScheduling::GetNumThreads),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+NrParallelScheduling::NrParallelScheduling()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NrParallelScheduling::~NrParallelScheduling()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+NrParallelScheduling::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_runEvent.Cancel();
+    m_gnbs.clear();
+    Object::DoDispose();
+}
+
+void
+NrParallelScheduling::SetNumThreads(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    m_numThreads = numThreads;
+}
+
+uint32_t
+NrParallelScheduling::GetNumThreads() const
+{
+    return m_numThreads;
+}
+
+void
+NrParallelScheduling::Enqueue(uint16_t cellId, std::function<void()> call, bool trigger)
+{
+    NS_ASSERT_MSG(cellId != NO_CELL, "Invalid cell ID");
+    if (t_actions != nullptr || cellId == m_currentCell)
+    {
+        // Called by the schedulers of the gNB being executed
+        call();
+        return;
+    }
+
+    m_gnbs[cellId].calls.push_back({std::move(call), trigger});
+    if (!m_runEvent.IsPending())
+    {
+        m_runEvent = Simulator::ScheduleNow(&NrParallelScheduling::Run, this);
+    }
+}
+
+void
+NrParallelScheduling::Flush(uint16_t cellId)
+{
+    if (t_actions != nullptr || cellId == m_currentCell)
+    {
+        return;
+    }
+
+    auto it = m_gnbs.find(cellId);
+    if (it != m_gnbs.end())
+    {
+        RunSequentially(cellId, it->second);
+    }
+}
+
+bool
+NrParallelScheduling::IsInTrigger()
+{
+    return t_actions != nullptr;
+}
+
+void
+NrParallelScheduling::Defer(std::function<void()> action)
+{
+    NS_ASSERT_MSG(t_actions != nullptr, "Only the scheduling triggers can defer actions");
+    t_actions->push_back(std::move(action));
+}
+
+void
+NrParallelScheduling::Run()
+{
+    NS_LOG_FUNCTION(this);
+
+    std::vector<Gnb*> round;
+    std::vector<uint16_t> roundCells;
+    do
+    {
+        round.clear();
+        roundCells.clear();
+        for (auto& [cellId, gnb] : m_gnbs)
+        {
+            auto previousCell = m_currentCell;
+            m_currentCell = cellId;
+            while (!gnb.calls.empty() && !gnb.calls.front().trigger)
+            {
+                auto call = std::move(gnb.calls.front().function);
+                gnb.calls.pop_front();
+                call();
+            }
+            m_currentCell = previousCell;
+
+            if (!gnb.calls.empty())
+            {
+                gnb.trigger = std::move(gnb.calls.front().function);
+                gnb.calls.pop_front();
+                round.push_back(&gnb);
+                roundCells.push_back(cellId);
+            }
+        }
+
+        NS_LOG_LOGIC("Running " << round.size() << " scheduling triggers");
+        RunTriggers(round);
+
+        for (size_t i = 0; i < round.size(); ++i)
+        {
+            Commit(roundCells[i], *round[i]);
+        }
+    } while (!round.empty());
+}
+
+void
+NrParallelScheduling::RunSequentially(uint16_t cellId, Gnb& gnb)
+{
+    NS_LOG_FUNCTION(this << cellId);
+
+    Commit(cellId, gnb);
+
+    auto previousCell = m_currentCell;
+    m_currentCell = cellId;
+    if (gnb.trigger)
+    {
+        // Flushed by another gNB in the round of this trigger, before the round started
+        auto trigger = std::move(gnb.trigger);
+        gnb.trigger = nullptr;
+        trigger();
+    }
+    while (!gnb.calls.empty())
+    {
+        auto call = std::move(gnb.calls.front().function);
+        gnb.calls.pop_front();
+        call();
+    }
+    m_currentCell = previousCell;
+}
+
+void
+NrParallelScheduling::Commit(uint16_t cellId, Gnb& gnb)
+{
+    auto previousCell = m_currentCell;
+    m_currentCell = cellId;
+    for (auto& action : gnb.actions)
+    {
+        action();
+    }
+    gnb.actions.clear();
+    m_currentCell = previousCell;
+}
+
+void
+NrParallelScheduling::RunTrigger(Gnb& gnb)
+{
+    if (!gnb.trigger)
+    {
+        return;
+    }
+    t_actions = &gnb.actions;
+    gnb.trigger();
+    gnb.trigger = nullptr;
+    t_actions = nullptr;
+}
+
+void
+NrParallelScheduling::RunTriggers(const std::vector<Gnb*>& gnbs)
+{
+    NrThreadPool::Get().Run(m_numThreads, gnbs.size(), [&gnbs](size_t i) {
+        RunTrigger(*gnbs[i]);
+    });
+}
+
+} // namespace ns3
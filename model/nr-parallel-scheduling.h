@@ -0,0 +1,177 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_PARALLEL_SCHEDULING_H
+#define NR_PARALLEL_SCHEDULING_H
+
+#include "ns3/event-id.h"
+#include "ns3/object.h"
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup gnb-mac
+ * @brief Runs the slot scheduling of several gNBs on the threads of NrThreadPool
+ *
+ * At the start of each slot, every gNB MAC passes the CQI, HARQ, SR, BSR and RACH
+ * information to its schedulers, and then triggers the DL and UL scheduling of future
+ * slots. The scheduling of a gNB only depends on its own state, so the schedulers of
+ * different gNBs can run at the same time.
+ *
+ * When a gNB MAC is given an NrParallelScheduling instance (see
+ * NrHelper::EnableParallelScheduling()), it queues the calls to its schedulers during the
+ * slot indications with Enqueue(), instead of calling them. The queued calls of all the
+ * gNBs are executed later, at the same simulation time, in rounds:
+ *
+ * - the calls that update the scheduler state are executed in the main thread, gNB after
+ *   gNB in cell ID order, up to the next scheduling trigger of each gNB;
+ * - the scheduling triggers of all the gNBs are executed by NumThreads threads. The
+ *   calls of the same gNB always run in the same thread, in the order they were queued;
+ * - the actions that must run in the main thread, such as passing the allocations to the
+ *   MAC and the PHY, which schedule events and fire traces, are deferred with Defer()
+ *   during the triggers, and executed after them, gNB after gNB in cell ID order.
+ *
+ * The result does not depend on the number of threads, nor on which thread runs each
+ * gNB. Before any other call to its schedulers, the MAC executes the calls still queued
+ * for its gNB with Flush(), so that the schedulers see the same sequence of calls as
+ * without this class. Compared to a simulation without it, the allocations are passed
+ * to the PHY later in the same time stamp, so the order of events that happen at the
+ * same time as a slot start may change.
+ *
+ * The schedulers of one gNB, i.e., of all its bandwidth parts, share the same thread.
+ * Schedulers that call user code while scheduling (e.g., NrMacSchedulerOfdmaAi) or that
+ * share state between gNBs need NumThreads equal to 1. The log messages of the
+ * schedulers of different gNBs may interleave.
+ */
+class NrParallelScheduling : public Object
+{
+  public:
+    /**
+     * @brief Get the type ID
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief NrParallelScheduling constructor
+     */
+    NrParallelScheduling();
+
+    /**
+     * @brief ~NrParallelScheduling
+     */
+    ~NrParallelScheduling() override;
+
+    /**
+     * @brief Set the number of threads that run the scheduling triggers
+     * @param numThreads the number of threads, or 0 to use all the available cores
+     */
+    void SetNumThreads(uint32_t numThreads);
+
+    /**
+     * @return the number of threads that run the scheduling triggers
+     */
+    uint32_t GetNumThreads() const;
+
+    /**
+     * @brief Queue a call to the schedulers of a gNB, to be executed at the end of the
+     * current time stamp
+     *
+     * If the calling thread is executing the calls of the same gNB, the call is executed
+     * immediately, as it would be without this class.
+     *
+     * @param cellId the cell ID of the gNB
+     * @param call the call
+     * @param trigger whether the call is a scheduling trigger, that can run in any thread
+     */
+    void Enqueue(uint16_t cellId, std::function<void()> call, bool trigger);
+
+    /**
+     * @brief Execute now, in the main thread, the calls queued for a gNB and its deferred
+     * actions
+     * @param cellId the cell ID of the gNB
+     */
+    void Flush(uint16_t cellId);
+
+    /**
+     * @return true if the calling thread is executing a scheduling trigger
+     */
+    static bool IsInTrigger();
+
+    /**
+     * @brief Defer an action of the scheduling trigger being executed by the calling
+     * thread, to be executed in the main thread after the triggers of all the gNBs
+     * @param action the action
+     */
+    static void Defer(std::function<void()> action);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Queued call to the schedulers of a gNB
+    struct Call
+    {
+        std::function<void()> function; //!< The call
+        bool trigger;                   //!< Whether it can run in any thread
+    };
+
+    /// Calls of a gNB
+    struct Gnb
+    {
+        std::deque<Call> calls;                     //!< Queued calls
+        std::function<void()> trigger;              //!< Trigger of the current round
+        std::vector<std::function<void()>> actions; //!< Actions deferred by the trigger
+    };
+
+    /**
+     * @brief Execute the queued calls of all the gNBs
+     */
+    void Run();
+
+    /**
+     * @brief Execute the deferred actions and the queued calls of a gNB in the main thread
+     * @param cellId the cell ID of the gNB
+     * @param gnb the calls of the gNB
+     */
+    void RunSequentially(uint16_t cellId, Gnb& gnb);
+
+    /**
+     * @brief Execute the deferred actions of a gNB in the main thread
+     * @param cellId the cell ID of the gNB
+     * @param gnb the calls of the gNB
+     */
+    void Commit(uint16_t cellId, Gnb& gnb);
+
+    /**
+     * @brief Execute the triggers of a round, with the threads of NrThreadPool
+     * @param gnbs the gNBs with a trigger in the round
+     */
+    void RunTriggers(const std::vector<Gnb*>& gnbs);
+
+    /**
+     * @brief Execute the trigger of a gNB, deferring its actions
+     * @param gnb the gNB
+     */
+    static void RunTrigger(Gnb& gnb);
+
+    static constexpr uint16_t NO_CELL{0}; //!< No gNB is being executed
+
+    uint32_t m_numThreads{0};        //!< The `NumThreads` attribute
+    std::map<uint16_t, Gnb> m_gnbs;  //!< Calls of each gNB, in cell ID order
+    uint16_t m_currentCell{NO_CELL}; //!< gNB whose calls the main thread is executing
+    EventId m_runEvent;              //!< Event that executes the queued calls
+
+    static thread_local std::vector<std::function<void()>>* t_actions; //!< Deferred actions
+};
+
+} // namespace ns3
+
+#endif // NR_PARALLEL_SCHEDULING_H
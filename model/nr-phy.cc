@@ -440,6 +440,19 @@ NrPhy::GetPowerAllocationType() const
     return m_powerAllocationType;
 }
 
+void
+NrPhy::SetLocal(bool local)
+{
+    NS_LOG_FUNCTION(this << local);
+    m_local = local;
+}
+
+bool
+NrPhy::IsLocal() const
+{
+    return m_local;
+}
+
 void
 NrPhy::EnqueueCtrlMessage(const Ptr<NrControlMessage>& m)
 {
@@ -556,7 +569,11 @@ NrPhy::DoUpdateRbNum()
     // once we have set noise power spectral density which will
     // initialize SpectrumModel of our SpectrumPhy, we can
     // call AddRx function of the SpectrumChannel
-    if (m_spectrumPhy->GetSpectrumChannel())
+    if (!m_local)
+    {
+        NS_LOG_INFO("PHY of another process, not a receiver of the channel");
+    }
+    else if (m_spectrumPhy->GetSpectrumChannel())
     {
         m_spectrumPhy->GetSpectrumChannel()->AddRx(m_spectrumPhy);
     }
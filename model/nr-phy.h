@@ -397,6 +397,22 @@ class NrPhy : public Object
      */
     enum NrSpectrumValueHelper::PowerAllocationType GetPowerAllocationType() const;
 
+    /**
+     * @brief Set whether the PHY is simulated by the local process
+     *
+     * In a distributed simulation, the PHYs of the nodes of other processes are passive
+     * copies: they are not receivers of the spectrum channel, and NrHelper does not start
+     * their event loop. See NrDistributedHelper.
+     *
+     * @param local whether the PHY is simulated by the local process
+     */
+    void SetLocal(bool local);
+
+    /**
+     * @return true if the PHY is simulated by the local process
+     */
+    bool IsLocal() const;
+
   protected:
     /**
      * @brief DoDispose method inherited from Object
@@ -602,6 +618,7 @@ class NrPhy : public Object
                                                                //!< supported modes to distribute
                                                                //!< power uniformly over all RBs, or
                                                                //!< only used RBs
+    bool m_local{true}; //!< Whether the PHY is simulated by the local process
 };
 
 } // namespace ns3
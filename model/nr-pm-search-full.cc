@@ -5,10 +5,12 @@
 #include "nr-pm-search-full.h"
 
 #include "ns3/boolean.h"
+#include "ns3/enum.h"
 #include "ns3/simulator.h"
 #include "ns3/uinteger.h"
 
 #include <numeric>
+#include <optional>
 
 namespace ns3
 {
@@ -19,14 +21,32 @@ NS_OBJECT_ENSURE_REGISTERED(NrPmSearchFull);
 TypeId
 NrPmSearchFull::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::NrPmSearchFull")
-                            .SetParent<NrPmSearch>()
-                            .AddConstructor<NrPmSearchFull>()
-                            .AddAttribute("CodebookType",
-                                          "Codebook class to be used",
-                                          TypeIdValue(NrCbTwoPort::GetTypeId()),
-                                          MakeTypeIdAccessor(&NrPmSearchFull::SetCodebookTypeId),
-                                          MakeTypeIdChecker());
+    static TypeId tid =
+        TypeId("ns3::NrPmSearchFull")
+            .SetParent<NrPmSearch>()
+            .AddConstructor<NrPmSearchFull>()
+            .AddAttribute("CodebookType",
+                          "Codebook class to be used",
+                          TypeIdValue(NrCbTwoPort::GetTypeId()),
+                          MakeTypeIdAccessor(&NrPmSearchFull::SetCodebookTypeId),
+                          MakeTypeIdChecker())
+            .AddAttribute("SearchPolicy",
+                          "Policy used to search the rank, the PMI and the MCS. Exhaustive "
+                          "evaluates all of them. Pruned stops at the rank where the capacity "
+                          "drops, runs the subband search only for NumI1Candidates wideband "
+                          "PMIs, and bisects the MCS",
+                          EnumValue(NrPmSearchFull::Exhaustive),
+                          MakeEnumAccessor<SearchPolicy>(&NrPmSearchFull::m_searchPolicy),
+                          MakeEnumChecker(NrPmSearchFull::Exhaustive,
+                                          "Exhaustive",
+                                          NrPmSearchFull::Pruned,
+                                          "Pruned"))
+            .AddAttribute("NumI1Candidates",
+                          "Number of wideband PMIs (i1) that go through the subband search "
+                          "with the Pruned policy",
+                          UintegerValue(4),
+                          MakeUintegerAccessor(&NrPmSearchFull::m_numI1Candidates),
+                          MakeUintegerChecker<uint32_t>(1));
     return tid;
 }
 
@@ -59,6 +79,7 @@ NrPmSearchFull::InitCodebooks()
         m_cbFactory.Set("Rank", UintegerValue(rank));
         m_rankParams[rank].cb = m_cbFactory.Create<NrCbTypeOne>();
         m_rankParams[rank].cb->Init();
+        m_rankParams[rank].precoders = m_rankParams[rank].cb->GetPrecoders();
     }
 }
 
@@ -76,6 +97,11 @@ NrPmSearchFull::CreateCqiFeedbackMimo(const NrMimoSignal& rxSignalRb, PmiUpdate
     // Compute the interference-normalized channel matrix
     auto rbNormChanMat = rxSignalRb.m_covMat.CalcIntfNormChannel(rxSignalRb.m_chanMat);
 
+    if (m_searchPolicy == Pruned)
+    {
+        return CreateCqiFeedbackPruned(rbNormChanMat, pmiUpdate);
+    }
+
     // Update optimal precoding matrices based on received signal, if update is requested
     ConditionallyUpdatePrecoding(rbNormChanMat, pmiUpdate);
 
@@ -104,6 +130,83 @@ NrPmSearchFull::CreateCqiFeedbackMimo(const NrMimoSignal& rxSignalRb, PmiUpdate
     return optRankCqiMsg;
 }
 
+PmCqiInfo
+NrPmSearchFull::CreateCqiFeedbackPruned(const NrIntfNormChanMat& rbNormChanMat, PmiUpdate pmiUpdate)
+{
+    NS_LOG_FUNCTION(this);
+
+    std::optional<NrIntfNormChanMat> sbNormChanMat;
+    auto getSbNormChanMat = [&]() -> const NrIntfNormChanMat& {
+        if (!sbNormChanMat)
+        {
+            sbNormChanMat = SubbandDownsampling(rbNormChanMat);
+        }
+        return *sbNormChanMat;
+    };
+
+    if (pmiUpdate.updateWb)
+    {
+        // The ranks that are not reached below must be searched again when they are evaluated
+        for (auto rank : m_ranks)
+        {
+            m_rankParams[rank].precParams = nullptr;
+        }
+    }
+
+    std::optional<PmCqiInfo> optRankCqiMsg;
+    double prevCapacity = 0.0;
+    bool isRankSearchDone = false;
+    for (auto rank : m_ranks)
+    {
+        auto& optPrec = m_rankParams[rank].precParams;
+        if (isRankSearchDone)
+        {
+            // As in the exhaustive search, a subband update refreshes the subband PMIs of all
+            // the ranks, so that they are not stale when a later feedback evaluates them
+            if (optPrec && pmiUpdate.updateSb)
+            {
+                optPrec = FindOptSubbandPrecoding(getSbNormChanMat(), optPrec->wbPmi, rank);
+            }
+            continue;
+        }
+
+        if (!optPrec)
+        {
+            optPrec = FindOptPrecoding(getSbNormChanMat(), rank);
+        }
+        else if (pmiUpdate.updateSb)
+        {
+            optPrec = FindOptSubbandPrecoding(getSbNormChanMat(), optPrec->wbPmi, rank);
+        }
+
+        // Stop increasing the rank once the capacity of the optimal precoding drops
+        if (optRankCqiMsg && optPrec->perfMetric < prevCapacity)
+        {
+            isRankSearchDone = true;
+            continue;
+        }
+        prevCapacity = optPrec->perfMetric;
+
+        auto cqiMsg = CreateCqiForRank(rank, rbNormChanMat);
+        // As in the exhaustive search, a rank that is incapable of maintaining the connection
+        // is only kept if it is the first one
+        if (cqiMsg.m_wbCqi == 0)
+        {
+            if (!optRankCqiMsg)
+            {
+                optRankCqiMsg = std::move(cqiMsg);
+            }
+            isRankSearchDone = true;
+            continue;
+        }
+        if (!optRankCqiMsg || cqiMsg.m_tbSize > optRankCqiMsg->m_tbSize)
+        {
+            optRankCqiMsg = std::move(cqiMsg);
+        }
+    }
+    return *optRankCqiMsg;
+}
+
 void
 NrPmSearchFull::ConditionallyUpdatePrecoding(const NrIntfNormChanMat& rbNormChanMat,
                                              PmiUpdate pmiUpdate)
@@ -126,26 +229,75 @@ NrPmSearchFull::UpdateAllPrecoding(const NrIntfNormChanMat& rbNormChanMat)
 
     for (auto rank : m_ranks)
     {
-        // Loop over wideband precoding matrices W1 (index i1).
-        std::vector<Ptr<PrecMatParams>> optSubbandPrecoders{};
-        auto numI1 = m_rankParams[rank].cb->GetNumI1();
-        for (auto i1 = size_t{0}; i1 < numI1; i1++)
-        {
-            // Find the optimal subband PMI values (i2) for this particular i1
-            auto subbandParams = FindOptSubbandPrecoding(sbNormChanMat, i1, rank);
+        m_rankParams[rank].precParams = FindOptPrecoding(sbNormChanMat, rank);
+    }
+}
 
-            // Store the parameters for this wideband index i1
-            optSubbandPrecoders.emplace_back(subbandParams);
-        }
+Ptr<NrPmSearchFull::PrecMatParams>
+NrPmSearchFull::FindOptPrecoding(const NrIntfNormChanMat& sbNormChanMat, uint8_t rank) const
+{
+    std::vector<size_t> i1s;
+    if (m_searchPolicy == Pruned)
+    {
+        i1s = GetI1Candidates(sbNormChanMat, rank);
+    }
+    else
+    {
+        i1s.resize(m_rankParams[rank].cb->GetNumI1());
+        std::iota(i1s.begin(), i1s.end(), 0);
+    }
+
+    // Loop over wideband precoding matrices W1 (index i1).
+    std::vector<Ptr<PrecMatParams>> optSubbandPrecoders{};
+    for (auto i1 : i1s)
+    {
+        // Find the optimal subband PMI values (i2) for this particular i1
+        auto subbandParams = FindOptSubbandPrecoding(sbNormChanMat, i1, rank);
+
+        // Store the parameters for this wideband index i1
+        optSubbandPrecoders.emplace_back(subbandParams);
+    }
+
+    // Find the optimal wideband PMI i1
+    return *std::max_element(optSubbandPrecoders.begin(),
+                             optSubbandPrecoders.end(),
+                             [](const Ptr<PrecMatParams>& a, const Ptr<PrecMatParams>& b) {
+                                 return a->perfMetric < b->perfMetric;
+                             });
+}
+
+std::vector<size_t>
+NrPmSearchFull::GetI1Candidates(const NrIntfNormChanMat& sbNormChanMat, uint8_t rank) const
+{
+    const auto& precoders = *m_rankParams[rank].precoders;
+    auto numI1 = precoders.GetNumI1();
+    std::vector<size_t> i1s(numI1);
+    std::iota(i1s.begin(), i1s.end(), 0);
+    if (numI1 <= m_numI1Candidates)
+    {
+        return i1s;
+    }
 
-        // Find the optimal wideband PMI i1
-        m_rankParams[rank].precParams =
-            *std::max_element(optSubbandPrecoders.begin(),
-                              optSubbandPrecoders.end(),
-                              [](const Ptr<PrecMatParams>& a, const Ptr<PrecMatParams>& b) {
-                                  return a->perfMetric < b->perfMetric;
-                              });
+    // Capacity of the best i2 of each i1 on a single page, the average of the channel
+    // correlation of the subbands (as in NrPmSearchFast)
+    auto corrMat = NrIntfNormChanMat(sbNormChanMat.HermitianTranspose() * sbNormChanMat);
+    auto wbChanMat = NrIntfNormChanMat(corrMat.GetWidebandChannel());
+    std::vector<double> wbCap(numI1);
+    for (auto i1 : i1s)
+    {
+        wbCap[i1] = ComputeCapacityForPrecoders(wbChanMat, precoders, i1).GetValues().max();
     }
+
+    // Keep the i1 with the highest capacity, the lowest i1 first on ties
+    std::partial_sort(i1s.begin(),
+                      i1s.begin() + m_numI1Candidates,
+                      i1s.end(),
+                      [&wbCap](size_t a, size_t b) {
+                          return wbCap[a] > wbCap[b] || (wbCap[a] == wbCap[b] && a < b);
+                      });
+    i1s.resize(m_numI1Candidates);
+    std::sort(i1s.begin(), i1s.end());
+    return i1s;
 }
 
 void
@@ -177,7 +329,7 @@ NrPmSearchFull::CreateCqiForRank(uint8_t rank, const NrIntfNormChanMat& rbNormCh
     auto sinrMat = rbNormChanMat.ComputeSinrForPrecoding(rbPrecMat);
 
     // For the optimal precoding matrix, determine the achievable TB size and TBLER.
-    auto mcsParams = m_amc->GetMaxMcsParams(sinrMat, m_subbandSize);
+    auto mcsParams = m_amc->GetMaxMcsParams(sinrMat, m_subbandSize, m_searchPolicy == Pruned);
 
     // Clamp sub-band CQI according to 3GPP 2-bit overhead limit
     if (m_subbandCqiClamping)
@@ -215,17 +367,19 @@ NrPmSearchFull::FindOptSubbandPrecoding(const NrIntfNormChanMat& sbNormChanMat,
                                         size_t i1,
                                         uint8_t rank) const
 {
-    // Create the possible subband precoding matrices for each value of i2, and compute the
-    // corresponding performance metric (channel capacity) for each subband and each i2.
+    // Compute the performance metric (channel capacity) of the precoding matrix of each value of
+    // i2 in each subband, using the shared precoding matrices of the codebook.
     auto nSubbands = sbNormChanMat.GetNumPages();
-    auto allPrecMats = CreateSubbandPrecoders(i1, rank, nSubbands);
-    auto subbandMetricForPrec = ComputeCapacityForPrecoders(sbNormChanMat, allPrecMats);
-    auto numI2 = allPrecMats.size();
+    const auto& precoders = *m_rankParams[rank].precoders;
+    const auto& allPrecMats = precoders.GetPrecMats();
+    auto subbandMetricForPrec = ComputeCapacityForPrecoders(sbNormChanMat, precoders, i1);
+    auto numI2 = precoders.GetNumI2();
 
     // For each subband, find the optimal value of i2 (subband PMI value)
     auto sbPmis = std::vector<size_t>(nSubbands);
     auto optSubbandMetric = DoubleMatrixArray{nSubbands};
-    auto optPrecMat = allPrecMats[0]; // Initialize optimal precoding matrix
+    auto optPrecMat =
+        ComplexMatrixArray{allPrecMats.GetNumRows(), allPrecMats.GetNumCols(), nSubbands};
     for (auto iSb = size_t{0}; iSb < nSubbands; iSb++)
     {
         // Find the optimal value of i2 (subband PMI value) for the current subband
@@ -238,11 +392,12 @@ NrPmSearchFull::FindOptSubbandPrecoding(const NrIntfNormChanMat& sbNormChanMat,
             }
         }
         // Store the optimal precoding matrix for this subband
+        auto page = precoders.GetPage(i1, sbPmis[iSb]);
         for (size_t i = 0; i < optPrecMat.GetNumRows(); i++)
         {
             for (size_t j = 0; j < optPrecMat.GetNumCols(); j++)
             {
-                optPrecMat(i, j, iSb) = allPrecMats[sbPmis[iSb]](i, j, iSb);
+                optPrecMat(i, j, iSb) = allPrecMats(i, j, page);
             }
         }
     }
@@ -256,61 +411,51 @@ NrPmSearchFull::FindOptSubbandPrecoding(const NrIntfNormChanMat& sbNormChanMat,
     return res;
 }
 
-std::vector<ComplexMatrixArray>
-NrPmSearchFull::CreateSubbandPrecoders(size_t i1, uint8_t rank, size_t nSubbands) const
+DoubleMatrixArray
+NrPmSearchFull::ComputeCapacityForPrecoders(const NrIntfNormChanMat& sbNormChanMat,
+                                            std::vector<ComplexMatrixArray> allPrecMats) const
 {
-    const auto& cb = m_rankParams[rank].cb;
-    auto numI2 = cb->GetNumI2();
-
-    std::vector<ComplexMatrixArray> allPrecMats;
-
+    auto nSubbands = sbNormChanMat.GetNumPages();
+    auto numI2 = allPrecMats.size();
+    // Loop over subband PMI value i2 and store the capacity for each subband and each i2
+    DoubleMatrixArray subbandCap{nSubbands, numI2};
     for (auto i2 = size_t{0}; i2 < numI2; i2++)
     {
-        auto basePrecMat = cb->GetBasePrecMat(i1, i2);
-        auto sbPrecMat = ExpandPrecodingMatrix(basePrecMat, nSubbands);
-        allPrecMats.emplace_back(sbPrecMat);
-    }
-    return allPrecMats;
-}
-
-ComplexMatrixArray
-NrPmSearchFull::ExpandPrecodingMatrix(ComplexMatrixArray basePrecMat, size_t nSubbands)
-{
-    NS_ASSERT_MSG(basePrecMat.GetNumPages() == 1, "Expanding to 3D requires a 2D input");
-    auto nRows = basePrecMat.GetNumRows();
-    auto nCols = basePrecMat.GetNumCols();
-    ComplexMatrixArray res{nRows, nCols, nSubbands};
-    for (size_t p = 0; p < nSubbands; p++)
-    {
-        for (size_t i = 0; i < nRows; i++)
+        const auto& sbPrecMat = allPrecMats[i2];
+        auto sinr = sbNormChanMat.ComputeSinrForPrecoding(sbPrecMat);
+        for (auto iSb = size_t{0}; iSb < nSubbands; iSb++)
         {
-            for (size_t j = 0; j < nCols; j++)
+            double currCap = 0;
+            for (size_t iLayer = 0; iLayer < sinr.GetNumRows(); iLayer++)
             {
-                res(i, j, p) = basePrecMat(i, j);
+                currCap += log2(1.0 + sinr(iLayer, iSb));
             }
+            subbandCap(iSb, i2) = currCap;
         }
     }
-    return res;
+    return subbandCap;
 }
 
 DoubleMatrixArray
 NrPmSearchFull::ComputeCapacityForPrecoders(const NrIntfNormChanMat& sbNormChanMat,
-                                            std::vector<ComplexMatrixArray> allPrecMats) const
+                                            const NrCbPrecoders& precoders,
+                                            size_t i1) const
 {
     auto nSubbands = sbNormChanMat.GetNumPages();
-    auto numI2 = allPrecMats.size();
-    // Loop over subband PMI value i2 and store the capacity for each subband and each i2
+    auto numI2 = precoders.GetNumI2();
+    // The i2 of the same i1 are consecutive pages, so their SINR is computed in a single batch
+    auto sinr = sbNormChanMat.ComputeSinrForPrecoders(precoders.GetPrecMats(),
+                                                      precoders.GetPage(i1, 0),
+                                                      numI2);
     DoubleMatrixArray subbandCap{nSubbands, numI2};
     for (auto i2 = size_t{0}; i2 < numI2; i2++)
     {
-        const auto& sbPrecMat = allPrecMats[i2];
-        auto sinr = sbNormChanMat.ComputeSinrForPrecoding(sbPrecMat);
         for (auto iSb = size_t{0}; iSb < nSubbands; iSb++)
         {
             double currCap = 0;
             for (size_t iLayer = 0; iLayer < sinr.GetNumRows(); iLayer++)
             {
-                currCap += log2(1.0 + sinr(iLayer, iSb));
+                currCap += log2(1.0 + sinr(iLayer, iSb, i2));
             }
             subbandCap(iSb, i2) = currCap;
         }
@@ -20,9 +20,22 @@ namespace ns3
 /// When a PMI update is requested, the optimal precoding matrices (PMI) are updated using
 /// exhaustive search over all possible precoding matrices specified in a codebook that is
 /// compatible to 3GPP TS 38.214 Type-I.
+///
+/// With the attribute SearchPolicy set to Pruned, the search is shortened in three ways: the
+/// ranks are evaluated in increasing order until the capacity of the optimal precoding drops,
+/// only the NumI1Candidates wideband PMIs (i1) with the highest capacity on the wideband
+/// channel go through the subband search, and the MCS of each rank is found by bisection
+/// (see NrAmc::GetMcs). The default Exhaustive policy evaluates every rank, i1 and MCS.
 class NrPmSearchFull : public NrPmSearch
 {
   public:
+    /// @brief Policy used to search the rank, the PMI and the MCS
+    enum SearchPolicy
+    {
+        Exhaustive, ///< Evaluate all the ranks, all the wideband PMIs and all the MCSs
+        Pruned,     ///< Stop at the rank where capacity drops, prune i1, bisect the MCS
+    };
+
     /// @brief Get TypeId
     /// @return the TypeId
     static TypeId GetTypeId();
@@ -52,8 +65,9 @@ class NrPmSearchFull : public NrPmSearch
   protected:
     struct RankParams
     {
-        Ptr<PrecMatParams> precParams; ///< The precoding parameters (WB/SB PMIs)
-        Ptr<NrCbTypeOne> cb;           ///< The codebook
+        Ptr<PrecMatParams> precParams;      ///< The precoding parameters (WB/SB PMIs)
+        Ptr<NrCbTypeOne> cb;                ///< The codebook
+        Ptr<const NrCbPrecoders> precoders; ///< The shared precoding matrices of the codebook
     };
 
     /// @brief Update the WB and/or SB PMI, or neither.
@@ -65,6 +79,33 @@ class NrPmSearchFull : public NrPmSearch
     /// @param rbNormChanMat the interference-normed channel matrix per RB
     void UpdateAllPrecoding(const NrIntfNormChanMat& rbNormChanMat);
 
+    /// @brief Find the optimum precoding matrices (wideband and subband) of a rank. With the
+    /// Pruned policy, only the candidates of GetI1Candidates() are evaluated.
+    /// @param sbNormChanMat the interference-normed channel matrix per subband
+    /// @param rank the rank (number of MIMO layers)
+    /// @return a struct containing wideband and subband PMIs, and full precoding matrix.
+    Ptr<PrecMatParams> FindOptPrecoding(const NrIntfNormChanMat& sbNormChanMat,
+                                        uint8_t rank) const;
+
+    /// @brief Select the wideband PMIs (i1) that go through the subband search with the Pruned
+    /// policy: the NumI1Candidates ones whose best i2 gets the highest capacity on the average
+    /// channel correlation of the subbands.
+    /// @param sbNormChanMat the interference-normed channel matrix per subband
+    /// @param rank the rank (number of MIMO layers)
+    /// @return the selected values of i1, in increasing order
+    std::vector<size_t> GetI1Candidates(const NrIntfNormChanMat& sbNormChanMat,
+                                        uint8_t rank) const;
+
+    /// @brief Create CQI feedback with the Pruned policy. The precoding of each rank is updated
+    /// just before its evaluation, and the ranks above the one where the capacity drops are not
+    /// evaluated. Their wideband PMIs are not searched, but a subband update refreshes the
+    /// subband PMIs of the ones that have a precoding, as the exhaustive search does.
+    /// @param rbNormChanMat the interference-normed channel matrix per RB
+    /// @param pmiUpdate struct that defines if WB/SB PMIs need to be updated
+    /// @return the CQI feedback message of the rank with the largest TB size
+    PmCqiInfo CreateCqiFeedbackPruned(const NrIntfNormChanMat& rbNormChanMat,
+                                      PmiUpdate pmiUpdate);
+
     /// @brief For all ranks, update the opt subband PMI assuming previous value of wideband PMI.
     /// @param rbNormChanMat the interference-normed channel matrix per RB
     void UpdateSubbandPrecoding(const NrIntfNormChanMat& rbNormChanMat);
@@ -84,18 +125,6 @@ class NrPmSearchFull : public NrPmSearch
                                                        size_t i1,
                                                        uint8_t rank) const;
 
-    /// @brief Create the subband precoding matrices for the given wideband precoding.
-    /// @param i1 the index of the wideband precoding matrix W1
-    /// @param rank the rank (number of MIMO layers)
-    /// @param nSubbands the number of subbands (desired number of pages in each precoding matrix)
-    /// @return a vector of all possible precoding matrices for fixed i1 and rank
-    std::vector<ComplexMatrixArray> CreateSubbandPrecoders(size_t i1,
-                                                           uint8_t rank,
-                                                           size_t nSubbands) const;
-
-    static ComplexMatrixArray ExpandPrecodingMatrix(ComplexMatrixArray basePrecMat,
-                                                    size_t nSubbands);
-
     /// @brief Compute the Shannon capacity for each possible precoding matrix in each subband.
     /// @param sbNormChanMat the interference-normed channel matrix per subband
     /// @param allPrecMats a vector of all possible subband precoding matrices for fixed i1 and rank
@@ -104,8 +133,21 @@ class NrPmSearchFull : public NrPmSearch
         const NrIntfNormChanMat& sbNormChanMat,
         std::vector<ComplexMatrixArray> allPrecMats) const;
 
-    std::vector<RankParams> m_rankParams; ///< The parameters (PMI values, codebook) for each rank
-    ObjectFactory m_cbFactory;            ///< The factory used to create the codebooks
+    /// @brief Compute the Shannon capacity for each subband precoding matrix (i2) of a wideband
+    /// precoding (i1) in each subband. The base precoding matrices of the codebook are applied to
+    /// all the subbands in place, in a single NrIntfNormChanMat::ComputeSinrForPrecoders() batch.
+    /// @param sbNormChanMat the interference-normed channel matrix per subband
+    /// @param precoders the precoding matrices of the codebook
+    /// @param i1 the index of the wideband precoding matrix W1
+    /// @return a matrix with the capacity values (nSubbands x numI2)
+    DoubleMatrixArray ComputeCapacityForPrecoders(const NrIntfNormChanMat& sbNormChanMat,
+                                                  const NrCbPrecoders& precoders,
+                                                  size_t i1) const;
+
+    std::vector<RankParams> m_rankParams;    ///< The parameters (PMI values, codebook) per rank
+    ObjectFactory m_cbFactory;               ///< The factory used to create the codebooks
+    SearchPolicy m_searchPolicy{Exhaustive}; ///< Policy used to search the rank, PMI and MCS
+    uint32_t m_numI1Candidates{4};           ///< Number of i1 candidates of the Pruned policy
 };
 
 } // namespace ns3
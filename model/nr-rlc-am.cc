@@ -8,6 +8,7 @@
 #include "nr-rlc-am.h"
 
 #include "nr-rlc-am-header.h"
+#include "nr-rlc-segment-chain.h"
 #include "nr-rlc-sdu-status-tag.h"
 #include "nr-rlc-tag.h"
 
@@ -134,7 +135,7 @@ NrRlcAm::DoDispose()
     m_retxBufferSize = 0;
     m_rxonBuffer.clear();
     m_sdusBuffer.clear();
-    m_keepS0 = nullptr;
+    m_keepS0.Clear();
     m_controlPduBuffer = nullptr;
 
     NrRlc::DoDispose();
@@ -379,8 +380,7 @@ NrRlcAm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
                     }
 
                     NS_LOG_INFO("Move SN = " << seqNumberValue << " back to txedBuffer");
-                    m_txedBuffer.at(seqNumberValue).m_pdu =
-                        m_retxBuffer.at(seqNumberValue).m_pdu->Copy();
+                    m_txedBuffer.at(seqNumberValue).m_pdu = m_retxBuffer.at(seqNumberValue).m_pdu;
                     m_txedBuffer.at(seqNumberValue).m_retxCount =
                         m_retxBuffer.at(seqNumberValue).m_retxCount;
                     m_txedBuffer.at(seqNumberValue).m_waitingSince =
@@ -463,15 +463,15 @@ NrRlcAm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
     }
 
     NS_LOG_LOGIC("SDUs in TxonBuffer  = " << m_txonBuffer.size());
-    NS_LOG_LOGIC("First SDU buffer  = " << m_txonBuffer.begin()->m_pdu);
-    NS_LOG_LOGIC("First SDU size    = " << m_txonBuffer.begin()->m_pdu->GetSize());
+    NS_LOG_LOGIC("First SDU buffer  = " << m_txonBuffer.front().m_pdu);
+    NS_LOG_LOGIC("First SDU size    = " << m_txonBuffer.front().m_pdu->GetSize());
     NS_LOG_LOGIC("Next segment size = " << nextSegmentSize);
     NS_LOG_LOGIC("Remove SDU from TxBuffer");
-    Time firstSegmentTime = m_txonBuffer.begin()->m_waitingSince;
-    Ptr<Packet> firstSegment = m_txonBuffer.begin()->m_pdu->Copy();
-    m_txonBufferSize -= m_txonBuffer.begin()->m_pdu->GetSize();
+    Time firstSegmentTime = m_txonBuffer.front().m_waitingSince;
+    Ptr<Packet> firstSegment = m_txonBuffer.front().m_pdu;
+    m_txonBufferSize -= m_txonBuffer.front().m_pdu->GetSize();
     NS_LOG_LOGIC("txBufferSize      = " << m_txonBufferSize);
-    m_txonBuffer.erase(m_txonBuffer.begin());
+    m_txonBuffer.pop_front();
 
     while (firstSegment && (firstSegment->GetSize() > 0) && (nextSegmentSize > 0))
     {
@@ -520,12 +520,12 @@ NrRlcAm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
             {
                 firstSegment->AddPacketTag(oldTag);
 
-                m_txonBuffer.insert(m_txonBuffer.begin(), TxPdu(firstSegment, firstSegmentTime));
-                m_txonBufferSize += m_txonBuffer.begin()->m_pdu->GetSize();
+                m_txonBuffer.emplace_front(firstSegment, firstSegmentTime);
+                m_txonBufferSize += m_txonBuffer.front().m_pdu->GetSize();
 
                 NS_LOG_LOGIC("    Txon buffer: Give back the remaining segment");
                 NS_LOG_LOGIC("    Txon buffers = " << m_txonBuffer.size());
-                NS_LOG_LOGIC("    Front buffer size = " << m_txonBuffer.begin()->m_pdu->GetSize());
+                NS_LOG_LOGIC("    Front buffer size = " << m_txonBuffer.front().m_pdu->GetSize());
                 NS_LOG_LOGIC("    txonBufferSize = " << m_txonBufferSize);
             }
             else
@@ -586,9 +586,9 @@ NrRlcAm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
             NS_LOG_LOGIC("        SDUs in TxBuffer  = " << m_txonBuffer.size());
             if (!m_txonBuffer.empty())
             {
-                NS_LOG_LOGIC("        First SDU buffer  = " << m_txonBuffer.begin()->m_pdu);
+                NS_LOG_LOGIC("        First SDU buffer  = " << m_txonBuffer.front().m_pdu);
                 NS_LOG_LOGIC(
-                    "        First SDU size    = " << m_txonBuffer.begin()->m_pdu->GetSize());
+                    "        First SDU size    = " << m_txonBuffer.front().m_pdu->GetSize());
             }
             NS_LOG_LOGIC("        Next segment size = " << nextSegmentSize);
 
@@ -616,18 +616,18 @@ NrRlcAm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
             NS_LOG_LOGIC("        SDUs in TxBuffer  = " << m_txonBuffer.size());
             if (!m_txonBuffer.empty())
             {
-                NS_LOG_LOGIC("        First SDU buffer  = " << m_txonBuffer.begin()->m_pdu);
+                NS_LOG_LOGIC("        First SDU buffer  = " << m_txonBuffer.front().m_pdu);
                 NS_LOG_LOGIC(
-                    "        First SDU size    = " << m_txonBuffer.begin()->m_pdu->GetSize());
+                    "        First SDU size    = " << m_txonBuffer.front().m_pdu->GetSize());
             }
             NS_LOG_LOGIC("        Next segment size = " << nextSegmentSize);
             NS_LOG_LOGIC("        Remove SDU from TxBuffer");
 
             // (more segments)
-            firstSegment = m_txonBuffer.begin()->m_pdu->Copy();
-            firstSegmentTime = m_txonBuffer.begin()->m_waitingSince;
-            m_txonBufferSize -= m_txonBuffer.begin()->m_pdu->GetSize();
-            m_txonBuffer.erase(m_txonBuffer.begin());
+            firstSegment = m_txonBuffer.front().m_pdu;
+            firstSegmentTime = m_txonBuffer.front().m_waitingSince;
+            m_txonBufferSize -= m_txonBuffer.front().m_pdu->GetSize();
+            m_txonBuffer.pop_front();
             NS_LOG_LOGIC("        txBufferSize = " << m_txonBufferSize);
         }
     }
@@ -669,16 +669,9 @@ NrRlcAm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
 
         NS_ASSERT_MSG((*it)->PeekPacketTag(tag), "NrRlcSduStatusTag is missing");
         (*it)->RemovePacketTag(tag);
-        if (packet->GetSize() > 0)
-        {
-            packet->AddAtEnd(*it);
-        }
-        else
-        {
-            packet = (*it);
-        }
         it++;
     }
+    packet = NrRlcSegmentChain::Concatenate(dataField);
 
     // LAST SEGMENT (Note: There could be only one and be the first one)
     it--;
@@ -1077,8 +1070,7 @@ NrRlcAm::DoReceivePdu(NrMacSapUser::ReceivePduParameters rxPduParams)
                 if (m_txedBuffer.at(seqNumberValue).m_pdu)
                 {
                     NS_LOG_INFO("Move SN = " << seqNumberValue << " to retxBuffer");
-                    m_retxBuffer.at(seqNumberValue).m_pdu =
-                        m_txedBuffer.at(seqNumberValue).m_pdu->Copy();
+                    m_retxBuffer.at(seqNumberValue).m_pdu = m_txedBuffer.at(seqNumberValue).m_pdu;
                     m_retxBuffer.at(seqNumberValue).m_retxCount =
                         m_txedBuffer.at(seqNumberValue).m_retxCount;
                     m_retxBuffer.at(seqNumberValue).m_waitingSince =
@@ -1282,7 +1274,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Keep S0
                  */
-                m_keepS0 = m_sdusBuffer.front();
+                m_keepS0.Start(m_sdusBuffer.front());
                 m_sdusBuffer.pop_front();
                 break;
 
@@ -1307,9 +1299,9 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Deliver (Kept)S0 + SN
                  */
-                m_keepS0->AddAtEnd(m_sdusBuffer.front());
+                m_keepS0.Append(m_sdusBuffer.front());
                 m_sdusBuffer.pop_front();
-                m_rlcSapUser->ReceivePdcpPdu(m_keepS0);
+                m_rlcSapUser->ReceivePdcpPdu(m_keepS0.Assemble());
 
                 /**
                  * Deliver zero, one or multiple PDUs
@@ -1329,7 +1321,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                  */
                 if (m_sdusBuffer.size() == 1)
                 {
-                    m_keepS0->AddAtEnd(m_sdusBuffer.front());
+                    m_keepS0.Append(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
                 }
                 else // m_sdusBuffer.size () > 1
@@ -1337,9 +1329,9 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                     /**
                      * Deliver (Kept)S0 + SN
                      */
-                    m_keepS0->AddAtEnd(m_sdusBuffer.front());
+                    m_keepS0.Append(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
-                    m_rlcSapUser->ReceivePdcpPdu(m_keepS0);
+                    m_rlcSapUser->ReceivePdcpPdu(m_keepS0.Assemble());
 
                     /**
                      * Deliver zero, one or multiple PDUs
@@ -1353,7 +1345,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                     /**
                      * Keep S0
                      */
-                    m_keepS0 = m_sdusBuffer.front();
+                    m_keepS0.Start(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
                 }
                 break;
@@ -1412,7 +1404,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Keep S0
                  */
-                m_keepS0 = m_sdusBuffer.front();
+                m_keepS0.Start(m_sdusBuffer.front());
                 m_sdusBuffer.pop_front();
                 break;
 
@@ -1463,7 +1455,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                     /**
                      * Keep S0
                      */
-                    m_keepS0 = m_sdusBuffer.front();
+                    m_keepS0.Start(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
                 }
                 break;
@@ -1487,7 +1479,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Discard S0
                  */
-                m_keepS0 = nullptr;
+                m_keepS0.Clear();
 
                 /**
                  * Deliver one or multiple PDUs
@@ -1505,7 +1497,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Discard S0
                  */
-                m_keepS0 = nullptr;
+                m_keepS0.Clear();
 
                 /**
                  * Deliver zero, one or multiple PDUs
@@ -1519,7 +1511,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Keep S0
                  */
-                m_keepS0 = m_sdusBuffer.front();
+                m_keepS0.Start(m_sdusBuffer.front());
                 m_sdusBuffer.pop_front();
 
                 break;
@@ -1530,7 +1522,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Discard S0
                  */
-                m_keepS0 = nullptr;
+                m_keepS0.Clear();
 
                 /**
                  * Discard SI or SN
@@ -1560,7 +1552,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Discard S0
                  */
-                m_keepS0 = nullptr;
+                m_keepS0.Clear();
 
                 /**
                  * Discard SI or SN
@@ -1581,7 +1573,7 @@ NrRlcAm::ReassembleAndDeliver(Ptr<Packet> packet)
                     /**
                      * Keep S0
                      */
-                    m_keepS0 = m_sdusBuffer.front();
+                    m_keepS0.Start(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
                 }
                 break;
@@ -1744,7 +1736,7 @@ NrRlcAm::ExpirePollRetransmitTimer()
             {
                 uint16_t snValue = sn.GetValue();
                 NS_LOG_INFO("Move PDU " << sn << " from txedBuffer to retxBuffer");
-                m_retxBuffer.at(snValue).m_pdu = m_txedBuffer.at(snValue).m_pdu->Copy();
+                m_retxBuffer.at(snValue).m_pdu = m_txedBuffer.at(snValue).m_pdu;
                 m_retxBuffer.at(snValue).m_retxCount = m_txedBuffer.at(snValue).m_retxCount;
                 m_retxBuffer.at(snValue).m_waitingSince = m_txedBuffer.at(snValue).m_waitingSince;
                 m_retxBufferSize += m_retxBuffer.at(snValue).m_pdu->GetSize();
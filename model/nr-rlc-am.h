@@ -7,6 +7,8 @@
 #ifndef NR_RLC_AM_H
 #define NR_RLC_AM_H
 
+#include "nr-rlc-ring-buffer.h"
+#include "nr-rlc-segment-chain.h"
 #include "nr-rlc-sequence-number.h"
 #include "nr-rlc.h"
 
@@ -117,7 +119,7 @@ class NrRlcAm : public NrRlc
         Time m_waitingSince; ///< Layer arrival time
     };
 
-    std::vector<TxPdu> m_txonBuffer; ///< Transmission buffer
+    NrRlcRingBuffer<TxPdu> m_txonBuffer; ///< Transmission buffer
 
     /// RetxPdu structure
     struct RetxPdu
@@ -127,10 +129,11 @@ class NrRlcAm : public NrRlc
         Time m_waitingSince;  ///< Layer arrival time
     };
 
-    std::vector<RetxPdu> m_txedBuffer; ///< Buffer for transmitted and retransmitted PDUs
-                                       ///< that have not been acked but are not considered
-                                       ///< for retransmission
-    std::vector<RetxPdu> m_retxBuffer; ///< Buffer for PDUs considered for retransmission
+    NrRlcRingBuffer<RetxPdu> m_txedBuffer; ///< Buffer for transmitted and retransmitted PDUs
+                                           ///< that have not been acked but are not considered
+                                           ///< for retransmission, indexed by sequence number
+    NrRlcRingBuffer<RetxPdu> m_retxBuffer; ///< Buffer for PDUs considered for retransmission,
+                                           ///< indexed by sequence number
 
     uint32_t m_maxTxBufferSize; ///< maximum transmission buffer size
     uint32_t m_txonBufferSize;  ///< transmit on buffer size
@@ -218,7 +221,7 @@ class NrRlcAm : public NrRlc
     };
 
     ReassemblingState_t m_reassemblingState; ///< reassembling state
-    Ptr<Packet> m_keepS0;                    ///< keep S0
+    NrRlcSegmentChain m_keepS0;              ///< keep S0 and the following segments
 
     /**
      * Expected Sequence Number
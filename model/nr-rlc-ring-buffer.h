@@ -0,0 +1,480 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_RLC_RING_BUFFER_H
+#define NR_RLC_RING_BUFFER_H
+
+#include "ns3/assert.h"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace ns3
+{
+
+/**
+ * @ingroup nr
+ * @brief Double-ended queue of the RLC entities, stored in a ring buffer
+ *
+ * The elements live in a single contiguous allocation whose capacity is a power of two,
+ * and the logical position i maps to the slot (head + i) mod capacity. Pushing and popping
+ * at both ends is O(1) amortized, and never moves the other elements, unlike the erase()
+ * and insert() at the beginning of a std::vector. The storage grows by doubling and is
+ * only released by the destructor, so a queue that reached its working depth does not
+ * allocate anymore.
+ *
+ * Indexing with operator[] or at() is O(1). When the queue is sized with resize(), the
+ * indexes are stable, which is how the retransmission buffers of NrRlcAm address
+ * their PDUs by sequence number.
+ *
+ * @tparam T the element type. It does not need to be default constructible, except for
+ * resize().
+ */
+template <typename T>
+class NrRlcRingBuffer
+{
+  public:
+    /**
+     * @brief Forward iterator over the elements, from the front to the back
+     * @tparam Q the ring buffer type, const or not
+     * @tparam V the element type, const or not
+     */
+    template <typename Q, typename V>
+    class Iterator
+    {
+      public:
+        using iterator_category = std::forward_iterator_tag; //!< Iterator category
+        using value_type = T;                                //!< Value type
+        using difference_type = std::ptrdiff_t;              //!< Difference type
+        using pointer = V*;                                  //!< Pointer type
+        using reference = V&;                                //!< Reference type
+
+        /**
+         * @brief Constructor
+         * @param queue the ring buffer
+         * @param pos the logical position
+         */
+        Iterator(Q* queue, std::size_t pos)
+            : m_queue(queue),
+              m_pos(pos)
+        {
+        }
+
+        /// @return the element
+        reference operator*() const
+        {
+            return (*m_queue)[m_pos];
+        }
+
+        /// @return a pointer to the element
+        pointer operator->() const
+        {
+            return &(*m_queue)[m_pos];
+        }
+
+        /// @return the iterator, advanced to the next element
+        Iterator& operator++()
+        {
+            ++m_pos;
+            return *this;
+        }
+
+        /// @return a copy of the iterator, before advancing it to the next element
+        Iterator operator++(int)
+        {
+            Iterator copy = *this;
+            ++m_pos;
+            return copy;
+        }
+
+        /**
+         * @param other the other iterator
+         * @return true if both iterators point to the same position
+         */
+        bool operator==(const Iterator& other) const
+        {
+            return m_queue == other.m_queue && m_pos == other.m_pos;
+        }
+
+        /**
+         * @param other the other iterator
+         * @return true if the iterators point to different positions
+         */
+        bool operator!=(const Iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+      private:
+        Q* m_queue;        //!< Ring buffer
+        std::size_t m_pos; //!< Logical position
+    };
+
+    using iterator = Iterator<NrRlcRingBuffer, T>;                   //!< Iterator
+    using const_iterator = Iterator<const NrRlcRingBuffer, const T>; //!< Const iterator
+
+    NrRlcRingBuffer() = default;
+
+    /**
+     * @brief Copy constructor
+     * @param other the ring buffer to copy
+     */
+    NrRlcRingBuffer(const NrRlcRingBuffer& other)
+    {
+        reserve(other.m_size);
+        for (std::size_t i = 0; i < other.m_size; ++i)
+        {
+            emplace_back(other[i]);
+        }
+    }
+
+    /**
+     * @brief Move constructor
+     * @param other the ring buffer to move from, left empty
+     */
+    NrRlcRingBuffer(NrRlcRingBuffer&& other) noexcept
+    {
+        Swap(other);
+    }
+
+    /**
+     * @brief Assignment operator
+     * @param other the ring buffer to copy or move from
+     * @return this ring buffer
+     */
+    NrRlcRingBuffer& operator=(NrRlcRingBuffer other) noexcept
+    {
+        Swap(other);
+        return *this;
+    }
+
+    ~NrRlcRingBuffer()
+    {
+        clear();
+        std::allocator<T>().deallocate(m_data, m_capacity);
+    }
+
+    /// @return true if there are no elements
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /// @return the number of elements
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    /// @return the number of elements that fit in the storage without growing it
+    std::size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    /**
+     * @param i the logical position, 0 being the front
+     * @return the element at position i
+     */
+    T& operator[](std::size_t i)
+    {
+        return *Slot(i);
+    }
+
+    /**
+     * @param i the logical position, 0 being the front
+     * @return the element at position i
+     */
+    const T& operator[](std::size_t i) const
+    {
+        return *Slot(i);
+    }
+
+    /**
+     * @param i the logical position, 0 being the front
+     * @return the element at position i, asserting that it exists
+     */
+    T& at(std::size_t i)
+    {
+        NS_ASSERT_MSG(i < m_size, "Position " << i << " out of a queue of size " << m_size);
+        return *Slot(i);
+    }
+
+    /**
+     * @param i the logical position, 0 being the front
+     * @return the element at position i, asserting that it exists
+     */
+    const T& at(std::size_t i) const
+    {
+        NS_ASSERT_MSG(i < m_size, "Position " << i << " out of a queue of size " << m_size);
+        return *Slot(i);
+    }
+
+    /// @return the first element
+    T& front()
+    {
+        NS_ASSERT(m_size > 0);
+        return *Slot(0);
+    }
+
+    /// @return the first element
+    const T& front() const
+    {
+        NS_ASSERT(m_size > 0);
+        return *Slot(0);
+    }
+
+    /// @return the last element
+    T& back()
+    {
+        NS_ASSERT(m_size > 0);
+        return *Slot(m_size - 1);
+    }
+
+    /// @return the last element
+    const T& back() const
+    {
+        NS_ASSERT(m_size > 0);
+        return *Slot(m_size - 1);
+    }
+
+    /// @return an iterator to the first element
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    /// @return an iterator past the last element
+    iterator end()
+    {
+        return iterator(this, m_size);
+    }
+
+    /// @return an iterator to the first element
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /// @return an iterator past the last element
+    const_iterator end() const
+    {
+        return const_iterator(this, m_size);
+    }
+
+    /**
+     * @brief Construct an element after the last one
+     * @param args the arguments of the constructor of T
+     * @return the new element
+     */
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (m_size == m_capacity)
+        {
+            // Build the new element before moving the old ones, as args may refer to them
+            Grow(false, std::forward<Args>(args)...);
+        }
+        else
+        {
+            ::new (static_cast<void*>(Slot(m_size))) T(std::forward<Args>(args)...);
+        }
+        ++m_size;
+        return back();
+    }
+
+    /**
+     * @brief Construct an element before the first one
+     * @param args the arguments of the constructor of T
+     * @return the new element
+     */
+    template <typename... Args>
+    T& emplace_front(Args&&... args)
+    {
+        if (m_size == m_capacity)
+        {
+            Grow(true, std::forward<Args>(args)...);
+        }
+        else
+        {
+            std::size_t head = (m_head + m_capacity - 1) & (m_capacity - 1);
+            ::new (static_cast<void*>(m_data + head)) T(std::forward<Args>(args)...);
+            m_head = head;
+        }
+        ++m_size;
+        return front();
+    }
+
+    /**
+     * @brief Copy or move an element after the last one
+     * @param value the element
+     */
+    void push_back(T value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    /**
+     * @brief Copy or move an element before the first one
+     * @param value the element
+     */
+    void push_front(T value)
+    {
+        emplace_front(std::move(value));
+    }
+
+    /// @brief Destroy the first element
+    void pop_front()
+    {
+        NS_ASSERT(m_size > 0);
+        Slot(0)->~T();
+        m_head = (m_head + 1) & (m_capacity - 1);
+        --m_size;
+    }
+
+    /// @brief Destroy the last element
+    void pop_back()
+    {
+        NS_ASSERT(m_size > 0);
+        Slot(m_size - 1)->~T();
+        --m_size;
+    }
+
+    /// @brief Destroy all the elements, keeping the storage
+    void clear()
+    {
+        while (m_size > 0)
+        {
+            pop_back();
+        }
+        m_head = 0;
+    }
+
+    /**
+     * @brief Make room for a number of elements, without adding them
+     * @param n the number of elements
+     */
+    void reserve(std::size_t n)
+    {
+        if (n > m_capacity)
+        {
+            Reallocate(RoundUpCapacity(n));
+        }
+    }
+
+    /**
+     * @brief Change the number of elements, destroying the last ones or appending
+     * value-initialized ones
+     * @param n the new number of elements
+     */
+    void resize(std::size_t n)
+    {
+        while (m_size > n)
+        {
+            pop_back();
+        }
+        reserve(n);
+        while (m_size < n)
+        {
+            emplace_back();
+        }
+    }
+
+  private:
+    /**
+     * @param i the logical position
+     * @return the storage of the element at position i
+     */
+    T* Slot(std::size_t i) const
+    {
+        return m_data + ((m_head + i) & (m_capacity - 1));
+    }
+
+    /**
+     * @param n the minimum capacity
+     * @return the smallest power of two that is not lower than n, and than 8
+     */
+    static std::size_t RoundUpCapacity(std::size_t n)
+    {
+        std::size_t capacity = 8;
+        while (capacity < n)
+        {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    /**
+     * @brief Double the storage, constructing a new element in it before moving the old
+     * elements to [0, m_size). The size is not updated.
+     * @param atFront true to place the new element in the last slot, which becomes the
+     * head, false to place it after the old elements
+     * @param args the arguments of the constructor of the new element
+     */
+    template <typename... Args>
+    void Grow(bool atFront, Args&&... args)
+    {
+        std::size_t capacity = RoundUpCapacity(m_capacity * 2);
+        T* data = std::allocator<T>().allocate(capacity);
+        std::size_t pos = atFront ? capacity - 1 : m_size;
+        ::new (static_cast<void*>(data + pos)) T(std::forward<Args>(args)...);
+        MoveTo(data, capacity);
+        if (atFront)
+        {
+            m_head = pos;
+        }
+    }
+
+    /**
+     * @brief Move the elements to a new storage
+     * @param capacity the capacity of the new storage, a power of two
+     */
+    void Reallocate(std::size_t capacity)
+    {
+        MoveTo(std::allocator<T>().allocate(capacity), capacity);
+    }
+
+    /**
+     * @brief Move the elements to [0, m_size) of a new storage, and release the old one
+     * @param data the new storage
+     * @param capacity the capacity of the new storage
+     */
+    void MoveTo(T* data, std::size_t capacity)
+    {
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            T* old = Slot(i);
+            ::new (static_cast<void*>(data + i)) T(std::move(*old));
+            old->~T();
+        }
+        std::allocator<T>().deallocate(m_data, m_capacity);
+        m_data = data;
+        m_capacity = capacity;
+        m_head = 0;
+    }
+
+    /**
+     * @brief Exchange the contents with another ring buffer
+     * @param other the other ring buffer
+     */
+    void Swap(NrRlcRingBuffer& other) noexcept
+    {
+        std::swap(m_data, other.m_data);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_head, other.m_head);
+        std::swap(m_size, other.m_size);
+    }
+
+    T* m_data{nullptr};        //!< Storage of m_capacity elements
+    std::size_t m_capacity{0}; //!< Capacity, zero or a power of two
+    std::size_t m_head{0};     //!< Slot of the first element
+    std::size_t m_size{0};     //!< Number of elements
+};
+
+} // namespace ns3
+
+#endif // NR_RLC_RING_BUFFER_H
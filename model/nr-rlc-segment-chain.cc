@@ -0,0 +1,74 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-rlc-segment-chain.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrRlcSegmentChain");
+
+void
+NrRlcSegmentChain::Start(Ptr<Packet> segment)
+{
+    m_segments.clear();
+    m_segments.push_back(segment);
+}
+
+void
+NrRlcSegmentChain::Append(Ptr<Packet> segment)
+{
+    NS_ASSERT_MSG(!m_segments.empty(), "Appending a segment to a chain that was not started");
+    m_segments.push_back(segment);
+}
+
+void
+NrRlcSegmentChain::Clear()
+{
+    m_segments.clear();
+}
+
+bool
+NrRlcSegmentChain::IsEmpty() const
+{
+    return m_segments.empty();
+}
+
+Ptr<Packet>
+NrRlcSegmentChain::Assemble()
+{
+    if (m_segments.empty())
+    {
+        return nullptr;
+    }
+    if (m_segments.size() > 1)
+    {
+        Ptr<Packet> packet = Concatenate(m_segments);
+        m_segments.assign(1, packet);
+    }
+    return m_segments.front();
+}
+
+Ptr<Packet>
+NrRlcSegmentChain::Concatenate(const std::vector<Ptr<Packet>>& packets)
+{
+    NS_ASSERT(!packets.empty());
+    NS_LOG_FUNCTION(packets.size());
+
+    // At each level, the packet at index i gets the one at i + stride appended,
+    // where i is a multiple of 2 * stride
+    for (size_t stride = 1; stride < packets.size(); stride *= 2)
+    {
+        for (size_t i = 0; i + stride < packets.size(); i += 2 * stride)
+        {
+            packets[i]->AddAtEnd(packets[i + stride]);
+        }
+    }
+    return packets.front();
+}
+
+} // namespace ns3
@@ -0,0 +1,79 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_RLC_SEGMENT_CHAIN_H
+#define NR_RLC_SEGMENT_CHAIN_H
+
+#include "ns3/packet.h"
+#include "ns3/ptr.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup nr
+ * @brief Chain of RLC segments that are joined in a single packet only when needed
+ *
+ * The segments created by the RLC entities with Packet::CreateFragment() and
+ * Packet::RemoveAtStart() are views of the buffer of the original SDU or PDU, which
+ * share its bytes until one of them is written. Appending a packet to another with
+ * Packet::AddAtEnd() copies both into a new buffer of the exact size, so building a
+ * packet by appending N segments one at a time copies the first one N - 1 times.
+ *
+ * The chain keeps the segments as they are, and Assemble() joins them by pairs of
+ * neighbours, so that each byte is copied once per level of a balanced tree, i.e.,
+ * log2(N) times. A chain of a single segment is returned without any copy.
+ */
+class NrRlcSegmentChain
+{
+  public:
+    /**
+     * @brief Drop the segments of the chain, and start a new one
+     * @param segment the first segment
+     */
+    void Start(Ptr<Packet> segment);
+
+    /**
+     * @brief Add a segment at the end of the chain
+     * @param segment the segment
+     */
+    void Append(Ptr<Packet> segment);
+
+    /**
+     * @brief Drop all the segments of the chain
+     */
+    void Clear();
+
+    /**
+     * @return true if the chain has no segments
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Join the segments of the chain into one packet, which remains as the only
+     * segment of the chain
+     * @return the packet, or nullptr if the chain is empty
+     */
+    Ptr<Packet> Assemble();
+
+    /**
+     * @brief Join a list of packets in order, by pairs of neighbours
+     *
+     * The first packet of each pair gets the second one appended, so the packets of the
+     * list are modified, and the returned packet is the first one of the list.
+     *
+     * @param packets the packets, which must not be empty
+     * @return the first packet, with all the others appended
+     */
+    static Ptr<Packet> Concatenate(const std::vector<Ptr<Packet>>& packets);
+
+  private:
+    std::vector<Ptr<Packet>> m_segments; //!< Segments of the chain, in order
+};
+
+} // namespace ns3
+
+#endif // NR_RLC_SEGMENT_CHAIN_H
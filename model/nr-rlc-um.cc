@@ -7,6 +7,7 @@
 #include "nr-rlc-um.h"
 
 #include "nr-rlc-header.h"
+#include "nr-rlc-segment-chain.h"
 #include "nr-rlc-sdu-status-tag.h"
 #include "nr-rlc-tag.h"
 
@@ -110,7 +111,7 @@ NrRlcUm::DoTransmitPdcpPdu(Ptr<Packet> p)
             if (!m_txBuffer.empty())
             {
                 headOfLineDelayInMs =
-                    (Simulator::Now() - m_txBuffer.begin()->m_waitingSince).GetMilliSeconds();
+                    (Simulator::Now() - m_txBuffer.front().m_waitingSince).GetMilliSeconds();
             }
             NS_LOG_DEBUG("head of line delay in MS:" << headOfLineDelayInMs);
             if (headOfLineDelayInMs > discardTimerMs)
@@ -185,8 +186,8 @@ NrRlcUm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
         return;
     }
 
-    Ptr<Packet> firstSegment = m_txBuffer.begin()->m_pdu->Copy();
-    Time firstSegmentTime = m_txBuffer.begin()->m_waitingSince;
+    Ptr<Packet> firstSegment = m_txBuffer.front().m_pdu;
+    Time firstSegmentTime = m_txBuffer.front().m_waitingSince;
 
     NS_LOG_LOGIC("SDUs in TxBuffer  = " << m_txBuffer.size());
     NS_LOG_LOGIC("First SDU buffer  = " << firstSegment);
@@ -195,7 +196,7 @@ NrRlcUm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
     NS_LOG_LOGIC("Remove SDU from TxBuffer");
     m_txBufferSize -= firstSegment->GetSize();
     NS_LOG_LOGIC("txBufferSize      = " << m_txBufferSize);
-    m_txBuffer.erase(m_txBuffer.begin());
+    m_txBuffer.pop_front();
 
     while (firstSegment && (firstSegment->GetSize() > 0) && (nextSegmentSize > 0))
     {
@@ -244,12 +245,12 @@ NrRlcUm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
             {
                 firstSegment->AddPacketTag(oldTag);
 
-                m_txBuffer.insert(m_txBuffer.begin(), TxPdu(firstSegment, firstSegmentTime));
-                m_txBufferSize += m_txBuffer.begin()->m_pdu->GetSize();
+                m_txBuffer.emplace_front(firstSegment, firstSegmentTime);
+                m_txBufferSize += m_txBuffer.front().m_pdu->GetSize();
 
                 NS_LOG_LOGIC("    TX buffer: Give back the remaining segment");
                 NS_LOG_LOGIC("    TX buffers = " << m_txBuffer.size());
-                NS_LOG_LOGIC("    Front buffer size = " << m_txBuffer.begin()->m_pdu->GetSize());
+                NS_LOG_LOGIC("    Front buffer size = " << m_txBuffer.front().m_pdu->GetSize());
                 NS_LOG_LOGIC("    txBufferSize = " << m_txBufferSize);
             }
             else
@@ -309,9 +310,9 @@ NrRlcUm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
             NS_LOG_LOGIC("        SDUs in TxBuffer  = " << m_txBuffer.size());
             if (!m_txBuffer.empty())
             {
-                NS_LOG_LOGIC("        First SDU buffer  = " << m_txBuffer.begin()->m_pdu);
+                NS_LOG_LOGIC("        First SDU buffer  = " << m_txBuffer.front().m_pdu);
                 NS_LOG_LOGIC(
-                    "        First SDU size    = " << m_txBuffer.begin()->m_pdu->GetSize());
+                    "        First SDU size    = " << m_txBuffer.front().m_pdu->GetSize());
             }
             NS_LOG_LOGIC("        Next segment size = " << nextSegmentSize);
 
@@ -339,16 +340,16 @@ NrRlcUm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
             NS_LOG_LOGIC("        SDUs in TxBuffer  = " << m_txBuffer.size());
             if (!m_txBuffer.empty())
             {
-                NS_LOG_LOGIC("        First SDU buffer  = " << m_txBuffer.begin()->m_pdu);
+                NS_LOG_LOGIC("        First SDU buffer  = " << m_txBuffer.front().m_pdu);
                 NS_LOG_LOGIC(
-                    "        First SDU size    = " << m_txBuffer.begin()->m_pdu->GetSize());
+                    "        First SDU size    = " << m_txBuffer.front().m_pdu->GetSize());
             }
             NS_LOG_LOGIC("        Next segment size = " << nextSegmentSize);
             NS_LOG_LOGIC("        Remove SDU from TxBuffer");
 
             // (more segments)
-            firstSegment = m_txBuffer.begin()->m_pdu->Copy();
-            firstSegmentTime = m_txBuffer.begin()->m_waitingSince;
+            firstSegment = m_txBuffer.front().m_pdu;
+            firstSegmentTime = m_txBuffer.front().m_waitingSince;
             m_txBufferSize -= firstSegment->GetSize();
             m_txBuffer.pop_front();
             NS_LOG_LOGIC("        txBufferSize = " << m_txBufferSize);
@@ -383,16 +384,9 @@ NrRlcUm::DoNotifyTxOpportunity(NrMacSapUser::TxOpportunityParameters txOpParams)
 
         NS_ASSERT_MSG((*it)->PeekPacketTag(tag), "NrRlcSduStatusTag is missing");
         (*it)->RemovePacketTag(tag);
-        if (packet->GetSize() > 0)
-        {
-            packet->AddAtEnd(*it);
-        }
-        else
-        {
-            packet = (*it);
-        }
         it++;
     }
+    packet = NrRlcSegmentChain::Concatenate(dataField);
 
     // LAST SEGMENT (Note: There could be only one and be the first one)
     it--;
@@ -750,7 +744,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Keep S0
                  */
-                m_keepS0 = m_sdusBuffer.front();
+                m_keepS0.Start(m_sdusBuffer.front());
                 m_sdusBuffer.pop_front();
                 break;
 
@@ -801,7 +795,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                     /**
                      * Keep S0
                      */
-                    m_keepS0 = m_sdusBuffer.front();
+                    m_keepS0.Start(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
                 }
                 break;
@@ -825,9 +819,9 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Deliver (Kept)S0 + SN
                  */
-                m_keepS0->AddAtEnd(m_sdusBuffer.front());
+                m_keepS0.Append(m_sdusBuffer.front());
                 m_sdusBuffer.pop_front();
-                m_rlcSapUser->ReceivePdcpPdu(m_keepS0);
+                m_rlcSapUser->ReceivePdcpPdu(m_keepS0.Assemble());
 
                 /**
                  * Deliver zero, one or multiple PDUs
@@ -847,7 +841,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                  */
                 if (m_sdusBuffer.size() == 1)
                 {
-                    m_keepS0->AddAtEnd(m_sdusBuffer.front());
+                    m_keepS0.Append(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
                 }
                 else // m_sdusBuffer.size () > 1
@@ -855,9 +849,9 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                     /**
                      * Deliver (Kept)S0 + SN
                      */
-                    m_keepS0->AddAtEnd(m_sdusBuffer.front());
+                    m_keepS0.Append(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
-                    m_rlcSapUser->ReceivePdcpPdu(m_keepS0);
+                    m_rlcSapUser->ReceivePdcpPdu(m_keepS0.Assemble());
 
                     /**
                      * Deliver zero, one or multiple PDUs
@@ -871,7 +865,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                     /**
                      * Keep S0
                      */
-                    m_keepS0 = m_sdusBuffer.front();
+                    m_keepS0.Start(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
                 }
                 break;
@@ -930,7 +924,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Keep S0
                  */
-                m_keepS0 = m_sdusBuffer.front();
+                m_keepS0.Start(m_sdusBuffer.front());
                 m_sdusBuffer.pop_front();
                 break;
 
@@ -981,7 +975,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                     /**
                      * Keep S0
                      */
-                    m_keepS0 = m_sdusBuffer.front();
+                    m_keepS0.Start(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
                 }
                 break;
@@ -1005,7 +999,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Discard S0
                  */
-                m_keepS0 = nullptr;
+                m_keepS0.Clear();
 
                 /**
                  * Deliver one or multiple PDUs
@@ -1023,7 +1017,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Discard S0
                  */
-                m_keepS0 = nullptr;
+                m_keepS0.Clear();
 
                 /**
                  * Deliver zero, one or multiple PDUs
@@ -1037,7 +1031,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Keep S0
                  */
-                m_keepS0 = m_sdusBuffer.front();
+                m_keepS0.Start(m_sdusBuffer.front());
                 m_sdusBuffer.pop_front();
 
                 break;
@@ -1048,7 +1042,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Discard S0
                  */
-                m_keepS0 = nullptr;
+                m_keepS0.Clear();
 
                 /**
                  * Discard SI or SN
@@ -1078,7 +1072,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                 /**
                  * Discard S0
                  */
-                m_keepS0 = nullptr;
+                m_keepS0.Clear();
 
                 /**
                  * Discard SI or SN
@@ -1099,7 +1093,7 @@ NrRlcUm::ReassembleAndDeliver(Ptr<Packet> packet)
                     /**
                      * Keep S0
                      */
-                    m_keepS0 = m_sdusBuffer.front();
+                    m_keepS0.Start(m_sdusBuffer.front());
                     m_sdusBuffer.pop_front();
                 }
                 break;
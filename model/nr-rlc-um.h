@@ -7,13 +7,15 @@
 #ifndef NR_RLC_UM_H
 #define NR_RLC_UM_H
 
+#include "nr-rlc-ring-buffer.h"
+#include "nr-rlc-segment-chain.h"
 #include "nr-rlc-sequence-number.h"
 #include "nr-rlc.h"
 
 #include "ns3/event-id.h"
 
-#include <deque>
 #include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -110,7 +112,7 @@ class NrRlcUm : public NrRlc
         Time m_waitingSince; ///< Layer arrival time
     };
 
-    std::deque<TxPdu> m_txBuffer;               ///< Transmission buffer
+    NrRlcRingBuffer<TxPdu> m_txBuffer;          ///< Transmission buffer
     std::map<uint16_t, Ptr<Packet>> m_rxBuffer; ///< Reception buffer
     std::vector<Ptr<Packet>> m_reasBuffer;      ///< Reassembling buffer
 
@@ -152,7 +154,7 @@ class NrRlcUm : public NrRlc
     };
 
     ReassemblingState_t m_reassemblingState; ///< reassembling state
-    Ptr<Packet> m_keepS0;                    ///< keep S0
+    NrRlcSegmentChain m_keepS0;              ///< keep S0 and the following segments
 
     /**
      * Expected Sequence Number
@@ -0,0 +1,125 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-thread-pool.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrThreadPool");
+
+thread_local bool NrThreadPool::t_inJob{false};
+
+NrThreadPool::~NrThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopWorkers = true;
+    }
+    m_batchStarted.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+NrThreadPool&
+NrThreadPool::Get()
+{
+    static NrThreadPool pool;
+    return pool;
+}
+
+void
+NrThreadPool::Run(uint32_t numThreads, size_t numJobs, const std::function<void(size_t)>& job)
+{
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    numThreads = static_cast<uint32_t>(std::min<size_t>(numThreads, numJobs));
+
+    if (numThreads <= 1 || t_inJob)
+    {
+        for (size_t i = 0; i < numJobs; ++i)
+        {
+            job(i);
+        }
+        return;
+    }
+    NS_LOG_LOGIC("Running " << numJobs << " jobs with " << numThreads << " threads");
+
+    while (m_workers.size() + 1 < numThreads)
+    {
+        m_workers.emplace_back(&NrThreadPool::WorkerLoop, this, m_batchId);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_numJobs = numJobs;
+        m_nextJob = 0;
+        m_freeSlots = numThreads - 1;
+        m_busyWorkers = numThreads - 1;
+        ++m_batchId;
+    }
+    m_batchStarted.notify_all();
+
+    RunPendingJobs();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_batchFinished.wait(lock, [this] { return m_busyWorkers == 0; });
+    m_job = nullptr;
+    m_numJobs = 0;
+}
+
+void
+NrThreadPool::RunPendingJobs()
+{
+    t_inJob = true;
+    for (size_t i = m_nextJob++; i < m_numJobs; i = m_nextJob++)
+    {
+        (*m_job)(i);
+    }
+    t_inJob = false;
+}
+
+void
+NrThreadPool::WorkerLoop(uint64_t batchId)
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_batchStarted.wait(lock, [this, batchId] {
+                return m_stopWorkers || m_batchId != batchId;
+            });
+            if (m_stopWorkers)
+            {
+                return;
+            }
+            batchId = m_batchId;
+            if (m_freeSlots == 0)
+            {
+                // The batch needs fewer threads than the pool has
+                continue;
+            }
+            --m_freeSlots;
+        }
+
+        RunPendingJobs();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyWorkers == 0)
+        {
+            m_batchFinished.notify_one();
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,97 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_THREAD_POOL_H
+#define NR_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @ingroup utils
+ * @brief Process-wide pool of threads that runs batches of independent jobs
+ *
+ * There is a single instance, returned by Get(), that NrParallelScheduling, NrCsiBatch
+ * and IdealBeamformingHelper share: each of them keeps its own `NumThreads` attribute,
+ * and passes it to Run() with every batch. The threads of the pool are created with the
+ * first batch that needs them, up to the largest number of threads ever requested minus
+ * the calling one, and wait for the next batch between batches; in a batch, only as many
+ * of them as requested take part.
+ *
+ * Run() must be called from the main thread. The jobs are taken in index order, but may
+ * run in any thread and in any order, so they must not depend on each other, nor touch
+ * the state of the simulator (events, logs, traces, reference counts of shared objects).
+ */
+class NrThreadPool
+{
+  public:
+    /**
+     * @brief ~NrThreadPool, which stops the threads of the pool
+     */
+    ~NrThreadPool();
+
+    NrThreadPool(const NrThreadPool&) = delete;
+    NrThreadPool& operator=(const NrThreadPool&) = delete;
+
+    /**
+     * @return the pool of the process
+     */
+    static NrThreadPool& Get();
+
+    /**
+     * @brief Execute a batch of jobs, and wait until all of them are done
+     *
+     * With a single thread, or a single job, the jobs run in the calling thread, in
+     * index order. So do the jobs of a batch started from a job of another batch.
+     *
+     * @param numThreads the number of threads, including the calling one, or 0 to use all
+     *        the available cores
+     * @param numJobs the number of jobs
+     * @param job the function that executes a job, given its index
+     */
+    void Run(uint32_t numThreads, size_t numJobs, const std::function<void(size_t)>& job);
+
+  private:
+    /**
+     * @brief NrThreadPool constructor, only used by Get()
+     */
+    NrThreadPool() = default;
+
+    /**
+     * @brief Execute the jobs of the current batch that were not taken by another thread
+     */
+    void RunPendingJobs();
+
+    /**
+     * @brief Loop of the threads of the pool
+     * @param batchId the last batch started before the thread
+     */
+    void WorkerLoop(uint64_t batchId);
+
+    std::vector<std::thread> m_workers;                //!< Threads besides the calling one
+    std::mutex m_mutex;                                //!< Protects the state of the pool
+    std::condition_variable m_batchStarted;            //!< Signals a new batch to the workers
+    std::condition_variable m_batchFinished;           //!< Signals the end of a batch
+    const std::function<void(size_t)>* m_job{nullptr}; //!< Job function of the batch
+    size_t m_numJobs{0};                               //!< Number of jobs of the batch
+    std::atomic<size_t> m_nextJob{0};                  //!< Index of the next job of the batch
+    uint64_t m_batchId{0};                             //!< Counter of the batches
+    uint32_t m_freeSlots{0};   //!< Workers that may still join the current batch
+    uint32_t m_busyWorkers{0}; //!< Workers that did not finish the current batch yet
+    bool m_stopWorkers{false}; //!< Whether the workers must exit
+
+    static thread_local bool t_inJob; //!< Whether the thread is executing a job
+};
+
+} // namespace ns3
+
+#endif // NR_THREAD_POOL_H
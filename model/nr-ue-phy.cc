@@ -68,6 +68,7 @@ NrUePhy::DoDispose()
         m_cam->Dispose();
         m_cam = nullptr;
     }
+    m_csiBatch = nullptr;
     NrPhy::DoDispose();
 }
 
@@ -1856,7 +1857,29 @@ NrUePhy::GenerateDlCqiReportMimo(const NrMimoSignal& rxSignal,
 
     // Create DL CQI message for CQI, PMI, and RI. PMI values are updated only if specified by
     // pmiUpdateParams, otherwise assume same PMI values as during last CQI feedback
-    auto cqi = m_pmSearch->CreateCqiFeedbackMimo(rxSignal, pmiUpdateParams);
+    if (m_csiBatch)
+    {
+        m_csiBatch->Enqueue(m_amc,
+                            m_pmSearch,
+                            rxSignal,
+                            pmiUpdateParams,
+                            [phy = Ptr<NrUePhy>(this)](const PmCqiInfo& cqi) {
+                                phy->SendDlCqiReportMimo(cqi);
+                            });
+        return;
+    }
+    SendDlCqiReportMimo(m_pmSearch->CreateCqiFeedbackMimo(rxSignal, pmiUpdateParams));
+}
+
+void
+NrUePhy::SendDlCqiReportMimo(const PmCqiInfo& cqi)
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_ulConfigured || (m_rnti == 0))
+    {
+        return;
+    }
+
     auto dlcqi = DlCqiInfo{
         .m_rnti = m_rnti,
         .m_ri = cqi.m_rank,
@@ -2035,4 +2058,11 @@ NrUePhy::GetPmSearch() const
     return m_pmSearch;
 }
 
+void
+NrUePhy::SetCsiBatch(const Ptr<NrCsiBatch>& csiBatch)
+{
+    NS_LOG_FUNCTION(this);
+    m_csiBatch = csiBatch;
+}
+
 } // namespace ns3
@@ -6,6 +6,7 @@
 #define NR_UE_PHY_H
 
 #include "nr-amc.h"
+#include "nr-csi-batch.h"
 #include "nr-harq-phy.h"
 #include "nr-phy-sap.h"
 #include "nr-phy.h"
@@ -479,6 +480,10 @@ class NrUePhy : public NrPhy
     void GenerateDlCqiReportMimo(const NrMimoSignal& cqiMimoFeedbackSignal,
                                  NrPmSearch::PmiUpdate pmiUpdateParams);
 
+    /// @brief Send the DL CQI message of a CQI, PMI, and RI search
+    /// @param cqi the result of the search
+    void SendDlCqiReportMimo(const PmCqiInfo& cqi);
+
     /**
      * @return The type of the CSI feedback
      */
@@ -542,6 +547,16 @@ class NrUePhy : public NrPhy
     /// @brief Get the precoding matrix search engine
     Ptr<NrPmSearch> GetPmSearch() const;
 
+    /// @brief Run the CSI searches of this PHY together with those of other UEs
+    ///
+    /// The PMI, RI and CQI searches are queued in the NrCsiBatch instance, which executes
+    /// them at the end of the time stamp, in parallel with the searches of other UEs, and
+    /// then sends the feedback of this PHY.
+    ///
+    /// @param csiBatch the instance shared by the UEs, or nullptr to run the searches
+    /// immediately (the default)
+    void SetCsiBatch(const Ptr<NrCsiBatch>& csiBatch);
+
   protected:
     /**
      * @brief DoDispose method inherited from Object
@@ -913,6 +928,7 @@ class NrUePhy : public NrPhy
     Ptr<const NrAmc> m_amc; //!< AMC model used to compute the CQI feedback
 
     Ptr<NrPmSearch> m_pmSearch{nullptr}; ///< The precoding matrix search engine
+    Ptr<NrCsiBatch> m_csiBatch;          ///< Batch of CSI searches, if any
 
     Time m_sbPmiLastUpdate{};                               ///< Time of last wideband PMI update
     Time m_wbPmiLastUpdate{};                               ///< Time of last subband PMI update
@@ -4,6 +4,7 @@
 
 #include "realistic-beamforming-algorithm.h"
 
+#include "cell-scan-beam-search.h"
 #include "nr-gnb-phy.h"
 #include "nr-mac-scheduler-ns3.h"
 #include "nr-ue-phy.h"
@@ -272,14 +273,6 @@ RealisticBeamformingAlgorithm::GetBeamformingVectors()
                     "Beamforming method cannot be performed between two devices that are placed in "
                     "the same position.");
 
-    double max = 0;
-    double maxTxTheta = 0;
-    double maxRxTheta = 0;
-    uint16_t maxTxSector = 0;
-    uint16_t maxRxSector = 0;
-    PhasedArrayModel::ComplexVector maxTxW;
-    PhasedArrayModel::ComplexVector maxRxW;
-
     TriggerEventConf conf = GetTriggerEventConf();
     double srsSinr = 0;
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix = nullptr;
@@ -308,83 +301,70 @@ RealisticBeamformingAlgorithm::GetBeamformingVectors()
     NS_ASSERT_MSG(ueUpa, "UE antenna should be UniformPlanarArray");
 
     uint16_t txNumCols = gnbUpa->GetNumColumns();
-    uint16_t txNumRows = gnbUpa->GetNumRows();
     uint16_t rxNumCols = ueUpa->GetNumColumns();
-    uint16_t rxNumRows = ueUpa->GetNumRows();
-
-    NS_ASSERT(gnbUpa->GetNumElems() && ueUpa->GetNumElems());
 
-    double txZenithStep = 180 / ((txNumRows > 1 ? m_oversamplingFactor : 1) * txNumRows);
-    double txSectorStep = 1.0 / (txNumCols > 1 ? m_oversamplingFactor : 1);
-    double rxZenithStep = 180 / ((rxNumRows > 1 ? m_oversamplingFactor : 1) * rxNumRows);
-    double rxSectorStep = 1.0 / (rxNumCols > 1 ? m_oversamplingFactor : 1);
-
-    for (double txZenith = 0; txZenith < 180; txZenith += txZenithStep)
+    CellScanBeamSearch beamSearch(gnbUpa, ueUpa, m_oversamplingFactor);
+    const auto& txBeams = beamSearch.GetTxBeams();
+    const auto& rxBeams = beamSearch.GetRxBeams();
+
+    Ptr<const MobilityModel> gnbMobility = m_gnbSpectrumPhy->GetObject<MobilityModel>();
+    Ptr<const MobilityModel> ueMobility = m_ueSpectrumPhy->GetObject<MobilityModel>();
+
+    // The estimation error is drawn for each pair of beams, so the metric has no upper bound
+    // and all the pairs are evaluated, in the order of the random draws of the nested loops
+    auto estimatedMetric = [&](size_t txBeam, size_t rxBeam) {
+        const PhasedArrayModel::ComplexVector& gnbW = txBeams[txBeam].weights;
+        const PhasedArrayModel::ComplexVector& ueW = rxBeams[rxBeam].weights;
+        NS_ABORT_MSG_IF(gnbW.GetSize() == 0 || ueW.GetSize() == 0,
+                        "Beamforming vectors must be initialized in order to calculate "
+                        "the long term matrix.");
+
+        const UniformPlanarArray::ComplexVector estimatedLongTermComponent =
+            GetEstimatedLongTermComponent(channelMatrix,
+                                          gnbW,
+                                          ueW,
+                                          gnbMobility,
+                                          ueMobility,
+                                          srsSinr,
+                                          gnbUpa,
+                                          ueUpa);
+
+        double estimatedLongTermMetric =
+            CalculateTheEstimatedLongTermMetric(estimatedLongTermComponent);
+
+        NS_LOG_LOGIC(" Estimated long term metric value: "
+                     << estimatedLongTermMetric << " gnb theta " << txBeams[txBeam].theta
+                     << " ue theta " << rxBeams[rxBeam].theta << " gnb sector "
+                     << (M_PI * txBeams[txBeam].sector / static_cast<double>(txNumCols) -
+                         0.5 * M_PI) /
+                            M_PI * 180
+                     << " ue sector "
+                     << (M_PI * rxBeams[rxBeam].sector / static_cast<double>(rxNumCols) -
+                         0.5 * M_PI) /
+                            M_PI * 180);
+        return estimatedLongTermMetric;
+    };
+    CellScanBeamSearch::Result best = beamSearch.Search(estimatedMetric);
+
+    // Leave the antennas with the last beams of the scan, as the exhaustive loops did
+    gnbUpa->SetBeamformingVector(txBeams.back().weights);
+    ueUpa->SetBeamformingVector(rxBeams.back().weights);
+
+    // If no pair has a positive metric, empty beams are returned, with sector and elevation 0
+    double maxTxTheta = 0;
+    double maxRxTheta = 0;
+    uint16_t maxTxSector = 0;
+    uint16_t maxRxSector = 0;
+    PhasedArrayModel::ComplexVector maxTxW;
+    PhasedArrayModel::ComplexVector maxRxW;
+    if (best.metric > 0)
     {
-        // Calculate beam elevation to center it into the middle of the wedge, and not at the start
-        double txTheta = txZenith + txZenithStep * 0.5;
-        for (double txSector = 0; txSector < txNumCols; txSector += txSectorStep)
-        {
-            NS_ASSERT(txSector < UINT16_MAX);
-            m_gnbSpectrumPhy->GetBeamManager()->SetSector(txSector, txTheta);
-            PhasedArrayModel::ComplexVector gnbW =
-                m_gnbSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-            for (double rxZenith = 0; rxZenith < 180; rxZenith += txZenithStep)
-            {
-                // Calculate beam elevation to center it into the middle of the wedge, and not at
-                // the start
-                double rxTheta = rxZenith + rxZenithStep * 0.5;
-                for (double rxSector = 0; rxSector < rxNumCols; rxSector += rxSectorStep)
-                {
-                    NS_ASSERT(rxSector < UINT16_MAX);
-                    m_ueSpectrumPhy->GetBeamManager()->SetSector(rxSector, rxTheta);
-                    PhasedArrayModel::ComplexVector ueW =
-                        m_ueSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-                    NS_ABORT_MSG_IF(gnbW.GetSize() == 0 || ueW.GetSize() == 0,
-                                    "Beamforming vectors must be initialized in order to calculate "
-                                    "the long term matrix.");
-
-                    const UniformPlanarArray::ComplexVector estimatedLongTermComponent =
-                        GetEstimatedLongTermComponent(
-                            channelMatrix,
-                            gnbW,
-                            ueW,
-                            m_gnbSpectrumPhy->GetObject<MobilityModel>(),
-                            m_ueSpectrumPhy->GetObject<MobilityModel>(),
-                            srsSinr,
-                            m_gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>(),
-                            m_ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>());
-
-                    double estimatedLongTermMetric =
-                        CalculateTheEstimatedLongTermMetric(estimatedLongTermComponent);
-
-                    NS_LOG_LOGIC(
-                        " Estimated long term metric value: "
-                        << estimatedLongTermMetric << " gnb theta " << txTheta << " ue theta "
-                        << rxTheta << " gnb sector "
-                        << (M_PI * static_cast<double>(txSector) / static_cast<double>(txNumCols) -
-                            0.5 * M_PI) /
-                               M_PI * 180
-                        << " ue sector "
-                        << (M_PI * static_cast<double>(rxSector) / static_cast<double>(rxNumCols) -
-                            0.5 * M_PI) /
-                               M_PI * 180);
-
-                    if (max < estimatedLongTermMetric)
-                    {
-                        max = estimatedLongTermMetric;
-                        maxTxSector = txSector;
-                        maxRxSector = rxSector;
-                        maxTxTheta = txTheta;
-                        maxRxTheta = rxTheta;
-                        maxTxW = gnbW;
-                        maxRxW = ueW;
-                    }
-                }
-            }
-        }
+        maxTxSector = static_cast<uint16_t>(txBeams[best.txBeam].sector);
+        maxRxSector = static_cast<uint16_t>(rxBeams[best.rxBeam].sector);
+        maxTxTheta = txBeams[best.txBeam].theta;
+        maxRxTheta = rxBeams[best.rxBeam].theta;
+        maxTxW = txBeams[best.txBeam].weights;
+        maxRxW = rxBeams[best.rxBeam].weights;
     }
 
     BeamformingVectorPair bfPair = std::make_pair(
@@ -172,6 +172,7 @@ cpp_examples = [
     ("cttc-error-model --simTime=2", "True", "True"),
     ("cttc-error-model-amc --simTime=2", "True", "True"),
     ("cttc-error-model-comparison", "True", "True"),
+    ("nr-bench-eesm --iterations=1000", "True", "True"),
     ("cttc-channel-randomness", "True", "True"),
     ("rem-beam-example", "True", "True"),
     ("rem-example", "True", "True"),
@@ -5,6 +5,8 @@
 #include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/ideal-beamforming-algorithm.h"
+#include "ns3/ideal-beamforming-helper.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/mobility-helper.h"
 #include "ns3/nr-channel-helper.h"
@@ -208,6 +210,180 @@ BeamformingTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * @brief Checks that the beams computed by IdealBeamformingHelper with several threads are
+ * the same as with one, and that SkipUnchangedTasks only computes again the tasks of the UEs
+ * that moved, with the 3GPP and the NYU channel models
+ */
+class IdealBeamformingHelperRunTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param channelModel the channel model, "ThreeGpp" or "NYU"
+     */
+    IdealBeamformingHelperRunTestCase(const std::string& channelModel)
+        : TestCase("IdealBeamformingHelper with several threads, unchanged tasks and channel "
+                   "updates, " +
+                   channelModel + " channel"),
+          m_channelModel(channelModel)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    std::string m_channelModel; //!< The channel model
+};
+
+void
+IdealBeamformingHelperRunTestCase::DoRun()
+{
+    const Time updatePeriod = MilliSeconds(10);
+    Config::SetDefault("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue(updatePeriod));
+    Config::SetDefault("ns3::NYUChannelModel::UpdatePeriod", TimeValue(updatePeriod));
+    const uint32_t numUes = 6;
+    // Only the cell scan bounds with a 3GPP channel run on several threads
+    const uint64_t numUesInParallel = m_channelModel == "ThreeGpp" ? numUes : 0;
+
+    NodeContainer gnbContainer;
+    gnbContainer.Create(2);
+    NodeContainer ueContainer;
+    ueContainer.Create(numUes);
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0.0, 0.0, 25.0));
+    positionAlloc->Add(Vector(300.0, 0.0, 25.0));
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(gnbContainer);
+    positionAlloc = CreateObject<ListPositionAllocator>();
+    for (uint32_t i = 0; i < numUes; ++i)
+    {
+        positionAlloc->Add(Vector(40.0 + 45 * i, (i % 3) * 60.0 - 60, 1.5));
+    }
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(ueContainer);
+
+    Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    idealBeamformingHelper->SetAttribute("BeamformingMethod",
+                                         TypeIdValue(CellScanBeamforming::GetTypeId()));
+
+    Ptr<NrChannelHelper> channelHelper = CreateObject<NrChannelHelper>();
+    channelHelper->ConfigureFactories("UMa", "Default", m_channelModel);
+    channelHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(3.5e9, 10e6, 1);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    channelHelper->AssignChannelsToBands({band});
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(4));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(4));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+    NetDeviceContainer gnbNetDevs = nrHelper->InstallGnbDevice(gnbContainer, allBwps);
+    NetDeviceContainer ueNetDevs = nrHelper->InstallUeDevice(ueContainer, allBwps);
+    nrHelper->AssignStreams(gnbNetDevs, 1);
+    nrHelper->AssignStreams(ueNetDevs, 1000);
+    for (uint32_t i = 0; i < numUes; ++i)
+    {
+        nrHelper->AttachToGnb(ueNetDevs.Get(i), gnbNetDevs.Get(i % 2));
+    }
+
+    // The beams of the gNB and of the UE of each pair
+    auto getBeams = [&]() {
+        std::vector<std::pair<BeamId, BeamId>> beams;
+        for (uint32_t i = 0; i < numUes; ++i)
+        {
+            auto gnbDev = DynamicCast<NrGnbNetDevice>(gnbNetDevs.Get(i % 2));
+            auto ueDev = DynamicCast<NrUeNetDevice>(ueNetDevs.Get(i));
+            beams.emplace_back(
+                gnbDev->GetPhy(0)->GetSpectrumPhy()->GetBeamManager()->GetBeamId(ueDev),
+                ueDev->GetPhy(0)->GetSpectrumPhy()->GetBeamManager()->GetBeamId(gnbDev));
+        }
+        return beams;
+    };
+
+    // Compare the beams of the last run with those of a run with a different number of
+    // threads, at the same time stamp
+    auto checkThreads = [&](uint32_t numThreads) {
+        auto beams = getBeams();
+        idealBeamformingHelper->SetAttribute("SkipUnchangedTasks", BooleanValue(false));
+        idealBeamformingHelper->SetAttribute("NumThreads", UintegerValue(numThreads));
+        idealBeamformingHelper->Run();
+        auto otherBeams = getBeams();
+        for (uint32_t i = 0; i < numUes; ++i)
+        {
+            NS_TEST_EXPECT_MSG_EQ(otherBeams[i].first,
+                                  beams[i].first,
+                                  "Different gNB beam with " << numThreads << " threads for UE "
+                                                             << i);
+            NS_TEST_EXPECT_MSG_EQ(otherBeams[i].second,
+                                  beams[i].second,
+                                  "Different UE beam with " << numThreads << " threads for UE "
+                                                            << i);
+        }
+    };
+
+    Simulator::Schedule(MilliSeconds(1), [&]() {
+        idealBeamformingHelper->Run();
+        checkThreads(4);
+        NS_TEST_EXPECT_MSG_EQ(idealBeamformingHelper->GetNumTasksInParallel(),
+                              numUesInParallel,
+                              "Wrong number of tasks prepared by several threads");
+
+        idealBeamformingHelper->SetAttribute("SkipUnchangedTasks", BooleanValue(true));
+        uint64_t numRun = idealBeamformingHelper->GetNumTasksRun();
+        uint64_t numSkipped = idealBeamformingHelper->GetNumTasksSkipped();
+        idealBeamformingHelper->Run();
+        NS_TEST_EXPECT_MSG_EQ(idealBeamformingHelper->GetNumTasksRun(),
+                              numRun,
+                              "No task should run without changes");
+        NS_TEST_EXPECT_MSG_EQ(idealBeamformingHelper->GetNumTasksSkipped(),
+                              numSkipped + numUes,
+                              "All the tasks should be skipped without changes");
+
+        ueContainer.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(40.0, 80.0, 1.5));
+        idealBeamformingHelper->Run();
+        NS_TEST_EXPECT_MSG_EQ(idealBeamformingHelper->GetNumTasksRun(),
+                              numRun + 1,
+                              "Only the task of the UE that moved should run");
+        NS_TEST_EXPECT_MSG_EQ(idealBeamformingHelper->GetNumTasksSkipped(),
+                              numSkipped + 2 * numUes - 1,
+                              "The tasks of the other UEs should be skipped");
+    });
+
+    // After the update period, the channels are generated again, either by the transmissions
+    // or by the beamforming itself, so all the tasks run again although nothing moved
+    Simulator::Schedule(MilliSeconds(2) + updatePeriod, [&]() {
+        uint64_t numRun = idealBeamformingHelper->GetNumTasksRun();
+        uint64_t numInParallel = idealBeamformingHelper->GetNumTasksInParallel();
+        idealBeamformingHelper->Run();
+        NS_TEST_EXPECT_MSG_EQ(idealBeamformingHelper->GetNumTasksRun(),
+                              numRun + numUes,
+                              "All the tasks should run after the update of their channel");
+        NS_TEST_EXPECT_MSG_EQ(idealBeamformingHelper->GetNumTasksInParallel(),
+                              numInParallel + numUesInParallel,
+                              "Wrong number of tasks prepared by several threads");
+
+        idealBeamformingHelper->SetAttribute("SkipUnchangedTasks", BooleanValue(true));
+        idealBeamformingHelper->Run();
+        NS_TEST_EXPECT_MSG_EQ(idealBeamformingHelper->GetNumTasksRun(),
+                              numRun + numUes,
+                              "No task should run again after the update of their channel");
+
+        // The updated channels give the same beams with a single thread
+        checkThreads(1);
+    });
+    Simulator::Stop(MilliSeconds(3) + updatePeriod);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
 class TestNrIdealBeamforming : public TestSuite
 {
   public:
@@ -336,6 +512,12 @@ class TestNrIdealBeamforming : public TestSuite
                                                 testParams.oversamp),
                         TestCase::Duration::QUICK);
         }
+
+        for (const auto& channelModel : {"ThreeGpp", "NYU"})
+        {
+            AddTestCase(new IdealBeamformingHelperRunTestCase(channelModel),
+                        TestCase::Duration::QUICK);
+        }
     }
 };
 
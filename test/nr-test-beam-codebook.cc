@@ -0,0 +1,130 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/beam-manager.h"
+#include "ns3/double.h"
+#include "ns3/object-factory.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+/**
+ * @file nr-test-beam-codebook.cc
+ * @ingroup test
+ *
+ * @brief Checks that the codebook cache of BeamManager returns the same beamforming vectors
+ * as CreateDirectionalBfv(), CreateKroneckerBfv() and CreateQuasiOmniBfv(), that the arrays
+ * with the same geometry share them, and that the arrays with another orientation do not.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Test case of the codebook cache of BeamManager
+ */
+class NrBeamCodebookTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     */
+    NrBeamCodebookTestCase()
+        : TestCase("Codebook cache of BeamManager")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Check that two beamforming vectors are equal
+     * @param actual the beamforming vector of the cache
+     * @param expected the beamforming vector created from scratch
+     * @param msg the message of the failures
+     */
+    void CheckEqual(const PhasedArrayModel::ComplexVector& actual,
+                    const PhasedArrayModel::ComplexVector& expected,
+                    const std::string& msg);
+};
+
+void
+NrBeamCodebookTestCase::CheckEqual(const PhasedArrayModel::ComplexVector& actual,
+                                   const PhasedArrayModel::ComplexVector& expected,
+                                   const std::string& msg)
+{
+    NS_TEST_ASSERT_MSG_EQ(actual.GetSize(), expected.GetSize(), msg);
+    for (size_t i = 0; i < actual.GetSize(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(actual[i], expected[i], msg);
+    }
+}
+
+void
+NrBeamCodebookTestCase::DoRun()
+{
+    auto createAntenna = [](double bearingAngle) {
+        return CreateObjectWithAttributes<UniformPlanarArray>("NumRows",
+                                                              UintegerValue(4),
+                                                              "NumColumns",
+                                                              UintegerValue(8),
+                                                              "BearingAngle",
+                                                              DoubleValue(bearingAngle));
+    };
+    auto antenna = createAntenna(0);
+    auto sameAntenna = createAntenna(0);
+    auto rotatedAntenna = createAntenna(M_PI / 3);
+
+    for (double sector = 0; sector < 8; sector += 0.5)
+    {
+        for (double elevation : {45.0, 90.0, 135.0})
+        {
+            const auto& bfv = BeamManager::GetDirectionalBfv(antenna, sector, elevation);
+            CheckEqual(bfv,
+                       CreateDirectionalBfv(antenna, sector, elevation),
+                       "Wrong directional beam");
+            NS_TEST_ASSERT_MSG_EQ(&BeamManager::GetDirectionalBfv(sameAntenna, sector, elevation),
+                                  &bfv,
+                                  "Arrays with the same geometry must share the beams");
+            CheckEqual(BeamManager::GetDirectionalBfv(rotatedAntenna, sector, elevation),
+                       CreateDirectionalBfv(rotatedAntenna, sector, elevation),
+                       "Wrong directional beam of the rotated array");
+        }
+    }
+
+    CheckEqual(BeamManager::GetKroneckerBfv(antenna, 80, 100),
+               CreateKroneckerBfv(antenna, 80, 100),
+               "Wrong Kronecker beam");
+    CheckEqual(BeamManager::GetQuasiOmniBfv(antenna),
+               CreateQuasiOmniBfv(antenna),
+               "Wrong quasi-omni beam");
+
+    // The size of the array is part of the key, so the beams follow its changes
+    antenna->SetAttribute("NumRows", UintegerValue(2));
+    CheckEqual(BeamManager::GetDirectionalBfv(antenna, 3, 90),
+               CreateDirectionalBfv(antenna, 3, 90),
+               "Wrong directional beam after changing the size of the array");
+
+    auto beamManager = CreateObject<BeamManager>();
+    beamManager->Configure(rotatedAntenna);
+    beamManager->SetSector(2.5, 135);
+    CheckEqual(rotatedAntenna->GetBeamformingVector(),
+               CreateDirectionalBfv(rotatedAntenna, 2.5, 135),
+               "SetSector configured a wrong beam");
+}
+
+/**
+ * @brief Test suite of the codebook cache of BeamManager
+ */
+class NrBeamCodebookTestSuite : public TestSuite
+{
+  public:
+    NrBeamCodebookTestSuite()
+        : TestSuite("nr-test-beam-codebook", Type::UNIT)
+    {
+        AddTestCase(new NrBeamCodebookTestCase(), Duration::QUICK);
+    }
+};
+
+static NrBeamCodebookTestSuite g_nrBeamCodebookTestSuite; //!< Beam codebook test suite
+
+} // namespace ns3
@@ -0,0 +1,195 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/boolean.h"
+#include "ns3/nr-cb-type-one-sp.h"
+#include "ns3/nr-mimo-matrices.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+/**
+ * @file nr-test-cb-precoders.cc
+ * @ingroup test
+ *
+ * @brief Checks that the precoding matrices cached by NrCbTypeOne::GetPrecoders() are shared
+ * by the codebooks with the same configuration, that they are the same as the ones returned by
+ * NrCbTypeOne::GetBasePrecMat(), and that the SINR computed by applying a cached precoding
+ * matrix to all the subbands in place, alone or in a batch of precoders, is the same as with a
+ * copy of it per subband.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Checks the cached precoding matrices of a Type-I single-panel codebook
+ */
+class NrCbPrecodersTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param n1 the number of horizontal ports
+     * @param n2 the number of vertical ports
+     * @param rank the rank
+     * @param nRxPorts the number of receive ports of the channel
+     */
+    NrCbPrecodersTestCase(size_t n1, size_t n2, uint8_t rank, size_t nRxPorts);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Create and initialize a dual-polarized codebook
+     * @param rank the rank
+     * @return the codebook
+     */
+    Ptr<NrCbTypeOne> CreateCodebook(uint8_t rank) const;
+
+    size_t m_n1;       //!< Number of horizontal ports
+    size_t m_n2;       //!< Number of vertical ports
+    uint8_t m_rank;    //!< Rank
+    size_t m_nRxPorts; //!< Number of receive ports of the channel
+};
+
+NrCbPrecodersTestCase::NrCbPrecodersTestCase(size_t n1, size_t n2, uint8_t rank, size_t nRxPorts)
+    : TestCase("Precoders of N1=" + std::to_string(n1) + " N2=" + std::to_string(n2) +
+               " rank " + std::to_string(rank) + " with " + std::to_string(nRxPorts) +
+               " RX ports"),
+      m_n1(n1),
+      m_n2(n2),
+      m_rank(rank),
+      m_nRxPorts(nRxPorts)
+{
+}
+
+Ptr<NrCbTypeOne>
+NrCbPrecodersTestCase::CreateCodebook(uint8_t rank) const
+{
+    Ptr<NrCbTypeOne> cb = CreateObject<NrCbTypeOneSp>();
+    cb->SetAttribute("N1", UintegerValue(m_n1));
+    cb->SetAttribute("N2", UintegerValue(m_n2));
+    cb->SetAttribute("IsDualPol", BooleanValue(true));
+    cb->SetAttribute("Rank", UintegerValue(rank));
+    cb->Init();
+    return cb;
+}
+
+void
+NrCbPrecodersTestCase::DoRun()
+{
+    auto cb = CreateCodebook(m_rank);
+    auto precoders = cb->GetPrecoders();
+    NS_TEST_ASSERT_MSG_EQ(CreateCodebook(m_rank)->GetPrecoders(),
+                          precoders,
+                          "Codebooks with the same configuration must share the precoders");
+    NS_TEST_ASSERT_MSG_NE(CreateCodebook(m_rank == 1 ? 2 : 1)->GetPrecoders(),
+                          precoders,
+                          "Codebooks with different ranks must not share the precoders");
+
+    NS_TEST_ASSERT_MSG_EQ(precoders->GetNumI1(), cb->GetNumI1(), "Unexpected number of i1");
+    NS_TEST_ASSERT_MSG_EQ(precoders->GetNumI2(), cb->GetNumI2(), "Unexpected number of i2");
+    const auto& precMats = precoders->GetPrecMats();
+    for (size_t i1 = 0; i1 < cb->GetNumI1(); i1++)
+    {
+        for (size_t i2 = 0; i2 < cb->GetNumI2(); i2++)
+        {
+            auto basePrecMat = cb->GetBasePrecMat(i1, i2);
+            auto page = precoders->GetPage(i1, i2);
+            for (size_t i = 0; i < basePrecMat.GetNumRows(); i++)
+            {
+                for (size_t j = 0; j < basePrecMat.GetNumCols(); j++)
+                {
+                    NS_TEST_ASSERT_MSG_EQ(precMats(i, j, page),
+                                          basePrecMat(i, j),
+                                          "Cached precoder differs for i1=" << i1 << " i2=" << i2);
+                }
+            }
+        }
+    }
+
+    // Random interference-normalized channel with 5 subbands
+    Ptr<NormalRandomVariable> rv = CreateObject<NormalRandomVariable>();
+    rv->SetStream(1);
+    const size_t nSubbands = 5;
+    auto nPorts = precMats.GetNumRows();
+    ComplexMatrixArray chanMat{m_nRxPorts, nPorts, nSubbands};
+    for (size_t iSb = 0; iSb < nSubbands; iSb++)
+    {
+        for (size_t i = 0; i < chanMat.GetNumRows(); i++)
+        {
+            for (size_t j = 0; j < nPorts; j++)
+            {
+                chanMat(i, j, iSb) = std::complex<double>{rv->GetValue(), rv->GetValue()};
+            }
+        }
+    }
+    NrIntfNormChanMat sbNormChanMat{chanMat};
+
+    for (size_t i1 = 0; i1 < cb->GetNumI1(); i1 += 3)
+    {
+        auto i2 = i1 % cb->GetNumI2();
+        auto copies = cb->GetBasePrecMat(i1, i2).MakeNCopies(nSubbands);
+        auto sinrCopies = sbNormChanMat.ComputeSinrForPrecoding(copies);
+        auto sinrInPlace =
+            sbNormChanMat.ComputeSinrForPrecoding(precMats, precoders->GetPage(i1, i2));
+        NS_TEST_ASSERT_MSG_EQ(sinrInPlace.GetNumRows(),
+                              size_t{m_rank},
+                              "Unexpected number of layers");
+        NS_TEST_ASSERT_MSG_EQ(sinrInPlace.GetNumCols(), nSubbands, "Unexpected number of bands");
+        for (size_t layer = 0; layer < m_rank; layer++)
+        {
+            for (size_t iSb = 0; iSb < nSubbands; iSb++)
+            {
+                NS_TEST_ASSERT_MSG_EQ_TOL(sinrInPlace(layer, iSb),
+                                          sinrCopies(layer, iSb),
+                                          1e-9 * sinrCopies(layer, iSb),
+                                          "SINR differs for i1=" << i1 << " i2=" << i2);
+            }
+        }
+
+        // All the i2 of this i1 in a single batch
+        auto numI2 = cb->GetNumI2();
+        auto sinrBatch =
+            sbNormChanMat.ComputeSinrForPrecoders(precMats, precoders->GetPage(i1, 0), numI2);
+        NS_TEST_ASSERT_MSG_EQ(sinrBatch.GetNumPages(), numI2, "Unexpected number of precoders");
+        for (size_t batchI2 = 0; batchI2 < numI2; batchI2++)
+        {
+            auto sinrPage =
+                sbNormChanMat.ComputeSinrForPrecoding(precMats, precoders->GetPage(i1, batchI2));
+            for (size_t layer = 0; layer < m_rank; layer++)
+            {
+                for (size_t iSb = 0; iSb < nSubbands; iSb++)
+                {
+                    NS_TEST_ASSERT_MSG_EQ_TOL(sinrBatch(layer, iSb, batchI2),
+                                              sinrPage(layer, iSb),
+                                              1e-9 * (1.0 + sinrPage(layer, iSb)),
+                                              "Batched SINR differs for i1=" << i1
+                                                                             << " i2=" << batchI2);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Test suite of the cached precoding matrices of the Type-I codebooks
+ */
+class NrCbPrecodersTestSuite : public TestSuite
+{
+  public:
+    NrCbPrecodersTestSuite()
+        : TestSuite("nr-test-cb-precoders", Type::UNIT)
+    {
+        AddTestCase(new NrCbPrecodersTestCase(2, 1, 1, 4), Duration::QUICK);
+        AddTestCase(new NrCbPrecodersTestCase(2, 1, 1, 1), Duration::QUICK);
+        AddTestCase(new NrCbPrecodersTestCase(2, 1, 2, 8), Duration::QUICK);
+        AddTestCase(new NrCbPrecodersTestCase(2, 2, 2, 4), Duration::QUICK);
+        AddTestCase(new NrCbPrecodersTestCase(4, 2, 4, 4), Duration::QUICK);
+    }
+};
+
+static NrCbPrecodersTestSuite g_nrCbPrecodersTestSuite; //!< Codebook precoders test suite
+
+} // namespace ns3
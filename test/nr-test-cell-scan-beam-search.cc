@@ -0,0 +1,236 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/boolean.h"
+#include "ns3/cell-scan-beam-search.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+/**
+ * @file nr-test-cell-scan-beam-search.cc
+ * @ingroup test
+ *
+ * @brief Compares the search of CellScanBeamSearch that skips the pairs of beams by their
+ * upper bound with the exhaustive one, for random clustered channels and several antenna
+ * arrays. The metric is the received power of a frequency-selective channel whose clusters
+ * have random delays and Doppler phases, as in the 3GPP channel model. Both searches must
+ * select the same pair of beams, including when several pairs have the same metric. With a
+ * gNB array of several ports, or with dual-polarized arrays, the search with a bound must
+ * evaluate all the pairs.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Checks that the bounded search selects the same beams as the exhaustive one
+ */
+class NrCellScanBeamSearchTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param gnbRows the number of rows of the gNB antenna array
+     * @param gnbCols the number of columns of the gNB antenna array
+     * @param ueRows the number of rows of the UE antenna array
+     * @param ueCols the number of columns of the UE antenna array
+     * @param oversamplingFactor the number of samples per antenna row and column
+     * @param isReverse whether the rows of the channel matrix are the gNB antenna elements
+     * @param gnbHorizontalPorts the number of horizontal ports of the gNB antenna array
+     * @param isDualPol whether both antenna arrays are dual-polarized
+     */
+    NrCellScanBeamSearchTestCase(uint32_t gnbRows,
+                                 uint32_t gnbCols,
+                                 uint32_t ueRows,
+                                 uint32_t ueCols,
+                                 uint8_t oversamplingFactor,
+                                 bool isReverse,
+                                 uint32_t gnbHorizontalPorts = 1,
+                                 bool isDualPol = false)
+        : TestCase("Cell scan beam search with " + std::to_string(gnbRows) + "x" +
+                   std::to_string(gnbCols) + " gNB, " + std::to_string(ueRows) + "x" +
+                   std::to_string(ueCols) + " UE, oversampling " +
+                   std::to_string(oversamplingFactor) + (isReverse ? ", reverse" : "") +
+                   (gnbHorizontalPorts > 1
+                        ? ", " + std::to_string(gnbHorizontalPorts) + " gNB ports"
+                        : "") +
+                   (isDualPol ? ", dual-polarized" : "")),
+          m_gnbRows(gnbRows),
+          m_gnbCols(gnbCols),
+          m_ueRows(ueRows),
+          m_ueCols(ueCols),
+          m_oversamplingFactor(oversamplingFactor),
+          m_isReverse(isReverse),
+          m_gnbHorizontalPorts(gnbHorizontalPorts),
+          m_isDualPol(isDualPol)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    uint32_t m_gnbRows;            //!< Rows of the gNB antenna array
+    uint32_t m_gnbCols;            //!< Columns of the gNB antenna array
+    uint32_t m_ueRows;             //!< Rows of the UE antenna array
+    uint32_t m_ueCols;             //!< Columns of the UE antenna array
+    uint8_t m_oversamplingFactor;  //!< Samples per antenna row and column
+    bool m_isReverse;              //!< Whether the channel is from the UE to the gNB
+    uint32_t m_gnbHorizontalPorts; //!< Horizontal ports of the gNB antenna array
+    bool m_isDualPol;              //!< Whether the antenna arrays are dual-polarized
+};
+
+void
+NrCellScanBeamSearchTestCase::DoRun()
+{
+    const size_t numClusters = 12;
+    const size_t numRbs = 24;
+
+    auto gnbAntenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumRows",
+        UintegerValue(m_gnbRows),
+        "NumColumns",
+        UintegerValue(m_gnbCols),
+        "NumHorizontalPorts",
+        UintegerValue(m_gnbHorizontalPorts),
+        "IsDualPolarized",
+        BooleanValue(m_isDualPol));
+    auto ueAntenna = CreateObjectWithAttributes<UniformPlanarArray>("NumRows",
+                                                                    UintegerValue(m_ueRows),
+                                                                    "NumColumns",
+                                                                    UintegerValue(m_ueCols),
+                                                                    "IsDualPolarized",
+                                                                    BooleanValue(m_isDualPol));
+    CellScanBeamSearch beamSearch(gnbAntenna, ueAntenna, m_oversamplingFactor);
+    bool isBoundValid = m_gnbHorizontalPorts == 1 && !m_isDualPol;
+    NS_TEST_ASSERT_MSG_EQ(beamSearch.IsMetricBoundValid(),
+                          isBoundValid,
+                          "Wrong validity of the bound of the metric");
+    const auto& txBeams = beamSearch.GetTxBeams();
+    const auto& rxBeams = beamSearch.GetRxBeams();
+    size_t numGnbElems = gnbAntenna->GetNumElems();
+    size_t numUeElems = ueAntenna->GetNumElems();
+
+    auto uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(1);
+    auto normal = CreateObject<NormalRandomVariable>();
+    normal->SetStream(2);
+
+    for (uint32_t run = 0; run < 4; ++run)
+    {
+        // Each cluster is a plane wave between random directions, with a decaying power
+        ComplexMatrixArray channel(m_isReverse ? numGnbElems : numUeElems,
+                                   m_isReverse ? numUeElems : numGnbElems,
+                                   numClusters);
+        std::vector<double> delays(numClusters);
+        std::vector<double> dopplers(numClusters);
+        for (size_t cluster = 0; cluster < numClusters; ++cluster)
+        {
+            auto gain = std::sqrt(std::exp(-0.5 * cluster)) *
+                        std::complex<double>(normal->GetValue(), normal->GetValue());
+            auto gnbSteering = CreateDirectionalBfv(gnbAntenna,
+                                                    uniform->GetValue(0, m_gnbCols),
+                                                    uniform->GetValue(0, 180));
+            auto ueSteering = CreateDirectionalBfv(ueAntenna,
+                                                   uniform->GetValue(0, m_ueCols),
+                                                   uniform->GetValue(0, 180));
+            for (size_t row = 0; row < channel.GetNumRows(); ++row)
+            {
+                for (size_t col = 0; col < channel.GetNumCols(); ++col)
+                {
+                    channel(row, col, cluster) =
+                        gain * std::conj(m_isReverse ? gnbSteering[row] * ueSteering[col]
+                                                     : ueSteering[row] * gnbSteering[col]);
+                }
+            }
+            delays[cluster] = uniform->GetValue(0, 1e-6);
+            dopplers[cluster] = uniform->GetValue(0, 2 * M_PI);
+        }
+
+        // The received power of each RB is |sum_c L_c g_c(f)|^2; with run 3, it is rounded
+        // down to 0.1 dB so that several pairs of beams have the same power
+        auto rxPower = [&](size_t txBeam, size_t rxBeam) {
+            const auto& txW = txBeams[txBeam].weights;
+            const auto& rxW = rxBeams[rxBeam].weights;
+            const auto& rowW = m_isReverse ? txW : rxW;
+            const auto& colW = m_isReverse ? rxW : txW;
+            std::vector<std::complex<double>> longTerm(numClusters);
+            for (size_t cluster = 0; cluster < numClusters; ++cluster)
+            {
+                for (size_t row = 0; row < channel.GetNumRows(); ++row)
+                {
+                    for (size_t col = 0; col < channel.GetNumCols(); ++col)
+                    {
+                        longTerm[cluster] += rowW[row] * channel(row, col, cluster) * colW[col];
+                    }
+                }
+            }
+            double power = 0;
+            for (size_t rb = 0; rb < numRbs; ++rb)
+            {
+                std::complex<double> gain;
+                for (size_t cluster = 0; cluster < numClusters; ++cluster)
+                {
+                    gain += longTerm[cluster] *
+                            std::polar(1.0,
+                                       dopplers[cluster] -
+                                           2 * M_PI * 180e3 * rb * delays[cluster]);
+                }
+                power += std::norm(gain);
+            }
+            if (run == 3)
+            {
+                power = std::pow(10, std::floor(100 * std::log10(power)) / 100);
+            }
+            return power;
+        };
+
+        auto exhaustive = beamSearch.Search(rxPower);
+        auto bounded = beamSearch.Search(rxPower, channel, m_isReverse, numRbs);
+        NS_TEST_ASSERT_MSG_EQ(bounded.txBeam, exhaustive.txBeam, "Different gNB beam");
+        NS_TEST_ASSERT_MSG_EQ(bounded.rxBeam, exhaustive.rxBeam, "Different UE beam");
+        NS_TEST_ASSERT_MSG_EQ(bounded.metric, exhaustive.metric, "Different metric");
+        NS_TEST_ASSERT_MSG_EQ(exhaustive.numEvaluations,
+                              txBeams.size() * rxBeams.size(),
+                              "The exhaustive search must evaluate all the pairs");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(bounded.numEvaluations,
+                                    exhaustive.numEvaluations,
+                                    "The bounded search evaluated more pairs");
+        if (!isBoundValid)
+        {
+            NS_TEST_ASSERT_MSG_EQ(bounded.numEvaluations,
+                                  exhaustive.numEvaluations,
+                                  "Without a valid bound, all the pairs must be evaluated");
+        }
+    }
+}
+
+/**
+ * @brief Test suite of CellScanBeamSearch
+ */
+class NrCellScanBeamSearchTestSuite : public TestSuite
+{
+  public:
+    NrCellScanBeamSearchTestSuite()
+        : TestSuite("nr-test-cell-scan-beam-search", Type::UNIT)
+    {
+        for (bool isReverse : {false, true})
+        {
+            AddTestCase(new NrCellScanBeamSearchTestCase(2, 2, 1, 1, 1, isReverse),
+                        Duration::QUICK);
+            AddTestCase(new NrCellScanBeamSearchTestCase(4, 4, 2, 2, 2, isReverse),
+                        Duration::QUICK);
+            AddTestCase(new NrCellScanBeamSearchTestCase(8, 4, 1, 2, 1, isReverse),
+                        Duration::QUICK);
+            AddTestCase(new NrCellScanBeamSearchTestCase(4, 4, 2, 2, 1, isReverse, 2, false),
+                        Duration::QUICK);
+            AddTestCase(new NrCellScanBeamSearchTestCase(4, 4, 2, 2, 1, isReverse, 1, true),
+                        Duration::QUICK);
+        }
+    }
+};
+
+static NrCellScanBeamSearchTestSuite g_nrCellScanBeamSearchTestSuite; //!< Beam search test suite
+
+} // namespace ns3
@@ -0,0 +1,166 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/double.h"
+#include "ns3/nr-mimo-matrices.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+/**
+ * @file nr-test-cov-mat.cc
+ * @ingroup test
+ *
+ * @brief Checks that the interference covariance matrices accumulated in place by
+ * NrCovMat::AddInterferenceSignal() and NrCovMat::AddPrecodedInterferenceSignal() are the same
+ * as the ones computed with the products of matrix arrays, and that the subtraction of a signal
+ * undoes its addition.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Compares the fused covariance kernels with the products of matrix arrays
+ */
+class NrCovMatTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param nRxPorts the number of receive ports
+     * @param nTxPorts the number of transmit ports of the interferers
+     * @param rank the rank of the interferers
+     */
+    NrCovMatTestCase(size_t nRxPorts, size_t nTxPorts, size_t rank);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Create a matrix array with random complex elements
+     * @param nRows the number of rows
+     * @param nCols the number of columns
+     * @return the matrix array
+     */
+    ComplexMatrixArray CreateRandomMatrix(size_t nRows, size_t nCols) const;
+
+    size_t m_nRxPorts;                    //!< Number of receive ports
+    size_t m_nTxPorts;                    //!< Number of transmit ports of the interferers
+    size_t m_rank;                        //!< Rank of the interferers
+    Ptr<UniformRandomVariable> m_rv;      //!< Random variable of the matrix elements
+    static constexpr size_t NUM_RBS = 13; //!< Number of RBs of the matrices
+};
+
+NrCovMatTestCase::NrCovMatTestCase(size_t nRxPorts, size_t nTxPorts, size_t rank)
+    : TestCase("Covariance of " + std::to_string(nRxPorts) + " RX ports, interferers with " +
+               std::to_string(nTxPorts) + " TX ports and rank " + std::to_string(rank)),
+      m_nRxPorts(nRxPorts),
+      m_nTxPorts(nTxPorts),
+      m_rank(rank)
+{
+}
+
+ComplexMatrixArray
+NrCovMatTestCase::CreateRandomMatrix(size_t nRows, size_t nCols) const
+{
+    ComplexMatrixArray mat{nRows, nCols, NUM_RBS};
+    for (size_t p = 0; p < NUM_RBS; p++)
+    {
+        for (size_t j = 0; j < nCols; j++)
+        {
+            for (size_t i = 0; i < nRows; i++)
+            {
+                mat(i, j, p) = std::complex<double>{m_rv->GetValue(), m_rv->GetValue()};
+            }
+        }
+    }
+    return mat;
+}
+
+void
+NrCovMatTestCase::DoRun()
+{
+    m_rv = CreateObject<UniformRandomVariable>();
+    m_rv->SetAttribute("Min", DoubleValue(-1.0));
+    m_rv->SetAttribute("Max", DoubleValue(1.0));
+    m_rv->SetStream(1);
+
+    std::vector<BandInfo> bands(NUM_RBS);
+    SpectrumValue noise(Create<SpectrumModel>(bands));
+    for (size_t p = 0; p < NUM_RBS; p++)
+    {
+        noise[p] = 0.1 * (p + 1);
+    }
+
+    // The reference covariance is computed as in the previous releases
+    NrCovMat refCov{ComplexMatrixArray(m_nRxPorts, m_nRxPorts, NUM_RBS)};
+    for (size_t p = 0; p < NUM_RBS; p++)
+    {
+        for (size_t i = 0; i < m_nRxPorts; i++)
+        {
+            refCov(i, i, p) = noise[p];
+        }
+    }
+    NrCovMat cov;
+    cov.SetDiagonal(m_nRxPorts, NUM_RBS, noise);
+    NS_TEST_ASSERT_MSG_EQ(cov.IsAlmostEqual(refCov, 0.0), true, "Wrong noise covariance");
+
+    for (size_t i = 0; i < 5; i++)
+    {
+        auto chanMat = CreateRandomMatrix(m_nRxPorts, m_nTxPorts);
+        auto precMats = CreateRandomMatrix(m_nTxPorts, m_rank);
+        auto chanPrec = chanMat * precMats;
+        refCov += chanPrec * chanPrec.HermitianTranspose();
+        cov.AddPrecodedInterferenceSignal(chanMat, precMats);
+
+        auto unprecoded = CreateRandomMatrix(m_nRxPorts, m_nTxPorts);
+        refCov += unprecoded * unprecoded.HermitianTranspose();
+        cov.AddInterferenceSignal(unprecoded);
+    }
+    NS_TEST_ASSERT_MSG_EQ(cov.IsAlmostEqual(refCov, 1e-12),
+                          true,
+                          "The covariance accumulated in place differs from the reference");
+
+    // Subtracting a signal undoes its addition, as in the running sums of NrInterference
+    auto chanMat = CreateRandomMatrix(m_nRxPorts, m_nTxPorts);
+    auto precMats = CreateRandomMatrix(m_nTxPorts, m_rank);
+    cov.AddPrecodedInterferenceSignal(chanMat, precMats);
+    cov.AddInterferenceSignal(chanMat);
+    cov.SubtractPrecodedInterferenceSignal(chanMat, precMats);
+    cov.SubtractInterferenceSignal(chanMat);
+    NS_TEST_ASSERT_MSG_EQ(cov.IsAlmostEqual(refCov, 1e-12),
+                          true,
+                          "The subtraction of a signal does not undo its addition");
+
+    // The pages are reused when the dimensions do not change
+    const auto* page = cov.GetPagePtr(0);
+    cov.SetDiagonal(m_nRxPorts, NUM_RBS, noise);
+    NS_TEST_ASSERT_MSG_EQ(cov.GetPagePtr(0), page, "The pages were allocated again");
+    NS_TEST_ASSERT_MSG_EQ(cov.Elem(0, 0, 1), std::complex<double>(0.2, 0.0), "Wrong diagonal");
+    if (m_nRxPorts > 1)
+    {
+        NS_TEST_ASSERT_MSG_EQ(cov.Elem(1, 0, 1),
+                              std::complex<double>(0.0, 0.0),
+                              "The interference was not cleared");
+    }
+}
+
+/**
+ * @brief Test suite of the interference covariance matrices
+ */
+class NrCovMatTestSuite : public TestSuite
+{
+  public:
+    NrCovMatTestSuite()
+        : TestSuite("nr-test-cov-mat", Type::UNIT)
+    {
+        AddTestCase(new NrCovMatTestCase(1, 1, 1), Duration::QUICK);
+        AddTestCase(new NrCovMatTestCase(2, 4, 2), Duration::QUICK);
+        AddTestCase(new NrCovMatTestCase(4, 4, 4), Duration::QUICK);
+        AddTestCase(new NrCovMatTestCase(8, 2, 1), Duration::QUICK);
+    }
+};
+
+static NrCovMatTestSuite g_nrCovMatTestSuite; //!< Covariance matrix test suite
+
+} // namespace ns3
@@ -0,0 +1,221 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/nr-csi-batch.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <map>
+
+/**
+ * @file nr-test-csi-batch.cc
+ * @ingroup test
+ *
+ * @brief Queues the CSI searches of several UEs, served by a few AMCs, in NrCsiBatch.
+ * Checks that, for any number of threads, the feedback of each search is the one it
+ * would get if run immediately, that the feedback is delivered in the order the searches
+ * were queued, at the time they were queued, that the searches of an AMC run in the
+ * order they were queued, and that the searches queued while delivering the feedback
+ * run in a later batch of the same time stamp.
+ */
+namespace ns3
+{
+
+/**
+ * @brief A PM search whose feedback depends on the number of searches done before
+ */
+class NrCsiBatchTestPmSearch : public NrPmSearch
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param ueId the ID of the UE
+     * @param amcLog the searches done with the AMC of the UE, in order
+     */
+    NrCsiBatchTestPmSearch(uint16_t ueId, std::vector<uint16_t>* amcLog)
+        : m_ueId(ueId),
+          m_amcLog(amcLog)
+    {
+    }
+
+    void InitCodebooks() override
+    {
+    }
+
+    PmCqiInfo CreateCqiFeedbackMimo(const NrMimoSignal& rxSignalRb, PmiUpdate pmiUpdate) override
+    {
+        m_amcLog->push_back(m_ueId);
+        PmCqiInfo cqi;
+        cqi.m_wbPmi = m_ueId * 100 + m_searches++;
+        cqi.m_rank = pmiUpdate.updateWb ? 2 : 1;
+        return cqi;
+    }
+
+  private:
+    uint16_t m_ueId;                 //!< ID of the UE
+    std::vector<uint16_t>* m_amcLog; //!< Searches done with the AMC of the UE
+    size_t m_searches{0};            //!< Number of searches done
+};
+
+/**
+ * @brief Checks the feedback and the order of the searches queued in NrCsiBatch
+ */
+class NrCsiBatchTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param numThreads the NumThreads attribute
+     */
+    NrCsiBatchTestCase(uint32_t numThreads)
+        : TestCase("CSI batch with " + std::to_string(numThreads) + " threads"),
+          m_numThreads(numThreads)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /// A delivered feedback
+    struct Delivery
+    {
+        uint16_t ueId; //!< ID of the UE
+        size_t wbPmi;  //!< Wideband PMI of the feedback
+        uint8_t rank;  //!< Rank of the feedback
+        Time time;     //!< Time of the delivery
+
+        /**
+         * @param other another delivery
+         * @return whether the deliveries are equal
+         */
+        bool operator==(const Delivery& other) const
+        {
+            return ueId == other.ueId && wbPmi == other.wbPmi && rank == other.rank &&
+                   time == other.time;
+        }
+    };
+
+    /**
+     * @brief Queue a search of a UE
+     * @param ueId the ID of the UE
+     * @param updateWb whether to update the wideband PMI
+     * @param requeue whether to queue another search when the feedback is delivered
+     */
+    void Enqueue(uint16_t ueId, bool updateWb, bool requeue);
+
+    static constexpr uint16_t NUM_UES{12}; //!< Number of UEs
+    static constexpr uint16_t NUM_AMCS{3}; //!< Number of AMCs
+
+    uint32_t m_numThreads;                             //!< Number of threads
+    Ptr<NrCsiBatch> m_csiBatch;                        //!< Object under test
+    std::vector<Ptr<NrAmc>> m_amcs;                    //!< AMCs of the UEs
+    std::vector<Ptr<NrPmSearch>> m_pmSearches;         //!< Search engine of each UE
+    std::vector<std::vector<uint16_t>> m_amcLogs;      //!< Searches done with each AMC
+    std::vector<std::vector<uint16_t>> m_expectedLogs; //!< Expected searches of each AMC
+    std::map<uint16_t, size_t> m_searches;             //!< Searches queued for each UE
+    std::vector<Delivery> m_deliveries;                //!< Delivered feedback, in order
+    std::vector<Delivery> m_expectedDeliveries;        //!< Expected deliveries
+};
+
+void
+NrCsiBatchTestCase::Enqueue(uint16_t ueId, bool updateWb, bool requeue)
+{
+    auto amcId = ueId % NUM_AMCS;
+    m_expectedLogs[amcId].push_back(ueId);
+    m_expectedDeliveries.push_back(
+        {ueId, ueId * 100 + m_searches[ueId]++, static_cast<uint8_t>(updateWb ? 2 : 1),
+         Simulator::Now()});
+
+    m_csiBatch->Enqueue(m_amcs[amcId],
+                        m_pmSearches[ueId],
+                        NrMimoSignal(),
+                        NrPmSearch::PmiUpdate(updateWb, false),
+                        [this, ueId, requeue](const PmCqiInfo& cqi) {
+                            m_deliveries.push_back(
+                                {ueId, cqi.m_wbPmi, cqi.m_rank, Simulator::Now()});
+                            if (requeue)
+                            {
+                                Enqueue(ueId, false, false);
+                            }
+                        });
+}
+
+void
+NrCsiBatchTestCase::DoRun()
+{
+    m_csiBatch = CreateObject<NrCsiBatch>();
+    m_csiBatch->SetNumThreads(m_numThreads);
+    m_amcLogs.resize(NUM_AMCS);
+    m_expectedLogs.resize(NUM_AMCS);
+    for (uint16_t amcId = 0; amcId < NUM_AMCS; ++amcId)
+    {
+        m_amcs.push_back(CreateObject<NrAmc>());
+    }
+    for (uint16_t ueId = 0; ueId < NUM_UES; ++ueId)
+    {
+        m_pmSearches.push_back(
+            CreateObject<NrCsiBatchTestPmSearch>(ueId, &m_amcLogs[ueId % NUM_AMCS]));
+    }
+
+    // First time stamp: every UE queues a search, in reverse order, and some UEs two
+    Simulator::Schedule(MilliSeconds(1), [this]() {
+        for (uint16_t ueId = NUM_UES; ueId-- > 0;)
+        {
+            Enqueue(ueId, ueId % 2 == 0, false);
+            if (ueId % 4 == 0)
+            {
+                Enqueue(ueId, false, false);
+            }
+        }
+    });
+
+    // Second time stamp: the feedback of some UEs queues another search
+    Simulator::Schedule(MilliSeconds(2), [this]() {
+        for (uint16_t ueId = 0; ueId < NUM_UES; ++ueId)
+        {
+            Enqueue(ueId, true, ueId % 3 == 1);
+        }
+    });
+
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_deliveries.size(),
+                          m_expectedDeliveries.size(),
+                          "Wrong number of deliveries");
+    for (size_t i = 0; i < m_deliveries.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ((m_deliveries[i] == m_expectedDeliveries[i]),
+                              true,
+                              "Delivery " << i << " to UE " << m_deliveries[i].ueId
+                                          << " differs from the expected one to UE "
+                                          << m_expectedDeliveries[i].ueId);
+    }
+    for (uint16_t amcId = 0; amcId < NUM_AMCS; ++amcId)
+    {
+        NS_TEST_ASSERT_MSG_EQ((m_amcLogs[amcId] == m_expectedLogs[amcId]),
+                              true,
+                              "Searches of AMC " << amcId << " not in order");
+    }
+}
+
+/**
+ * @brief Test suite of NrCsiBatch
+ */
+class NrCsiBatchTestSuite : public TestSuite
+{
+  public:
+    NrCsiBatchTestSuite()
+        : TestSuite("nr-test-csi-batch", Type::UNIT)
+    {
+        for (uint32_t numThreads : {1, 2, 4})
+        {
+            AddTestCase(new NrCsiBatchTestCase(numThreads), Duration::QUICK);
+        }
+    }
+};
+
+static NrCsiBatchTestSuite g_nrCsiBatchTestSuite; //!< CSI batch test suite
+
+} // namespace ns3
@@ -0,0 +1,253 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/node.h"
+#include "ns3/nr-distributed-helper.h"
+#include "ns3/nr-spectrum-value-helper.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/test.h"
+
+/**
+ * @file nr-test-distributed-helper.cc
+ * @ingroup test
+ *
+ * @brief Checks, in a sequential simulation, the summaries of the signals that
+ * NrDistributedHelper exchanges between processes: a sequence of summaries, with and without
+ * precoding matrix, must be read back as written, and every truncation of the sequence must
+ * be detected. It also checks the minimum propagation delay between devices of different
+ * processes, which is the default lookahead.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Checks the signal summaries and the lookahead of NrDistributedHelper
+ */
+class NrDistributedHelperTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     */
+    NrDistributedHelperTestCase()
+        : TestCase("Signal summaries and lookahead of NrDistributedHelper")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Create a summary with random values
+     * @param isPrecoded whether the summary has a precoding matrix
+     * @return the summary
+     */
+    NrDistributedHelper::SignalSummary CreateSummary(bool isPrecoded) const;
+
+    /**
+     * @brief Check that a summary was read back as written
+     * @param summary the summary read
+     * @param expected the summary written
+     */
+    void CheckSummary(const NrDistributedHelper::SignalSummary& summary,
+                      const NrDistributedHelper::SignalSummary& expected);
+
+    /**
+     * @brief Check the minimum propagation delay between devices of different processes
+     */
+    void CheckMinPropagationDelay();
+
+    Ptr<UniformRandomVariable> m_rv; //!< Values of the summaries
+};
+
+NrDistributedHelper::SignalSummary
+NrDistributedHelperTestCase::CreateSummary(bool isPrecoded) const
+{
+    NrDistributedHelper::SignalSummary summary;
+    summary.phyIndex = m_rv->GetInteger(0, 100);
+    summary.type = isPrecoded ? NrDistributedHelper::SignalType::DATA
+                              : NrDistributedHelper::SignalType::UL_CTRL;
+    summary.cellId = m_rv->GetInteger(1, 1000);
+    summary.rnti = m_rv->GetInteger(1, 1000);
+    summary.txTime = NanoSeconds(m_rv->GetInteger(0, 1000000));
+    summary.duration = NanoSeconds(m_rv->GetInteger(1, 1000000));
+    summary.numRbs = 12;
+    summary.centralFrequency = 3.5e9;
+    summary.subcarrierSpacing = 30000;
+    summary.psd = Create<SpectrumValue>(NrSpectrumValueHelper::GetSpectrumModel(
+        summary.numRbs,
+        summary.centralFrequency,
+        summary.subcarrierSpacing));
+    for (auto value = summary.psd->ValuesBegin(); value != summary.psd->ValuesEnd(); ++value)
+    {
+        *value = m_rv->GetValue(1e-12, 1e-9);
+    }
+    summary.panel = m_rv->GetInteger(0, 3);
+    summary.beamformingVector = PhasedArrayModel::ComplexVector(8);
+    for (size_t i = 0; i < summary.beamformingVector.GetSize(); ++i)
+    {
+        summary.beamformingVector[i] = {m_rv->GetValue(-1, 1), m_rv->GetValue(-1, 1)};
+    }
+    if (isPrecoded)
+    {
+        auto precodingMatrix = Create<ComplexMatrixArray>(4, 2, summary.numRbs);
+        for (size_t p = 0; p < summary.numRbs; ++p)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                for (size_t j = 0; j < 2; ++j)
+                {
+                    (*precodingMatrix)(i, j, p) = {m_rv->GetValue(-1, 1), m_rv->GetValue(-1, 1)};
+                }
+            }
+        }
+        summary.precodingMatrix = precodingMatrix;
+    }
+    return summary;
+}
+
+void
+NrDistributedHelperTestCase::CheckSummary(const NrDistributedHelper::SignalSummary& summary,
+                                          const NrDistributedHelper::SignalSummary& expected)
+{
+    NS_TEST_ASSERT_MSG_EQ(summary.phyIndex, expected.phyIndex, "Wrong PHY index");
+    NS_TEST_ASSERT_MSG_EQ((summary.type == expected.type), true, "Wrong signal type");
+    NS_TEST_ASSERT_MSG_EQ(summary.cellId, expected.cellId, "Wrong cell ID");
+    NS_TEST_ASSERT_MSG_EQ(summary.rnti, expected.rnti, "Wrong RNTI");
+    NS_TEST_ASSERT_MSG_EQ(summary.txTime, expected.txTime, "Wrong transmission time");
+    NS_TEST_ASSERT_MSG_EQ(summary.duration, expected.duration, "Wrong duration");
+
+    NS_TEST_ASSERT_MSG_EQ(summary.numRbs, expected.numRbs, "Wrong number of RBs");
+    NS_TEST_ASSERT_MSG_EQ(summary.centralFrequency,
+                          expected.centralFrequency,
+                          "Wrong central frequency");
+    NS_TEST_ASSERT_MSG_EQ(summary.subcarrierSpacing,
+                          expected.subcarrierSpacing,
+                          "Wrong subcarrier spacing");
+    NS_TEST_ASSERT_MSG_EQ(summary.psd->GetSpectrumModel(),
+                          expected.psd->GetSpectrumModel(),
+                          "Wrong spectrum model of the PSD");
+    for (size_t rb = 0; rb < expected.numRbs; ++rb)
+    {
+        NS_TEST_ASSERT_MSG_EQ(summary.psd->ValuesAt(rb),
+                              expected.psd->ValuesAt(rb),
+                              "Wrong PSD of RB " << rb);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(+summary.panel, +expected.panel, "Wrong panel");
+    NS_TEST_ASSERT_MSG_EQ(summary.beamformingVector.GetSize(),
+                          expected.beamformingVector.GetSize(),
+                          "Wrong size of the beamforming vector");
+    for (size_t i = 0; i < expected.beamformingVector.GetSize(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(summary.beamformingVector[i],
+                              expected.beamformingVector[i],
+                              "Wrong beamforming vector element " << i);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(bool(summary.precodingMatrix),
+                          bool(expected.precodingMatrix),
+                          "Wrong presence of the precoding matrix");
+    if (expected.precodingMatrix)
+    {
+        NS_TEST_ASSERT_MSG_EQ((*summary.precodingMatrix == *expected.precodingMatrix),
+                              true,
+                              "Wrong precoding matrix");
+    }
+}
+
+void
+NrDistributedHelperTestCase::CheckMinPropagationDelay()
+{
+    const double speedOfLight = 299792458.0;
+    NetDeviceContainer devices;
+    auto addDevice = [&devices](uint32_t systemId, double x) {
+        auto node = CreateObject<Node>(systemId);
+        auto mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(x, 0, 10));
+        node->AggregateObject(mobility);
+        auto device = CreateObject<SimpleNetDevice>();
+        node->AddDevice(device);
+        devices.Add(device);
+    };
+
+    addDevice(0, 0);
+    addDevice(0, 100);
+    NS_TEST_ASSERT_MSG_EQ(NrDistributedHelper::GetMinPropagationDelay(devices),
+                          Time::Max(),
+                          "Devices of a single process must not need a lookahead");
+
+    // The closest devices of different processes are 300 m apart, while the ones of the same
+    // process are closer
+    addDevice(1, 400);
+    addDevice(1, 450);
+    addDevice(2, 1000);
+    NS_TEST_ASSERT_MSG_EQ(NrDistributedHelper::GetMinPropagationDelay(devices),
+                          Seconds(300 / speedOfLight),
+                          "Wrong minimum propagation delay between processes");
+}
+
+void
+NrDistributedHelperTestCase::DoRun()
+{
+    m_rv = CreateObject<UniformRandomVariable>();
+    m_rv->SetStream(1);
+
+    // A sequence of summaries, with and without precoding matrix
+    std::vector<NrDistributedHelper::SignalSummary> summaries;
+    std::vector<uint8_t> buffer;
+    std::vector<size_t> ends;
+    for (bool isPrecoded : {true, false, true})
+    {
+        summaries.push_back(CreateSummary(isPrecoded));
+        NrDistributedHelper::WriteSummary(summaries.back(), buffer);
+        ends.push_back(buffer.size());
+    }
+
+    const uint8_t* data = buffer.data();
+    const uint8_t* end = buffer.data() + buffer.size();
+    size_t begin = 0;
+    for (size_t i = 0; i < summaries.size(); ++i)
+    {
+        auto size = NrDistributedHelper::GetSummarySize(data + begin, end);
+        NS_TEST_ASSERT_MSG_EQ(size, ends[i] - begin, "Wrong size of summary " << i);
+        CheckSummary(NrDistributedHelper::ReadSummary(data + begin, data + begin + size),
+                     summaries[i]);
+
+        // Any truncation of the summary is detected
+        for (size_t truncatedEnd = begin; truncatedEnd < ends[i]; ++truncatedEnd)
+        {
+            NS_TEST_ASSERT_MSG_EQ(NrDistributedHelper::GetSummarySize(data + begin,
+                                                                      data + truncatedEnd),
+                                  0,
+                                  "Summary " << i << " truncated at " << truncatedEnd
+                                             << " not detected");
+        }
+        begin = ends[i];
+    }
+
+    CheckMinPropagationDelay();
+    Simulator::Destroy();
+}
+
+/**
+ * @brief Test suite of NrDistributedHelper
+ */
+class NrDistributedHelperTestSuite : public TestSuite
+{
+  public:
+    NrDistributedHelperTestSuite()
+        : TestSuite("nr-test-distributed-helper", Type::UNIT)
+    {
+        AddTestCase(new NrDistributedHelperTestCase(), Duration::QUICK);
+    }
+};
+
+static NrDistributedHelperTestSuite g_nrDistributedHelperTestSuite; //!< Distributed helper suite
+
+} // namespace ns3
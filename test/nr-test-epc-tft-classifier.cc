@@ -193,6 +193,68 @@ NrEpcTftClassifierTestCase::DoRun()
     NS_TEST_ASSERT_MSG_EQ(obtainedTftId, (uint16_t)m_tftId, "bad classification of UDP packet");
 }
 
+/**
+ * @ingroup nr-test
+ *
+ * @brief Test case to check that the classification of a flow follows the changes of the
+ * TFTs, i.e. that the compiled filters and the cached results of the flows are updated when
+ * a TFT is added or deleted, and when a filter is added to a TFT that is already in use.
+ */
+class NrEpcTftClassifierUpdateTestCase : public TestCase
+{
+  public:
+    NrEpcTftClassifierUpdateTestCase()
+        : TestCase("Classification after changes of the TFTs")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrEpcTftClassifierUpdateTestCase::DoRun()
+{
+    UdpHeader udpHeader;
+    udpHeader.SetSourcePort(1234);
+    udpHeader.SetDestinationPort(5678);
+    Ipv4Header ipHeader;
+    ipHeader.SetSource(Ipv4Address("1.1.1.1"));
+    ipHeader.SetDestination(Ipv4Address("7.0.0.1"));
+    ipHeader.SetPayloadSize(8);
+    ipHeader.SetProtocol(UdpL4Protocol::PROT_NUMBER);
+    Ptr<Packet> packet = Create<Packet>();
+    packet->AddHeader(udpHeader);
+    packet->AddHeader(ipHeader);
+
+    Ptr<NrEpcTftClassifier> c = Create<NrEpcTftClassifier>();
+    auto classify = [&]() {
+        return c->Classify(packet, NrEpcTft::DOWNLINK, Ipv4L3Protocol::PROT_NUMBER);
+    };
+
+    NS_TEST_ASSERT_MSG_EQ(classify(), 0, "No TFT should match");
+
+    c->Add(NrEpcTft::Default(), 1);
+    NS_TEST_ASSERT_MSG_EQ(classify(), 1, "The default TFT should match");
+
+    Ptr<NrEpcTft> tft = Create<NrEpcTft>();
+    NrEpcTft::PacketFilter otherPort;
+    otherPort.localPortStart = 80;
+    otherPort.localPortEnd = 80;
+    tft->Add(otherPort);
+    c->Add(tft, 2);
+    NS_TEST_ASSERT_MSG_EQ(classify(), 1, "The dedicated TFT should not match yet");
+
+    NrEpcTft::PacketFilter flowPort;
+    flowPort.localPortStart = 5678;
+    flowPort.localPortEnd = 5678;
+    tft->Add(flowPort);
+    NS_TEST_ASSERT_MSG_EQ(classify(), 2, "The filter added to the dedicated TFT is ignored");
+
+    c->Delete(2);
+    NS_TEST_ASSERT_MSG_EQ(classify(), 1, "The deleted TFT should not match");
+}
+
 /**
  * @ingroup nr-test
  *
@@ -1005,4 +1067,6 @@ NrEpcTftClassifierTestSuite::NrEpcTftClassifierTestSuite()
                                                    useIpv6),
                     TestCase::Duration::QUICK);
     }
+
+    AddTestCase(new NrEpcTftClassifierUpdateTestCase(), TestCase::Duration::QUICK);
 }
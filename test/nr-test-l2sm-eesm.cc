@@ -2,13 +2,22 @@
 //
 // SPDX-License-Identifier: GPL-2.0-only
 
+#include "ns3/boolean.h"
 #include "ns3/enum.h"
+#include "ns3/nr-amc.h"
 #include "ns3/nr-eesm-cc-t1.h"
 #include "ns3/nr-eesm-cc-t2.h"
 #include "ns3/nr-eesm-error-model.h"
+#include "ns3/nr-eesm-exp-sum.h"
 #include "ns3/nr-eesm-ir-t1.h"
 #include "ns3/nr-eesm-ir-t2.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
 
 /**
  * @file nr-test-l2sm-eesm.cc
@@ -17,7 +26,14 @@
  * @brief This test validates specific functions of the NR PHY abstraction model.
  * The test checks two issues: 1) LDPC base graph (BG) selection works properly, and 2)
  * BLER values are properly obtained from the BLER-SINR look up tables for different
- * block sizes, MCS Tables, BG types, and SINR values.
+ * block sizes, MCS Tables, BG types, and SINR values. It also checks that the
+ * vectorized sums of exponential SINRs stay within the error bound of exp21d. A
+ * second test checks that the vectorized implementations of the sums that the CPU
+ * supports give the same sums as the scalar one. A third test checks that the MCS
+ * selected through the SINR threshold table of NrAmc is the same as the one selected
+ * by evaluating the TBLER of every MCS, and a fourth one that the TB sizes memoized by
+ * NrAmc follow the changes of its configuration. A last test checks that the MCS found
+ * by bisection is within the TBLER target, while the next MCS is not.
  *
  */
 namespace ns3
@@ -48,6 +64,7 @@ class NrL2smEesmTestCase : public TestCase
     void TestMappingSinrBler2(const Ptr<NrEesmErrorModel>& em);
     void TestBgType1(const Ptr<NrEesmErrorModel>& em);
     void TestBgType2(const Ptr<NrEesmErrorModel>& em);
+    void TestSinrExp(const Ptr<NrEesmErrorModel>& em);
 
     void TestEesmCcTable1();
     void TestEesmCcTable2();
@@ -210,6 +227,63 @@ NrL2smEesmTestCase::TestMappingSinrBler2(const Ptr<NrEesmErrorModel>& em)
     }
 }
 
+void
+NrL2smEesmTestCase::TestSinrExp(const Ptr<NrEesmErrorModel>& em)
+{
+    // The vectorized sum of exponential SINRs must stay within the error bound of exp21d
+    // (relative error < 0.173%), and the batched sums must be equal to the single ones
+    const double maxRelError = 0.00173;
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(2);
+
+    std::vector<double> betas(*em->GetBetaTable());
+    std::sort(betas.begin(), betas.end());
+    betas.erase(std::unique(betas.begin(), betas.end()), betas.end());
+
+    for (uint32_t run = 0; run < 100; ++run)
+    {
+        auto nRbs = rv->GetInteger(1, 300);
+        std::vector<BandInfo> bands(nRbs);
+        auto sinr = SpectrumValue(Create<SpectrumModel>(bands));
+        for (uint32_t rb = 0; rb < nRbs; ++rb)
+        {
+            sinr[rb] = std::pow(10.0, rv->GetValue(-20.0, 35.0) / 10.0);
+        }
+        std::vector<int> map(rv->GetInteger(1, nRbs));
+        for (auto& rb : map)
+        {
+            rb = static_cast<int>(rv->GetInteger(0, nRbs - 1));
+        }
+
+        auto batch = em->SinrExpBatch(sinr, map, betas);
+        auto sinrEff = em->GetSinrEffPerMcs(sinr, map);
+        for (uint8_t mcs = 0; mcs <= em->GetMaxMcs(); ++mcs)
+        {
+            double beta = em->GetBetaTable()->at(mcs);
+            double ref = 0.0;
+            for (int rb : map)
+            {
+                ref += std::exp(-sinr[rb] / beta);
+            }
+            double sinrExp = em->SinrExp(sinr, map, mcs);
+            // exp21d returns 0 below -708, so each RB can also miss up to exp (-708)
+            NS_TEST_ASSERT_MSG_EQ_TOL(sinrExp,
+                                      ref,
+                                      ref * maxRelError + map.size() * std::exp(-708.0),
+                                      "TestSinrExp: exponential sum out of the exp21d error bound");
+
+            auto it = std::find(betas.begin(), betas.end(), beta);
+            NS_TEST_ASSERT_MSG_EQ(batch.at(std::distance(betas.begin(), it)),
+                                  sinrExp,
+                                  "TestSinrExp: batched sum differs from the single one");
+            NS_TEST_ASSERT_MSG_EQ(sinrEff.at(mcs),
+                                  em->SinrEff(sinr, map, mcs, 0, map.size()),
+                                  "TestSinrExp: batched effective SINR differs from the single "
+                                  "one");
+        }
+    }
+}
+
 void
 NrL2smEesmTestCase::TestEesmCcTable1()
 {
@@ -223,6 +297,7 @@ NrL2smEesmTestCase::TestEesmCcTable1()
     // Test here the functions:
     TestBgType1(em);
     TestMappingSinrBler1(em);
+    TestSinrExp(em);
 }
 
 void
@@ -238,6 +313,7 @@ NrL2smEesmTestCase::TestEesmCcTable2()
     // Test here the functions:
     TestBgType2(em);
     TestMappingSinrBler2(em);
+    TestSinrExp(em);
 }
 
 void
@@ -253,6 +329,7 @@ NrL2smEesmTestCase::TestEesmIrTable1()
     // Test here the functions:
     TestBgType1(em);
     TestMappingSinrBler1(em);
+    TestSinrExp(em);
 }
 
 void
@@ -268,6 +345,7 @@ NrL2smEesmTestCase::TestEesmIrTable2()
     // Test here the functions:
     TestBgType2(em);
     TestMappingSinrBler2(em);
+    TestSinrExp(em);
 }
 
 void
@@ -279,6 +357,349 @@ NrL2smEesmTestCase::DoRun()
     TestEesmIrTable2();
 }
 
+/**
+ * @brief Check that the vectorized implementations of NrEesmExpSums() that the CPU supports
+ * give the same sums as the scalar one, bit by bit, including the RBs of the tail that do not
+ * fill a vector
+ */
+class NrEesmExpSumsTestCase : public TestCase
+{
+  public:
+    NrEesmExpSumsTestCase()
+        : TestCase("Vectorized EESM exponential sums against the scalar ones")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrEesmExpSumsTestCase::DoRun()
+{
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(3);
+
+    std::vector<double> betas(*CreateObject<NrEesmCcT1>()->GetBetaTable());
+    std::sort(betas.begin(), betas.end());
+    betas.erase(std::unique(betas.begin(), betas.end()), betas.end());
+    auto implementations = NrEesmExpSumsImplementations();
+    NS_TEST_ASSERT_MSG_EQ(implementations.back(), "scalar", "The scalar kernel must be the last");
+    NS_TEST_ASSERT_MSG_EQ(implementations.front(),
+                          std::string(NrEesmExpSumsImplementation()),
+                          "NrEesmExpSums() must use the first kernel");
+
+    std::vector<size_t> mapSizes;
+    for (size_t mapSize = 1; mapSize <= 40; ++mapSize)
+    {
+        mapSizes.push_back(mapSize);
+    }
+    for (uint32_t run = 0; run < 60; ++run)
+    {
+        // Random sizes that do not fill the 8 partial sums
+        mapSizes.push_back(8 * rv->GetInteger(5, 37) + rv->GetInteger(1, 7));
+    }
+
+    for (size_t mapSize : mapSizes)
+    {
+        // SINRs up to 60 dB, so that some exponents are below the range of exp21d
+        std::vector<double> sinr(mapSize + 8);
+        for (auto& value : sinr)
+        {
+            value = std::pow(10.0, rv->GetValue(-20.0, 60.0) / 10.0);
+        }
+        std::vector<int> map(mapSize);
+        for (auto& rb : map)
+        {
+            rb = static_cast<int>(rv->GetInteger(0, sinr.size() - 1));
+        }
+
+        std::vector<double> scalar(betas.size());
+        NrEesmExpSumsWith("scalar",
+                          sinr.data(),
+                          map.data(),
+                          map.size(),
+                          betas.data(),
+                          betas.size(),
+                          scalar.data());
+        for (const auto& implementation : implementations)
+        {
+            std::vector<double> sums(betas.size());
+            NrEesmExpSumsWith(implementation,
+                              sinr.data(),
+                              map.data(),
+                              map.size(),
+                              betas.data(),
+                              betas.size(),
+                              sums.data());
+            for (size_t b = 0; b < betas.size(); ++b)
+            {
+                NS_TEST_ASSERT_MSG_EQ(sums[b],
+                                      scalar[b],
+                                      "The " << implementation << " sum of " << mapSize
+                                             << " RBs differs from the scalar one");
+            }
+        }
+    }
+}
+
+/**
+ * @brief Check that the SINR threshold table of NrAmc selects the same MCS (and CQI) as
+ * the evaluation of the TBLER of every MCS, over random SINR vectors and matrices
+ */
+class NrEesmSinrThresholdTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Create the test case
+     * @param errorModelType the EESM error model to test
+     */
+    NrEesmSinrThresholdTestCase(const TypeId& errorModelType)
+        : TestCase("SINR threshold table for " + errorModelType.GetName()),
+          m_errorModelType(errorModelType)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Create an AMC with the error model under test
+     * @param useSinrThresholdTable value of the UseSinrThresholdTable attribute
+     * @return the AMC
+     */
+    Ptr<NrAmc> CreateAmc(bool useSinrThresholdTable) const;
+
+    TypeId m_errorModelType; //!< The EESM error model to test
+};
+
+Ptr<NrAmc>
+NrEesmSinrThresholdTestCase::CreateAmc(bool useSinrThresholdTable) const
+{
+    Ptr<NrAmc> amc = CreateObject<NrAmc>();
+    amc->SetAttribute("ErrorModelType", TypeIdValue(m_errorModelType));
+    amc->SetAttribute("UseSinrThresholdTable", BooleanValue(useSinrThresholdTable));
+    return amc;
+}
+
+void
+NrEesmSinrThresholdTestCase::DoRun()
+{
+    Ptr<NrAmc> amcScan = CreateAmc(false);
+    Ptr<NrAmc> amcThreshold = CreateAmc(true);
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+
+    const uint32_t numRuns = 300;
+    for (uint32_t run = 0; run < numRuns; ++run)
+    {
+        // SISO: random number of RBs, with some of them without signal
+        auto nRbs = rv->GetInteger(1, 100);
+        std::vector<BandInfo> bands(nRbs);
+        auto sinr = SpectrumValue(Create<SpectrumModel>(bands));
+        for (uint32_t rb = 0; rb < nRbs; ++rb)
+        {
+            bool noSignal = rb != 0 && rv->GetValue() < 0.1;
+            sinr[rb] = noSignal ? 0.0 : std::pow(10.0, rv->GetValue(-10.0, 35.0) / 10.0);
+        }
+
+        uint8_t mcsScan = 0;
+        uint8_t mcsThreshold = 0;
+        auto cqiScan = amcScan->CreateCqiFeedbackSiso(sinr, mcsScan);
+        auto cqiThreshold = amcThreshold->CreateCqiFeedbackSiso(sinr, mcsThreshold);
+        NS_TEST_ASSERT_MSG_EQ(+mcsThreshold,
+                              +mcsScan,
+                              "SISO MCS differs with the SINR threshold table, run " << run);
+        NS_TEST_ASSERT_MSG_EQ(+cqiThreshold,
+                              +cqiScan,
+                              "SISO CQI differs with the SINR threshold table, run " << run);
+
+        // MIMO: random rank, with SINR matrices (rank x nRbs)
+        auto rank = static_cast<uint8_t>(rv->GetInteger(1, 4));
+        NrSinrMatrix sinrMat(rank, nRbs);
+        for (uint8_t layer = 0; layer < rank; ++layer)
+        {
+            for (uint32_t rb = 0; rb < nRbs; ++rb)
+            {
+                sinrMat(layer, rb) = std::pow(10.0, rv->GetValue(-10.0, 35.0) / 10.0);
+            }
+        }
+        const size_t subbandSize = 8;
+        auto paramsScan = amcScan->GetMaxMcsParams(sinrMat, subbandSize);
+        auto paramsThreshold = amcThreshold->GetMaxMcsParams(sinrMat, subbandSize);
+        NS_TEST_ASSERT_MSG_EQ(+paramsThreshold.mcs,
+                              +paramsScan.mcs,
+                              "MIMO MCS differs with the SINR threshold table, run " << run);
+        NS_TEST_ASSERT_MSG_EQ(+paramsThreshold.wbCqi,
+                              +paramsScan.wbCqi,
+                              "MIMO CQI differs with the SINR threshold table, run " << run);
+        NS_TEST_ASSERT_MSG_EQ(paramsThreshold.tbSize,
+                              paramsScan.tbSize,
+                              "MIMO TB size differs with the SINR threshold table, run " << run);
+        NS_TEST_ASSERT_MSG_EQ((paramsThreshold.sbCqis == paramsScan.sbCqis),
+                              true,
+                              "MIMO subband CQIs differ with the SINR threshold table, run "
+                                  << run);
+    }
+}
+
+/**
+ * @brief Check that the TB sizes memoized by NrAmc are the same as the ones computed by
+ * a new AMC with the same configuration, when the mode and the number of reference
+ * subcarriers change
+ */
+class NrAmcTbSizeMemoTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Create the test case
+     * @param errorModelType the error model of the AMC
+     */
+    NrAmcTbSizeMemoTestCase(const TypeId& errorModelType)
+        : TestCase("TB size memo for " + errorModelType.GetName()),
+          m_errorModelType(errorModelType)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Create an AMC with the error model under test
+     * @param ul true for UL mode, false for DL mode
+     * @param numRefScPerRb value of the NumRefScPerRb attribute
+     * @return the AMC
+     */
+    Ptr<NrAmc> CreateAmc(bool ul, uint8_t numRefScPerRb) const;
+
+    TypeId m_errorModelType; //!< The error model of the AMC
+};
+
+Ptr<NrAmc>
+NrAmcTbSizeMemoTestCase::CreateAmc(bool ul, uint8_t numRefScPerRb) const
+{
+    Ptr<NrAmc> amc = CreateObject<NrAmc>();
+    amc->SetAttribute("ErrorModelType", TypeIdValue(m_errorModelType));
+    amc->SetAttribute("NumRefScPerRb", UintegerValue(numRefScPerRb));
+    if (ul)
+    {
+        amc->SetUlMode();
+    }
+    else
+    {
+        amc->SetDlMode();
+    }
+    return amc;
+}
+
+void
+NrAmcTbSizeMemoTestCase::DoRun()
+{
+    ObjectFactory factory;
+    factory.SetTypeId(m_errorModelType);
+    const uint8_t maxMcs = DynamicCast<NrErrorModel>(factory.Create())->GetMaxMcs();
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+
+    // A few numbers of RBs, so that most of the requests are served by the memo
+    std::vector<uint32_t> nprbs;
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        nprbs.push_back(rv->GetInteger(1, 275 * 14));
+    }
+
+    Ptr<NrAmc> memoAmc = CreateAmc(false, 1);
+    for (const auto& [ul, numRefScPerRb] :
+         std::vector<std::pair<bool, uint8_t>>{{false, 1}, {true, 1}, {true, 4}, {false, 1}})
+    {
+        if (ul)
+        {
+            memoAmc->SetUlMode();
+        }
+        else
+        {
+            memoAmc->SetDlMode();
+        }
+        memoAmc->SetAttribute("NumRefScPerRb", UintegerValue(numRefScPerRb));
+
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            auto mcs = static_cast<uint8_t>(rv->GetInteger(0, maxMcs));
+            auto rank = static_cast<uint8_t>(rv->GetInteger(1, 4));
+            auto nprb = nprbs.at(rv->GetInteger(0, nprbs.size() - 1));
+            uint32_t expected = CreateAmc(ul, numRefScPerRb)->CalculateTbSize(mcs, rank, nprb);
+            NS_TEST_ASSERT_MSG_EQ(memoAmc->CalculateTbSize(mcs, rank, nprb),
+                                  expected,
+                                  "Memoized TB size differs for MCS " << +mcs << ", rank " << +rank
+                                                                      << ", " << nprb << " RBs");
+        }
+    }
+}
+
+/**
+ * @brief Check that the MCS found by NrAmc with bisection is within the TBLER target,
+ * and that the next MCS is out of target
+ */
+class NrAmcMcsBisectionTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Create the test case
+     * @param errorModelType the error model of the AMC
+     */
+    NrAmcMcsBisectionTestCase(const TypeId& errorModelType)
+        : TestCase("MCS bisection for " + errorModelType.GetName()),
+          m_errorModelType(errorModelType)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    TypeId m_errorModelType; //!< The error model of the AMC
+};
+
+void
+NrAmcMcsBisectionTestCase::DoRun()
+{
+    Ptr<NrAmc> amc = CreateObject<NrAmc>();
+    amc->SetAttribute("ErrorModelType", TypeIdValue(m_errorModelType));
+    const auto maxMcs = amc->m_errorModel->GetMaxMcs();
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+
+    for (uint32_t run = 0; run < 100; ++run)
+    {
+        auto nRbs = rv->GetInteger(1, 100);
+        auto rank = static_cast<uint8_t>(rv->GetInteger(1, 4));
+        NrSinrMatrix sinrMat(rank, nRbs);
+        for (uint8_t layer = 0; layer < rank; ++layer)
+        {
+            for (uint32_t rb = 0; rb < nRbs; ++rb)
+            {
+                sinrMat(layer, rb) = std::pow(10.0, rv->GetValue(-10.0, 35.0) / 10.0);
+            }
+        }
+
+        auto mcs = amc->GetMcs(sinrMat, true);
+        auto withinTarget = amc->CalcTblerForMimoMatrix(mcs, sinrMat) <= 0.1;
+        if (mcs == 0 && !withinTarget)
+        {
+            continue;
+        }
+        NS_TEST_ASSERT_MSG_EQ(withinTarget, true, "Bisected MCS out of target, run " << run);
+        if (mcs < maxMcs)
+        {
+            NS_TEST_ASSERT_MSG_GT(amc->CalcTblerForMimoMatrix(mcs + 1, sinrMat),
+                                  0.1,
+                                  "MCS after the bisected one within target, run " << run);
+        }
+    }
+}
+
 class NrTestL2smEesm : public TestSuite
 {
   public:
@@ -286,6 +707,16 @@ class NrTestL2smEesm : public TestSuite
         : TestSuite("nr-test-l2sm-eesm", Type::UNIT)
     {
         AddTestCase(new NrL2smEesmTestCase("First test"), Duration::QUICK);
+        AddTestCase(new NrEesmExpSumsTestCase(), Duration::QUICK);
+        for (const auto& type : {NrEesmIrT1::GetTypeId(),
+                                 NrEesmIrT2::GetTypeId(),
+                                 NrEesmCcT1::GetTypeId(),
+                                 NrEesmCcT2::GetTypeId()})
+        {
+            AddTestCase(new NrEesmSinrThresholdTestCase(type), Duration::QUICK);
+            AddTestCase(new NrAmcTbSizeMemoTestCase(type), Duration::QUICK);
+            AddTestCase(new NrAmcMcsBisectionTestCase(type), Duration::QUICK);
+        }
     }
 };
 
@@ -0,0 +1,282 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/nr-interference.h"
+#include "ns3/nr-mimo-chunk-processor.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+/**
+ * @file nr-test-mimo-interference.cc
+ * @ingroup test
+ *
+ * @brief Checks the running sum of the covariance of the MIMO interferers of NrInterference.
+ * Overlapping interferers, with and without precoding, start and end during three receptions,
+ * one of them of a signal that was an interferer and that becomes one again after its
+ * reception. The interference-plus-noise covariance of each chunk, given to the MIMO chunk
+ * processor, must be the one computed from scratch with the interferers of the chunk, for
+ * several values of MimoCovRecomputeInterval.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Compares the covariance of each chunk with the one computed from the interferers
+ */
+class NrMimoInterferenceCovTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param recomputeInterval the MimoCovRecomputeInterval attribute
+     */
+    NrMimoInterferenceCovTestCase(uint32_t recomputeInterval)
+        : TestCase("MIMO interference covariance recomputed every " +
+                   std::to_string(recomputeInterval) + " updates"),
+          m_recomputeInterval(recomputeInterval)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Create a signal with a random channel, and add it to the interference at its start
+     * @param startUs the start time of the signal (us)
+     * @param endUs the end time of the signal (us)
+     * @param isPrecoded whether the signal has a precoding matrix
+     * @return the index of the signal
+     */
+    size_t AddSignal(int64_t startUs, int64_t endUs, bool isPrecoded);
+
+    /**
+     * @brief Receive a signal between two times
+     * @param signal the index of the signal
+     * @param startUs the start time of the reception (us)
+     * @param endUs the end time of the reception (us)
+     */
+    void Receive(size_t signal, int64_t startUs, int64_t endUs);
+
+    /**
+     * @brief Check the covariance of the chunks of a reception
+     * @param chunks the chunks of the reception
+     */
+    void CheckChunks(const std::vector<MimoSignalChunk>& chunks);
+
+    /**
+     * @brief Create a matrix array with random complex elements
+     * @param nRows the number of rows
+     * @param nCols the number of columns
+     * @return the matrix array
+     */
+    Ptr<ComplexMatrixArray> CreateRandomMatrix(size_t nRows, size_t nCols) const;
+
+    /// A signal seen by the interference
+    struct Signal
+    {
+        Time start;                           //!< Start of the signal
+        Time end;                             //!< End of the signal
+        Ptr<SpectrumSignalParameters> params; //!< Parameters of the signal
+    };
+
+    static constexpr size_t NUM_RX_PORTS{2}; //!< Number of receive ports
+    static constexpr size_t NUM_TX_PORTS{4}; //!< Number of transmit ports of the signals
+    static constexpr size_t RANK{2};         //!< Rank of the precoded signals
+    static constexpr size_t NUM_RBS{6};      //!< Number of RBs of the signals
+
+    uint32_t m_recomputeInterval;       //!< The MimoCovRecomputeInterval attribute
+    Ptr<NrInterference> m_interference; //!< Object under test
+    Ptr<SpectrumValue> m_noise;         //!< Noise PSD
+    Ptr<UniformRandomVariable> m_rv;    //!< Elements of the matrices
+    std::vector<Signal> m_signals;      //!< All the signals
+    size_t m_rxSignal{0};               //!< Index of the signal being received
+    Time m_rxStart;                     //!< Start of the current reception
+    size_t m_numReceptions{0};          //!< Receptions whose chunks were checked
+};
+
+Ptr<ComplexMatrixArray>
+NrMimoInterferenceCovTestCase::CreateRandomMatrix(size_t nRows, size_t nCols) const
+{
+    auto mat = Create<ComplexMatrixArray>(nRows, nCols, NUM_RBS);
+    for (size_t p = 0; p < NUM_RBS; p++)
+    {
+        for (size_t j = 0; j < nCols; j++)
+        {
+            for (size_t i = 0; i < nRows; i++)
+            {
+                (*mat)(i, j, p) = std::complex<double>{m_rv->GetValue(), m_rv->GetValue()};
+            }
+        }
+    }
+    return mat;
+}
+
+size_t
+NrMimoInterferenceCovTestCase::AddSignal(int64_t startUs, int64_t endUs, bool isPrecoded)
+{
+    auto params = Create<SpectrumSignalParameters>();
+    params->psd = m_noise->Copy();
+    *params->psd = 1.0;
+    params->duration = MicroSeconds(endUs - startUs);
+    params->spectrumChannelMatrix = CreateRandomMatrix(NUM_RX_PORTS, NUM_TX_PORTS);
+    if (isPrecoded)
+    {
+        params->precodingMatrix = CreateRandomMatrix(NUM_TX_PORTS, RANK);
+    }
+    m_signals.push_back({MicroSeconds(startUs), MicroSeconds(endUs), params});
+    Simulator::Schedule(MicroSeconds(startUs),
+                        &NrInterference::AddSignalMimo,
+                        m_interference,
+                        params,
+                        params->duration);
+    return m_signals.size() - 1;
+}
+
+void
+NrMimoInterferenceCovTestCase::Receive(size_t signal, int64_t startUs, int64_t endUs)
+{
+    Simulator::Schedule(MicroSeconds(startUs), [this, signal]() {
+        m_rxSignal = signal;
+        m_rxStart = Simulator::Now();
+        m_interference->StartRxMimo(m_signals[signal].params);
+    });
+    Simulator::Schedule(MicroSeconds(endUs), &NrInterference::EndRx, m_interference);
+}
+
+void
+NrMimoInterferenceCovTestCase::CheckChunks(const std::vector<MimoSignalChunk>& chunks)
+{
+    NS_TEST_ASSERT_MSG_GT(chunks.size(), 0, "No chunk in the reception");
+    ++m_numReceptions;
+
+    auto chunkStart = m_rxStart;
+    for (const auto& chunk : chunks)
+    {
+        // The covariance of the interferers of the chunk, from scratch, plus noise
+        ComplexMatrixArray expected{NUM_RX_PORTS, NUM_RX_PORTS, NUM_RBS};
+        for (size_t p = 0; p < NUM_RBS; p++)
+        {
+            for (size_t i = 0; i < NUM_RX_PORTS; i++)
+            {
+                expected(i, i, p) = m_noise->ValuesAt(p);
+            }
+        }
+        for (size_t s = 0; s < m_signals.size(); s++)
+        {
+            const auto& signal = m_signals[s];
+            if (s == m_rxSignal || signal.start > chunkStart || signal.end <= chunkStart)
+            {
+                continue;
+            }
+            auto chanMat = *signal.params->spectrumChannelMatrix;
+            if (signal.params->precodingMatrix)
+            {
+                chanMat = chanMat * *signal.params->precodingMatrix;
+            }
+            for (size_t p = 0; p < NUM_RBS; p++)
+            {
+                for (size_t i = 0; i < NUM_RX_PORTS; i++)
+                {
+                    for (size_t k = 0; k < NUM_RX_PORTS; k++)
+                    {
+                        for (size_t l = 0; l < chanMat.GetNumCols(); l++)
+                        {
+                            expected(i, k, p) += chanMat(i, l, p) * std::conj(chanMat(k, l, p));
+                        }
+                    }
+                }
+            }
+        }
+
+        const auto& cov = chunk.interfNoiseCov;
+        NS_TEST_ASSERT_MSG_EQ(cov.GetNumRows(), NUM_RX_PORTS, "Wrong covariance dimensions");
+        NS_TEST_ASSERT_MSG_EQ(cov.GetNumPages(), NUM_RBS, "Wrong covariance dimensions");
+        for (size_t p = 0; p < NUM_RBS; p++)
+        {
+            for (size_t i = 0; i < NUM_RX_PORTS; i++)
+            {
+                for (size_t k = 0; k < NUM_RX_PORTS; k++)
+                {
+                    NS_TEST_ASSERT_MSG_LT(std::abs(cov(i, k, p) - expected(i, k, p)),
+                                          1e-12 * (1 + std::abs(expected(i, i, p))),
+                                          "Wrong covariance of the chunk at "
+                                              << chunkStart.As(Time::US) << ", RB " << p);
+                }
+            }
+        }
+        chunkStart += chunk.dur;
+    }
+}
+
+void
+NrMimoInterferenceCovTestCase::DoRun()
+{
+    m_rv = CreateObject<UniformRandomVariable>();
+    m_rv->SetStream(1);
+
+    std::vector<double> centerFrequencies;
+    for (size_t rb = 0; rb < NUM_RBS; ++rb)
+    {
+        centerFrequencies.push_back(3.5e9 + rb * 180e3);
+    }
+    m_noise = Create<SpectrumValue>(Create<SpectrumModel>(centerFrequencies));
+    *m_noise = 1e-2;
+
+    m_interference = CreateObject<NrInterference>();
+    m_interference->SetAttribute("MimoCovRecomputeInterval", UintegerValue(m_recomputeInterval));
+    m_interference->SetNoisePowerSpectralDensity(m_noise);
+    auto chunkProcessor = Create<NrMimoChunkProcessor>();
+    chunkProcessor->AddCallback(MakeCallback(&NrMimoInterferenceCovTestCase::CheckChunks, this));
+    m_interference->AddMimoChunkProcessor(chunkProcessor);
+
+    // First reception, with overlapping interferers that start and end during it
+    auto first = AddSignal(0, 10, true);
+    AddSignal(0, 30, true);
+    AddSignal(0, 12, false);
+    AddSignal(2, 7, true);
+    auto second = AddSignal(3, 25, true);
+    AddSignal(4, 20, false);
+    AddSignal(6, 8, true);
+    Receive(first, 0, 10);
+
+    // Second reception, of a signal that was an interferer during the first one
+    AddSignal(12, 14, true);
+    AddSignal(13, 18, false);
+    AddSignal(15, 16, true);
+    AddSignal(16, 30, true);
+    Receive(second, 11, 22);
+
+    // Third reception, during which the second received signal is an interferer again
+    auto third = AddSignal(23, 28, true);
+    AddSignal(24, 26, true);
+    Receive(third, 23, 28);
+
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_ASSERT_MSG_EQ(m_numReceptions, 3, "Wrong number of receptions");
+}
+
+/**
+ * @brief Test suite of the MIMO interference of NrInterference
+ */
+class NrMimoInterferenceTestSuite : public TestSuite
+{
+  public:
+    NrMimoInterferenceTestSuite()
+        : TestSuite("nr-test-mimo-interference", Type::UNIT)
+    {
+        for (uint32_t recomputeInterval : {0, 1, 3, 64})
+        {
+            AddTestCase(new NrMimoInterferenceCovTestCase(recomputeInterval), Duration::QUICK);
+        }
+    }
+};
+
+static NrMimoInterferenceTestSuite g_nrMimoInterferenceTestSuite; //!< MIMO interference suite
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_TEST_NUM_THREADS_H
+#define NR_TEST_NUM_THREADS_H
+
+#include "ns3/test.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * @file nr-test-num-threads.h
+ * @ingroup test
+ *
+ * @brief Base of the test cases that check that a scenario run with several threads gives
+ * the same results as with a single thread.
+ */
+
+/**
+ * @brief Runs a scenario with one thread and with several, and compares their results
+ *
+ * The scenario is run by RunScenario(), which must create all its objects again, so that
+ * both runs start from the same state. Its results, e.g., the feedback or the traces in
+ * the order they were produced, are compared one by one with CheckEqual().
+ *
+ * @tparam Result the type of each result of the scenario
+ */
+template <typename Result>
+class NrNumThreadsTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param name the name of the scenario
+     * @param numThreads the number of threads compared with a single one
+     */
+    NrNumThreadsTestCase(const std::string& name, uint32_t numThreads)
+        : TestCase(name + " with " + std::to_string(numThreads) + " threads"),
+          m_numThreads(numThreads)
+    {
+    }
+
+  protected:
+    /**
+     * @brief Run the scenario
+     * @param numThreads the number of threads
+     * @return the results of the scenario, in the order they were produced
+     */
+    virtual std::vector<Result> RunScenario(uint32_t numThreads) = 0;
+
+    /**
+     * @brief Check the results of the run with a single thread, e.g., their number
+     * @param results the results
+     */
+    virtual void CheckScenario([[maybe_unused]] const std::vector<Result>& results)
+    {
+    }
+
+    /**
+     * @brief Check that a result with several threads is the one with a single thread
+     * @param result the result with several threads
+     * @param expected the result with a single thread
+     * @param index the index of the result
+     */
+    virtual void CheckEqual(const Result& result, const Result& expected, size_t index) = 0;
+
+  private:
+    void DoRun() override
+    {
+        auto expected = RunScenario(1);
+        auto results = RunScenario(m_numThreads);
+
+        CheckScenario(expected);
+        if (IsStatusFailure())
+        {
+            return;
+        }
+        NS_TEST_ASSERT_MSG_EQ(results.size(), expected.size(), "Different number of results");
+        for (size_t i = 0; i < results.size() && !IsStatusFailure(); ++i)
+        {
+            CheckEqual(results[i], expected[i], i);
+        }
+    }
+
+    uint32_t m_numThreads; //!< Number of threads compared with a single one
+};
+
+} // namespace ns3
+
+#endif // NR_TEST_NUM_THREADS_H
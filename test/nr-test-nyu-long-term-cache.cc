@@ -0,0 +1,221 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/beamforming-vector.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/node.h"
+#include "ns3/nyu-channel-model.h"
+#include "ns3/nyu-spectrum-propagation-loss-model.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+#include "ns3/uniform-planar-array.h"
+
+/**
+ * @file nr-test-nyu-long-term-cache.cc
+ * @ingroup test
+ *
+ * @brief Checks the cache of long term components of NYUSpectrumPropagationLossModel. The gNB
+ * alternates between two beams toward a UE, and the long term component of a beam must be found
+ * in the cache when the gNB returns to it, unless the cache holds a single component per link.
+ * The received PSD of a cached component must be the same as the one computed with it. All the
+ * components of the link are discarded when the channel is updated.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Checks the hits and misses of the cache of long term components
+ */
+class NrNyuLongTermCacheTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param maxLongTermsPerLink the value of the MaxLongTermsPerLink attribute
+     */
+    NrNyuLongTermCacheTestCase(uint32_t maxLongTermsPerLink)
+        : TestCase("NYU long term cache with " + std::to_string(maxLongTermsPerLink) +
+                   " long terms per link"),
+          m_maxLongTermsPerLink(maxLongTermsPerLink)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Compute the received PSD and check the number of cache hits and misses
+     * @param a the mobility model of the transmitter
+     * @param b the mobility model of the receiver
+     * @param aAntenna the antenna of the transmitter
+     * @param bAntenna the antenna of the receiver
+     * @param hits the expected number of hits
+     * @param misses the expected number of misses
+     * @return the received PSD
+     */
+    Ptr<SpectrumValue> CheckRxPsd(Ptr<const MobilityModel> a,
+                                  Ptr<const MobilityModel> b,
+                                  Ptr<const PhasedArrayModel> aAntenna,
+                                  Ptr<const PhasedArrayModel> bAntenna,
+                                  uint64_t hits,
+                                  uint64_t misses);
+
+    /**
+     * @brief Check that two PSDs are equal
+     * @param psd the PSD
+     * @param expected the expected PSD
+     */
+    void CheckEqual(Ptr<const SpectrumValue> psd, Ptr<const SpectrumValue> expected);
+
+    uint32_t m_maxLongTermsPerLink;              //!< Long term components per link
+    Ptr<NYUSpectrumPropagationLossModel> m_splm; //!< The model under test
+    Ptr<SpectrumSignalParameters> m_txParams;    //!< The transmitted signal
+};
+
+Ptr<SpectrumValue>
+NrNyuLongTermCacheTestCase::CheckRxPsd(Ptr<const MobilityModel> a,
+                                       Ptr<const MobilityModel> b,
+                                       Ptr<const PhasedArrayModel> aAntenna,
+                                       Ptr<const PhasedArrayModel> bAntenna,
+                                       uint64_t hits,
+                                       uint64_t misses)
+{
+    auto rxParams = m_splm->CalcRxPowerSpectralDensity(m_txParams, a, b, aAntenna, bAntenna);
+    UintegerValue numHits;
+    m_splm->GetAttribute("LongTermCacheHits", numHits);
+    UintegerValue numMisses;
+    m_splm->GetAttribute("LongTermCacheMisses", numMisses);
+    NS_TEST_EXPECT_MSG_EQ(numHits.Get(), hits, "Wrong number of cache hits");
+    NS_TEST_EXPECT_MSG_EQ(numMisses.Get(), misses, "Wrong number of cache misses");
+    return rxParams->psd;
+}
+
+void
+NrNyuLongTermCacheTestCase::CheckEqual(Ptr<const SpectrumValue> psd,
+                                       Ptr<const SpectrumValue> expected)
+{
+    for (size_t band = 0; band < expected->GetValuesN(); ++band)
+    {
+        NS_TEST_EXPECT_MSG_EQ(psd->ValuesAt(band),
+                              expected->ValuesAt(band),
+                              "The cached long term gives a different PSD");
+    }
+}
+
+void
+NrNyuLongTermCacheTestCase::DoRun()
+{
+    auto channelModel = CreateObjectWithAttributes<NYUChannelModel>(
+        "Frequency",
+        DoubleValue(7e9),
+        "RfBandwidth",
+        DoubleValue(100e6),
+        "Scenario",
+        StringValue("UMa"),
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()),
+        "UpdatePeriod",
+        TimeValue(MilliSeconds(1)));
+    channelModel->AssignStreams(1);
+    m_splm = CreateObjectWithAttributes<NYUSpectrumPropagationLossModel>(
+        "ChannelModel",
+        PointerValue(channelModel),
+        "MaxLongTermsPerLink",
+        UintegerValue(m_maxLongTermsPerLink));
+
+    auto gnbNode = CreateObject<Node>();
+    auto gnbMobility = CreateObject<ConstantPositionMobilityModel>();
+    gnbMobility->SetPosition(Vector(0, 0, 25));
+    gnbNode->AggregateObject(gnbMobility);
+    auto ueNode = CreateObject<Node>();
+    auto ueMobility = CreateObject<ConstantPositionMobilityModel>();
+    ueMobility->SetPosition(Vector(100, 30, 1.5));
+    ueNode->AggregateObject(ueMobility);
+
+    auto gnbAntenna = CreateObjectWithAttributes<UniformPlanarArray>("NumRows",
+                                                                     UintegerValue(4),
+                                                                     "NumColumns",
+                                                                     UintegerValue(4));
+    auto ueAntenna = CreateObjectWithAttributes<UniformPlanarArray>("NumRows",
+                                                                    UintegerValue(2),
+                                                                    "NumColumns",
+                                                                    UintegerValue(2));
+    auto beamA = CreateDirectionalBfv(gnbAntenna, 1, 60);
+    auto beamB = CreateDirectionalBfv(gnbAntenna, 3, 120);
+    gnbAntenna->SetBeamformingVector(beamA);
+    ueAntenna->SetBeamformingVector(CreateQuasiOmniBfv(ueAntenna));
+
+    std::vector<double> centerFrequencies;
+    for (size_t band = 0; band < 24; ++band)
+    {
+        centerFrequencies.push_back(7e9 + band * 360e3);
+    }
+    m_txParams = Create<SpectrumSignalParameters>();
+    m_txParams->psd = Create<SpectrumValue>(Create<SpectrumModel>(centerFrequencies));
+    *m_txParams->psd = 1e-10;
+
+    Simulator::Schedule(MilliSeconds(1), [&]() {
+        bool hasSpace = m_maxLongTermsPerLink > 1;
+        auto psdA = CheckRxPsd(gnbMobility, ueMobility, gnbAntenna, ueAntenna, 0, 1);
+        CheckEqual(CheckRxPsd(gnbMobility, ueMobility, gnbAntenna, ueAntenna, 1, 1), psdA);
+        // The channel is reciprocal, so the uplink uses the same long term
+        CheckEqual(CheckRxPsd(ueMobility, gnbMobility, ueAntenna, gnbAntenna, 2, 1), psdA);
+
+        gnbAntenna->SetBeamformingVector(beamB);
+        CheckRxPsd(gnbMobility, ueMobility, gnbAntenna, ueAntenna, 2, 2);
+        gnbAntenna->SetBeamformingVector(beamA);
+        auto psd = CheckRxPsd(gnbMobility,
+                              ueMobility,
+                              gnbAntenna,
+                              ueAntenna,
+                              hasSpace ? 3 : 2,
+                              hasSpace ? 2 : 3);
+        CheckEqual(psd, psdA);
+    });
+
+    // The channel is updated after the update period, so its long terms are computed again
+    Simulator::Schedule(MilliSeconds(3), [&]() {
+        bool hasSpace = m_maxLongTermsPerLink > 1;
+        CheckRxPsd(gnbMobility,
+                   ueMobility,
+                   gnbAntenna,
+                   ueAntenna,
+                   hasSpace ? 3 : 2,
+                   hasSpace ? 3 : 4);
+        gnbAntenna->SetBeamformingVector(beamB);
+        CheckRxPsd(gnbMobility,
+                   ueMobility,
+                   gnbAntenna,
+                   ueAntenna,
+                   hasSpace ? 3 : 2,
+                   hasSpace ? 4 : 5);
+    });
+
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+/**
+ * @brief Test suite of the cache of long term components of NYUSpectrumPropagationLossModel
+ */
+class NrNyuLongTermCacheTestSuite : public TestSuite
+{
+  public:
+    NrNyuLongTermCacheTestSuite()
+        : TestSuite("nr-test-nyu-long-term-cache", Type::UNIT)
+    {
+        AddTestCase(new NrNyuLongTermCacheTestCase(8), Duration::QUICK);
+        AddTestCase(new NrNyuLongTermCacheTestCase(1), Duration::QUICK);
+    }
+};
+
+static NrNyuLongTermCacheTestSuite g_nrNyuLongTermCacheTestSuite; //!< NYU long term cache suite
+
+} // namespace ns3
@@ -0,0 +1,134 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/nyu-spectrum-propagation-loss-model.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/spectrum-model.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/test.h"
+
+/**
+ * @file nr-test-nyu-ray-gains.cc
+ * @ingroup test
+ *
+ * @brief Compares the gains of NYUSpectrumPropagationLossModel::ApplyRayGains, which advances the
+ * phase of each ray from a band to the next one with a rotation, with the gains computed with
+ * cos and sin at every band. The PSDs have hundreds of rays, evenly and unevenly spaced bands,
+ * and bands with zero power, which break the runs of consecutive bands.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Checks that the gains of the rays computed with the phase recurrence are the exact ones
+ */
+class NrNyuRayGainsTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param numRays the number of rays
+     * @param isUneven whether some bands have a different spacing than the others
+     * @param hasZeros whether some bands have zero power
+     */
+    NrNyuRayGainsTestCase(size_t numRays, bool isUneven, bool hasZeros)
+        : TestCase("NYU ray gains with " + std::to_string(numRays) + " rays" +
+                   (isUneven ? ", uneven bands" : "") + (hasZeros ? ", zero bands" : "")),
+          m_numRays(numRays),
+          m_isUneven(isUneven),
+          m_hasZeros(hasZeros)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    size_t m_numRays; //!< Number of rays
+    bool m_isUneven;  //!< Whether some bands have a different spacing
+    bool m_hasZeros;  //!< Whether some bands have zero power
+};
+
+void
+NrNyuRayGainsTestCase::DoRun()
+{
+    const size_t numBands = 273;
+
+    auto uniform = CreateObject<UniformRandomVariable>();
+    uniform->SetStream(1);
+    auto normal = CreateObject<NormalRandomVariable>();
+    normal->SetStream(2);
+
+    Bands bands;
+    double fc = 7e9;
+    for (size_t band = 0; band < numBands; ++band)
+    {
+        double spacing = (m_isUneven && band > 100 && band < 150) ? 720e3 : 360e3;
+        fc += spacing;
+        BandInfo info;
+        info.fl = fc - spacing / 2;
+        info.fc = fc;
+        info.fh = fc + spacing / 2;
+        bands.push_back(info);
+    }
+    SpectrumValue psd(Create<SpectrumModel>(bands));
+    for (size_t band = 0; band < numBands; ++band)
+    {
+        psd[band] = (m_hasZeros && band % 50 < 7) ? 0 : uniform->GetValue(1e-10, 2e-10);
+    }
+
+    PhasedArrayModel::ComplexVector rayGains(m_numRays);
+    MatrixBasedChannelModel::DoubleVector delays(m_numRays);
+    double sumAbs = 0;
+    for (size_t ray = 0; ray < m_numRays; ++ray)
+    {
+        rayGains[ray] = std::complex<double>(normal->GetValue(), normal->GetValue());
+        delays[ray] = uniform->GetValue(0, 3000); // ns
+        sumAbs += std::abs(rayGains[ray]);
+    }
+
+    SpectrumValue rxPsd = psd;
+    NYUSpectrumPropagationLossModel::ApplyRayGains(rxPsd, rayGains, delays);
+
+    for (size_t band = 0; band < numBands; ++band)
+    {
+        std::complex<double> gain;
+        for (size_t ray = 0; ray < m_numRays; ++ray)
+        {
+            double phase = -2 * M_PI * bands[band].fc * delays[ray] * 1e-9;
+            gain += rayGains[ray] * std::complex<double>(cos(phase), sin(phase));
+        }
+        // The error is relative to the largest power that the rays can add up to
+        NS_TEST_ASSERT_MSG_EQ_TOL(rxPsd[band],
+                                  psd[band] * std::norm(gain),
+                                  psd[band] * sumAbs * sumAbs * 1e-10,
+                                  "Wrong gain of band " << band);
+    }
+}
+
+/**
+ * @brief Test suite of the gains of the rays of NYUSpectrumPropagationLossModel
+ */
+class NrNyuRayGainsTestSuite : public TestSuite
+{
+  public:
+    NrNyuRayGainsTestSuite()
+        : TestSuite("nr-test-nyu-ray-gains", Type::UNIT)
+    {
+        for (size_t numRays : {1, 7, 300})
+        {
+            for (bool isUneven : {false, true})
+            {
+                for (bool hasZeros : {false, true})
+                {
+                    AddTestCase(new NrNyuRayGainsTestCase(numRays, isUneven, hasZeros),
+                                Duration::QUICK);
+                }
+            }
+        }
+    }
+};
+
+static NrNyuRayGainsTestSuite g_nrNyuRayGainsTestSuite; //!< NYU ray gains test suite
+
+} // namespace ns3
@@ -0,0 +1,525 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-test-num-threads.h"
+
+#include "ns3/applications-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/nr-module.h"
+#include "ns3/nr-parallel-scheduling.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+/**
+ * @file nr-test-parallel-scheduling.cc
+ * @ingroup test
+ *
+ * @brief Queues calls of several gNBs in NrParallelScheduling, as the gNB MACs do during
+ * the slot indications: calls that update the state of each gNB, and scheduling triggers
+ * that compute an allocation from that state and defer its commit. Checks that the
+ * commits happen in the same order, with the same allocations, for any number of
+ * threads, that the calls of a gNB run in the order they were queued, that calls made
+ * by a trigger run immediately, and that Flush() executes the calls of a gNB at once.
+ * Then, it simulates several gNBs with DL and UL traffic, with the parallel scheduling
+ * enabled, and checks that the scheduling, symbols per beam and reception traces are the
+ * same for any number of threads.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Checks the order and the results of the calls queued in NrParallelScheduling
+ */
+class NrParallelSchedulingTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param numThreads the NumThreads attribute
+     */
+    NrParallelSchedulingTestCase(uint32_t numThreads)
+        : TestCase("Parallel scheduling with " + std::to_string(numThreads) + " threads"),
+          m_numThreads(numThreads)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /// A committed allocation
+    struct Commit
+    {
+        uint16_t cellId;     //!< Cell ID of the gNB
+        uint64_t allocation; //!< The allocation
+        Time time;           //!< Time of the commit
+
+        /**
+         * @param other another commit
+         * @return whether the commits are equal
+         */
+        bool operator==(const Commit& other) const
+        {
+            return cellId == other.cellId && allocation == other.allocation &&
+                   time == other.time;
+        }
+    };
+
+    /**
+     * @brief Compute the allocation of a gNB from its state, with enough work for the
+     * triggers of different gNBs to overlap
+     * @param state the state of the gNB
+     * @return the allocation
+     */
+    static uint64_t Allocate(uint64_t state);
+
+    /**
+     * @brief Queue the calls of the slot indications of a gNB: two updates of its state,
+     * each followed by a trigger
+     * @param cellId the cell ID of the gNB
+     * @param value the value of the first update
+     */
+    void SlotIndication(uint16_t cellId, uint64_t value);
+
+    /**
+     * @brief Add the commit expected after an update of the state of a gNB
+     * @param cellId the cell ID of the gNB
+     * @param update the value of the update
+     * @param time the time of the commit
+     */
+    void Expect(uint16_t cellId, uint64_t update, Time time);
+
+    /**
+     * @brief Flush the calls of a gNB, and check that its commits are done
+     * @param cellId the cell ID of the gNB
+     */
+    void Flush(uint16_t cellId);
+
+    uint32_t m_numThreads;                              //!< Number of threads
+    Ptr<NrParallelScheduling> m_parallelScheduling;     //!< Object under test
+    std::map<uint16_t, uint64_t> m_states;              //!< State of each gNB
+    std::map<uint16_t, uint64_t> m_expectedStates;      //!< Expected state of each gNB
+    std::vector<Commit> m_commits;                      //!< Commits, in order
+    std::vector<Commit> m_expectedCommits;              //!< Expected commits
+    std::atomic<uint32_t> m_nestedCallsNotImmediate{0}; //!< Nested calls that were queued
+    uint32_t m_flushedTriggers{0};                      //!< Triggers executed by Flush()
+    uint32_t m_updatesInTrigger{0};                     //!< Updates seen as triggers
+    uint32_t m_flushedCommitsMissing{0};                //!< Commits not done by Flush()
+};
+
+uint64_t
+NrParallelSchedulingTestCase::Allocate(uint64_t state)
+{
+    uint64_t allocation = state;
+    for (uint32_t i = 0; i < 100000; ++i)
+    {
+        allocation = allocation * 6364136223846793005ULL + 1442695040888963407ULL;
+    }
+    return allocation;
+}
+
+void
+NrParallelSchedulingTestCase::SlotIndication(uint16_t cellId, uint64_t value)
+{
+    for (uint64_t update : {value, value + 1})
+    {
+        m_parallelScheduling->Enqueue(
+            cellId,
+            [this, cellId, update]() {
+                m_updatesInTrigger += NrParallelScheduling::IsInTrigger() ? 1 : 0;
+                m_states[cellId] = m_states[cellId] * 31 + update;
+            },
+            false);
+
+        // The map of states is not modified while the triggers run
+        uint64_t* state = &m_states[cellId];
+        m_parallelScheduling->Enqueue(
+            cellId,
+            [this, cellId, state]() {
+                bool nestedCallDone = false;
+                m_parallelScheduling->Enqueue(
+                    cellId,
+                    [&nestedCallDone]() { nestedCallDone = true; },
+                    false);
+                if (!nestedCallDone)
+                {
+                    ++m_nestedCallsNotImmediate;
+                }
+
+                uint64_t allocation = Allocate(*state);
+                auto commit = [this, cellId, allocation]() {
+                    m_commits.push_back({cellId, allocation, Simulator::Now()});
+                };
+                // As in NrGnbMac, the triggers executed by Flush() commit immediately
+                if (NrParallelScheduling::IsInTrigger())
+                {
+                    NrParallelScheduling::Defer(commit);
+                }
+                else
+                {
+                    ++m_flushedTriggers;
+                    commit();
+                }
+            },
+            true);
+    }
+}
+
+void
+NrParallelSchedulingTestCase::Expect(uint16_t cellId, uint64_t update, Time time)
+{
+    auto& state = m_expectedStates[cellId];
+    state = state * 31 + update;
+    m_expectedCommits.push_back({cellId, Allocate(state), time});
+}
+
+void
+NrParallelSchedulingTestCase::Flush(uint16_t cellId)
+{
+    auto commits = m_commits.size();
+    m_parallelScheduling->Flush(cellId);
+    if (m_commits.size() != commits + 2 || m_commits.back().cellId != cellId)
+    {
+        ++m_flushedCommitsMissing;
+    }
+}
+
+void
+NrParallelSchedulingTestCase::DoRun()
+{
+    m_parallelScheduling = CreateObject<NrParallelScheduling>();
+    m_parallelScheduling->SetNumThreads(m_numThreads);
+
+    // First slot: the gNBs are queued out of cell ID order
+    const std::map<uint16_t, uint64_t> firstValues = {{1, 11}, {2, 22}, {3, 33}, {7, 77}};
+    Simulator::Schedule(MilliSeconds(1), [this, firstValues]() {
+        for (uint16_t cellId : {7, 3, 1, 2})
+        {
+            SlotIndication(cellId, firstValues.at(cellId));
+        }
+    });
+
+    // Second slot: the gNB 2 is flushed before the end of the time stamp
+    const std::map<uint16_t, uint64_t> secondValues = {{1, 5}, {2, 6}, {3, 7}, {7, 8}};
+    Simulator::Schedule(MilliSeconds(2), [this, secondValues]() {
+        for (uint16_t cellId : {1, 2, 3, 7})
+        {
+            SlotIndication(cellId, secondValues.at(cellId));
+        }
+    });
+    Simulator::Schedule(MilliSeconds(2), &NrParallelSchedulingTestCase::Flush, this, 2);
+
+    Simulator::Run();
+    Simulator::Destroy();
+
+    // Each round commits one allocation of each gNB, in cell ID order
+    for (uint64_t round = 0; round < 2; ++round)
+    {
+        for (uint16_t cellId : {1, 2, 3, 7})
+        {
+            Expect(cellId, firstValues.at(cellId) + round, MilliSeconds(1));
+        }
+    }
+    // The flushed gNB commits before the others
+    for (uint64_t round = 0; round < 2; ++round)
+    {
+        Expect(2, secondValues.at(2) + round, MilliSeconds(2));
+    }
+    for (uint64_t round = 0; round < 2; ++round)
+    {
+        for (uint16_t cellId : {1, 3, 7})
+        {
+            Expect(cellId, secondValues.at(cellId) + round, MilliSeconds(2));
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(m_commits.size(), m_expectedCommits.size(), "Wrong number of commits");
+    for (size_t i = 0; i < m_commits.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ((m_commits[i] == m_expectedCommits[i]),
+                              true,
+                              "Commit " << i << " of cell " << m_commits[i].cellId
+                                        << " differs from the expected one of cell "
+                                        << m_expectedCommits[i].cellId);
+    }
+    NS_TEST_ASSERT_MSG_EQ(m_flushedTriggers, 2, "Only the flushed triggers run as calls");
+    NS_TEST_ASSERT_MSG_EQ(m_nestedCallsNotImmediate.load(), 0, "Nested calls were queued");
+    NS_TEST_ASSERT_MSG_EQ(m_updatesInTrigger, 0, "Updates seen as triggers");
+    NS_TEST_ASSERT_MSG_EQ(m_flushedCommitsMissing, 0, "Flush() did not commit the gNB");
+}
+
+/**
+ * @brief Checks that a simulation of several gNBs with parallel scheduling gives the same
+ * MAC and PHY traces with one thread and with several threads
+ */
+class NrParallelSchedulingE2eTestCase : public NrNumThreadsTestCase<std::string>
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param numThreads the number of threads compared with a single one
+     */
+    NrParallelSchedulingE2eTestCase(uint32_t numThreads)
+        : NrNumThreadsTestCase("End to end parallel scheduling", numThreads)
+    {
+    }
+
+  private:
+    /**
+     * @brief Simulate the scenario and record its traces
+     * @param numThreads the number of threads of the parallel scheduling
+     * @return the traces, in the order they were fired
+     */
+    std::vector<std::string> RunScenario(uint32_t numThreads) override;
+
+    void CheckScenario(const std::vector<std::string>& results) override;
+
+    void CheckEqual(const std::string& trace, const std::string& expected, size_t i) override;
+
+    /**
+     * @brief Record a DL or UL scheduling decision of a gNB MAC
+     * @param context the cell ID and direction
+     * @param info the scheduling decision
+     */
+    void Scheduling(std::string context, NrSchedulingCallbackInfo info);
+
+    /**
+     * @brief Record the symbols assigned to a beam by a gNB scheduler
+     * @param context the cell ID
+     * @param oldValue the previous value
+     * @param newValue the symbols of the beam
+     */
+    void SymPerBeam(std::string context, uint32_t oldValue, uint32_t newValue);
+
+    /**
+     * @brief Record the reception of a transport block
+     * @param context the receiver
+     * @param params the reception
+     */
+    void RxPacket(std::string context, RxPacketTraceParams params);
+
+    std::vector<std::string> m_traces; //!< Traces of the current run
+};
+
+void
+NrParallelSchedulingE2eTestCase::Scheduling(std::string context, NrSchedulingCallbackInfo info)
+{
+    std::ostringstream trace;
+    trace << Simulator::Now().GetNanoSeconds() << " " << context << " " << info.m_frameNum << "/"
+          << +info.m_subframeNum << "/" << info.m_slotNum << " sym " << +info.m_symStart << "+"
+          << +info.m_numSym << " rnti " << info.m_rnti << " mcs " << +info.m_mcs << " tbs "
+          << info.m_tbSize << " ndi " << +info.m_ndi << " rv " << +info.m_rv << " harq "
+          << +info.m_harqId;
+    m_traces.push_back(trace.str());
+}
+
+void
+NrParallelSchedulingE2eTestCase::SymPerBeam(std::string context,
+                                            [[maybe_unused]] uint32_t oldValue,
+                                            uint32_t newValue)
+{
+    std::ostringstream trace;
+    trace << Simulator::Now().GetNanoSeconds() << " " << context << " SymPerBeam " << newValue;
+    m_traces.push_back(trace.str());
+}
+
+void
+NrParallelSchedulingE2eTestCase::RxPacket(std::string context, RxPacketTraceParams params)
+{
+    std::ostringstream trace;
+    trace << std::setprecision(17) << Simulator::Now().GetNanoSeconds() << " " << context
+          << " cell " << params.m_cellId << " rnti " << params.m_rnti << " " << params.m_frameNum
+          << "/" << +params.m_subframeNum << "/" << params.m_slotNum << " sym "
+          << +params.m_symStart << "+" << +params.m_numSym << " tbs " << params.m_tbSize
+          << " mcs " << +params.m_mcs << " rank " << +params.m_rank << " rv " << +params.m_rv
+          << " sinr " << params.m_sinr << " corrupt " << params.m_corrupt;
+    m_traces.push_back(trace.str());
+}
+
+std::vector<std::string>
+NrParallelSchedulingE2eTestCase::RunScenario(uint32_t numThreads)
+{
+    m_traces.clear();
+    const uint32_t gnbNum = 3;
+    const uint32_t uePerGnbNum = 2;
+
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(gnbNum);
+    ueNodes.Create(gnbNum * uePerGnbNum);
+
+    // Neighbouring cells, so that the gNBs interfere with each other
+    auto gnbPositions = CreateObject<ListPositionAllocator>();
+    auto uePositions = CreateObject<ListPositionAllocator>();
+    for (uint32_t gnb = 0; gnb < gnbNum; ++gnb)
+    {
+        const double x = 60.0 * gnb;
+        gnbPositions->Add(Vector(x, 0, 10));
+        for (uint32_t ue = 0; ue < uePerGnbNum; ++ue)
+        {
+            uePositions->Add(Vector(x + 5 + 10 * ue, ue == 0 ? 15 : -20, 1.5));
+        }
+    }
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(gnbPositions);
+    mobility.Install(gnbNodes);
+    mobility.SetPositionAllocator(uePositions);
+    mobility.Install(ueNodes);
+
+    auto nrEpcHelper = CreateObject<NrPointToPointEpcHelper>();
+    auto idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    idealBeamformingHelper->SetAttribute("BeamformingMethod",
+                                         TypeIdValue(DirectPathBeamforming::GetTypeId()));
+    auto nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    nrHelper->SetEpcHelper(nrEpcHelper);
+    nrHelper->EnableParallelScheduling(numThreads);
+
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(4));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(1));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(1));
+    // An OFDMA scheduler, which fires the SymPerBeam trace
+    nrHelper->SetSchedulerTypeId(NrMacSchedulerOfdmaPF::GetTypeId());
+
+    auto channelHelper = CreateObject<NrChannelHelper>();
+    channelHelper->ConfigureFactories("UMi", "Default");
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(3.5e9, 20e6, 1);
+    auto band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    channelHelper->AssignChannelsToBands({band});
+    auto allBwps = CcBwpCreator::GetAllBwps({band});
+
+    auto gnbDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    auto ueDevs = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    int64_t randomStream = 1;
+    randomStream += nrHelper->AssignStreams(gnbDevs, randomStream);
+    randomStream += nrHelper->AssignStreams(ueDevs, randomStream);
+
+    auto pgw = nrEpcHelper->GetPgwNode();
+    NodeContainer remoteHostContainer;
+    remoteHostContainer.Create(1);
+    auto remoteHost = remoteHostContainer.Get(0);
+    InternetStackHelper internet;
+    internet.Install(remoteHostContainer);
+    PointToPointHelper p2ph;
+    p2ph.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Gb/s")));
+    p2ph.SetChannelAttribute("Delay", TimeValue(Seconds(0)));
+    auto internetDevices = p2ph.Install(pgw, remoteHost);
+    Ipv4AddressHelper ipv4h;
+    ipv4h.SetBase("1.0.0.0", "255.0.0.0");
+    auto internetIpIfaces = ipv4h.Assign(internetDevices);
+    auto remoteHostAddr = internetIpIfaces.GetAddress(1);
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    ipv4RoutingHelper.GetStaticRouting(remoteHost->GetObject<Ipv4>())
+        ->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"), 1);
+    internet.Install(ueNodes);
+    auto ueIpIfaces = nrEpcHelper->AssignUeIpv4Address(ueDevs);
+    nrHelper->AttachToClosestGnb(ueDevs, gnbDevs);
+
+    // DL and UL traffic on the default bearers
+    const uint16_t dlPort = 1234;
+    const uint16_t ulPort = 2000;
+    ApplicationContainer serverApps;
+    ApplicationContainer clientApps;
+    serverApps.Add(UdpServerHelper(ulPort).Install(remoteHost));
+    serverApps.Add(UdpServerHelper(dlPort).Install(ueNodes));
+    for (uint32_t j = 0; j < ueNodes.GetN(); ++j)
+    {
+        UdpClientHelper dlClient(ueIpIfaces.GetAddress(j), dlPort);
+        dlClient.SetAttribute("PacketSize", UintegerValue(1000));
+        dlClient.SetAttribute("Interval", TimeValue(MicroSeconds(500)));
+        clientApps.Add(dlClient.Install(remoteHost));
+
+        UdpClientHelper ulClient(remoteHostAddr, ulPort);
+        ulClient.SetAttribute("PacketSize", UintegerValue(500));
+        ulClient.SetAttribute("Interval", TimeValue(MilliSeconds(1)));
+        clientApps.Add(ulClient.Install(ueNodes.Get(j)));
+    }
+    serverApps.Start(MilliSeconds(50));
+    clientApps.Start(MilliSeconds(50));
+
+    for (uint32_t i = 0; i < gnbDevs.GetN(); ++i)
+    {
+        auto gnbDev = DynamicCast<NrGnbNetDevice>(gnbDevs.Get(i));
+        auto cell = "cell " + std::to_string(gnbDev->GetCellId());
+        gnbDev->GetMac(0)->TraceConnect(
+            "DlScheduling",
+            cell + " DL",
+            MakeCallback(&NrParallelSchedulingE2eTestCase::Scheduling, this));
+        gnbDev->GetMac(0)->TraceConnect(
+            "UlScheduling",
+            cell + " UL",
+            MakeCallback(&NrParallelSchedulingE2eTestCase::Scheduling, this));
+        gnbDev->GetScheduler(0)->TraceConnect(
+            "SymPerBeam",
+            cell,
+            MakeCallback(&NrParallelSchedulingE2eTestCase::SymPerBeam, this));
+        gnbDev->GetPhy(0)->GetSpectrumPhy()->TraceConnect(
+            "RxPacketTraceGnb",
+            cell,
+            MakeCallback(&NrParallelSchedulingE2eTestCase::RxPacket, this));
+    }
+    for (uint32_t i = 0; i < ueDevs.GetN(); ++i)
+    {
+        auto ueDev = DynamicCast<NrUeNetDevice>(ueDevs.Get(i));
+        ueDev->GetPhy(0)->GetSpectrumPhy()->TraceConnect(
+            "RxPacketTraceUe",
+            "ue " + std::to_string(ueDev->GetImsi()),
+            MakeCallback(&NrParallelSchedulingE2eTestCase::RxPacket, this));
+    }
+
+    Simulator::Stop(MilliSeconds(150));
+    Simulator::Run();
+    Simulator::Destroy();
+    return std::move(m_traces);
+}
+
+void
+NrParallelSchedulingE2eTestCase::CheckScenario(const std::vector<std::string>& results)
+{
+    size_t numSymPerBeam = 0;
+    for (const auto& trace : results)
+    {
+        numSymPerBeam += trace.find("SymPerBeam") != std::string::npos ? 1 : 0;
+    }
+    NS_TEST_ASSERT_MSG_GT(numSymPerBeam, 0, "The schedulers did not fire SymPerBeam");
+}
+
+void
+NrParallelSchedulingE2eTestCase::CheckEqual(const std::string& trace,
+                                            const std::string& expected,
+                                            size_t i)
+{
+    NS_TEST_ASSERT_MSG_EQ(trace, expected, "Trace " << i << " differs");
+}
+
+/**
+ * @brief Test suite of NrParallelScheduling
+ */
+class NrParallelSchedulingTestSuite : public TestSuite
+{
+  public:
+    NrParallelSchedulingTestSuite()
+        : TestSuite("nr-test-parallel-scheduling", Type::UNIT)
+    {
+        for (uint32_t numThreads : {1, 2, 4})
+        {
+            AddTestCase(new NrParallelSchedulingTestCase(numThreads), Duration::QUICK);
+        }
+        AddTestCase(new NrParallelSchedulingE2eTestCase(4), Duration::QUICK);
+    }
+};
+
+static NrParallelSchedulingTestSuite g_nrParallelSchedulingTestSuite; //!< Parallel scheduling suite
+
+} // namespace ns3
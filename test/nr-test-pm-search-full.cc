@@ -0,0 +1,316 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-test-num-threads.h"
+
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/nr-amc.h"
+#include "ns3/nr-cb-type-one-sp.h"
+#include "ns3/nr-csi-batch.h"
+#include "ns3/nr-eesm-ir-t1.h"
+#include "ns3/nr-pm-search-full.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <cmath>
+
+/**
+ * @file nr-test-pm-search-full.cc
+ * @ingroup test
+ *
+ * @brief Checks that the Pruned search policy of NrPmSearchFull selects the same rank and PMIs
+ * as the Exhaustive one, over sequences of wideband, subband and no PMI updates, on channels
+ * whose capacity increases with the rank. The sequences alternate strong channels, where all
+ * the ranks are evaluated, with weak isotropic ones, where the highest ranks cannot keep the
+ * connection, so that the Pruned policy stops before them during a subband update and
+ * evaluates them again in a later feedback without PMI update.
+ *
+ * It also runs the searches of several UEs, served by AMCs with and without the SINR threshold
+ * table, in NrCsiBatch, and checks that the feedback with several threads is the one with a
+ * single thread.
+ */
+namespace ns3
+{
+
+static constexpr size_t NUM_PORTS{4}; //!< Number of ports of the gNB and the UE
+static constexpr size_t NUM_RBS{24};  //!< Number of RBs of the signals
+
+/**
+ * @brief Create a PM search with 4 gNB and 4 UE ports
+ * @param amc the AMC of the search
+ * @param policy the search policy
+ * @return the PM search
+ */
+static Ptr<NrPmSearchFull>
+CreatePmSearch(const Ptr<NrAmc>& amc, NrPmSearchFull::SearchPolicy policy)
+{
+    auto pmSearch = CreateObject<NrPmSearchFull>();
+    pmSearch->SetAttribute("CodebookType", TypeIdValue(NrCbTypeOneSp::GetTypeId()));
+    pmSearch->SetAttribute("SearchPolicy", EnumValue(policy));
+    // Evaluate every wideband PMI, so that only the rank search differs between the policies
+    pmSearch->SetAttribute("NumI1Candidates", UintegerValue(UINT32_MAX));
+    pmSearch->SetAttribute("SubbandSize", UintegerValue(4));
+    pmSearch->SetAttribute("EnforceSubbandSize", BooleanValue(false));
+    pmSearch->SetAmc(amc);
+    pmSearch->SetGnbParams(true, 2, 1);
+    pmSearch->SetUeParams(NUM_PORTS);
+    pmSearch->InitCodebooks();
+    return pmSearch;
+}
+
+/**
+ * @brief Create a signal with unit noise, whose channel is the identity matrix plus a random
+ * matrix per RB
+ * @param snrDb the SNR of each receive port (dB)
+ * @param scattering the standard deviation of the random matrix, 0 for the identity
+ * @param normal the entries of the random matrix
+ * @return the signal
+ */
+static NrMimoSignal
+CreateSignal(double snrDb, double scattering, const Ptr<NormalRandomVariable>& normal)
+{
+    auto gain = std::sqrt(std::pow(10.0, snrDb / 10.0));
+    NrMimoSignal signal;
+    signal.m_chanMat = ComplexMatrixArray(NUM_PORTS, NUM_PORTS, NUM_RBS);
+    signal.m_covMat = NrCovMat(ComplexMatrixArray(NUM_PORTS, NUM_PORTS, NUM_RBS));
+    for (size_t rb = 0; rb < NUM_RBS; ++rb)
+    {
+        for (size_t i = 0; i < NUM_PORTS; ++i)
+        {
+            for (size_t j = 0; j < NUM_PORTS; ++j)
+            {
+                std::complex<double> entry(i == j ? 1.0 : 0.0, 0.0);
+                if (scattering > 0)
+                {
+                    entry += scattering *
+                             std::complex<double>(normal->GetValue(), normal->GetValue());
+                }
+                signal.m_chanMat(i, j, rb) = gain * entry;
+            }
+            signal.m_covMat(i, i, rb) = 1.0;
+        }
+    }
+    return signal;
+}
+
+/**
+ * @brief Compares the feedback of the Pruned and Exhaustive policies of NrPmSearchFull
+ */
+class NrPmSearchPrunedTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param weakSnrDb the SNR of the weak channels (dB)
+     */
+    NrPmSearchPrunedTestCase(int weakSnrDb)
+        : TestCase("Pruned PM search with weak channels at " + std::to_string(weakSnrDb) +
+                   " dB"),
+          m_weakSnrDb(weakSnrDb)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    int m_weakSnrDb; //!< SNR of the weak channels (dB)
+};
+
+void
+NrPmSearchPrunedTestCase::DoRun()
+{
+    auto amc = CreateObject<NrAmc>();
+    auto normal = CreateObject<NormalRandomVariable>();
+    normal->SetStream(1);
+
+    auto exhaustive = CreatePmSearch(amc, NrPmSearchFull::Exhaustive);
+    auto pruned = CreatePmSearch(amc, NrPmSearchFull::Pruned);
+
+    // Strong channels are scattered around the identity, so that the PMIs depend on them, and
+    // the weak ones are isotropic, so that the capacity of each rank does not depend on the PMI
+    // and increases with the rank
+    const double strongSnrDb = 25.0;
+    const double scattering = 0.3;
+    struct Step
+    {
+        bool isStrong;                   //!< Whether the channel is strong
+        NrPmSearch::PmiUpdate pmiUpdate; //!< PMI update of the feedback
+    };
+
+    const std::vector<Step> steps{
+        {true, {true, true}},
+        {false, {false, true}},
+        {true, {false, false}},
+        {true, {false, true}},
+        {false, {false, false}},
+        {false, {false, true}},
+        {false, {false, false}},
+        {true, {false, false}},
+        {true, {true, true}},
+        {false, {false, true}},
+        {true, {false, true}},
+        {true, {false, false}},
+    };
+    for (size_t i = 0; i < steps.size(); ++i)
+    {
+        auto signal = steps[i].isStrong ? CreateSignal(strongSnrDb, scattering, normal)
+                                        : CreateSignal(m_weakSnrDb, 0.0, normal);
+        auto expected = exhaustive->CreateCqiFeedbackMimo(signal, steps[i].pmiUpdate);
+        auto cqi = pruned->CreateCqiFeedbackMimo(signal, steps[i].pmiUpdate);
+        NS_TEST_ASSERT_MSG_EQ(+cqi.m_rank, +expected.m_rank, "Different rank at step " << i);
+        NS_TEST_ASSERT_MSG_EQ(cqi.m_wbPmi, expected.m_wbPmi, "Different WB PMI at step " << i);
+        NS_TEST_ASSERT_MSG_EQ((cqi.m_sbPmis == expected.m_sbPmis),
+                              true,
+                              "Different SB PMIs at step " << i);
+    }
+}
+
+/**
+ * @brief Checks that the feedback of the full PM searches run by NrCsiBatch with several
+ * threads is the one with a single thread
+ */
+class NrCsiBatchPmSearchTestCase : public NrNumThreadsTestCase<PmCqiInfo>
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param numThreads the NumThreads attribute
+     */
+    NrCsiBatchPmSearchTestCase(uint32_t numThreads)
+        : NrNumThreadsTestCase("CSI batch of full PM searches", numThreads)
+    {
+    }
+
+  private:
+    /**
+     * @brief Run the searches of all the UEs in NrCsiBatch, with new AMCs and searches
+     * @param numThreads the NumThreads attribute of the batch
+     * @return the feedback of the searches, in the order it was delivered
+     */
+    std::vector<PmCqiInfo> RunScenario(uint32_t numThreads) override;
+
+    void CheckScenario(const std::vector<PmCqiInfo>& results) override;
+
+    void CheckEqual(const PmCqiInfo& cqi, const PmCqiInfo& expectedCqi, size_t i) override;
+
+    static constexpr size_t NUM_UES{12};  //!< Number of UEs
+    static constexpr size_t NUM_AMCS{3};  //!< Number of AMCs
+    static constexpr size_t NUM_STEPS{3}; //!< Number of time stamps with searches
+
+    std::vector<std::vector<NrMimoSignal>> m_signals; //!< Signal of each UE at each step
+};
+
+std::vector<PmCqiInfo>
+NrCsiBatchPmSearchTestCase::RunScenario(uint32_t numThreads)
+{
+    // The UEs see channels of different quality, so that their ranks and MCSs differ. The
+    // same signals are used by all the runs
+    if (m_signals.empty())
+    {
+        auto normal = CreateObject<NormalRandomVariable>();
+        normal->SetStream(1);
+        m_signals.resize(NUM_STEPS);
+        for (auto& signals : m_signals)
+        {
+            for (size_t ueId = 0; ueId < NUM_UES; ++ueId)
+            {
+                signals.push_back(CreateSignal(-5.0 + 3.0 * ueId, 0.3, normal));
+            }
+        }
+    }
+
+    auto csiBatch = CreateObject<NrCsiBatch>();
+    csiBatch->SetNumThreads(numThreads);
+    std::vector<Ptr<NrAmc>> amcs;
+    for (size_t amcId = 0; amcId < NUM_AMCS; ++amcId)
+    {
+        auto amc = CreateObject<NrAmc>();
+        // The last AMC compares the effective SINR with the thresholds of an EESM error model
+        if (amcId == NUM_AMCS - 1)
+        {
+            amc->SetAttribute("ErrorModelType", TypeIdValue(NrEesmIrT1::GetTypeId()));
+            amc->SetAttribute("UseSinrThresholdTable", BooleanValue(true));
+        }
+        amcs.push_back(amc);
+    }
+    std::vector<Ptr<NrPmSearchFull>> pmSearches;
+    for (size_t ueId = 0; ueId < NUM_UES; ++ueId)
+    {
+        pmSearches.push_back(CreatePmSearch(amcs[ueId % NUM_AMCS],
+                                            ueId % 2 == 0 ? NrPmSearchFull::Exhaustive
+                                                          : NrPmSearchFull::Pruned));
+    }
+
+    std::vector<PmCqiInfo> feedback;
+    const std::vector<NrPmSearch::PmiUpdate> pmiUpdates{{true, true},
+                                                        {false, true},
+                                                        {false, false}};
+    for (size_t step = 0; step < NUM_STEPS; ++step)
+    {
+        Simulator::Schedule(MilliSeconds(step + 1), [&, step]() {
+            for (size_t ueId = 0; ueId < NUM_UES; ++ueId)
+            {
+                csiBatch->Enqueue(amcs[ueId % NUM_AMCS],
+                                  pmSearches[ueId],
+                                  m_signals[step][ueId],
+                                  pmiUpdates[step],
+                                  [&feedback](const PmCqiInfo& cqi) { feedback.push_back(cqi); });
+            }
+        });
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+    return feedback;
+}
+
+void
+NrCsiBatchPmSearchTestCase::CheckScenario(const std::vector<PmCqiInfo>& results)
+{
+    NS_TEST_ASSERT_MSG_EQ(results.size(), NUM_UES * NUM_STEPS, "Wrong number of feedbacks");
+}
+
+void
+NrCsiBatchPmSearchTestCase::CheckEqual(const PmCqiInfo& cqi, const PmCqiInfo& expectedCqi, size_t i)
+{
+    NS_TEST_ASSERT_MSG_EQ(+cqi.m_rank, +expectedCqi.m_rank, "Different rank of " << i);
+    NS_TEST_ASSERT_MSG_EQ(+cqi.m_mcs, +expectedCqi.m_mcs, "Different MCS of " << i);
+    NS_TEST_ASSERT_MSG_EQ(cqi.m_wbPmi, expectedCqi.m_wbPmi, "Different WB PMI of " << i);
+    NS_TEST_ASSERT_MSG_EQ(+cqi.m_wbCqi, +expectedCqi.m_wbCqi, "Different WB CQI of " << i);
+    NS_TEST_ASSERT_MSG_EQ((cqi.m_sbPmis == expectedCqi.m_sbPmis),
+                          true,
+                          "Different SB PMIs of " << i);
+    NS_TEST_ASSERT_MSG_EQ((cqi.m_sbCqis == expectedCqi.m_sbCqis),
+                          true,
+                          "Different SB CQIs of " << i);
+    NS_TEST_ASSERT_MSG_EQ(cqi.m_tbSize, expectedCqi.m_tbSize, "Different TB size of " << i);
+    NS_TEST_ASSERT_MSG_EQ((cqi.m_optPrecMat && expectedCqi.m_optPrecMat &&
+                           *cqi.m_optPrecMat == *expectedCqi.m_optPrecMat),
+                          true,
+                          "Different precoding matrix of " << i);
+}
+
+/**
+ * @brief Test suite of the search policies of NrPmSearchFull
+ */
+class NrPmSearchFullTestSuite : public TestSuite
+{
+  public:
+    NrPmSearchFullTestSuite()
+        : TestSuite("nr-test-pm-search-full", Type::UNIT)
+    {
+        // The weak channels span the SNRs where ranks 2, 3 or 4 lose the connection
+        for (int weakSnrDb = -6; weakSnrDb <= 2; ++weakSnrDb)
+        {
+            AddTestCase(new NrPmSearchPrunedTestCase(weakSnrDb), Duration::QUICK);
+        }
+        AddTestCase(new NrCsiBatchPmSearchTestCase(4), Duration::QUICK);
+    }
+};
+
+static NrPmSearchFullTestSuite g_nrPmSearchFullTestSuite; //!< PM search full test suite
+
+} // namespace ns3
@@ -0,0 +1,398 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/boolean.h"
+#include "ns3/ideal-beamforming-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/nr-channel-helper.h"
+#include "ns3/nr-helper.h"
+#include "ns3/nr-radio-environment-map-helper.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <cstdio>
+
+/**
+ * @file nr-test-rem.cc
+ * @ingroup test
+ *
+ * @brief Checks that the BeamShape, CoverageArea and UeCoverage REM maps do not depend
+ * on the number of threads that compute the REM points, and that the CoverageArea map is
+ * the same when the channels of the RTDs are computed once per iteration and reused for
+ * all the beams of the RRD, as when they are computed again for each beam.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Compares CoverageArea REM maps computed with different configurations
+ */
+class NrRemCoverageAreaTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param iterations The number of iterations to average in each REM point
+     */
+    NrRemCoverageAreaTestCase(uint16_t iterations);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Creates a REM helper, and schedules its installation
+     * @param reuseRtdChannels The ReuseRtdChannels attribute
+     * @param numThreads The NumThreads attribute
+     * @param simTag The SimTag attribute
+     * @return The REM helper
+     */
+    Ptr<NrRadioEnvironmentMapHelper> CreateRemHelper(bool reuseRtdChannels,
+                                                     uint32_t numThreads,
+                                                     const std::string& simTag) const;
+
+    /**
+     * @brief Computes the REM map of a helper, without writing the map files
+     * @param remHelper The REM helper
+     * @param rtdNetDev The RTDs
+     * @param rrdDevice The RRD
+     * @return The SNR, SINR and received power of each REM point
+     */
+    std::vector<double> ComputeRem(const Ptr<NrRadioEnvironmentMapHelper>& remHelper,
+                                   const NetDeviceContainer& rtdNetDev,
+                                   const Ptr<NetDevice>& rrdDevice) const;
+
+    uint16_t m_iterations; //!< Number of iterations to average in each REM point
+};
+
+NrRemCoverageAreaTestCase::NrRemCoverageAreaTestCase(uint16_t iterations)
+    : TestCase("CoverageArea REM with " + std::to_string(iterations) + " iterations"),
+      m_iterations(iterations)
+{
+}
+
+Ptr<NrRadioEnvironmentMapHelper>
+NrRemCoverageAreaTestCase::CreateRemHelper(bool reuseRtdChannels,
+                                           uint32_t numThreads,
+                                           const std::string& simTag) const
+{
+    Ptr<NrRadioEnvironmentMapHelper> remHelper = CreateObject<NrRadioEnvironmentMapHelper>();
+    remHelper->SetMinX(-60.0);
+    remHelper->SetMaxX(60.0);
+    remHelper->SetResX(3);
+    remHelper->SetMinY(-40.0);
+    remHelper->SetMaxY(40.0);
+    remHelper->SetResY(3);
+    remHelper->SetZ(1.5);
+    remHelper->SetSimTag(simTag);
+    remHelper->SetRemMode(NrRadioEnvironmentMapHelper::COVERAGE_AREA);
+    remHelper->SetNumOfItToAverage(m_iterations);
+    remHelper->SetReuseRtdChannels(reuseRtdChannels);
+    remHelper->SetNumThreads(numThreads);
+    // The REM is computed by ComputeRem(), the scheduled installation is never executed
+    remHelper->SetInstallationDelay(Seconds(10));
+    return remHelper;
+}
+
+std::vector<double>
+NrRemCoverageAreaTestCase::ComputeRem(const Ptr<NrRadioEnvironmentMapHelper>& remHelper,
+                                      const NetDeviceContainer& rtdNetDev,
+                                      const Ptr<NetDevice>& rrdDevice) const
+{
+    remHelper->ConfigureRrd(rrdDevice);
+    remHelper->ConfigureRtdList(rtdNetDev);
+    remHelper->CreateListOfRemPoints();
+    remHelper->CalcCoverageAreaRemMap();
+    std::remove(("nr-rem-" + remHelper->m_simTag + "-ues.txt").c_str());
+
+    std::vector<double> values;
+    for (const auto& remPoint : remHelper->m_rem)
+    {
+        values.push_back(remPoint.avgSnrDb);
+        values.push_back(remPoint.avgSinrDb);
+        values.push_back(remPoint.avRxPowerDbm);
+    }
+    return values;
+}
+
+void
+NrRemCoverageAreaTestCase::DoRun()
+{
+    NodeContainer gnbNodes;
+    gnbNodes.Create(2);
+    NodeContainer ueNodes;
+    ueNodes.Create(1);
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(-30.0, 0.0, 25.0));
+    positionAlloc->Add(Vector(30.0, 0.0, 25.0));
+    positionAlloc->Add(Vector(0.0, 10.0, 1.5));
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(gnbNodes);
+    mobility.Install(ueNodes);
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetBeamformingHelper(CreateObject<IdealBeamformingHelper>());
+
+    // Random channel condition and shadowing, so that the maps only match if the
+    // channels of the RTDs use the same RNG streams in all the configurations
+    Ptr<NrChannelHelper> channelHelper = CreateObject<NrChannelHelper>();
+    channelHelper->ConfigureFactories("UMa", "Default", "ThreeGpp");
+    channelHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(true));
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(3.5e9, 10e6, 1);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    channelHelper->AssignChannelsToBands({band});
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    NrHelper::AntennaParams apGnb;
+    apGnb.antennaElem = "ns3::ThreeGppAntennaModel";
+    apGnb.nAntRows = 2;
+    apGnb.nAntCols = 2;
+    NrHelper::AntennaParams apUe;
+    apUe.antennaElem = "ns3::IsotropicAntennaModel";
+    apUe.nAntRows = 1;
+    apUe.nAntCols = 2;
+    nrHelper->SetupGnbAntennas(apGnb);
+    nrHelper->SetupUeAntennas(apUe);
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(0));
+
+    NetDeviceContainer gnbNetDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueNetDevs = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    nrHelper->AttachToGnb(ueNetDevs.Get(0), gnbNetDevs.Get(0));
+
+    std::vector<Ptr<NrRadioEnvironmentMapHelper>> remHelpers{
+        CreateRemHelper(false, 1, "test-rem-per-beam"),
+        CreateRemHelper(true, 1, "test-rem-reuse"),
+        CreateRemHelper(true, 3, "test-rem-reuse-threads"),
+    };
+    for (const auto& remHelper : remHelpers)
+    {
+        remHelper->CreateRem(gnbNetDevs, ueNetDevs.Get(0), 0);
+    }
+
+    Simulator::Stop(MilliSeconds(100));
+    Simulator::Run();
+
+    std::vector<double> reference = ComputeRem(remHelpers[0], gnbNetDevs, ueNetDevs.Get(0));
+    NS_TEST_ASSERT_MSG_EQ(reference.size(), 3 * 4 * 4, "Unexpected number of REM points");
+
+    for (size_t i = 1; i < remHelpers.size(); ++i)
+    {
+        std::vector<double> values = ComputeRem(remHelpers[i], gnbNetDevs, ueNetDevs.Get(0));
+        NS_TEST_ASSERT_MSG_EQ(values.size(), reference.size(), "Unexpected number of REM points");
+        for (size_t j = 0; j < values.size(); ++j)
+        {
+            NS_TEST_ASSERT_MSG_EQ_TOL(values[j],
+                                      reference[j],
+                                      1e-9,
+                                      "REM value " << j << " of " << remHelpers[i]->m_simTag
+                                                   << " differs from the per-beam computation");
+        }
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * @brief Compares the REM maps of a mode computed with one thread and with several
+ */
+class NrRemNumThreadsTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param remMode The REM mode
+     * @param remModeName The name of the REM mode
+     * @param numThreads The number of threads compared with a single one
+     */
+    NrRemNumThreadsTestCase(NrRadioEnvironmentMapHelper::RemMode remMode,
+                            const std::string& remModeName,
+                            uint32_t numThreads);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * @brief Computes the REM map of a helper, without writing the map files
+     * @param remHelper The REM helper
+     * @param rtdNetDev The RTDs
+     * @param rrdDevice The RRD
+     * @return The SNR, SINR, SIR and received power of each REM point
+     */
+    std::vector<double> ComputeRem(const Ptr<NrRadioEnvironmentMapHelper>& remHelper,
+                                   const NetDeviceContainer& rtdNetDev,
+                                   const Ptr<NetDevice>& rrdDevice) const;
+
+    NrRadioEnvironmentMapHelper::RemMode m_remMode; //!< The REM mode
+    uint32_t m_numThreads; //!< Number of threads compared with a single one
+};
+
+NrRemNumThreadsTestCase::NrRemNumThreadsTestCase(NrRadioEnvironmentMapHelper::RemMode remMode,
+                                                 const std::string& remModeName,
+                                                 uint32_t numThreads)
+    : TestCase(remModeName + " REM with " + std::to_string(numThreads) + " threads"),
+      m_remMode(remMode),
+      m_numThreads(numThreads)
+{
+}
+
+std::vector<double>
+NrRemNumThreadsTestCase::ComputeRem(const Ptr<NrRadioEnvironmentMapHelper>& remHelper,
+                                    const NetDeviceContainer& rtdNetDev,
+                                    const Ptr<NetDevice>& rrdDevice) const
+{
+    remHelper->ConfigureRrd(rrdDevice);
+    remHelper->ConfigureRtdList(rtdNetDev);
+    remHelper->CreateListOfRemPoints();
+    switch (m_remMode)
+    {
+    case NrRadioEnvironmentMapHelper::BEAM_SHAPE:
+        remHelper->CalcBeamShapeRemMap();
+        break;
+    case NrRadioEnvironmentMapHelper::COVERAGE_AREA:
+        remHelper->CalcCoverageAreaRemMap();
+        break;
+    case NrRadioEnvironmentMapHelper::UE_COVERAGE:
+        remHelper->CalcUeCoverageRemMap();
+        break;
+    }
+    std::remove(("nr-rem-" + remHelper->m_simTag + "-ues.txt").c_str());
+
+    std::vector<double> values;
+    for (const auto& remPoint : remHelper->m_rem)
+    {
+        values.push_back(remPoint.avgSnrDb);
+        values.push_back(remPoint.avgSinrDb);
+        values.push_back(remPoint.avgSirDb);
+        values.push_back(remPoint.avRxPowerDbm);
+    }
+    return values;
+}
+
+void
+NrRemNumThreadsTestCase::DoRun()
+{
+    NodeContainer gnbNodes;
+    gnbNodes.Create(2);
+    NodeContainer ueNodes;
+    ueNodes.Create(2);
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(-30.0, 0.0, 25.0));
+    positionAlloc->Add(Vector(30.0, 0.0, 25.0));
+    positionAlloc->Add(Vector(-10.0, 10.0, 1.5));
+    positionAlloc->Add(Vector(20.0, -15.0, 1.5));
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(gnbNodes);
+    mobility.Install(ueNodes);
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetBeamformingHelper(CreateObject<IdealBeamformingHelper>());
+
+    // Random channel condition and shadowing, so that the maps only match if every REM
+    // point uses the same RNG streams with any number of threads
+    Ptr<NrChannelHelper> channelHelper = CreateObject<NrChannelHelper>();
+    channelHelper->ConfigureFactories("UMa", "Default", "ThreeGpp");
+    channelHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(true));
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(3.5e9, 10e6, 1);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    channelHelper->AssignChannelsToBands({band});
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    NrHelper::AntennaParams apGnb;
+    apGnb.antennaElem = "ns3::ThreeGppAntennaModel";
+    apGnb.nAntRows = 2;
+    apGnb.nAntCols = 2;
+    NrHelper::AntennaParams apUe;
+    apUe.antennaElem = "ns3::IsotropicAntennaModel";
+    apUe.nAntRows = 1;
+    apUe.nAntCols = 2;
+    nrHelper->SetupGnbAntennas(apGnb);
+    nrHelper->SetupUeAntennas(apUe);
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(0));
+
+    NetDeviceContainer gnbNetDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueNetDevs = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    nrHelper->AttachToGnb(ueNetDevs.Get(0), gnbNetDevs.Get(0));
+    nrHelper->AttachToGnb(ueNetDevs.Get(1), gnbNetDevs.Get(1));
+
+    // The UEs transmit towards a gNB in the UeCoverage map, the gNBs towards a UE otherwise
+    bool ueCoverage = m_remMode == NrRadioEnvironmentMapHelper::UE_COVERAGE;
+    NetDeviceContainer rtdNetDevs = ueCoverage ? ueNetDevs : gnbNetDevs;
+    Ptr<NetDevice> rrdDevice = ueCoverage ? gnbNetDevs.Get(0) : ueNetDevs.Get(0);
+
+    std::vector<Ptr<NrRadioEnvironmentMapHelper>> remHelpers;
+    for (uint32_t numThreads : {1U, m_numThreads})
+    {
+        Ptr<NrRadioEnvironmentMapHelper> remHelper = CreateObject<NrRadioEnvironmentMapHelper>();
+        remHelper->SetMinX(-60.0);
+        remHelper->SetMaxX(60.0);
+        remHelper->SetResX(3);
+        remHelper->SetMinY(-40.0);
+        remHelper->SetMaxY(40.0);
+        remHelper->SetResY(3);
+        remHelper->SetZ(1.5);
+        remHelper->SetSimTag("test-rem-threads-" + std::to_string(numThreads));
+        remHelper->SetRemMode(m_remMode);
+        remHelper->SetNumOfItToAverage(2);
+        remHelper->SetNumThreads(numThreads);
+        // The REM is computed by ComputeRem(), the scheduled installation is never executed
+        remHelper->SetInstallationDelay(Seconds(10));
+        remHelper->CreateRem(rtdNetDevs, rrdDevice, 0);
+        remHelpers.push_back(remHelper);
+    }
+
+    Simulator::Stop(MilliSeconds(100));
+    Simulator::Run();
+
+    std::vector<double> expected = ComputeRem(remHelpers[0], rtdNetDevs, rrdDevice);
+    std::vector<double> values = ComputeRem(remHelpers[1], rtdNetDevs, rrdDevice);
+    NS_TEST_ASSERT_MSG_EQ(expected.size(), 4 * 4 * 4, "Unexpected number of REM points");
+    NS_TEST_ASSERT_MSG_EQ(values.size(), expected.size(), "Unexpected number of REM points");
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(values[i],
+                              expected[i],
+                              "REM value " << i << " differs from the single thread computation");
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * @brief Test suite of the radio environment map helper
+ */
+class NrRemTestSuite : public TestSuite
+{
+  public:
+    NrRemTestSuite()
+        : TestSuite("nr-test-rem", Type::SYSTEM)
+    {
+        AddTestCase(new NrRemCoverageAreaTestCase(1), Duration::QUICK);
+        AddTestCase(new NrRemCoverageAreaTestCase(2), Duration::QUICK);
+        AddTestCase(new NrRemNumThreadsTestCase(NrRadioEnvironmentMapHelper::BEAM_SHAPE,
+                                                "BeamShape",
+                                                4),
+                    Duration::QUICK);
+        AddTestCase(new NrRemNumThreadsTestCase(NrRadioEnvironmentMapHelper::COVERAGE_AREA,
+                                                "CoverageArea",
+                                                4),
+                    Duration::QUICK);
+        AddTestCase(new NrRemNumThreadsTestCase(NrRadioEnvironmentMapHelper::UE_COVERAGE,
+                                                "UeCoverage",
+                                                4),
+                    Duration::QUICK);
+    }
+};
+
+static NrRemTestSuite g_nrRemTestSuite; //!< REM test suite
+
+} // namespace ns3
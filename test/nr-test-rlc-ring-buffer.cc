@@ -0,0 +1,196 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/nr-rlc-ring-buffer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <deque>
+
+/**
+ * @file nr-test-rlc-ring-buffer.cc
+ * @ingroup test
+ *
+ * @brief Checks that NrRlcRingBuffer behaves as a std::deque for a random sequence of
+ * pushes and pops at both ends, that it destroys all the elements it constructs, and that
+ * the elements of a resized buffer keep their positions.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Element without default constructor that counts the live instances
+ */
+class NrRingBufferElement
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param value the value
+     */
+    explicit NrRingBufferElement(uint32_t value)
+        : m_value(value)
+    {
+        ++m_live;
+    }
+
+    /**
+     * @brief Copy constructor
+     * @param other the element to copy
+     */
+    NrRingBufferElement(const NrRingBufferElement& other)
+        : m_value(other.m_value)
+    {
+        ++m_live;
+    }
+
+    /**
+     * @brief Assignment operator
+     * @param other the element to copy
+     * @return this element
+     */
+    NrRingBufferElement& operator=(const NrRingBufferElement& other) = default;
+
+    ~NrRingBufferElement()
+    {
+        --m_live;
+    }
+
+    uint32_t m_value;      //!< Value
+    static int64_t m_live; //!< Number of live instances
+};
+
+int64_t NrRingBufferElement::m_live = 0;
+
+/**
+ * @brief Compares NrRlcRingBuffer with std::deque
+ */
+class NrRlcRingBufferTestCase : public TestCase
+{
+  public:
+    NrRlcRingBufferTestCase()
+        : TestCase("NrRlcRingBuffer against std::deque")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrRlcRingBufferTestCase::DoRun()
+{
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+
+    {
+        NrRlcRingBuffer<NrRingBufferElement> queue;
+        std::deque<uint32_t> reference;
+        for (uint32_t op = 0; op < 20000; ++op)
+        {
+            // Grow on average during the first half, then shrink, so that the capacity
+            // doubles several times while the head wraps around
+            uint32_t pushBias = op < 10000 ? 6 : 3;
+            uint32_t action = rv->GetInteger(0, 9);
+            if (action < pushBias)
+            {
+                if (action % 2)
+                {
+                    queue.emplace_back(op);
+                    reference.push_back(op);
+                }
+                else if (reference.empty())
+                {
+                    queue.emplace_front(op);
+                    reference.push_front(op);
+                }
+                else
+                {
+                    // Copy an element of the queue itself, which must survive the growth
+                    // of the storage
+                    queue.emplace_front(queue.back());
+                    reference.push_front(reference.back());
+                }
+            }
+            else if (!reference.empty())
+            {
+                if (action % 2)
+                {
+                    queue.pop_front();
+                    reference.pop_front();
+                }
+                else
+                {
+                    queue.pop_back();
+                    reference.pop_back();
+                }
+            }
+
+            NS_TEST_ASSERT_MSG_EQ(queue.size(), reference.size(), "Size differs at op " << op);
+            if (!reference.empty())
+            {
+                NS_TEST_ASSERT_MSG_EQ(queue.front().m_value,
+                                      reference.front(),
+                                      "Front differs at op " << op);
+                NS_TEST_ASSERT_MSG_EQ(queue.back().m_value,
+                                      reference.back(),
+                                      "Back differs at op " << op);
+                size_t i = rv->GetInteger(0, reference.size() - 1);
+                NS_TEST_ASSERT_MSG_EQ(queue[i].m_value,
+                                      reference[i],
+                                      "Element " << i << " differs at op " << op);
+            }
+        }
+
+        size_t i = 0;
+        for (const auto& element : queue)
+        {
+            NS_TEST_ASSERT_MSG_EQ(element.m_value, reference.at(i++), "Iteration differs");
+        }
+        NS_TEST_ASSERT_MSG_EQ(i, reference.size(), "Iteration length differs");
+
+        NrRlcRingBuffer<NrRingBufferElement> copy(queue);
+        NS_TEST_ASSERT_MSG_EQ(copy.size(), queue.size(), "Copy size differs");
+        NS_TEST_ASSERT_MSG_EQ(NrRingBufferElement::m_live,
+                              static_cast<int64_t>(2 * reference.size()),
+                              "Unexpected number of live elements");
+
+        size_t capacity = queue.capacity();
+        queue.clear();
+        NS_TEST_ASSERT_MSG_EQ(queue.empty(), true, "Queue not empty after clear");
+        NS_TEST_ASSERT_MSG_EQ(queue.capacity(), capacity, "Clear released the storage");
+    }
+    NS_TEST_ASSERT_MSG_EQ(NrRingBufferElement::m_live, 0, "Elements were leaked");
+
+    // Sequence-number indexed buffer, as the retransmission buffers of NrRlcAm
+    NrRlcRingBuffer<uint32_t> snBuffer;
+    snBuffer.resize(1024);
+    NS_TEST_ASSERT_MSG_EQ(snBuffer.size(), 1024, "Wrong size after resize");
+    for (uint32_t sn = 0; sn < 1024; ++sn)
+    {
+        NS_TEST_ASSERT_MSG_EQ(snBuffer.at(sn), 0, "Resize did not value-initialize");
+        snBuffer.at(sn) = sn * 3;
+    }
+    for (uint32_t sn = 0; sn < 1024; ++sn)
+    {
+        NS_TEST_ASSERT_MSG_EQ(snBuffer[sn], sn * 3, "Element moved from its sequence number");
+    }
+}
+
+/**
+ * @brief Test suite of the ring buffer of the RLC entities
+ */
+class NrRlcRingBufferTestSuite : public TestSuite
+{
+  public:
+    NrRlcRingBufferTestSuite()
+        : TestSuite("nr-test-rlc-ring-buffer", Type::UNIT)
+    {
+        AddTestCase(new NrRlcRingBufferTestCase(), Duration::QUICK);
+    }
+};
+
+static NrRlcRingBufferTestSuite g_nrRlcRingBufferTestSuite; //!< RLC ring buffer test suite
+
+} // namespace ns3
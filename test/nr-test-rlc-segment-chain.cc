@@ -0,0 +1,109 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/nr-rlc-segment-chain.h"
+#include "ns3/packet.h"
+#include "ns3/test.h"
+
+#include <numeric>
+
+/**
+ * @file nr-test-rlc-segment-chain.cc
+ * @ingroup test
+ *
+ * @brief Checks that NrRlcSegmentChain reassembles the fragments of a packet, for any
+ * number of fragments, into a packet with the same bytes, and that a chain of a single
+ * segment is returned as it is.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Splits a packet into fragments and reassembles them with NrRlcSegmentChain
+ */
+class NrRlcSegmentChainTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param numSegments the number of fragments
+     */
+    NrRlcSegmentChainTestCase(uint32_t numSegments);
+
+  private:
+    void DoRun() override;
+
+    uint32_t m_numSegments; //!< Number of fragments
+};
+
+NrRlcSegmentChainTestCase::NrRlcSegmentChainTestCase(uint32_t numSegments)
+    : TestCase("Reassembly of " + std::to_string(numSegments) + " segments"),
+      m_numSegments(numSegments)
+{
+}
+
+void
+NrRlcSegmentChainTestCase::DoRun()
+{
+    const uint32_t sduSize = 1500;
+    std::vector<uint8_t> bytes(sduSize);
+    std::iota(bytes.begin(), bytes.end(), 0);
+    Ptr<Packet> sdu = Create<Packet>(bytes.data(), sduSize);
+
+    // Segments of different sizes, as created by the transmitting RLC entities
+    NrRlcSegmentChain chain;
+    Ptr<Packet> remaining = sdu->Copy();
+    for (uint32_t i = 0; i < m_numSegments; ++i)
+    {
+        uint32_t size = i + 1 < m_numSegments ? remaining->GetSize() / (m_numSegments - i) + i
+                                              : remaining->GetSize();
+        Ptr<Packet> segment = remaining->CreateFragment(0, size);
+        remaining->RemoveAtStart(size);
+        if (i == 0)
+        {
+            chain.Start(segment);
+        }
+        else
+        {
+            chain.Append(segment);
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(remaining->GetSize(), 0, "Not all the bytes were segmented");
+
+    Ptr<Packet> first = chain.Assemble();
+    Ptr<Packet> again = chain.Assemble();
+    NS_TEST_ASSERT_MSG_EQ(first, again, "The assembled packet is not kept in the chain");
+    NS_TEST_ASSERT_MSG_EQ(first->GetSize(), sduSize, "Wrong size of the reassembled SDU");
+
+    std::vector<uint8_t> reassembled(sduSize);
+    first->CopyData(reassembled.data(), sduSize);
+    for (uint32_t i = 0; i < sduSize; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(+reassembled[i], +bytes[i], "Byte " << i << " differs");
+    }
+
+    chain.Clear();
+    NS_TEST_ASSERT_MSG_EQ(chain.IsEmpty(), true, "The chain is not empty after Clear()");
+    NS_TEST_ASSERT_MSG_EQ((chain.Assemble() == nullptr), true, "An empty chain assembled a packet");
+}
+
+/**
+ * @brief Test suite of the RLC segment chain
+ */
+class NrRlcSegmentChainTestSuite : public TestSuite
+{
+  public:
+    NrRlcSegmentChainTestSuite()
+        : TestSuite("nr-test-rlc-segment-chain", Type::UNIT)
+    {
+        for (uint32_t numSegments : {1, 2, 3, 5, 8, 13})
+        {
+            AddTestCase(new NrRlcSegmentChainTestCase(numSegments), Duration::QUICK);
+        }
+    }
+};
+
+static NrRlcSegmentChainTestSuite g_nrRlcSegmentChainTestSuite; //!< RLC segment chain test suite
+
+} // namespace ns3
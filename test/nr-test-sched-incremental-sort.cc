@@ -0,0 +1,360 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/boolean.h"
+#include "ns3/enum.h"
+#include "ns3/nr-amc.h"
+#include "ns3/nr-mac-sched-sap.h"
+#include "ns3/nr-mac-scheduler-ns3.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <memory>
+
+/**
+ * @file nr-test-sched-incremental-sort.cc
+ * @ingroup test
+ *
+ * @brief Checks that the OFDMA schedulers produce the same DL and UL allocations
+ * when the UEs are sorted again for each RBG, and when only the UE that got the RBG
+ * is moved in the sorted vector (attribute IncrementalUeSort of NrMacSchedulerOfdma).
+ */
+namespace ns3
+{
+
+/**
+ * @brief CSCHED SAP user that ignores all the messages
+ */
+class NrIncrementalSortCschedSapUser : public NrMacCschedSapUser
+{
+  public:
+    void CschedCellConfigCnf(
+        [[maybe_unused]] const struct CschedCellConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigCnf(
+        [[maybe_unused]] const struct CschedUeConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcConfigCnf(
+        [[maybe_unused]] const struct CschedLcConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcReleaseCnf(
+        [[maybe_unused]] const struct CschedLcReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeReleaseCnf(
+        [[maybe_unused]] const struct CschedUeReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigUpdateInd(
+        [[maybe_unused]] const struct CschedUeConfigUpdateIndParameters& params) override
+    {
+    }
+
+    void CschedCellConfigUpdateInd(
+        [[maybe_unused]] const struct CschedCellConfigUpdateIndParameters& params) override
+    {
+    }
+};
+
+/**
+ * @brief SCHED SAP user that stores the DCIs of the last scheduled slot
+ */
+class NrIncrementalSortSchedSapUser : public NrMacSchedSapUser
+{
+  public:
+    void SchedConfigInd(const struct SchedConfigIndParameters& params) override
+    {
+        m_dcis.clear();
+        for (const auto& varTti : params.m_slotAllocInfo.m_varTtiAllocInfo)
+        {
+            m_dcis.push_back(varTti.m_dci);
+        }
+    }
+
+    Ptr<const SpectrumModel> GetSpectrumModel() const override
+    {
+        return nullptr;
+    }
+
+    uint32_t GetNumRbPerRbg() const override
+    {
+        return 1;
+    }
+
+    uint8_t GetNumHarqProcess() const override
+    {
+        return 20;
+    }
+
+    uint16_t GetBwpId() const override
+    {
+        return 0;
+    }
+
+    uint16_t GetCellId() const override
+    {
+        return 0;
+    }
+
+    uint32_t GetSymbolsPerSlot() const override
+    {
+        return 14;
+    }
+
+    Time GetSlotPeriod() const override
+    {
+        return MilliSeconds(1);
+    }
+
+    void BuildRarList([[maybe_unused]] SlotAllocInfo& allocInfo) override
+    {
+    }
+
+    std::vector<std::shared_ptr<DciInfoElementTdma>> m_dcis; //!< DCIs of the last slot
+};
+
+/**
+ * @brief Schedules the same traffic with and without the incremental sort of the UEs,
+ * and compares the DCIs
+ */
+class NrSchedIncrementalSortTestCase : public TestCase
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param scheduler The OFDMA scheduler (RR, PF, MR, Qos)
+     * @param mcsCsiSource The McsCsiSource attribute of the scheduler
+     * @param uesPerBeam The number of UEs in each of the two beams
+     */
+    NrSchedIncrementalSortTestCase(const std::string& scheduler,
+                                   const std::string& mcsCsiSource,
+                                   uint32_t uesPerBeam)
+        : TestCase("OFDMA " + scheduler + ", " + mcsCsiSource + ", " +
+                   std::to_string(uesPerBeam) + " UEs per beam"),
+          m_scheduler(scheduler),
+          m_mcsCsiSource(mcsCsiSource),
+          m_uesPerBeam(uesPerBeam)
+    {
+    }
+
+  private:
+    /**
+     * @brief A scheduler and its SAP users
+     */
+    struct Cell
+    {
+        Ptr<NrMacSchedulerNs3> sched;                           //!< The scheduler
+        std::unique_ptr<NrIncrementalSortSchedSapUser> sapUser; //!< The SCHED SAP user
+        std::unique_ptr<NrIncrementalSortCschedSapUser> csapUser; //!< The CSCHED SAP user
+    };
+
+    void DoRun() override;
+
+    /**
+     * @brief Create and configure a scheduler
+     * @param incrementalUeSort The IncrementalUeSort attribute
+     * @return The scheduler and its SAP users
+     */
+    Cell CreateCell(bool incrementalUeSort) const;
+
+    /**
+     * @brief Check that two slots have the same DCIs
+     * @param reference The DCIs of the scheduler that sorts the UEs for each RBG
+     * @param incremental The DCIs of the scheduler with the incremental sort
+     * @param slot The slot, for the error messages
+     */
+    void CheckSameDcis(const std::vector<std::shared_ptr<DciInfoElementTdma>>& reference,
+                       const std::vector<std::shared_ptr<DciInfoElementTdma>>& incremental,
+                       const std::string& slot);
+
+    std::string m_scheduler;    //!< The OFDMA scheduler
+    std::string m_mcsCsiSource; //!< The McsCsiSource attribute
+    uint32_t m_uesPerBeam;      //!< The number of UEs in each beam
+};
+
+NrSchedIncrementalSortTestCase::Cell
+NrSchedIncrementalSortTestCase::CreateCell(bool incrementalUeSort) const
+{
+    ObjectFactory schedFactory;
+    schedFactory.SetTypeId("ns3::NrMacSchedulerOfdma" + m_scheduler);
+    schedFactory.Set("IncrementalUeSort", BooleanValue(incrementalUeSort));
+    schedFactory.Set("McsCsiSource", StringValue(m_mcsCsiSource));
+
+    Cell cell;
+    cell.sched = DynamicCast<NrMacSchedulerNs3>(schedFactory.Create());
+    cell.sapUser = std::make_unique<NrIncrementalSortSchedSapUser>();
+    cell.csapUser = std::make_unique<NrIncrementalSortCschedSapUser>();
+    cell.sched->SetMacSchedSapUser(cell.sapUser.get());
+    cell.sched->SetMacCschedSapUser(cell.csapUser.get());
+
+    NrMacCschedSapProvider::CschedCellConfigReqParameters cellConfig{};
+    cellConfig.m_dlBandwidth = 100;
+    cellConfig.m_ulBandwidth = 100;
+    cell.sched->DoCschedCellConfigReq(cellConfig);
+    cell.sched->InstallDlAmc(CreateObject<NrAmc>());
+    cell.sched->InstallUlAmc(CreateObject<NrAmc>());
+
+    for (uint16_t rnti = 1; rnti <= 2 * m_uesPerBeam; ++rnti)
+    {
+        NrMacCschedSapProvider::CschedUeConfigReqParameters ueConfig;
+        ueConfig.m_rnti = rnti;
+        ueConfig.m_beamId = BeamId(rnti % 2, 120.0);
+        cell.sched->DoCschedUeConfigReq(ueConfig);
+
+        NrMacCschedSapProvider::CschedLcConfigReqParameters lcConfig;
+        lcConfig.m_rnti = rnti;
+        lcConfig.m_reconfigureFlag = false;
+        nr::LogicalChannelConfigListElement_s lc;
+        lc.m_direction = nr::LogicalChannelConfigListElement_s::Direction_e::DIR_BOTH;
+        lc.m_qosBearerType = nr::LogicalChannelConfigListElement_s::QosBearerType_e::QBT_NON_GBR;
+        lc.m_qci = 9;
+        lc.m_logicalChannelGroup = 3;
+        lc.m_logicalChannelIdentity = 3;
+        lcConfig.m_logicalChannelConfigList.emplace_back(lc);
+        cell.sched->DoCschedLcConfigReq(lcConfig);
+    }
+    return cell;
+}
+
+void
+NrSchedIncrementalSortTestCase::CheckSameDcis(
+    const std::vector<std::shared_ptr<DciInfoElementTdma>>& reference,
+    const std::vector<std::shared_ptr<DciInfoElementTdma>>& incremental,
+    const std::string& slot)
+{
+    NS_TEST_ASSERT_MSG_EQ(incremental.size(), reference.size(), "Different DCIs in " << slot);
+    for (size_t i = 0; i < reference.size(); ++i)
+    {
+        const auto& ref = *reference[i];
+        const auto& inc = *incremental[i];
+        NS_TEST_ASSERT_MSG_EQ(inc.m_rnti, ref.m_rnti, "Different RNTI in " << slot);
+        NS_TEST_ASSERT_MSG_EQ(inc.m_format, ref.m_format, "Different format in " << slot);
+        NS_TEST_ASSERT_MSG_EQ(+inc.m_symStart, +ref.m_symStart, "Different symbol in " << slot);
+        NS_TEST_ASSERT_MSG_EQ(+inc.m_numSym, +ref.m_numSym, "Different symbols in " << slot);
+        NS_TEST_ASSERT_MSG_EQ(+inc.m_mcs, +ref.m_mcs, "Different MCS in " << slot);
+        NS_TEST_ASSERT_MSG_EQ(inc.m_tbSize, ref.m_tbSize, "Different TB size in " << slot);
+        NS_TEST_ASSERT_MSG_EQ((inc.m_rbgBitmask == ref.m_rbgBitmask),
+                              true,
+                              "Different RBGs for UE " << ref.m_rnti << " in " << slot);
+    }
+}
+
+void
+NrSchedIncrementalSortTestCase::DoRun()
+{
+    Cell reference = CreateCell(false);
+    Cell incremental = CreateCell(true);
+
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+    random->SetStream(1);
+
+    const bool subband = m_mcsCsiSource != "WIDEBAND_MCS";
+    for (uint16_t slot = 0; slot < 8; ++slot)
+    {
+        NrMacSchedSapProvider::SchedDlCqiInfoReqParameters cqiParams{};
+        NrMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrParams{};
+        std::vector<NrMacSchedSapProvider::SchedDlRlcBufferReqParameters> rlcParams;
+
+        for (uint16_t rnti = 1; rnti <= 2 * m_uesPerBeam; ++rnti)
+        {
+            DlCqiInfo cqi;
+            cqi.m_rnti = rnti;
+            cqi.m_ri = 1;
+            cqi.m_wbCqi = random->GetInteger(1, 15);
+            if (subband)
+            {
+                cqi.m_cqiType = DlCqiInfo::SB;
+                for (uint32_t sb = 0; sb < 13; ++sb)
+                {
+                    cqi.m_sbCqis.push_back(random->GetInteger(0, 15));
+                }
+            }
+            cqiParams.m_cqiList.push_back(cqi);
+
+            // Some UEs without data, and some with a small buffer, so that the scheduler
+            // skips UEs and reaps the resources of the UEs with a too small TB
+            NrMacSchedSapProvider::SchedDlRlcBufferReqParameters rlc{};
+            rlc.m_rnti = rnti;
+            rlc.m_logicalChannelIdentity = 3;
+            rlc.m_rlcTransmissionQueueSize =
+                random->GetValue() < 0.2 ? 0 : random->GetInteger(1, 30000);
+            rlcParams.push_back(rlc);
+
+            MacCeElement bsr;
+            bsr.m_rnti = rnti;
+            bsr.m_macCeType = MacCeElement::BSR;
+            bsr.m_macCeValue.m_bufferStatus = {0, 0, 0, 0};
+            bsr.m_macCeValue.m_bufferStatus[3] = random->GetInteger(0, 24);
+            bsrParams.m_macCeList.push_back(bsr);
+        }
+
+        const SfnSf sfnSf(0, slot, 0, 0);
+        for (auto cell : {&reference, &incremental})
+        {
+            cell->sched->DoSchedDlCqiInfoReq(cqiParams);
+            for (const auto& rlc : rlcParams)
+            {
+                cell->sched->DoSchedDlRlcBufferReq(rlc);
+            }
+            cell->sched->DoSchedUlMacCtrlInfoReq(bsrParams);
+        }
+
+        NrMacSchedSapProvider::SchedDlTriggerReqParameters dlTrigger;
+        dlTrigger.m_snfSf = sfnSf;
+        dlTrigger.m_slotType = LteNrTddSlotType::DL;
+        reference.sched->DoSchedDlTriggerReq(dlTrigger);
+        incremental.sched->DoSchedDlTriggerReq(dlTrigger);
+        CheckSameDcis(reference.sapUser->m_dcis,
+                      incremental.sapUser->m_dcis,
+                      "DL slot " + std::to_string(slot));
+
+        NrMacSchedSapProvider::SchedUlTriggerReqParameters ulTrigger;
+        ulTrigger.m_snfSf = sfnSf;
+        ulTrigger.m_slotType = LteNrTddSlotType::UL;
+        reference.sched->DoSchedUlTriggerReq(ulTrigger);
+        incremental.sched->DoSchedUlTriggerReq(ulTrigger);
+        CheckSameDcis(reference.sapUser->m_dcis,
+                      incremental.sapUser->m_dcis,
+                      "UL slot " + std::to_string(slot));
+    }
+}
+
+/**
+ * @brief Test suite of the incremental sort of the UEs in the OFDMA schedulers
+ */
+class NrSchedIncrementalSortTestSuite : public TestSuite
+{
+  public:
+    NrSchedIncrementalSortTestSuite()
+        : TestSuite("nr-test-sched-incremental-sort", Type::UNIT)
+    {
+        for (const auto& scheduler : {"RR", "PF", "MR", "Qos"})
+        {
+            for (const auto& mcsCsiSource : {"WIDEBAND_MCS", "AVG_MCS"})
+            {
+                for (uint32_t uesPerBeam : {3, 20})
+                {
+                    AddTestCase(
+                        new NrSchedIncrementalSortTestCase(scheduler, mcsCsiSource, uesPerBeam),
+                        Duration::QUICK);
+                }
+            }
+        }
+    }
+};
+
+static NrSchedIncrementalSortTestSuite
+    g_nrSchedIncrementalSortTestSuite; //!< Incremental UE sort test suite
+
+} // namespace ns3
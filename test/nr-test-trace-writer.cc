@@ -0,0 +1,226 @@
+// Copyright (c) 2025 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "ns3/nr-trace-writer.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+/**
+ * @file nr-test-trace-writer.cc
+ * @ingroup test
+ *
+ * @brief Writes the same rows with the TEXT and BINARY trace writers, and checks that the
+ * binary file reads back the exact values, over several blocks, and converts to a text
+ * file identical to the one of the TEXT writer. The same is checked for rows with arrays
+ * of variable length, in blocks limited by size.
+ */
+namespace ns3
+{
+
+/**
+ * @brief Compares the text and binary trace writers
+ */
+class NrTraceWriterTestCase : public TestCase
+{
+  public:
+    NrTraceWriterTestCase()
+        : TestCase("Binary traces convert to the same text as the text traces")
+    {
+    }
+
+    /**
+     * @param fileName the name of a file
+     * @return the contents of the file
+     */
+    static std::string ReadFile(const std::string& fileName);
+
+  private:
+    void DoRun() override;
+};
+
+std::string
+NrTraceWriterTestCase::ReadFile(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+void
+NrTraceWriterTestCase::DoRun()
+{
+    NS_TEST_ASSERT_MSG_EQ(NrTraceWriter::GetFileName("RxPacketTrace.txt", NrTraceWriter::BINARY),
+                          "RxPacketTrace.bin",
+                          "The .txt extension is not replaced");
+    NS_TEST_ASSERT_MSG_EQ(NrTraceWriter::GetFileName("NrDlMacStats", NrTraceWriter::BINARY),
+                          "NrDlMacStats.bin",
+                          "The .bin extension is not appended");
+    NS_TEST_ASSERT_MSG_EQ(NrTraceWriter::GetFileName("RxPacketTrace.txt", NrTraceWriter::TEXT),
+                          "RxPacketTrace.txt",
+                          "The text file name is changed");
+
+    const std::vector<NrTraceWriter::Column> columns = {
+        {"Time", NrTraceWriter::ColumnType::DOUBLE, {}},
+        {"direction", NrTraceWriter::ColumnType::LABEL, {"DL", "UL"}},
+        {"frame", NrTraceWriter::ColumnType::UINT32, {}},
+        {"slot", NrTraceWriter::ColumnType::UINT8, {}},
+        {"cellId", NrTraceWriter::ColumnType::UINT64, {}},
+        {"rnti", NrTraceWriter::ColumnType::UINT16, {}},
+        {"SINR(dB)", NrTraceWriter::ColumnType::DOUBLE, {}}};
+    const std::string textFile = CreateTempDirFilename("NrTraceWriter.txt");
+    const std::string binaryFile =
+        CreateTempDirFilename(NrTraceWriter::GetFileName("NrTraceWriter.txt",
+                                                         NrTraceWriter::BINARY));
+    const std::string convertedFile = CreateTempDirFilename("NrTraceWriterConverted.txt");
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(1);
+
+    // More than two blocks, the last one incomplete
+    const uint32_t rows = 2 * NrBinaryTraceWriter::GetBlockRows() + 100;
+    std::vector<double> sinrs;
+    std::vector<uint64_t> cellIds;
+    {
+        auto text = NrTraceWriter::Create(NrTraceWriter::TEXT, textFile, columns, "% ");
+        auto binary = NrTraceWriter::Create(NrTraceWriter::BINARY, binaryFile, columns, "% ");
+        for (uint32_t i = 0; i < rows; ++i)
+        {
+            double time = i * 125e-6;
+            const char* direction = rv->GetInteger(0, 1) ? "UL" : "DL";
+            uint32_t frame = i / 80;
+            auto slot = static_cast<uint8_t>(rv->GetInteger(0, 255));
+            // Large jumps in both directions, and values that need all 64 bits
+            uint64_t cellId = rv->GetInteger(0, 3) == 0 ? std::numeric_limits<uint64_t>::max() - i
+                                                         : rv->GetInteger(1, 100);
+            auto rnti = static_cast<uint16_t>(rv->GetInteger(1, 65535));
+            double sinr = i % 1000 == 0 ? -std::numeric_limits<double>::infinity()
+                                        : rv->GetValue(-20, 40);
+            sinrs.push_back(sinr);
+            cellIds.push_back(cellId);
+
+            *text << time << direction << frame << slot << cellId << rnti << sinr;
+            text->EndRow();
+            *binary << time << direction << frame << slot << cellId << rnti << sinr;
+            binary->EndRow();
+        }
+    }
+
+    NrBinaryTraceReader reader(binaryFile);
+    NS_TEST_ASSERT_MSG_EQ(reader.GetColumns().size(), columns.size(), "Wrong number of columns");
+    NS_TEST_ASSERT_MSG_EQ(reader.GetHeaderPrefix(), "% ", "Wrong header prefix");
+    for (uint32_t i = 0; i < rows; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(reader.ReadRow(), true, "Missing row " << i);
+        NS_TEST_ASSERT_MSG_EQ(reader.GetUint(4), cellIds[i], "Wrong cell ID at row " << i);
+        // Bit-exact, including infinities
+        NS_TEST_ASSERT_MSG_EQ((reader.GetDouble(6) == sinrs[i]), true, "Wrong SINR at row " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(reader.ReadRow(), false, "Unexpected row after the last one");
+
+    NrBinaryTraceReader converter(binaryFile);
+    NS_TEST_ASSERT_MSG_EQ(converter.ConvertToText(convertedFile), rows, "Rows not converted");
+
+    std::string text = ReadFile(textFile);
+    NS_TEST_ASSERT_MSG_GT(text.size(), 0, "Empty text file");
+    NS_TEST_ASSERT_MSG_EQ((text == ReadFile(convertedFile)),
+                          true,
+                          "The converted binary file differs from the text file");
+    NS_TEST_ASSERT_MSG_LT(ReadFile(binaryFile).size(),
+                          text.size(),
+                          "The binary file is not smaller than the text file");
+}
+
+/**
+ * @brief Checks the DOUBLE_ARRAY columns, as in the per-UE UL SINR traces
+ */
+class NrTraceWriterArrayTestCase : public TestCase
+{
+  public:
+    NrTraceWriterArrayTestCase()
+        : TestCase("Binary traces with arrays of doubles")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrTraceWriterArrayTestCase::DoRun()
+{
+    const std::vector<NrTraceWriter::Column> columns = {
+        {"subframe", NrTraceWriter::ColumnType::UINT64, {}},
+        {"slot", NrTraceWriter::ColumnType::UINT8, {}},
+        {"SINR(dB)", NrTraceWriter::ColumnType::DOUBLE_ARRAY, {}}};
+    const std::string textFile = CreateTempDirFilename("NrTraceWriterArray.txt");
+    const std::string binaryFile = CreateTempDirFilename("NrTraceWriterArray.bin");
+    const std::string convertedFile = CreateTempDirFilename("NrTraceWriterArrayConverted.txt");
+
+    Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable>();
+    rv->SetStream(2);
+
+    const uint32_t rows = 3000;
+    std::vector<std::vector<double>> arrays;
+    {
+        NrTextTraceWriter text(textFile, columns, "");
+        NrBinaryTraceWriter binary(binaryFile, columns, "");
+        // Blocks of a few rows, and rows larger than a block
+        binary.SetMaxBlockSize(4096);
+        for (uint32_t i = 0; i < rows; ++i)
+        {
+            std::vector<double> sinrs(rv->GetInteger(0, 1000));
+            for (auto& sinr : sinrs)
+            {
+                sinr = rv->GetValue(-10, 30);
+            }
+            text << i / 8 + 1 << i % 8 + 1 << sinrs;
+            text.EndRow();
+            binary << i / 8 + 1 << i % 8 + 1 << sinrs;
+            binary.EndRow();
+            arrays.push_back(std::move(sinrs));
+        }
+    }
+
+    NrBinaryTraceReader reader(binaryFile);
+    for (uint32_t i = 0; i < rows; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(reader.ReadRow(), true, "Missing row " << i);
+        NS_TEST_ASSERT_MSG_EQ(reader.GetUint(0), i / 8 + 1, "Wrong subframe at row " << i);
+        NS_TEST_ASSERT_MSG_EQ((reader.GetDoubleArray(2) == arrays[i]),
+                              true,
+                              "Wrong array at row " << i);
+    }
+    NS_TEST_ASSERT_MSG_EQ(reader.ReadRow(), false, "Unexpected row after the last one");
+
+    NrBinaryTraceReader converter(binaryFile);
+    NS_TEST_ASSERT_MSG_EQ(converter.ConvertToText(convertedFile), rows, "Rows not converted");
+    NS_TEST_ASSERT_MSG_EQ((NrTraceWriterTestCase::ReadFile(textFile) ==
+                           NrTraceWriterTestCase::ReadFile(convertedFile)),
+                          true,
+                          "The converted binary file differs from the text file");
+}
+
+/**
+ * @brief Test suite of the trace writers
+ */
+class NrTraceWriterTestSuite : public TestSuite
+{
+  public:
+    NrTraceWriterTestSuite()
+        : TestSuite("nr-test-trace-writer", Type::UNIT)
+    {
+        AddTestCase(new NrTraceWriterTestCase(), Duration::QUICK);
+        AddTestCase(new NrTraceWriterArrayTestCase(), Duration::QUICK);
+    }
+};
+
+static NrTraceWriterTestSuite g_nrTraceWriterTestSuite; //!< Trace writer test suite
+
+} // namespace ns3
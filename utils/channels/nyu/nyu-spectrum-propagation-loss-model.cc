@@ -16,8 +16,14 @@
 #include "ns3/simulator.h"
 #include "ns3/spectrum-signal-parameters.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <functional>
 #include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -26,6 +32,35 @@ NS_LOG_COMPONENT_DEFINE("NYUSpectrumPropagationLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED(NYUSpectrumPropagationLossModel);
 
+/// Number of partial sums of the gains of the rays, which the compiler can vectorize
+static constexpr size_t RAY_LANES = 4;
+
+/// Maximum number of bands whose ray phases are advanced by a rotation, before computing them
+/// again with cos and sin
+static constexpr size_t RAY_PHASE_ANCHOR_PERIOD = 32;
+
+/// Relative difference between band spacings below which the same rotations are used
+static constexpr double RAY_SPACING_TOLERANCE = 1e-9;
+
+/**
+ * Combines a hash with the hash of the elements of a beamforming vector
+ * @param seed the hash to combine
+ * @param bfv the beamforming vector
+ * @return the combined hash
+ */
+static size_t
+HashBeamformingVector(size_t seed, const PhasedArrayModel::ComplexVector& bfv)
+{
+    for (size_t i = 0; i < bfv.GetSize(); ++i)
+    {
+        for (double part : {bfv[i].real(), bfv[i].imag()})
+        {
+            seed ^= std::hash<double>{}(part) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+        }
+    }
+    return seed;
+}
+
 NYUSpectrumPropagationLossModel::NYUSpectrumPropagationLossModel()
 {
     NS_LOG_FUNCTION(this);
@@ -57,7 +92,29 @@ NYUSpectrumPropagationLossModel::GetTypeId()
                 StringValue("ns3::NYUChannelModel"),
                 MakePointerAccessor(&NYUSpectrumPropagationLossModel::SetChannelModel,
                                     &NYUSpectrumPropagationLossModel::GetChannelModel),
-                MakePointerChecker<MatrixBasedChannelModel>());
+                MakePointerChecker<MatrixBasedChannelModel>())
+            .AddAttribute("MaxLongTermsPerLink",
+                          "The maximum number of long term components cached for each link, "
+                          "one per pair of beamforming vectors used on the current channel",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(
+                              &NYUSpectrumPropagationLossModel::m_maxLongTermsPerLink),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("LongTermCacheHits",
+                          "The number of long term components found in the cache",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(
+                              &NYUSpectrumPropagationLossModel::GetNumLongTermHits),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("LongTermCacheMisses",
+                          "The number of long term components computed because they were not "
+                          "in the cache",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(
+                              &NYUSpectrumPropagationLossModel::GetNumLongTermMisses),
+                          MakeUintegerChecker<uint64_t>());
     return tid;
 }
 
@@ -121,7 +178,7 @@ NYUSpectrumPropagationLossModel::CalcLongTerm(
 Ptr<SpectrumValue>
 NYUSpectrumPropagationLossModel::CalcBeamformingGain(
     Ptr<SpectrumValue> txPsd,
-    PhasedArrayModel::ComplexVector longTerm,
+    const PhasedArrayModel::ComplexVector& longTerm,
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
     Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
     const ns3::Vector& sSpeed,
@@ -139,35 +196,33 @@ NYUSpectrumPropagationLossModel::CalcBeamformingGain(
     // each cluster in to consideration.
     double slotTime = Simulator::Now().GetSeconds();
     double factor = 2 * M_PI * slotTime * GetFrequency() / 3e8;
-    PhasedArrayModel::ComplexVector doppler(numRays);
 
     // check if channelParams structure is generated in direction s-to-u or u-to-s
     bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-    MatrixBasedChannelModel::DoubleVector zoa;
-    MatrixBasedChannelModel::DoubleVector zod;
-    MatrixBasedChannelModel::DoubleVector aoa;
-    MatrixBasedChannelModel::DoubleVector aod;
-
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenit od departure and arrival are ok,
     // just set them to corresponding variable that will be used for the generation
     // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
-    if (isSameDirection)
-    {
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-    else
-    {
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-
+    const auto& angles = channelParams->m_angle;
+    const MatrixBasedChannelModel::DoubleVector& zoa =
+        angles[isSameDirection ? MatrixBasedChannelModel::ZOA_INDEX
+                               : MatrixBasedChannelModel::ZOD_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& zod =
+        angles[isSameDirection ? MatrixBasedChannelModel::ZOD_INDEX
+                               : MatrixBasedChannelModel::ZOA_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& aoa =
+        angles[isSameDirection ? MatrixBasedChannelModel::AOA_INDEX
+                               : MatrixBasedChannelModel::AOD_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& aod =
+        angles[isSameDirection ? MatrixBasedChannelModel::AOD_INDEX
+                               : MatrixBasedChannelModel::AOA_INDEX];
+
+    NS_ASSERT(numRays <= longTerm.GetSize());
+
+    // The Doppler term does not depend on the frequency, so it is applied once to the long term
+    // component of each ray, and the gains are reused for all the bands
+    PhasedArrayModel::ComplexVector rayGains(numRays);
     for (size_t cIndex = 0; cIndex < numRays; cIndex++)
     {
         // Compute alpha and D as described in 3GPP TR 37.885 v15.3.0, Sec. 6.2.3
@@ -188,45 +243,122 @@ NYUSpectrumPropagationLossModel::CalcBeamformingGain(
               sin(zoa[cIndex]) * sin(aoa[cIndex]) * uSpeed.y + cos(zoa[cIndex]) * uSpeed.z) +
              (sin(zod[cIndex]) * cos(aod[cIndex]) * sSpeed.x +
               sin(zod[cIndex]) * sin(aod[cIndex]) * sSpeed.y + cos(zod[cIndex]) * sSpeed.z));
-        doppler[cIndex] = std::complex<double>(cos(tempDoppler), sin(tempDoppler));
+        rayGains[cIndex] =
+            longTerm[cIndex] * std::complex<double>(cos(tempDoppler), sin(tempDoppler));
     }
 
-    NS_ASSERT(numRays <= doppler.GetSize());
+    // apply the propagation delay to the gains of the rays to obtain the beamforming gain
+    ApplyRayGains(*tempPsd, rayGains, channelParams->m_delay);
+    return tempPsd;
+}
+
+void
+NYUSpectrumPropagationLossModel::ApplyRayGains(SpectrumValue& psd,
+                                               const PhasedArrayModel::ComplexVector& rayGains,
+                                               const MatrixBasedChannelModel::DoubleVector& delays)
+{
+    size_t numRays = rayGains.GetSize();
+    NS_ASSERT(numRays <= delays.size());
+
+    // The rays are stored as separate real and imaginary arrays, padded with zero gains to a
+    // multiple of the number of partial sums
+    size_t numPadded = (numRays + RAY_LANES - 1) / RAY_LANES * RAY_LANES;
+    std::vector<double> delay(numPadded, 0.0);
+    std::vector<double> gainRe(numPadded, 0.0);
+    std::vector<double> gainIm(numPadded, 0.0);
+    for (size_t ray = 0; ray < numRays; ++ray)
+    {
+        delay[ray] = delays[ray] * 1e-9;
+        gainRe[ray] = rayGains[ray].real();
+        gainIm[ray] = rayGains[ray].imag();
+    }
 
-    // apply the doppler term and the propagation delay to the long term component
-    // to obtain the beamforming gain
-    auto vit = tempPsd->ValuesBegin();      // psd iterator
-    auto sbit = tempPsd->ConstBandsBegin(); // band iterator
-    while (vit != tempPsd->ValuesEnd())
+    // The gain of each ray at the current band, g_n exp(-j 2 pi f tau_n), and its rotation
+    // from a band to the next one, exp(-j 2 pi df tau_n)
+    std::vector<double> phasorRe(numPadded, 0.0);
+    std::vector<double> phasorIm(numPadded, 0.0);
+    std::vector<double> rotationRe(numPadded, 1.0);
+    std::vector<double> rotationIm(numPadded, 0.0);
+    double rotationSpacing = 0; // the band spacing of the rotations, 0 if not computed yet
+    bool hasPhasors = false;    // whether the phasors were computed for a previous band
+    size_t phasorBand = 0;      // the band of the phasors
+    size_t anchorBand = 0;      // the last band where the phasors were computed with cos and sin
+    double phasorFc = 0;        // the center frequency of the band of the phasors
+
+    auto vit = psd.ValuesBegin();      // psd iterator
+    auto sbit = psd.ConstBandsBegin(); // band iterator
+    for (size_t band = 0; vit != psd.ValuesEnd(); ++vit, ++sbit, ++band)
     {
-        if ((*vit) != 0.00)
+        if ((*vit) == 0.00)
+        {
+            continue;
+        }
+
+        double fsb = (*sbit).fc; // center frequency of the sub-band
+        if (hasPhasors && phasorBand + 1 == band && band - anchorBand < RAY_PHASE_ANCHOR_PERIOD)
+        {
+            double spacing = fsb - phasorFc;
+            if (std::abs(spacing - rotationSpacing) > RAY_SPACING_TOLERANCE * std::abs(spacing))
+            {
+                for (size_t ray = 0; ray < numRays; ++ray)
+                {
+                    double phase = -2 * M_PI * spacing * delay[ray];
+                    rotationRe[ray] = cos(phase);
+                    rotationIm[ray] = sin(phase);
+                }
+                rotationSpacing = spacing;
+            }
+
+            // advance the phasors of the previous band
+            for (size_t ray = 0; ray < numPadded; ++ray)
+            {
+                double re = phasorRe[ray] * rotationRe[ray] - phasorIm[ray] * rotationIm[ray];
+                double im = phasorRe[ray] * rotationIm[ray] + phasorIm[ray] * rotationRe[ray];
+                phasorRe[ray] = re;
+                phasorIm[ray] = im;
+            }
+        }
+        else
+        {
+            for (size_t ray = 0; ray < numRays; ++ray)
+            {
+                double phase = -2 * M_PI * fsb * delay[ray];
+                double c = cos(phase);
+                double s = sin(phase);
+                phasorRe[ray] = gainRe[ray] * c - gainIm[ray] * s;
+                phasorIm[ray] = gainRe[ray] * s + gainIm[ray] * c;
+            }
+            anchorBand = band;
+        }
+        hasPhasors = true;
+        phasorBand = band;
+        phasorFc = fsb;
+
+        double sumRe[RAY_LANES] = {};
+        double sumIm[RAY_LANES] = {};
+        for (size_t ray = 0; ray < numPadded; ray += RAY_LANES)
         {
-            std::complex<double> subsbandGain(0.0, 0.0);
-            double fsb = (*sbit).fc; // center frequency of the sub-band
-            for (size_t cIndex = 0; cIndex < numRays; cIndex++)
+            for (size_t lane = 0; lane < RAY_LANES; ++lane)
             {
-                double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]) * 1e-9;
-                subsbandGain = subsbandGain + longTerm[cIndex] *
-                                                  std::complex<double>(cos(delay), sin(delay)) *
-                                                  doppler[cIndex];
+                sumRe[lane] += phasorRe[ray + lane];
+                sumIm[lane] += phasorIm[ray + lane];
             }
-            *vit = (*vit) * (norm(subsbandGain));
         }
-        vit++;
-        sbit++;
+        std::complex<double> subsbandGain(0.0, 0.0);
+        for (size_t lane = 0; lane < RAY_LANES; ++lane)
+        {
+            subsbandGain += std::complex<double>(sumRe[lane], sumIm[lane]);
+        }
+        *vit = (*vit) * (norm(subsbandGain));
     }
-    return tempPsd;
 }
 
-PhasedArrayModel::ComplexVector
+Ptr<const NYUSpectrumPropagationLossModel::LongTerm>
 NYUSpectrumPropagationLossModel::GetLongTerm(
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
     Ptr<const PhasedArrayModel> aPhasedArrayModel,
     Ptr<const PhasedArrayModel> bPhasedArrayModel) const
 {
-    PhasedArrayModel::ComplexVector
-        longTerm; // vector containing the long term component for each cluster
-
     // check if the channel matrix was generated considering a as the s-node and
     // b as the u-node or vice-versa
     PhasedArrayModel::ComplexVector sW;
@@ -241,50 +373,51 @@ NYUSpectrumPropagationLossModel::GetLongTerm(
         sW = bPhasedArrayModel->GetBeamformingVector();
         uW = aPhasedArrayModel->GetBeamformingVector();
     }
-
-    bool update = false;   // indicates whether the long term has to be updated
-    bool notFound = false; // indicates if the long term has not been computed yet
+    size_t bfKey = HashBeamformingVector(HashBeamformingVector(0, sW), uW);
 
     // compute the long term key, the key is unique for each tx-rx pair
     uint64_t longTermId =
         MatrixBasedChannelModel::GetKey(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId());
+    auto& longTerms = m_longTermMap[longTermId];
 
-    // look for the long term in the map and check if it is valid
-    if (m_longTermMap.find(longTermId) != m_longTermMap.end())
+    // the long terms of a previous realization of the channel are no longer valid
+    if (!longTerms.empty() &&
+        (longTerms.front()->m_channel != channelMatrix ||
+         longTerms.front()->m_channel->m_generatedTime != channelMatrix->m_generatedTime))
     {
-        NS_LOG_DEBUG("found the long term component in the map");
-        longTerm = m_longTermMap[longTermId]->m_longTerm;
-
-        // check if the channel matrix has been updated
-        // or the s beam has been changed
-        // or the u beam has been changed
-        update = (m_longTermMap[longTermId]->m_channel->m_generatedTime !=
-                      channelMatrix->m_generatedTime ||
-                  m_longTermMap[longTermId]->m_sW != sW || m_longTermMap[longTermId]->m_uW != uW);
+        NS_LOG_DEBUG("the channel matrix was updated, discard " << longTerms.size()
+                                                                << " long term components");
+        longTerms.clear();
     }
-    else
+
+    // look for the long term of the beamforming vectors, and move it to the front
+    for (auto it = longTerms.begin(); it != longTerms.end(); ++it)
     {
-        NS_LOG_DEBUG("long term component NOT found");
-        notFound = true;
+        if ((*it)->m_bfKey == bfKey && (*it)->m_sW == sW && (*it)->m_uW == uW)
+        {
+            NS_LOG_DEBUG("found the long term component in the map");
+            ++m_numLongTermHits;
+            std::rotate(longTerms.begin(), it, it + 1);
+            return longTerms.front();
+        }
     }
 
-    if (update || notFound)
+    NS_LOG_DEBUG("long term component NOT found, compute it");
+    ++m_numLongTermMisses;
+    Ptr<LongTerm> longTermItem = Create<LongTerm>();
+    longTermItem->m_longTerm = CalcLongTerm(channelMatrix, sW, uW);
+    longTermItem->m_channel = channelMatrix;
+    longTermItem->m_sW = std::move(sW);
+    longTermItem->m_uW = std::move(uW);
+    longTermItem->m_bfKey = bfKey;
+
+    // store the long term in place of the least recently used one
+    if (longTerms.size() >= m_maxLongTermsPerLink)
     {
-        NS_LOG_DEBUG("compute the long term");
-        // compute the long term component
-        longTerm = CalcLongTerm(channelMatrix, sW, uW);
-
-        // store the long term
-        Ptr<LongTerm> longTermItem = Create<LongTerm>();
-        longTermItem->m_longTerm = longTerm;
-        longTermItem->m_channel = channelMatrix;
-        longTermItem->m_sW = sW;
-        longTermItem->m_uW = uW;
-
-        m_longTermMap[longTermId] = longTermItem;
+        longTerms.resize(m_maxLongTermsPerLink - 1);
     }
-
-    return longTerm;
+    longTerms.insert(longTerms.begin(), longTermItem);
+    return longTermItem;
 }
 
 Ptr<SpectrumSignalParameters>
@@ -317,12 +450,12 @@ NYUSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
         m_channelModel->GetParams(a, b);
 
     // retrieve the long term component
-    PhasedArrayModel::ComplexVector longTerm =
+    Ptr<const LongTerm> longTerm =
         GetLongTerm(channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
 
     // apply the beamforming gain
     rxParams->psd = CalcBeamformingGain(rxParams->psd,
-                                        longTerm,
+                                        longTerm->m_longTerm,
                                         channelMatrix,
                                         channelParams,
                                         a->GetVelocity(),
@@ -337,4 +470,16 @@ NYUSpectrumPropagationLossModel::DoAssignStreams(int64_t stream)
     return 0;
 }
 
+uint64_t
+NYUSpectrumPropagationLossModel::GetNumLongTermHits() const
+{
+    return m_numLongTermHits;
+}
+
+uint64_t
+NYUSpectrumPropagationLossModel::GetNumLongTermMisses() const
+{
+    return m_numLongTermMisses;
+}
+
 } // namespace ns3
@@ -9,10 +9,12 @@
 #include "ns3/matrix-based-channel-model.h"
 #include "ns3/phased-array-spectrum-propagation-loss-model.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/spectrum-value.h"
 
 #include <complex.h>
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -92,9 +94,10 @@ class NYUSpectrumPropagationLossModel : public PhasedArraySpectrumPropagationLos
      * the product between the cluster matrices and the TX and RX beamforming
      * vectors (w_rx^T H^n_ab w_tx), and accounts for the Doppler component and
      * the propagation delay.
-     * To reduce the computational load, the long term component associated with
-     * a certain channel is cached and recomputed only when the channel realization
-     * is updated, or when the beamforming vectors change.
+     * To reduce the computational load, the long term components associated with
+     * a certain channel are cached for the last MaxLongTermsPerLink pairs of
+     * beamforming vectors used on it, and they are discarded when the channel
+     * realization is updated.
      *
      * @param txPsd tx PSD
      * @param a first node mobility model
@@ -112,6 +115,36 @@ class NYUSpectrumPropagationLossModel : public PhasedArraySpectrumPropagationLos
 
     int64_t DoAssignStreams(int64_t stream) override;
 
+    /**
+     * Get the number of long term components found in the cache
+     * @return the number of cache hits since the creation of the model
+     */
+    uint64_t GetNumLongTermHits() const;
+
+    /**
+     * Get the number of long term components computed because they were not in the cache
+     * @return the number of cache misses since the creation of the model
+     */
+    uint64_t GetNumLongTermMisses() const;
+
+    /**
+     * @brief Multiplies each non-zero value of a PSD by the power gain of the rays at the
+     * center frequency of its band, |sum_n g_n exp(-j 2 pi f tau_n)|^2
+     *
+     * The phase of each ray is computed with cos and sin only at the first band of each run of
+     * consecutive, evenly spaced non-zero bands. In the following bands of the run, it is
+     * advanced by a constant rotation per ray, and recomputed every 32 bands to bound the
+     * accumulated rounding error. The rays are processed in fixed groups of partial sums, which
+     * the compiler vectorizes.
+     *
+     * @param psd the PSD
+     * @param rayGains the complex gain of each ray, including the long term and Doppler terms
+     * @param delays the delay of each ray, in ns
+     */
+    static void ApplyRayGains(SpectrumValue& psd,
+                              const PhasedArrayModel::ComplexVector& rayGains,
+                              const MatrixBasedChannelModel::DoubleVector& delays);
+
   private:
     /**
      * Data structure that stores the long term component for a tx-rx pair
@@ -125,7 +158,8 @@ class NYUSpectrumPropagationLossModel : public PhasedArraySpectrumPropagationLos
         PhasedArrayModel::ComplexVector
             m_sW; //!< the beamforming vector for the node s used to compute the long term
         PhasedArrayModel::ComplexVector
-            m_uW; //!< the beamforming vector for the node u used to compute the long term
+            m_uW;       //!< the beamforming vector for the node u used to compute the long term
+        size_t m_bfKey; //!< the hash of m_sW and m_uW
     };
 
     /**
@@ -135,15 +169,17 @@ class NYUSpectrumPropagationLossModel : public PhasedArraySpectrumPropagationLos
     double GetFrequency() const;
 
     /**
-     * Looks for the long term component in m_longTermMap. If found, checks
-     * whether it has to be updated. If not found or if it has to be updated,
-     * calls the method CalcLongTerm to compute it.
+     * Looks for the long term component of the current beamforming vectors in
+     * m_longTermMap. The entries of the link are discarded if the channel matrix
+     * was updated. If not found, calls the method CalcLongTerm to compute it, and
+     * stores it in place of the least recently used entry of the link if there are
+     * MaxLongTermsPerLink of them.
      * @param channelMatrix the channel matrix
      * @param aPhasedArrayModel the antenna array of the tx device
      * @param bPhasedArrayModel the antenna array of the rx device
-     * @return vector containing the long term component for each cluster
+     * @return the long term component for each cluster
      */
-    PhasedArrayModel::ComplexVector GetLongTerm(
+    Ptr<const LongTerm> GetLongTerm(
         Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
         Ptr<const PhasedArrayModel> aPhasedArrayModel,
         Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
@@ -171,15 +207,18 @@ class NYUSpectrumPropagationLossModel : public PhasedArraySpectrumPropagationLos
      */
     Ptr<SpectrumValue> CalcBeamformingGain(
         Ptr<SpectrumValue> txPsd,
-        PhasedArrayModel::ComplexVector longTerm,
+        const PhasedArrayModel::ComplexVector& longTerm,
         Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
         Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
         const Vector& sSpeed,
         const Vector& uSpeed) const;
 
-    mutable std::unordered_map<uint64_t, Ptr<const LongTerm>>
-        m_longTermMap;                           //!< map containing the long term components
+    /// The long term components of each link, from the most to the least recently used
+    mutable std::unordered_map<uint64_t, std::vector<Ptr<const LongTerm>>> m_longTermMap;
     Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
+    uint32_t m_maxLongTermsPerLink;              //!< the maximum number of long terms per link
+    mutable uint64_t m_numLongTermHits{0};       //!< the number of long terms found in the cache
+    mutable uint64_t m_numLongTermMisses{0};     //!< the number of long terms computed
 };
 } // namespace ns3
 